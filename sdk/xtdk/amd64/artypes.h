@@ -28,6 +28,10 @@
 #define CR0_CD                                          0x40000000
 #define CR0_PG                                          0x80000000
 
+/* Control Register 3 constants */
+#define CR3_PCID_MASK                                   0x0000000000000FFFULL
+#define CR3_NOFLUSH                                     0x8000000000000000ULL
+
 /* Control Register 4 constants */
 #define CR4_VME                                         0x00000001
 #define CR4_PVI                                         0x00000002
@@ -57,6 +61,12 @@
 #define CR4_LASS                                        0x08000000
 #define CR4_LAM_SUP                                     0x10000000
 
+/* INVPCID invalidation types */
+#define INVPCID_INDIVIDUAL_ADDRESS                      0
+#define INVPCID_SINGLE_CONTEXT                          1
+#define INVPCID_ALL_CONTEXTS_GLOBAL                     2
+#define INVPCID_ALL_CONTEXTS                            3
+
 /* Descriptors size */
 #define GDT_ENTRIES                                     128
 #define IDT_ENTRIES                                     256
@@ -72,6 +82,13 @@
 #define PAT_TYPE_WB                                     6ULL
 #define PAT_TYPE_WEAK_UC                                7ULL
 
+/* Page fault error code bits */
+#define PF_ERROR_PRESENT                                0x00000001
+#define PF_ERROR_WRITE                                  0x00000002
+#define PF_ERROR_USER                                   0x00000004
+#define PF_ERROR_RESERVED                               0x00000008
+#define PF_ERROR_INSTRUCTION_FETCH                      0x00000010
+
 /* Segment defintions */
 #define SEGMENT_CS                                      0x2E
 #define SEGMENT_DS                                      0x3E
@@ -193,6 +210,15 @@ typedef enum _CPUID_FEATURES_EXTENDED
     CPUID_FEATURES_EDX_3DNOW                  = 1 << 31
 } CPUID_FEATURES_EXTENDED, *PCPUID_FEATURES_EXTENDED;
 
+/* CPUID extended state features (0x0000000D, subleaf 1) enumeration list */
+typedef enum _CPUID_FEATURES_EXTENDED_STATE
+{
+    CPUID_FEATURES_EAX_XSAVEOPT               = 1 << 0,
+    CPUID_FEATURES_EAX_XSAVEC                 = 1 << 1,
+    CPUID_FEATURES_EAX_XGETBV_ECX1            = 1 << 2,
+    CPUID_FEATURES_EAX_XSAVES                 = 1 << 3
+} CPUID_FEATURES_EXTENDED_STATE, *PCPUID_FEATURES_EXTENDED_STATE;
+
 /* CPUID Thermal and Power Management features (0x00000006) enumeration list */
 typedef enum _CPUID_FEATURES_POWER_MANAGEMENT
 {
@@ -418,10 +444,12 @@ typedef enum _CPUID_REQUESTS
     CPUID_GET_MONITOR_MWAIT                   = 0x00000005,
     CPUID_GET_POWER_MANAGEMENT                = 0x00000006,
     CPUID_GET_STANDARD7_FEATURES              = 0x00000007,
+    CPUID_GET_EXTENDED_STATE                  = 0x0000000D,
     CPUID_GET_TSC_CRYSTAL_CLOCK               = 0x00000015,
     CPUID_GET_EXTENDED_MAX                    = 0x80000000,
     CPUID_GET_EXTENDED_FEATURES               = 0x80000001,
-    CPUID_GET_ADVANCED_POWER_MANAGEMENT       = 0x80000007
+    CPUID_GET_ADVANCED_POWER_MANAGEMENT       = 0x80000007,
+    CPUID_GET_EXTENDED_CACHE_TOPOLOGY         = 0x8000001D
 } CPUID_REQUESTS, *PCPUID_REQUESTS;
 
 /* Interrupt handler */
@@ -433,6 +461,8 @@ typedef struct _CPU_IDENTIFICATION
     ULONGLONG ExtendedFeatureBits;
     USHORT Family;
     ULONGLONG FeatureBits;
+    ULONG MaxExtendedLeaf;
+    ULONG MaxStandardLeaf;
     USHORT Model;
     USHORT Stepping;
     CPU_VENDOR Vendor;
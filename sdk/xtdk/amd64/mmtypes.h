@@ -66,7 +66,7 @@
 /* PTE cache flags */
 #define MM_PTE_CACHE_ENABLE                        0x0000000000000000ULL
 #define MM_PTE_CACHE_DISABLE                       0x0000000000000010ULL
-#define MM_PTE_CACHE_WRITECOMBINED                 0x0000000000000010ULL
+#define MM_PTE_CACHE_WRITECOMBINED                 0x0000000000000008ULL
 #define MM_PTE_CACHE_WRITETHROUGH                  0x0000000000000008ULL
 
 /* PTE software flags */
@@ -95,9 +95,12 @@
 /* Number of HAL allocation descriptors */
 #define MM_HARDWARE_ALLOCATION_DESCRIPTORS         64
 
-/* Kernel HAL heap initial start address */
+/* Kernel HAL heap start address */
 #define MM_HARDWARE_HEAP_START_ADDRESS             ((PVOID)(((ULONG_PTR)MM_HARDWARE_VA_START) + 1024 * 1024))
 
+/* Number of pages in the kernel HAL heap, spanning up to the end of the address space */
+#define MM_HARDWARE_HEAP_PAGES                     768
+
 /* HAL memory pool virtual address start */
 #define MM_HARDWARE_VA_START                       0xFFFFFFFFFFC00000ULL
 
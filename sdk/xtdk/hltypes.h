@@ -101,6 +101,16 @@
 #define ACPI_MADT_PLACE_ENABLED                     0 /* Processor Local APIC CPU Enabled */
 #define ACPI_MADT_PLAOC_ENABLED                     1 /* Processor Local APIC Online Capable */
 
+/* ACPI SRAT subtable types */
+#define ACPI_SRAT_TYPE_CPU_AFFINITY                 0
+#define ACPI_SRAT_TYPE_MEMORY_AFFINITY              1
+#define ACPI_SRAT_TYPE_X2APIC_CPU_AFFINITY          2
+
+/* ACPI SRAT affinity structure flags */
+#define ACPI_SRAT_AFFINITY_ENABLED                  0x01 /* Affinity Structure Enabled */
+#define ACPI_SRAT_MEMORY_HOT_PLUGGABLE              0x02 /* Memory Hot Pluggable */
+#define ACPI_SRAT_MEMORY_NON_VOLATILE               0x04 /* Memory Non-Volatile */
+
 /* ACPI Timer frequency */
 #define ACPI_PM_TIMER_FREQUENCY                     3579545
 
@@ -400,6 +410,60 @@ typedef struct _ACPI_MADT_LOCAL_X2APIC
     ULONG AcpiId;
 } PACKED ACPI_MADT_LOCAL_X2APIC, *PACPI_MADT_LOCAL_X2APIC;
 
+/* ACPI System Locality Distance Information Table (SLIT) structure */
+typedef struct _ACPI_SLIT
+{
+    ACPI_DESCRIPTION_HEADER Header;
+    ULONGLONG LocalityCount;
+    UCHAR Entries[];
+} PACKED ACPI_SLIT, *PACPI_SLIT;
+
+/* ACPI Static Resource Affinity Table (SRAT) structure */
+typedef struct _ACPI_SRAT
+{
+    ACPI_DESCRIPTION_HEADER Header;
+    ULONG Reserved1;
+    ULONGLONG Reserved2;
+    ULONG AffinityTables[];
+} PACKED ACPI_SRAT, *PACPI_SRAT;
+
+/* ACPI Processor Local APIC Affinity SRAT subtable structure */
+typedef struct _ACPI_SRAT_CPU_AFFINITY
+{
+    ACPI_SUBTABLE_HEADER Header;
+    UCHAR ProximityDomainLow;
+    UCHAR ApicId;
+    ULONG Flags;
+    UCHAR LocalSapicEid;
+    UCHAR ProximityDomainHigh[3];
+    ULONG ClockDomain;
+} PACKED ACPI_SRAT_CPU_AFFINITY, *PACPI_SRAT_CPU_AFFINITY;
+
+/* ACPI Memory Affinity SRAT subtable structure */
+typedef struct _ACPI_SRAT_MEMORY_AFFINITY
+{
+    ACPI_SUBTABLE_HEADER Header;
+    ULONG ProximityDomain;
+    USHORT Reserved1;
+    ULONGLONG BaseAddress;
+    ULONGLONG Length;
+    ULONG Reserved2;
+    ULONG Flags;
+    ULONGLONG Reserved3;
+} PACKED ACPI_SRAT_MEMORY_AFFINITY, *PACPI_SRAT_MEMORY_AFFINITY;
+
+/* ACPI Processor Local X2APIC Affinity SRAT subtable structure */
+typedef struct _ACPI_SRAT_X2APIC_CPU_AFFINITY
+{
+    ACPI_SUBTABLE_HEADER Header;
+    USHORT Reserved1;
+    ULONG ProximityDomain;
+    ULONG ApicId;
+    ULONG Flags;
+    ULONG ClockDomain;
+    ULONG Reserved2;
+} PACKED ACPI_SRAT_X2APIC_CPU_AFFINITY, *PACPI_SRAT_X2APIC_CPU_AFFINITY;
+
 /* ACPI System Information structure */
 typedef struct _ACPI_SYSTEM_INFO
 {
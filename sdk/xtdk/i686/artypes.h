@@ -64,6 +64,21 @@
 /* Initial MXCSR control */
 #define INITIAL_MXCSR                                   0x1F80
 
+/* Page Attributes Table types */
+#define PAT_TYPE_STRONG_UC                              0ULL
+#define PAT_TYPE_USWC                                   1ULL
+#define PAT_TYPE_WT                                     4ULL
+#define PAT_TYPE_WP                                     5ULL
+#define PAT_TYPE_WB                                     6ULL
+#define PAT_TYPE_WEAK_UC                                7ULL
+
+/* Page fault error code bits */
+#define PF_ERROR_PRESENT                                0x00000001
+#define PF_ERROR_WRITE                                  0x00000002
+#define PF_ERROR_USER                                   0x00000004
+#define PF_ERROR_RESERVED                               0x00000008
+#define PF_ERROR_INSTRUCTION_FETCH                      0x00000010
+
 /* Segment defintions */
 #define SEGMENT_CS                                      0x2E
 #define SEGMENT_DS                                      0x3E
@@ -72,6 +87,9 @@
 #define SEGMENT_FS                                      0x64
 #define SEGMENT_GS                                      0x65
 
+/* MSR values */
+#define X86_MSR_PAT                                     0x00000277
+
 /* X86 EFLAG bit masks definitions */
 #define X86_EFLAGS_NF_MASK                              0x00000000 /* None */
 #define X86_EFLAGS_CF_MASK                              0x00000001 /* Carry */
@@ -158,6 +176,15 @@ typedef enum _CPUID_FEATURES_EXTENDED
     CPUID_FEATURES_EDX_3DNOW                  = 1 << 31
 } CPUID_FEATURES_EXTENDED, *PCPUID_FEATURES_EXTENDED;
 
+/* CPUID extended state features (0x0000000D, subleaf 1) enumeration list */
+typedef enum _CPUID_FEATURES_EXTENDED_STATE
+{
+    CPUID_FEATURES_EAX_XSAVEOPT               = 1 << 0,
+    CPUID_FEATURES_EAX_XSAVEC                 = 1 << 1,
+    CPUID_FEATURES_EAX_XGETBV_ECX1            = 1 << 2,
+    CPUID_FEATURES_EAX_XSAVES                 = 1 << 3
+} CPUID_FEATURES_EXTENDED_STATE, *PCPUID_FEATURES_EXTENDED_STATE;
+
 /* CPUID Thermal and Power Management features (0x00000006) enumeration list */
 typedef enum _CPUID_FEATURES_POWER_MANAGEMENT
 {
@@ -383,10 +410,12 @@ typedef enum _CPUID_REQUESTS
     CPUID_GET_MONITOR_MWAIT                   = 0x00000005,
     CPUID_GET_POWER_MANAGEMENT                = 0x00000006,
     CPUID_GET_STANDARD7_FEATURES              = 0x00000007,
+    CPUID_GET_EXTENDED_STATE                  = 0x0000000D,
     CPUID_GET_TSC_CRYSTAL_CLOCK               = 0x00000015,
     CPUID_GET_EXTENDED_MAX                    = 0x80000000,
     CPUID_GET_EXTENDED_FEATURES               = 0x80000001,
-    CPUID_GET_ADVANCED_POWER_MANAGEMENT       = 0x80000007
+    CPUID_GET_ADVANCED_POWER_MANAGEMENT       = 0x80000007,
+    CPUID_GET_EXTENDED_CACHE_TOPOLOGY         = 0x8000001D
 } CPUID_REQUESTS, *PCPUID_REQUESTS;
 
 /* Interrupt handler */
@@ -398,6 +427,8 @@ typedef struct _CPU_IDENTIFICATION
     ULONGLONG ExtendedFeatureBits;
     USHORT Family;
     ULONGLONG FeatureBits;
+    ULONG MaxExtendedLeaf;
+    ULONG MaxStandardLeaf;
     USHORT Model;
     USHORT Stepping;
     CPU_VENDOR Vendor;
@@ -132,6 +132,13 @@
 #define KCF_SHA                           (1ULL << 38) /* SHA Extensions */
 #define KCF_LA57                          (1ULL << 39) /* 57-bit Linear Addresses */
 #define KCF_ARAT                          (1ULL << 40) /* Always Running APIC Timer */
+#define KCF_PCID                          (1ULL << 41) /* Process-Context Identifiers */
+#define KCF_INVPCID                       (1ULL << 42) /* INVPCID Instruction */
+#define KCF_ERMS                          (1ULL << 43) /* Enhanced REP MOVSB/STOSB */
+#define KCF_FSRM                          (1ULL << 44) /* Fast Short REP MOVSB */
+#define KCF_XSAVEOPT                      (1ULL << 45) /* XSAVEOPT Instruction */
+#define KCF_XSAVEC                        (1ULL << 46) /* XSAVEC Instruction */
+#define KCF_XSAVES                        (1ULL << 47) /* XSAVES/XRSTORS Instructions */
 
 /* Kernel CPU Extended Features */
 #define KCF_SVM                           (1ULL << 0)  /* AMD Secure Virtual Machine */
@@ -524,6 +531,12 @@ typedef struct _KPROCESSOR_CONTROL_BLOCK
     SINGLE_LIST_ENTRY DeferredReadyListHead;
     PROCESSOR_POWER_STATE PowerState;
     ULONG ProfilingCountdown;
+    MMPOOL_LOOKASIDE_LIST PoolLookasideList[MM_POOL_LOOKASIDE_LISTS];
+    ULONG PoolLookasideGeneration;
+    MMPAGE_MAGAZINE PageMagazine;
+    MMSYSTEM_PTE_CACHE SystemPteCache[MaximumPtePoolTypes];
+    MMKERNEL_STACK_CACHE KernelStackCache;
+    ULONG_PTR PerformanceCounters[MaximumPerformanceCounters];
 } KPROCESSOR_CONTROL_BLOCK, *PKPROCESSOR_CONTROL_BLOCK;
 
 /* Processor Block structure definition */
@@ -62,7 +62,7 @@
 /* PTE cache flags */
 #define MM_PTE_CACHE_ENABLE                        0x00000000
 #define MM_PTE_CACHE_DISABLE                       0x00000010
-#define MM_PTE_CACHE_WRITECOMBINED                 0x00000010
+#define MM_PTE_CACHE_WRITECOMBINED                 0x00000008
 #define MM_PTE_CACHE_WRITETHROUGH                  0x00000008
 
 /* PTE software flags */
@@ -93,9 +93,12 @@
 /* Number of HAL allocation descriptors */
 #define MM_HARDWARE_ALLOCATION_DESCRIPTORS         64
 
-/* Kernel HAL heap initial start address */
+/* Kernel HAL heap start address */
 #define MM_HARDWARE_HEAP_START_ADDRESS             ((PVOID)(((ULONG_PTR)MM_HARDWARE_VA_START) + 1024 * 1024))
 
+/* Number of pages in the kernel HAL heap, spanning up to the end of the address space */
+#define MM_HARDWARE_HEAP_PAGES                     768
+
 /* HAL memory pool virtual address start */
 #define MM_HARDWARE_VA_START                       0xFFC00000
 
@@ -417,6 +417,7 @@ typedef struct _KPROCESS
     DISPATCHER_HEADER Header;
     LIST_ENTRY ProfileListHead;
     ULONG_PTR DirectoryTable[2];
+    USHORT AddressSpaceId;
     USHORT IopmOffset;
     UCHAR Iopl;
     VOLATILE KAFFINITY ActiveProcessors;
@@ -17,11 +17,68 @@
 /* Number of hyper space pages */
 #define MM_HYPERSPACE_PAGE_COUNT                   255
 
-/* Number of free page list heads */
-#define MM_MAX_FREE_PAGE_LIST_HEADS                4
+/* Non-paged pool free page runs index definitions */
+#define MM_FREE_PAGE_RUN_FIRST_LEVELS              30
+#define MM_FREE_PAGE_RUN_SECOND_LEVEL_SHIFT        3
+#define MM_FREE_PAGE_RUN_SECOND_LEVELS             (1 << MM_FREE_PAGE_RUN_SECOND_LEVEL_SHIFT)
+#define MM_FREE_PAGE_RUN_LISTS                     (MM_FREE_PAGE_RUN_FIRST_LEVELS * MM_FREE_PAGE_RUN_SECOND_LEVELS)
+
+/* System PTE free cluster index definitions */
+#define MM_SYSTEM_PTE_FIRST_LEVELS                 30
+#define MM_SYSTEM_PTE_SECOND_LEVEL_SHIFT           3
+#define MM_SYSTEM_PTE_SECOND_LEVELS                (1 << MM_SYSTEM_PTE_SECOND_LEVEL_SHIFT)
+#define MM_SYSTEM_PTE_LISTS                        (MM_SYSTEM_PTE_FIRST_LEVELS * MM_SYSTEM_PTE_SECOND_LEVELS)
+
+/* Object cache definitions */
+#define MM_OBJECT_CACHE_MAGAZINE_SIZE              16
+#define MM_OBJECT_CACHE_MAGAZINE_BATCH             8
+
+/* Per-processor page magazine definitions */
+#define MM_PAGE_MAGAZINE_SIZE                      32
+#define MM_PAGE_MAGAZINE_BATCH                     16
+#define MM_PAGE_MAGAZINE_LOW_MEMORY_PAGES          256
+
+/* Per-processor system PTE cache definitions */
+#define MM_SYSTEM_PTE_CACHE_SIZES                  16
+#define MM_SYSTEM_PTE_CACHE_DEPTH                  8
+#define MM_SYSTEM_PTE_CACHE_BATCH                  4
+#define MM_SYSTEM_PTE_CACHE_MAXIMUM_PTES           256
+
+/* Per-processor kernel stack cache definitions */
+#define MM_KERNEL_STACK_CACHE_DEPTH                16
+#define MM_KERNEL_STACK_CACHE_DEFAULT_DEPTH        4
+#define MM_KERNEL_STACK_CACHE_LOW_MEMORY_PAGES     512
+
+/* TLB shootdown definitions */
+#define MM_TLB_FLUSH_RANGES                        16
+#define MM_TLB_FLUSH_THRESHOLD                     32
+
+/* Number of hardware address space identifiers (PCIDs) */
+#define MM_ADDRESS_SPACE_IDS                       4096
+
+/* Maximum number of physical pages acquired in a single bulk allocation */
+#define MM_PAGE_BULK_ALLOCATION_SIZE               64
+
+/* Number of free pages zeroed by the idle zero page worker in a single pass */
+#define MM_ZERO_PAGE_BATCH                         16
+
+/* Deferred PFN database initialization definitions */
+#define MM_DEFERRED_PFN_BASE_PAGE                  0x100000
+#define MM_DEFERRED_PFN_CHUNK_PAGES                0x8000
+#define MM_MAXIMUM_DEFERRED_PFN_RUNS               32
+
+/* Highest page of the region reserved for physically contiguous allocations, kept reachable by 32-bit DMA */
+#define MM_CONTIGUOUS_RESERVE_HIGHEST_PAGE         0xFFFFF
+
+/* NUMA topology definitions */
+#define MM_MAXIMUM_NUMA_NODES                      16
+#define MM_MAXIMUM_NUMA_MEMORY_RANGES              64
+#define MM_NUMA_LOCAL_DISTANCE                     10
+#define MM_NUMA_REMOTE_DISTANCE                    20
 
 /* Number of paging colors */
 #define MM_PAGING_COLORS                           64
+#define MM_MAXIMUM_PAGING_COLORS                   1024
 
 /* PTE frame mask definition */
 #define MM_PFN_PTE_FRAME                           (((ULONG_PTR)1 << MM_PTE_FRAME_BITS) - 1)
@@ -33,6 +90,27 @@
 #define MM_POOL_INVALID_ALLOC_RUNLEVEL             8
 #define MM_POOL_INVALID_FREE_RUNLEVEL              9
 
+/* Per-processor pool lookaside lists definitions */
+#define MM_POOL_LOOKASIDE_LISTS                    32
+#define MM_POOL_LOOKASIDE_MINIMUM_DEPTH            4
+#define MM_POOL_LOOKASIDE_MAXIMUM_DEPTH            256
+#define MM_POOL_LOOKASIDE_ADJUST_INTERVAL          256
+#define MM_POOL_LOOKASIDE_LOW_MEMORY_PAGES         256
+
+/* Big allocations tracker definitions */
+#define MM_POOL_BIG_ALLOCATIONS_MIGRATION_BATCH    16
+#define MM_POOL_BIG_ALLOCATIONS_SHARDS             16
+#define MM_POOL_BIG_ALLOCATIONS_SHARD_SHIFT        4
+
+/* Pool verification levels */
+#define MM_POOL_VERIFY_NONE                        0
+#define MM_POOL_VERIFY_HEADERS                     1
+#define MM_POOL_VERIFY_FULL                        2
+
+/* Guard page pool definitions */
+#define MM_POOL_GUARD_PTES                         4096
+#define MM_POOL_GUARD_PATTERN                      0xAA
+
 /* Pool flags */
 #define MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE         0x1
 #define MM_POOL_PROTECTED                          0x80000000
@@ -72,6 +150,25 @@ typedef enum _MMPAGELISTS
    TransitionPage = 7
 } MMPAGELISTS, *PMMPAGELISTS;
 
+/* Memory manager performance counters, allocations and frees are ordered as the page lists */
+typedef enum _MMPERFORMANCE_COUNTER
+{
+    ZeroedPageAllocations,
+    FreePageAllocations,
+    StandbyPageAllocations,
+    ModifiedPageAllocations,
+    ZeroedPageFrees,
+    FreePageFrees,
+    StandbyPageFrees,
+    ModifiedPageFrees,
+    ColoredListMisses,
+    PoolExpansions,
+    SystemPteFailures,
+    TlbFlushes,
+    PageFaults,
+    MaximumPerformanceCounters
+} MMPERFORMANCE_COUNTER, *PMMPERFORMANCE_COUNTER;
+
 /* Page cache attributes */
 typedef enum _MMPFN_CACHE_ATTRIBUTE
 {
@@ -107,6 +204,9 @@ typedef enum _MMSYSTEM_PTE_POOL_TYPE
     MaximumPtePoolTypes
 } MMSYSTEM_PTE_POOL_TYPE, *PMMSYSTEM_PTE_POOL_TYPE;
 
+/* Object cache constructor routine callback */
+typedef VOID (XTAPI *PMMOBJECT_CONSTRUCTOR)(IN PVOID Object, IN PVOID Context);
+
 /* Page map routines structure definition */
 typedef CONST STRUCT _CMMPAGEMAP_ROUTINES
 {
@@ -132,6 +232,16 @@ typedef struct _MMFREE_POOL_ENTRY
     PMMFREE_POOL_ENTRY Owner;
 } MMFREE_POOL_ENTRY, *PMMFREE_POOL_ENTRY;
 
+/* Per-processor kernel stack cache structure definition */
+typedef struct _MMKERNEL_STACK_CACHE
+{
+    ULONG Count;
+    ULONG DirtyCount;
+    ULONG FlushGeneration;
+    PVOID Stacks[MM_KERNEL_STACK_CACHE_DEPTH];
+    PVOID DirtyStacks[MM_KERNEL_STACK_CACHE_DEPTH];
+} MMKERNEL_STACK_CACHE, *PMMKERNEL_STACK_CACHE;
+
 /* Memory layout structure definition */
 typedef struct _MMMEMORY_LAYOUT
 {
@@ -176,6 +286,72 @@ typedef struct _MMMEMORY_LAYOUT
     PVOID PteSpaceEnd;
 } MMMEMORY_LAYOUT, *PMMMEMORY_LAYOUT;
 
+/* NUMA memory range structure definition */
+typedef struct _MMNUMA_MEMORY_RANGE
+{
+    PFN_NUMBER BasePage;
+    PFN_NUMBER EndPage;
+    ULONG Node;
+} MMNUMA_MEMORY_RANGE, *PMMNUMA_MEMORY_RANGE;
+
+/* Per-processor object cache magazine structure definition */
+typedef struct _MMOBJECT_MAGAZINE
+{
+    ULONG Count;
+    ULONG TotalAllocates;
+    ULONG AllocateMisses;
+    ULONG TotalFrees;
+    ULONG FreeMisses;
+    PVOID Objects[MM_OBJECT_CACHE_MAGAZINE_SIZE];
+} MMOBJECT_MAGAZINE, *PMMOBJECT_MAGAZINE;
+
+/* Object cache structure definition */
+typedef struct _MMOBJECT_CACHE
+{
+    KSPIN_LOCK Lock;
+    ULONG Tag;
+    ULONG ObjectSize;
+    ULONG ObjectsPerSlab;
+    ULONG ObjectsOffset;
+    ULONG NextColor;
+    ULONG MaximumColor;
+    PMMOBJECT_CONSTRUCTOR Constructor;
+    PVOID Context;
+    LIST_ENTRY FullSlabs;
+    LIST_ENTRY PartialSlabs;
+    LIST_ENTRY FreeSlabs;
+    ULONG TotalSlabs;
+    ULONG ActiveObjects;
+    ULONG MagazineCount;
+    PMMOBJECT_MAGAZINE Magazines;
+} MMOBJECT_CACHE, *PMMOBJECT_CACHE;
+
+/* Object cache slab structure definition */
+typedef struct _MMOBJECT_SLAB
+{
+    LIST_ENTRY ListEntry;
+    PMMOBJECT_CACHE Cache;
+    PVOID Objects;
+    USHORT FreeCount;
+    USHORT FreeStack[1];
+} MMOBJECT_SLAB, *PMMOBJECT_SLAB;
+
+/* Per-processor page magazine structure definition */
+typedef struct _MMPAGE_MAGAZINE
+{
+    ULONG Count;
+    ULONG ColorMisses;
+    PFN_NUMBER Pages[MM_PAGE_MAGAZINE_SIZE];
+} MMPAGE_MAGAZINE, *PMMPAGE_MAGAZINE;
+
+/* Memory manager performance information structure definition */
+typedef struct _MMPERFORMANCE_INFORMATION
+{
+    ULONG_PTR Counters[MaximumPerformanceCounters];
+    PFN_NUMBER ListPages[BadPageList + 1];
+    PFN_NUMBER AvailablePages;
+} MMPERFORMANCE_INFORMATION, *PMMPERFORMANCE_INFORMATION;
+
 /* Page Frame Entry structure definition */
 typedef struct _MMPFNENTRY
 {
@@ -200,6 +376,48 @@ typedef struct _MMPFNLIST
     PFN_NUMBER Blink;
 } MMPFNLIST, *PMMPFNLIST;
 
+/* Pool lookaside list structure definition */
+typedef struct _MMPOOL_LOOKASIDE_LIST
+{
+    SINGLE_LIST_HEADER ListHead;
+    USHORT Depth;
+    USHORT MaximumDepth;
+    ULONG TotalAllocates;
+    ULONG AllocateMisses;
+    ULONG TotalFrees;
+    ULONG FreeMisses;
+    ULONG LastTotalAllocates;
+    ULONG LastAllocateMisses;
+} MMPOOL_LOOKASIDE_LIST, *PMMPOOL_LOOKASIDE_LIST;
+
+/* Per-processor system PTE cache structure definition */
+typedef struct _MMSYSTEM_PTE_CACHE
+{
+    ULONG CachedPtes;
+    ULONG TotalReserves;
+    ULONG ReserveMisses;
+    UCHAR Count[MM_SYSTEM_PTE_CACHE_SIZES];
+    PMMPTE Runs[MM_SYSTEM_PTE_CACHE_SIZES][MM_SYSTEM_PTE_CACHE_DEPTH];
+} MMSYSTEM_PTE_CACHE, *PMMSYSTEM_PTE_CACHE;
+
+/* TLB flush range structure definition */
+typedef struct _MMTLB_FLUSH_RANGE
+{
+    PVOID VirtualAddress;
+    PFN_COUNT NumberOfPages;
+} MMTLB_FLUSH_RANGE, *PMMTLB_FLUSH_RANGE;
+
+/* TLB flush batch structure definition */
+typedef struct _MMTLB_FLUSH_BATCH
+{
+    BOOLEAN FlushEntireTlb;
+    BOOLEAN UserSpace;
+    USHORT AddressSpaceId;
+    ULONG Count;
+    PFN_COUNT NumberOfPages;
+    MMTLB_FLUSH_RANGE Ranges[MM_TLB_FLUSH_RANGES];
+} MMTLB_FLUSH_BATCH, *PMMTLB_FLUSH_BATCH;
+
 /* Physical memory run structure definition */
 typedef struct _PHYSICAL_MEMORY_RUN
 {
@@ -250,17 +468,48 @@ typedef struct _POOL_TRACKING_BIG_ALLOCATIONS
     PVOID VirtualAddress;
 } POOL_TRACKING_BIG_ALLOCATIONS, *PPOOL_TRACKING_BIG_ALLOCATIONS;
 
+/* Big allocations tracking shard structure definition */
+typedef struct _POOL_TRACKING_BIG_ALLOCATIONS_SHARD
+{
+    KSPIN_LOCK Lock;
+    LONG Generation;
+    LONG Readers;
+    LONG InUse;
+    PPOOL_TRACKING_BIG_ALLOCATIONS Table;
+    SIZE_T TableSize;
+    PPOOL_TRACKING_BIG_ALLOCATIONS MigrationTable;
+    SIZE_T MigrationTableSize;
+    SIZE_T MigrationIndex;
+    PPOOL_TRACKING_BIG_ALLOCATIONS RetiredTable;
+} POOL_TRACKING_BIG_ALLOCATIONS_SHARD, *PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD;
+
 /* Pool tracking table structure definition */
 typedef struct _POOL_TRACKING_TABLE
 {
     LONG NonPagedAllocations;
     SIZE_T NonPagedBytes;
     LONG NonPagedFrees;
+    SIZE_T NonPagedPeakBytes;
     LONG PagedAllocations;
     SIZE_T PagedBytes;
     LONG PagedFrees;
+    SIZE_T PagedPeakBytes;
     ULONG Tag;
 } POOL_TRACKING_TABLE, *PPOOL_TRACKING_TABLE;
 
+/* Pool tag statistics structure definition */
+typedef struct _POOL_TAG_STATISTICS
+{
+    ULONG Tag;
+    LONG NonPagedAllocations;
+    LONG NonPagedFrees;
+    SIZE_T NonPagedBytes;
+    SIZE_T NonPagedPeakBytes;
+    LONG PagedAllocations;
+    LONG PagedFrees;
+    SIZE_T PagedBytes;
+    SIZE_T PagedPeakBytes;
+} POOL_TAG_STATISTICS, *PPOOL_TAG_STATISTICS;
+
 #endif /* __XTOS_ASSEMBLER__ */
 #endif /* __XTDK_MMTYPES_H */
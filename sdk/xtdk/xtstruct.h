@@ -53,6 +53,7 @@ typedef enum _KTIMER_TYPE KTIMER_TYPE, *PKTIMER_TYPE;
 typedef enum _KUBSAN_DATA_TYPE KUBSAN_DATA_TYPE, *PKUBSAN_DATA_TYPE;
 typedef enum _LOADER_MEMORY_TYPE LOADER_MEMORY_TYPE, *PLOADER_MEMORY_TYPE;
 typedef enum _MMPAGELISTS MMPAGELISTS, *PMMPAGELISTS;
+typedef enum _MMPERFORMANCE_COUNTER MMPERFORMANCE_COUNTER, *PMMPERFORMANCE_COUNTER;
 typedef enum _MMPFN_CACHE_ATTRIBUTE MMPFN_CACHE_ATTRIBUTE, *PMMPFN_CACHE_ATTRIBUTE;
 typedef enum _MMPOOL_TYPE MMPOOL_TYPE, *PMMPOOL_TYPE;
 typedef enum _MMSYSTEM_PTE_POOL_TYPE MMSYSTEM_PTE_POOL_TYPE, *PMMSYSTEM_PTE_POOL_TYPE;
@@ -74,6 +75,11 @@ typedef struct _ACPI_MADT_LOCAL_APIC ACPI_MADT_LOCAL_APIC, *PACPI_MADT_LOCAL_API
 typedef struct _ACPI_MADT_LOCAL_X2APIC ACPI_MADT_LOCAL_X2APIC, *PACPI_MADT_LOCAL_X2APIC;
 typedef struct _ACPI_RSDP ACPI_RSDP, *PACPI_RSDP;
 typedef struct _ACPI_RSDT ACPI_RSDT, *PACPI_RSDT;
+typedef struct _ACPI_SLIT ACPI_SLIT, *PACPI_SLIT;
+typedef struct _ACPI_SRAT ACPI_SRAT, *PACPI_SRAT;
+typedef struct _ACPI_SRAT_CPU_AFFINITY ACPI_SRAT_CPU_AFFINITY, *PACPI_SRAT_CPU_AFFINITY;
+typedef struct _ACPI_SRAT_MEMORY_AFFINITY ACPI_SRAT_MEMORY_AFFINITY, *PACPI_SRAT_MEMORY_AFFINITY;
+typedef struct _ACPI_SRAT_X2APIC_CPU_AFFINITY ACPI_SRAT_X2APIC_CPU_AFFINITY, *PACPI_SRAT_X2APIC_CPU_AFFINITY;
 typedef struct _ACPI_SUBTABLE_HEADER ACPI_SUBTABLE_HEADER, *PACPI_SUBTABLE_HEADER;
 typedef struct _ACPI_SYSTEM_INFO ACPI_SYSTEM_INFO, *PACPI_SYSTEM_INFO;
 typedef struct _ACPI_TIMER_INFO ACPI_TIMER_INFO, *PACPI_TIMER_INFO;
@@ -289,9 +295,20 @@ typedef struct _LOADER_MEMORY_DESCRIPTOR LOADER_MEMORY_DESCRIPTOR, *PLOADER_MEMO
 typedef struct _M128 M128, *PM128;
 typedef struct _MMCOLOR_TABLES MMCOLOR_TABLES, *PMMCOLOR_TABLES;
 typedef struct _MMFREE_POOL_ENTRY MMFREE_POOL_ENTRY, *PMMFREE_POOL_ENTRY;
+typedef struct _MMKERNEL_STACK_CACHE MMKERNEL_STACK_CACHE, *PMMKERNEL_STACK_CACHE;
 typedef struct _MMMEMORY_LAYOUT MMMEMORY_LAYOUT, *PMMMEMORY_LAYOUT;
+typedef struct _MMNUMA_MEMORY_RANGE MMNUMA_MEMORY_RANGE, *PMMNUMA_MEMORY_RANGE;
+typedef struct _MMOBJECT_CACHE MMOBJECT_CACHE, *PMMOBJECT_CACHE;
+typedef struct _MMOBJECT_MAGAZINE MMOBJECT_MAGAZINE, *PMMOBJECT_MAGAZINE;
+typedef struct _MMOBJECT_SLAB MMOBJECT_SLAB, *PMMOBJECT_SLAB;
+typedef struct _MMPAGE_MAGAZINE MMPAGE_MAGAZINE, *PMMPAGE_MAGAZINE;
+typedef struct _MMPERFORMANCE_INFORMATION MMPERFORMANCE_INFORMATION, *PMMPERFORMANCE_INFORMATION;
 typedef struct _MMPFNENTRY MMPFNENTRY, *PMMPFNENTRY;
 typedef struct _MMPFNLIST MMPFNLIST, *PMMPFNLIST;
+typedef struct _MMPOOL_LOOKASIDE_LIST MMPOOL_LOOKASIDE_LIST, *PMMPOOL_LOOKASIDE_LIST;
+typedef struct _MMSYSTEM_PTE_CACHE MMSYSTEM_PTE_CACHE, *PMMSYSTEM_PTE_CACHE;
+typedef struct _MMTLB_FLUSH_BATCH MMTLB_FLUSH_BATCH, *PMMTLB_FLUSH_BATCH;
+typedef struct _MMTLB_FLUSH_RANGE MMTLB_FLUSH_RANGE, *PMMTLB_FLUSH_RANGE;
 typedef struct _PCAT_FIRMWARE_INFORMATION PCAT_FIRMWARE_INFORMATION, *PPCAT_FIRMWARE_INFORMATION;
 typedef struct _PCI_BRIDGE_CONTROL_REGISTER PCI_BRIDGE_CONTROL_REGISTER, *PPCI_BRIDGE_CONTROL_REGISTER;
 typedef struct _PCI_COMMON_CONFIG PCI_COMMON_CONFIG, *PPCI_COMMON_CONFIG;
@@ -323,7 +340,9 @@ typedef struct _PECOFF_IMAGE_VXD_HEADER PECOFF_IMAGE_VXD_HEADER, *PPECOFF_IMAGE_
 typedef struct _PHYSICAL_MEMORY_DESCRIPTOR PHYSICAL_MEMORY_DESCRIPTOR, *PPHYSICAL_MEMORY_DESCRIPTOR;
 typedef struct _PHYSICAL_MEMORY_RUN PHYSICAL_MEMORY_RUN, *PPHYSICAL_MEMORY_RUN;
 typedef struct _POOL_HEADER POOL_HEADER, *PPOOL_HEADER;
+typedef struct _POOL_TAG_STATISTICS POOL_TAG_STATISTICS, *PPOOL_TAG_STATISTICS;
 typedef struct _POOL_TRACKING_BIG_ALLOCATIONS POOL_TRACKING_BIG_ALLOCATIONS, *PPOOL_TRACKING_BIG_ALLOCATIONS;
+typedef struct _POOL_TRACKING_BIG_ALLOCATIONS_SHARD POOL_TRACKING_BIG_ALLOCATIONS_SHARD, *PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD;
 typedef struct _POOL_TRACKING_TABLE POOL_TRACKING_TABLE, *PPOOL_TRACKING_TABLE;
 typedef struct _PROCESSOR_IDENTITY PROCESSOR_IDENTITY, *PPROCESSOR_IDENTITY;
 typedef struct _PROCESSOR_POWER_STATE PROCESSOR_POWER_STATE, *PPROCESSOR_POWER_STATE;
@@ -67,6 +67,23 @@ AR::CpuFunctions::CpuId(IN OUT PCPUID_REGISTERS Registers)
     return TRUE;
 }
 
+/**
+ * Writes back all modified cache lines and invalidates all processor caches.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTCDECL
+VOID
+AR::CpuFunctions::FlushCache(VOID)
+{
+    __asm__ volatile("wbinvd"
+                     :
+                     :
+                     : "memory");
+}
+
 /**
  * Partially flushes the Translation Lookaside Buffer (TLB)
  *
@@ -160,6 +177,41 @@ AR::CpuFunctions::InterruptsEnabled(VOID)
     return (Flags & X86_EFLAGS_IF_MASK) ? TRUE : FALSE;
 }
 
+/**
+ * Invalidates TLB (Translation Lookaside Buffer) entries tagged with process-context identifiers (PCIDs).
+ *
+ * @param Type
+ *        Supplies the INVPCID invalidation type.
+ *
+ * @param ContextId
+ *        Supplies the process-context identifier whose entries will be invalidated.
+ *
+ * @param Address
+ *        Supplies a virtual address whose associated TLB entry will be invalidated, if applicable.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTCDECL
+VOID
+AR::CpuFunctions::InvalidateTlbContext(IN ULONG_PTR Type,
+                                       IN USHORT ContextId,
+                                       IN PVOID Address)
+{
+    struct
+    {
+        ULONGLONG ContextId;
+        PVOID Address;
+    } Descriptor = {ContextId, Address};
+
+    __asm__ volatile("invpcid %0, %1"
+                     :
+                     : "m" (Descriptor),
+                       "r" (Type)
+                     : "memory");
+}
+
 /**
  * Invalidates the TLB (Translation Lookaside Buffer) for specified virtual address.
  *
@@ -30,5 +30,11 @@ KTSS AR::ProcessorSupport::InitialTss;
 /* Initial kernel NMI stack */
 UCHAR AR::ProcessorSupport::NmiStack[KERNEL_STACK_SIZE] = {};
 
+/* Extended CPU features supported by all processors */
+ULONGLONG AR::ProcessorSupport::SystemExtendedFeatureBits;
+
+/* CPU features supported by all processors */
+ULONGLONG AR::ProcessorSupport::SystemFeatureBits;
+
 /* Unhandled interrupt routine */
 PINTERRUPT_HANDLER AR::Traps::UnhandledInterruptRoutine = NULLPTR;
@@ -61,24 +61,12 @@ XTCDECL
 VOID
 AR::Traps::DispatchTrap(IN PKTRAP_FRAME TrapFrame)
 {
-    DebugPrint(L"Caught trap: 0x%.2llX with error code: %.4llX at RIP: 0x%.16llX\n"
-               L"RAX: 0x%.16llX, RBX: 0x%.16llX, RCX: 0x%.16llX, RDX: 0x%.16llX\n"
-               L"R8:  0x%.16llX, R9:  0x%.16llX, R10: 0x%.16llX, R11: 0x%.16llX\n"
-               L"R12: 0x%.16llX, R13: 0x%.16llX, R14: 0x%.16llX, R15: 0x%.16llX\n"
-               L"RBP: 0x%.16llX, RSP: 0x%.16llX, RDI: 0x%.16llX, RSI: 0x%.16llX\n"
-               L"DR0: 0x%.16llX, DR1: 0x%.16llX, DR2: 0x%.16llX, DR3: 0x%.16llX\n"
-               L"DR6: 0x%.16llX, DR7: 0x%.16llX\n"
-               L"CR2: 0x%.16llX, CR3: 0x%.16llX, CS:  0x%.16llX, DS:  0x%.16hX\n"
-               L"ES:  0x%.16hX, FS:  0x%.16hX, GS:  0x%.16hX, SS:  0x%.16llX\n",
-               TrapFrame->Vector, TrapFrame->ErrorCode, TrapFrame->Rip,
-               TrapFrame->Rax, TrapFrame->Rbx, TrapFrame->Rcx, TrapFrame->Rdx,
-               TrapFrame->R8, TrapFrame->R9, TrapFrame->R10, TrapFrame->R11,
-               TrapFrame->R12, TrapFrame->R13, TrapFrame->R14, TrapFrame->R15,
-               TrapFrame->Rbp, TrapFrame->Rsp, TrapFrame->Rdi, TrapFrame->Rsi,
-               TrapFrame->Dr0, TrapFrame->Dr1, TrapFrame->Dr2, TrapFrame->Dr3,
-               TrapFrame->Dr6, TrapFrame->Dr7,
-               TrapFrame->Cr2, TrapFrame->Cr3, TrapFrame->SegCs, TrapFrame->SegDs,
-               TrapFrame->SegEs, TrapFrame->SegFs, TrapFrame->SegGs, TrapFrame->SegSs);
+    /* Check if the trap is a page fault */
+    if(TrapFrame->Vector != 0x0E)
+    {
+        /* Print the trap frame, page faults are reported only when they cannot be resolved */
+        DumpTrapFrame(TrapFrame);
+    }
 
     /* Check vector and call appropriate handler */
     switch(TrapFrame->Vector)
@@ -186,6 +174,40 @@ AR::Traps::DispatchTrap(IN PKTRAP_FRAME TrapFrame)
     }
 }
 
+/**
+ * Prints the contents of the trap frame to the debug output.
+ *
+ * @param TrapFrame
+ *        Supplies a kernel trap frame pushed by common trap handler on the stack.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTCDECL
+VOID
+AR::Traps::DumpTrapFrame(IN PKTRAP_FRAME TrapFrame)
+{
+    DebugPrint(L"Caught trap: 0x%.2llX with error code: %.4llX at RIP: 0x%.16llX\n"
+               L"RAX: 0x%.16llX, RBX: 0x%.16llX, RCX: 0x%.16llX, RDX: 0x%.16llX\n"
+               L"R8:  0x%.16llX, R9:  0x%.16llX, R10: 0x%.16llX, R11: 0x%.16llX\n"
+               L"R12: 0x%.16llX, R13: 0x%.16llX, R14: 0x%.16llX, R15: 0x%.16llX\n"
+               L"RBP: 0x%.16llX, RSP: 0x%.16llX, RDI: 0x%.16llX, RSI: 0x%.16llX\n"
+               L"DR0: 0x%.16llX, DR1: 0x%.16llX, DR2: 0x%.16llX, DR3: 0x%.16llX\n"
+               L"DR6: 0x%.16llX, DR7: 0x%.16llX\n"
+               L"CR2: 0x%.16llX, CR3: 0x%.16llX, CS:  0x%.16llX, DS:  0x%.16hX\n"
+               L"ES:  0x%.16hX, FS:  0x%.16hX, GS:  0x%.16hX, SS:  0x%.16llX\n",
+               TrapFrame->Vector, TrapFrame->ErrorCode, TrapFrame->Rip,
+               TrapFrame->Rax, TrapFrame->Rbx, TrapFrame->Rcx, TrapFrame->Rdx,
+               TrapFrame->R8, TrapFrame->R9, TrapFrame->R10, TrapFrame->R11,
+               TrapFrame->R12, TrapFrame->R13, TrapFrame->R14, TrapFrame->R15,
+               TrapFrame->Rbp, TrapFrame->Rsp, TrapFrame->Rdi, TrapFrame->Rsi,
+               TrapFrame->Dr0, TrapFrame->Dr1, TrapFrame->Dr2, TrapFrame->Dr3,
+               TrapFrame->Dr6, TrapFrame->Dr7,
+               TrapFrame->Cr2, TrapFrame->Cr3, TrapFrame->SegCs, TrapFrame->SegDs,
+               TrapFrame->SegEs, TrapFrame->SegFs, TrapFrame->SegGs, TrapFrame->SegSs);
+}
+
 /**
  * Handles a 32-bit system call.
  *
@@ -479,8 +501,20 @@ XTCDECL
 VOID
 AR::Traps::HandleTrap0E(IN PKTRAP_FRAME TrapFrame)
 {
+    XTSTATUS Status;
+
+    /* Let the memory manager resolve the fault, committing a physical page on the first access if possible */
+    Status = MM::PageFault::HandlePageFault((PVOID)TrapFrame->Cr2, TrapFrame->ErrorCode);
+    if(Status == STATUS_SUCCESS)
+    {
+        /* Page fault resolved, resume execution */
+        return;
+    }
+
+    /* Page fault cannot be resolved, report it and crash the system */
+    DumpTrapFrame(TrapFrame);
     DebugPrint(L"Handled Page-Fault exception (0x0E)!\n");
-    KE::Crash::Panic(0x0E);
+    KE::Crash::Panic(0x0E, TrapFrame->Cr2, TrapFrame->ErrorCode, TrapFrame->Rip, Status);
 }
 
 /**
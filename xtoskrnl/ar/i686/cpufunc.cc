@@ -67,6 +67,23 @@ AR::CpuFunctions::CpuId(IN OUT PCPUID_REGISTERS Registers)
     return TRUE;
 }
 
+/**
+ * Writes back all modified cache lines and invalidates all processor caches.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTCDECL
+VOID
+AR::CpuFunctions::FlushCache(VOID)
+{
+    __asm__ volatile("wbinvd"
+                     :
+                     :
+                     : "memory");
+}
+
 /**
  * Partially flushes the Translation Lookaside Buffer (TLB)
  *
@@ -36,5 +36,11 @@ UCHAR AR::ProcessorSupport::NmiStack[KERNEL_STACK_SIZE] = {};
 /* NMI task gate */
 UCHAR AR::ProcessorSupport::NonMaskableInterruptTss[KTSS_IO_MAPS];
 
+/* Extended CPU features supported by all processors */
+ULONGLONG AR::ProcessorSupport::SystemExtendedFeatureBits;
+
+/* CPU features supported by all processors */
+ULONGLONG AR::ProcessorSupport::SystemFeatureBits;
+
 /* Unhandled interrupt routine */
 PINTERRUPT_HANDLER AR::Traps::UnhandledInterruptRoutine = NULLPTR;
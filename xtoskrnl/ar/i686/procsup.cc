@@ -122,7 +122,8 @@ AR::ProcessorSupport::IdentifyProcessor(VOID)
 }
 
 /**
- * Identifies processor features and stores them in Processor Control Block (PRCB).
+ * Identifies processor features and stores them in Processor Control Block (PRCB), as well as in the system-wide
+ * feature table.
  *
  * @return This routine does not return any value.
  *
@@ -151,6 +152,10 @@ AR::ProcessorSupport::IdentifyProcessorFeatures(VOID)
     AR::CpuFunctions::CpuId(&CpuRegisters);
     MaxExtendedLeaf = CpuRegisters.Eax;
 
+    /* Store maximum CPUID leaves in processor control block */
+    Prcb->CpuId.MaxExtendedLeaf = MaxExtendedLeaf;
+    Prcb->CpuId.MaxStandardLeaf = MaxStandardLeaf;
+
     /* Check if CPU supports standard features leaf */
     if(MaxStandardLeaf >= CPUID_GET_STANDARD1_FEATURES)
     {
@@ -165,6 +170,7 @@ AR::ProcessorSupport::IdentifyProcessorFeatures(VOID)
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_SSSE3) Prcb->CpuId.FeatureBits |= KCF_SSSE3;
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_SSE4_1) Prcb->CpuId.FeatureBits |= KCF_SSE41;
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_SSE4_2) Prcb->CpuId.FeatureBits |= KCF_SSE42;
+        if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_PCID) Prcb->CpuId.FeatureBits |= KCF_PCID;
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_X2APIC) Prcb->CpuId.FeatureBits |= KCF_X2APIC;
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_POPCNT) Prcb->CpuId.FeatureBits |= KCF_POPCNT;
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_TSC_DEADLINE) Prcb->CpuId.FeatureBits |= KCF_TSC_DEADLINE;
@@ -207,10 +213,28 @@ AR::ProcessorSupport::IdentifyProcessorFeatures(VOID)
         if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_FSGSBASE) Prcb->CpuId.FeatureBits |= KCF_FSGSBASE;
         if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_AVX2) Prcb->CpuId.FeatureBits |= KCF_AVX2;
         if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_SMEP) Prcb->CpuId.FeatureBits |= KCF_SMEP;
+        if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_ERMS) Prcb->CpuId.FeatureBits |= KCF_ERMS;
+        if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_INVPCID) Prcb->CpuId.FeatureBits |= KCF_INVPCID;
         if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_RDSEED) Prcb->CpuId.FeatureBits |= KCF_RDSEED;
         if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_SMAP) Prcb->CpuId.FeatureBits |= KCF_SMAP;
         if(CpuRegisters.Ebx & CPUID_FEATURES_EBX_SHA) Prcb->CpuId.FeatureBits |= KCF_SHA;
         if(CpuRegisters.Ecx & CPUID_FEATURES_ECX_LA57) Prcb->CpuId.FeatureBits |= KCF_LA57;
+        if(CpuRegisters.Edx & CPUID_FEATURES_EDX_FAST_SHORT_REP_MOV) Prcb->CpuId.FeatureBits |= KCF_FSRM;
+    }
+
+    /* Check if CPU supports XSAVE and its extended state enumeration leaf */
+    if(MaxStandardLeaf >= CPUID_GET_EXTENDED_STATE && (Prcb->CpuId.FeatureBits & KCF_XSAVE))
+    {
+        /* Get CPU extended state features */
+        RTL::Memory::ZeroMemory(&CpuRegisters, sizeof(CPUID_REGISTERS));
+        CpuRegisters.Leaf = CPUID_GET_EXTENDED_STATE;
+        CpuRegisters.SubLeaf = 1;
+        AR::CpuFunctions::CpuId(&CpuRegisters);
+
+        /* Store CPU extended state features in processor control block */
+        if(CpuRegisters.Eax & CPUID_FEATURES_EAX_XSAVEOPT) Prcb->CpuId.FeatureBits |= KCF_XSAVEOPT;
+        if(CpuRegisters.Eax & CPUID_FEATURES_EAX_XSAVEC) Prcb->CpuId.FeatureBits |= KCF_XSAVEC;
+        if(CpuRegisters.Eax & CPUID_FEATURES_EAX_XSAVES) Prcb->CpuId.FeatureBits |= KCF_XSAVES;
     }
 
     /* Check if CPU supports power management leaf */
@@ -257,6 +281,20 @@ AR::ProcessorSupport::IdentifyProcessorFeatures(VOID)
         /* Store CPU advanced power management features in processor control block */
         if(CpuRegisters.Edx & CPUID_FEATURES_EDX_TSCI) Prcb->CpuId.ExtendedFeatureBits |= KCF_INVARIANT_TSC;
     }
+
+    /* Check if this is the boot processor */
+    if(Prcb->CpuNumber == 0)
+    {
+        /* Initialize the system-wide feature table with the boot processor features */
+        SystemExtendedFeatureBits = Prcb->CpuId.ExtendedFeatureBits;
+        SystemFeatureBits = Prcb->CpuId.FeatureBits;
+    }
+    else
+    {
+        /* Application processors are started one by one, keep only features supported by all of them */
+        SystemExtendedFeatureBits &= Prcb->CpuId.ExtendedFeatureBits;
+        SystemFeatureBits &= Prcb->CpuId.FeatureBits;
+    }
 }
 
 /**
@@ -342,6 +380,54 @@ AR::ProcessorSupport::InitializeIdt(IN PKPROCESSOR_BLOCK ProcessorBlock)
 }
 
 
+/**
+ * Programs the Page Attribute Table (PAT), making write-combining memory type available to page table entries.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The PAT keeps the power-on memory types for all combinations of the PCD and PWT bits, except that PWT
+ *       alone selects write-combining instead of write-through. It must be identical on all processors.
+ */
+XTAPI
+VOID
+AR::ProcessorSupport::InitializePageAttributeTable(VOID)
+{
+    ULONG_PTR Cr0, Cr4;
+    ULONGLONG PatAttributes;
+
+    /* Check if processor supports PAT */
+    if(!(KE::Processor::GetCurrentProcessorControlBlock()->CpuId.FeatureBits & KCF_PAT))
+    {
+        /* PAT not supported, PCD and PWT bits keep their legacy meaning */
+        return;
+    }
+
+    /* Set PAT entries, the upper half mirrors the lower one */
+    PatAttributes = (PAT_TYPE_WB << 0) | (PAT_TYPE_USWC << 8) | (PAT_TYPE_WEAK_UC << 16) | (PAT_TYPE_STRONG_UC << 24) |
+                    (PAT_TYPE_WB << 32) | (PAT_TYPE_USWC << 40) | (PAT_TYPE_WEAK_UC << 48) | (PAT_TYPE_STRONG_UC << 56);
+
+    /* Enter the no-fill cache mode and flush all caches */
+    Cr0 = AR::CpuFunctions::ReadControlRegister(0);
+    AR::CpuFunctions::WriteControlRegister(0, (Cr0 | CR0_CD) & ~CR0_NW);
+    AR::CpuFunctions::FlushCache();
+
+    /* Flush the TLB, including global entries */
+    Cr4 = AR::CpuFunctions::ReadControlRegister(4);
+    AR::CpuFunctions::WriteControlRegister(4, Cr4 & ~CR4_PGE);
+    AR::CpuFunctions::FlushTlb();
+
+    /* Program the Page Attribute Table */
+    AR::CpuFunctions::WriteModelSpecificRegister(X86_MSR_PAT, PatAttributes);
+
+    /* Flush caches and the TLB again, then restore the previous cache mode */
+    AR::CpuFunctions::FlushCache();
+    AR::CpuFunctions::FlushTlb();
+    AR::CpuFunctions::WriteControlRegister(4, Cr4);
+    AR::CpuFunctions::WriteControlRegister(0, Cr0);
+}
+
 /**
  * Initializes i686 processor specific structures.
  *
@@ -409,6 +495,9 @@ AR::ProcessorSupport::InitializeProcessor(IN PVOID ProcessorStructures)
 
     /* Identify processor */
     IdentifyProcessor();
+
+    /* Initialize Page Attribute Table */
+    InitializePageAttributeTable();
 }
 
 /**
@@ -61,20 +61,12 @@ XTCDECL
 VOID
 AR::Traps::DispatchTrap(IN PKTRAP_FRAME TrapFrame)
 {
-    DebugPrint(L"Caught trap: 0x%.2lX with error code: %.4lX at EIP: 0x%.8lX\n"
-               L"EAX: 0x%.8lX, EBX: 0x%.8lX, ECX: 0x%.8lX, EDX: 0x%.8lX\n"
-               L"EBP: 0x%.8lX, ESP: 0x%.8lX, EDI: 0x%.8lX, ESI: 0x%.8lX\n"
-               L"DR0: 0x%.8lX, DR1: 0x%.8lX, DR2: 0x%.8lX, DR3: 0x%.8lX\n"
-               L"DR6: 0x%.8lX, DR7: 0x%.8lX\n"
-               L"CR2: 0x%.8lX, CR3: 0x%.8lX, CS:  0x%.8lX, DS:  0x%.8hX\n"
-               L"ES:  0x%.8hX, FS:  0x%.8hX, GS:  0x%.8hX, SS:  0x%.8lX\n",
-               TrapFrame->Vector, TrapFrame->ErrorCode, TrapFrame->Eip,
-               TrapFrame->Eax, TrapFrame->Ebx, TrapFrame->Ecx, TrapFrame->Edx,
-               TrapFrame->Ebp, TrapFrame->Esp, TrapFrame->Edi, TrapFrame->Esi,
-               TrapFrame->Dr0, TrapFrame->Dr1, TrapFrame->Dr2, TrapFrame->Dr3,
-               TrapFrame->Dr6, TrapFrame->Dr7,
-               TrapFrame->Cr2, TrapFrame->Cr3, TrapFrame->SegCs, TrapFrame->SegDs,
-               TrapFrame->SegEs, TrapFrame->SegFs, TrapFrame->SegGs, TrapFrame->SegSs);
+    /* Check if the trap is a page fault */
+    if(TrapFrame->Vector != 0x0E)
+    {
+        /* Print the trap frame, page faults are reported only when they cannot be resolved */
+        DumpTrapFrame(TrapFrame);
+    }
 
     /* Check vector and call appropriate handler */
     switch(TrapFrame->Vector)
@@ -182,6 +174,36 @@ AR::Traps::DispatchTrap(IN PKTRAP_FRAME TrapFrame)
     }
 }
 
+/**
+ * Prints the contents of the trap frame to the debug output.
+ *
+ * @param TrapFrame
+ *        Supplies a kernel trap frame pushed by common trap handler on the stack.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTCDECL
+VOID
+AR::Traps::DumpTrapFrame(IN PKTRAP_FRAME TrapFrame)
+{
+    DebugPrint(L"Caught trap: 0x%.2lX with error code: %.4lX at EIP: 0x%.8lX\n"
+               L"EAX: 0x%.8lX, EBX: 0x%.8lX, ECX: 0x%.8lX, EDX: 0x%.8lX\n"
+               L"EBP: 0x%.8lX, ESP: 0x%.8lX, EDI: 0x%.8lX, ESI: 0x%.8lX\n"
+               L"DR0: 0x%.8lX, DR1: 0x%.8lX, DR2: 0x%.8lX, DR3: 0x%.8lX\n"
+               L"DR6: 0x%.8lX, DR7: 0x%.8lX\n"
+               L"CR2: 0x%.8lX, CR3: 0x%.8lX, CS:  0x%.8lX, DS:  0x%.8hX\n"
+               L"ES:  0x%.8hX, FS:  0x%.8hX, GS:  0x%.8hX, SS:  0x%.8lX\n",
+               TrapFrame->Vector, TrapFrame->ErrorCode, TrapFrame->Eip,
+               TrapFrame->Eax, TrapFrame->Ebx, TrapFrame->Ecx, TrapFrame->Edx,
+               TrapFrame->Ebp, TrapFrame->Esp, TrapFrame->Edi, TrapFrame->Esi,
+               TrapFrame->Dr0, TrapFrame->Dr1, TrapFrame->Dr2, TrapFrame->Dr3,
+               TrapFrame->Dr6, TrapFrame->Dr7,
+               TrapFrame->Cr2, TrapFrame->Cr3, TrapFrame->SegCs, TrapFrame->SegDs,
+               TrapFrame->SegEs, TrapFrame->SegFs, TrapFrame->SegGs, TrapFrame->SegSs);
+}
+
 /**
  * Handles the trap 0x00 when a Divide By Zero exception occurs.
  *
@@ -447,8 +469,27 @@ XTCDECL
 VOID
 AR::Traps::HandleTrap0E(IN PKTRAP_FRAME TrapFrame)
 {
+    XTSTATUS Status;
+
+    /* Check if interrupts were enabled when the fault occurred */
+    if(TrapFrame->Flags & X86_EFLAGS_IF_MASK)
+    {
+        /* Re-enable interrupts, as resolving the fault may wait for other processors to acknowledge TLB flush IPIs */
+        AR::CpuFunctions::SetInterruptFlag();
+    }
+
+    /* Let the memory manager resolve the fault, committing a physical page on the first access if possible */
+    Status = MM::PageFault::HandlePageFault((PVOID)TrapFrame->Cr2, TrapFrame->ErrorCode);
+    if(Status == STATUS_SUCCESS)
+    {
+        /* Page fault resolved, resume execution */
+        return;
+    }
+
+    /* Page fault cannot be resolved, report it and crash the system */
+    DumpTrapFrame(TrapFrame);
     DebugPrint(L"Handled Page-Fault exception (0x0E)!\n");
-    KE::Crash::Panic(0x0E);
+    KE::Crash::Panic(0x0E, TrapFrame->Cr2, TrapFrame->ErrorCode, TrapFrame->Eip, Status);
 }
 
 /**
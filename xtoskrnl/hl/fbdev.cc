@@ -424,6 +424,40 @@ HL::FrameBuffer::EnableShadowBuffer(VOID)
     return STATUS_SUCCESS;
 }
 
+/**
+ * Maps the frame buffer as write-combining memory, so that screen updates are streamed to VRAM.
+ *
+ * @return This routine returns a status code indicating the success or failure of the operation.
+ *
+ * @since XT 1.0
+ *
+ * @note This routine requires page map support to be initialized.
+ */
+XTAPI
+XTSTATUS
+HL::FrameBuffer::EnableWriteCombining(VOID)
+{
+    ULONG FrameBufferSize;
+
+    /* Make sure frame buffer is already initialized */
+    if(FrameBufferData.Initialized == FALSE)
+    {
+        /* Unable to operate on non-initialized frame buffer */
+        return STATUS_DEVICE_NOT_READY;
+    }
+
+    /* Calculate the total size of the framebuffer */
+    FrameBufferSize = FrameBufferData.Pitch * FrameBufferData.Height;
+
+    /* Mark all framebuffer pages as write-combining */
+    MM::HardwarePool::MarkHardwareMemoryWriteCombined(FrameBufferData.Address,
+                                                      SIZE_TO_PAGES(PAGE_OFFSET(FrameBufferData.Address) +
+                                                                    FrameBufferSize));
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
 /**
  * Returns the current resolution of the frame buffer display.
  *
@@ -152,7 +152,7 @@ HL::Cpu::StartAllProcessors(VOID)
         }
 
         /* Allocate memory for the processor structures (Stacks, GDT, and Processor Block) */
-        Status = MM::KernelPool::AllocateProcessorStructures(&CpuStructures);
+        Status = MM::KernelPool::AllocateProcessorStructures(CpuNumber, &CpuStructures);
         if(Status != STATUS_SUCCESS)
         {
             /* Failed to allocate memory, unmap memory and return error */
@@ -973,11 +973,8 @@ HL::Timer::QueryTimerCapabilities(VOID)
     TimerCapabilities.RDTSCP = (Prcb->CpuId.ExtendedFeatureBits & KCF_RDTSCP) != 0;
     TimerCapabilities.TscDeadline = (Prcb->CpuId.FeatureBits & KCF_TSC_DEADLINE) != 0;
 
-    /* Query maximum standard CPUID leaf */
-    RTL::Memory::ZeroMemory(&CpuRegisters, sizeof(CPUID_REGISTERS));
-    CpuRegisters.Leaf = CPUID_GET_VENDOR_STRING;
-    AR::CpuFunctions::CpuId(&CpuRegisters);
-    MaxStandardLeaf = CpuRegisters.Eax;
+    /* Get maximum standard CPUID leaf */
+    MaxStandardLeaf = Prcb->CpuId.MaxStandardLeaf;
 
     /* Check Always Running Timer - ART if leaf supported */
     if(MaxStandardLeaf >= CPUID_GET_TSC_CRYSTAL_CLOCK)
@@ -20,11 +20,15 @@ namespace AR
         public:
             STATIC XTCDECL VOID ClearInterruptFlag(VOID);
             STATIC XTCDECL BOOLEAN CpuId(IN OUT PCPUID_REGISTERS Registers);
+            STATIC XTCDECL VOID FlushCache(VOID);
             STATIC XTCDECL VOID FlushTlb(VOID);
             STATIC XTCDECL ULONG GetCpuFlags(VOID);
             STATIC XTASSEMBLY XTCDECL ULONG_PTR GetStackPointer(VOID);
             STATIC XTCDECL VOID Halt(VOID);
             STATIC XTCDECL BOOLEAN InterruptsEnabled(VOID);
+            STATIC XTCDECL VOID InvalidateTlbContext(IN ULONG_PTR Type,
+                                                     IN USHORT ContextId,
+                                                     IN PVOID Address);
             STATIC XTCDECL VOID InvalidateTlbEntry(IN PVOID Address);
             STATIC XTCDECL VOID LoadGlobalDescriptorTable(IN PVOID Source);
             STATIC XTCDECL VOID LoadInterruptDescriptorTable(IN PVOID Source);
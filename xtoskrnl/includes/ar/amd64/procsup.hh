@@ -25,12 +25,27 @@ namespace AR
             STATIC KPROCESSOR_BLOCK InitialProcessorBlock;
             STATIC KTSS InitialTss;
             STATIC UCHAR NmiStack[KERNEL_STACK_SIZE];
+            STATIC ULONGLONG SystemExtendedFeatureBits;
+            STATIC ULONGLONG SystemFeatureBits;
 
         public:
             STATIC XTAPI PVOID GetBootStack(VOID);
             STATIC XTAPI VOID GetTrampolineInformation(IN TRAMPOLINE_TYPE TrampolineType,
                                                        OUT PVOID *TrampolineCode,
                                                        OUT PULONG_PTR TrampolineSize);
+
+            STATIC XTINLINE BOOLEAN HasExtendedFeature(IN ULONGLONG Feature)
+            {
+                /* Check if all processors support the extended feature */
+                return ((SystemExtendedFeatureBits & Feature) == Feature) ? TRUE : FALSE;
+            }
+
+            STATIC XTINLINE BOOLEAN HasFeature(IN ULONGLONG Feature)
+            {
+                /* Check if all processors support the feature */
+                return ((SystemFeatureBits & Feature) == Feature) ? TRUE : FALSE;
+            }
+
             STATIC XTAPI VOID InitializeProcessor(IN PVOID ProcessorStructures);
             STATIC XTAPI VOID InitializeProcessorStructures(IN PVOID ProcessorStructures,
                                                             OUT PKGDTENTRY *Gdt,
@@ -52,6 +67,7 @@ namespace AR
             STATIC XTAPI VOID IdentifyProcessorFeatures(VOID);
             STATIC XTAPI VOID InitializeGdt(IN PKPROCESSOR_BLOCK ProcessorBlock);
             STATIC XTAPI VOID InitializeIdt(IN PKPROCESSOR_BLOCK ProcessorBlock);
+            STATIC XTAPI VOID InitializePageAttributeTable(VOID);
             STATIC XTAPI VOID InitializeProcessorBlock(OUT PKPROCESSOR_BLOCK ProcessorBlock,
                                                        IN PKGDTENTRY Gdt,
                                                        IN PKIDTENTRY Idt,
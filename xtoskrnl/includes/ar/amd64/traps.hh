@@ -27,6 +27,7 @@ namespace AR
             STATIC XTCDECL VOID SetUnhandledInterruptRoutine(PINTERRUPT_HANDLER Handler);
 
         private:
+            STATIC XTCDECL VOID DumpTrapFrame(IN PKTRAP_FRAME TrapFrame);
             STATIC XTCDECL VOID HandleSystemCall32(VOID);
             STATIC XTCDECL VOID HandleSystemCall64(VOID);
             STATIC XTCDECL VOID HandleTrap00(IN PKTRAP_FRAME TrapFrame);
@@ -20,6 +20,7 @@ namespace AR
         public:
             STATIC XTCDECL VOID ClearInterruptFlag(VOID);
             STATIC XTCDECL BOOLEAN CpuId(IN OUT PCPUID_REGISTERS Registers);
+            STATIC XTCDECL VOID FlushCache(VOID);
             STATIC XTCDECL VOID FlushTlb(VOID);
             STATIC XTCDECL ULONG GetCpuFlags(VOID);
             STATIC XTASSEMBLY XTCDECL ULONG_PTR GetStackPointer(VOID);
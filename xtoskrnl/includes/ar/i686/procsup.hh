@@ -27,6 +27,8 @@ namespace AR
             STATIC KTSS InitialTss;
             STATIC UCHAR NmiStack[KERNEL_STACK_SIZE];
             STATIC UCHAR NonMaskableInterruptTss[KTSS_IO_MAPS];
+            STATIC ULONGLONG SystemExtendedFeatureBits;
+            STATIC ULONGLONG SystemFeatureBits;
 
 
         public:
@@ -34,6 +36,19 @@ namespace AR
             STATIC XTAPI VOID GetTrampolineInformation(IN TRAMPOLINE_TYPE TrampolineType,
                                                        OUT PVOID *TrampolineCode,
                                                        OUT PULONG_PTR TrampolineSize);
+
+            STATIC XTINLINE BOOLEAN HasExtendedFeature(IN ULONGLONG Feature)
+            {
+                /* Check if all processors support the extended feature */
+                return ((SystemExtendedFeatureBits & Feature) == Feature) ? TRUE : FALSE;
+            }
+
+            STATIC XTINLINE BOOLEAN HasFeature(IN ULONGLONG Feature)
+            {
+                /* Check if all processors support the feature */
+                return ((SystemFeatureBits & Feature) == Feature) ? TRUE : FALSE;
+            }
+
             STATIC XTAPI VOID InitializeProcessor(IN PVOID ProcessorStructures);
             STATIC XTAPI VOID InitializeProcessorStructures(IN PVOID ProcessorStructures,
                                                             OUT PKGDTENTRY *Gdt,
@@ -55,6 +70,7 @@ namespace AR
             STATIC XTAPI VOID IdentifyProcessorFeatures(VOID);
             STATIC XTAPI VOID InitializeGdt(IN PKPROCESSOR_BLOCK ProcessorBlock);
             STATIC XTAPI VOID InitializeIdt(IN PKPROCESSOR_BLOCK ProcessorBlock);
+            STATIC XTAPI VOID InitializePageAttributeTable(VOID);
             STATIC XTAPI VOID InitializeProcessorBlock(OUT PKPROCESSOR_BLOCK ProcessorBlock,
                                                        IN PKGDTENTRY Gdt,
                                                        IN PKIDTENTRY Idt,
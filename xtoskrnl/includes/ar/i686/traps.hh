@@ -26,6 +26,7 @@ namespace AR
             STATIC XTCDECL VOID SetUnhandledInterruptRoutine(PINTERRUPT_HANDLER Handler);
 
         private:
+            STATIC XTCDECL VOID DumpTrapFrame(IN PKTRAP_FRAME TrapFrame);
             STATIC XTCDECL VOID HandleTrap00(IN PKTRAP_FRAME TrapFrame);
             STATIC XTCDECL VOID HandleTrap01(IN PKTRAP_FRAME TrapFrame);
             STATIC XTCDECL VOID HandleTrap02(IN PKTRAP_FRAME TrapFrame);
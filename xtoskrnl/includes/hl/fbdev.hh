@@ -26,6 +26,7 @@ namespace HL
             STATIC XTAPI VOID ClearScreen(IN ULONG Color);
             STATIC XTCDECL XTSTATUS DisplayCharacter(IN WCHAR Character);
             STATIC XTAPI XTSTATUS EnableShadowBuffer(VOID);
+            STATIC XTAPI XTSTATUS EnableWriteCombining(VOID);
             STATIC XTAPI VOID GetFrameBufferResolution(OUT PULONG Width,
                                                        OUT PULONG Height);
             STATIC XTAPI XTSTATUS InitializeFrameBuffer(VOID);
@@ -24,6 +24,7 @@ namespace KE
 
         private:
             STATIC XTAPI VOID BootstrapKernel(VOID);
+            STATIC XTAPI VOID EnterIdleLoop(VOID);
             STATIC XTAPI VOID InitializeKernel(VOID);
     };
 }
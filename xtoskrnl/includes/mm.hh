@@ -16,13 +16,19 @@
 #include XTOS_ARCH_HEADER(mm, pte.hh)
 
 #include <mm/alloc.hh>
+#include <mm/buddy.hh>
 #include <mm/colors.hh>
 #include <mm/guard.hh>
 #include <mm/hlpool.hh>
 #include <mm/kpool.hh>
 #include <mm/mmgr.hh>
+#include <mm/numa.hh>
+#include <mm/objcache.hh>
+#include <mm/pagemap.hh>
 #include <mm/pfault.hh>
 #include <mm/pfn.hh>
 #include <mm/pool.hh>
+#include <mm/stats.hh>
+#include <mm/tlb.hh>
 
 #endif /* __XTOSKRNL_MM_HH */
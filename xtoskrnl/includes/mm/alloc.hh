@@ -25,11 +25,10 @@ namespace MM
             STATIC KSPIN_LOCK AllocationsTrackingTableLock;
             STATIC SIZE_T AllocationsTrackingTableMask;
             STATIC SIZE_T AllocationsTrackingTableSize;
-            STATIC ULONG BigAllocationsInUse;
-            STATIC PPOOL_TRACKING_BIG_ALLOCATIONS BigAllocationsTrackingTable;
-            STATIC SIZE_T BigAllocationsTrackingTableHash;
-            STATIC KSPIN_LOCK BigAllocationsTrackingTableLock;
-            STATIC SIZE_T BigAllocationsTrackingTableSize;
+            STATIC POOL_TRACKING_BIG_ALLOCATIONS_SHARD BigAllocationsShards[MM_POOL_BIG_ALLOCATIONS_SHARDS];
+            STATIC ULONG LookasideFlushGeneration;
+            STATIC ULONGLONG PoolTagMonitorDeadline;
+            STATIC ULONGLONG PoolTagMonitorInterval;
             STATIC PPOOL_TRACKING_TABLE TagTables[MM_POOL_TRACKING_TABLES];
 
         public:
@@ -43,6 +42,8 @@ namespace MM
                                                IN SIZE_T Bytes,
                                                OUT PVOID *Memory,
                                                IN ULONG Tag);
+            STATIC XTAPI VOID DumpPoolTagStatistics(VOID);
+            STATIC XTAPI VOID FlushLookasideLists(VOID);
             STATIC XTAPI XTSTATUS FreePages(IN PVOID VirtualAddress);
             STATIC XTAPI XTSTATUS FreePages(IN PVOID VirtualAddress,
                                             OUT PPFN_NUMBER PagesFreed);
@@ -51,20 +52,52 @@ namespace MM
                                            IN ULONG Tag);
             STATIC XTAPI VOID InitializeAllocationsTracking(VOID);
             STATIC XTAPI VOID InitializeBigAllocationsTracking(VOID);
+            STATIC XTAPI VOID InitializeLookasideLists(VOID);
+            STATIC XTAPI VOID MonitorPoolTags(VOID);
+            STATIC XTAPI XTSTATUS QueryPoolTagStatistics(OUT PPOOL_TAG_STATISTICS Statistics,
+                                                         IN ULONG Count,
+                                                         OUT PULONG ReturnedCount);
+            STATIC XTAPI VOID TrimLookasideLists(VOID);
+#ifdef DBG
+            STATIC XTAPI VOID VerifyPageRelease(VOID);
+#endif
 
         private:
+            STATIC XTAPI VOID AdjustLookasideDepth(IN PMMPOOL_LOOKASIDE_LIST LookasideList);
+            STATIC XTAPI XTSTATUS AllocateGuardPool(IN MMPOOL_TYPE PoolType,
+                                                    IN SIZE_T Bytes,
+                                                    OUT PVOID *Memory,
+                                                    IN ULONG Tag);
+            STATIC XTAPI PPOOL_HEADER AllocateLookasidePoolBlock(IN USHORT Index);
             STATIC XTAPI XTSTATUS AllocateNonPagedPoolPages(IN PFN_COUNT Pages,
+                                                            IN ULONG Node,
                                                             OUT PVOID *Memory);
             STATIC XTAPI XTSTATUS AllocatePagedPoolPages(IN PFN_COUNT Pages,
                                                          OUT PVOID *Memory);
             STATIC XTINLINE ULONG ComputeHash(IN PVOID VirtualAddress);
             STATIC XTINLINE ULONG ComputeHash(IN ULONG Tag,
                                               IN ULONG TableMask);
-            STATIC XTAPI BOOLEAN ExpandBigAllocationsTable(VOID);
+            STATIC XTAPI BOOLEAN ExpandBigAllocationsTable(IN PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard);
+            STATIC XTAPI XTSTATUS ExpandNonPagedPool(IN PFN_COUNT Pages,
+                                                     IN ULONG Node,
+                                                     OUT PVOID *Memory);
+            STATIC XTAPI VOID FreeBigAllocationsTable(IN PPOOL_TRACKING_BIG_ALLOCATIONS Table);
+            STATIC XTAPI XTSTATUS FreeGuardPool(IN PVOID VirtualAddress);
+            STATIC XTAPI BOOLEAN FreeLookasidePoolBlock(IN PPOOL_HEADER PoolEntry);
             STATIC XTAPI XTSTATUS FreeNonPagedPoolPages(IN PVOID VirtualAddress,
                                                         OUT PPFN_NUMBER PagesFreed);
             STATIC XTAPI XTSTATUS FreePagedPoolPages(IN PVOID VirtualAddress,
                                                      OUT PPFN_NUMBER PagesFreed);
+            STATIC XTAPI XTSTATUS FreePoolBlock(IN PPOOL_DESCRIPTOR PoolDescriptor,
+                                                IN PPOOL_HEADER PoolEntry);
+            STATIC XTAPI BOOLEAN GetTagStatistics(IN ULONG Index,
+                                                  OUT PPOOL_TAG_STATISTICS Statistics);
+            STATIC XTAPI PPOOL_TRACKING_BIG_ALLOCATIONS LookupBigAllocation(IN PPOOL_TRACKING_BIG_ALLOCATIONS Table,
+                                                                            IN SIZE_T TableSize,
+                                                                            IN ULONG Hash,
+                                                                            IN PVOID VirtualAddress);
+            STATIC XTAPI VOID MigrateBigAllocations(IN PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard,
+                                                    IN SIZE_T Entries);
             STATIC XTAPI VOID RegisterAllocationTag(IN ULONG Tag,
                                                     IN SIZE_T Bytes,
                                                     IN MMPOOL_TYPE PoolType);
@@ -84,6 +117,8 @@ namespace MM
             STATIC XTAPI ULONG UnregisterBigAllocationTag(IN PVOID VirtualAddress,
                                                           OUT PULONG_PTR Pages,
                                                           IN MMPOOL_TYPE PoolType);
+            STATIC XTINLINE SIZE_T UpdatePeakBytes(IN OUT PSIZE_T PeakBytes,
+                                                   IN SIZE_T Bytes);
     };
 }
 
@@ -54,6 +54,7 @@ namespace MM
             VIRTUAL XTAPI PVOID GetPxeVirtualAddress(IN PMMPXE PxePointer) = 0;
             XTAPI BOOLEAN GetXpaStatus();
             VIRTUAL XTAPI VOID InitializePageMapInfo(VOID) = 0;
+            XTAPI BOOLEAN PteLargePage(IN PMMPTE PtePointer);
             XTAPI BOOLEAN PteValid(IN PMMPTE PtePointer);
             XTAPI VOID SetNextEntry(IN PMMPTE Pte,
                                     IN ULONG_PTR Value);
@@ -10,6 +10,7 @@
 #define __XTOSKRNL_MM_AMD64_PAGING_HH
 
 #include <xtos.hh>
+#include <mm/pagemap.hh>
 
 
 /* Memory Manager */
@@ -18,6 +19,7 @@ namespace MM
     class Paging
     {
         private:
+            STATIC PAGEMAP_RANGE_ROUTINES PmlRangeRoutines;
             STATIC PPAGEMAP PmlRoutines;
 
         public:
@@ -51,9 +53,21 @@ namespace MM
             STATIC XTAPI PVOID GetPxeVirtualAddress(IN PMMPXE PxePointer);
             STATIC XTAPI BOOLEAN GetXpaStatus(VOID);
             STATIC XTAPI VOID InitializePageMapSupport(VOID);
+            STATIC XTAPI VOID MapContiguousPtes(IN PMMPTE StartPte,
+                                                IN PFN_NUMBER PageFrameNumber,
+                                                IN PFN_COUNT NumberOfPtes,
+                                                IN ULONGLONG Attributes);
+            STATIC XTAPI VOID MapPtes(IN PMMPTE StartPte,
+                                      IN PPFN_NUMBER PageFrames,
+                                      IN PFN_COUNT NumberOfPtes,
+                                      IN PMMPTE TemplatePte);
             STATIC XTAPI XTSTATUS MapVirtualAddress(IN PVOID VirtualAddress,
                                                     IN PFN_NUMBER PageFrameNumber,
                                                     IN ULONGLONG Attributes);
+#ifdef DBG
+            STATIC XTAPI VOID MeasurePageMapRoutines(VOID);
+#endif
+            STATIC XTAPI BOOLEAN PteLargePage(IN PMMPTE PtePointer);
             STATIC XTAPI BOOLEAN PteValid(IN PMMPTE PtePointer);
             STATIC XTAPI VOID SetNextEntry(IN PMMPTE Pte,
                                            IN ULONG_PTR Value);
@@ -71,8 +85,13 @@ namespace MM
                                        IN MMPTE Value);
             STATIC XTAPI VOID TransitionPte(IN PMMPTE PointerPte,
                                             IN ULONG_PTR Protection);
+            STATIC XTAPI VOID UnmapPtes(IN PMMPTE StartPte,
+                                        IN PFN_COUNT NumberOfPtes,
+                                        OUT PPFN_NUMBER PageFrames);
             STATIC XTFASTCALL VOID ZeroPages(IN PVOID Address,
                                              IN ULONG Size);
+            STATIC XTFASTCALL VOID ZeroPagesNonTemporal(IN PVOID Address,
+                                                        IN ULONG Size);
 
         private:
             STATIC XTAPI BOOLEAN GetExtendedPhysicalAddressingStatus(VOID);
@@ -18,8 +18,13 @@ namespace MM
     class Pte
     {
         private:
-            STATIC MMPTE FirstSystemFreePte[MaximumPtePoolTypes];
+            STATIC BOOLEAN LargePageSupport;
+            STATIC PULONG SystemPteBackLinks[MaximumPtePoolTypes];
             STATIC PMMPTE SystemPteBase;
+            STATIC RTL_BITMAP SystemPteBitMap[MaximumPtePoolTypes];
+            STATIC MMPTE SystemPteFreeList[MaximumPtePoolTypes][MM_SYSTEM_PTE_LISTS];
+            STATIC ULONG SystemPteFreeListBitmap[MaximumPtePoolTypes];
+            STATIC ULONG SystemPteFreeListSubBitmap[MaximumPtePoolTypes][MM_SYSTEM_PTE_FIRST_LEVELS];
             STATIC PMMPTE SystemPtesEnd[MaximumPtePoolTypes];
             STATIC PMMPTE SystemPtesStart[MaximumPtePoolTypes];
             STATIC PFN_COUNT TotalSystemFreePtes[MaximumPtePoolTypes];
@@ -27,6 +32,8 @@ namespace MM
 
         public:
             STATIC XTAPI BOOLEAN AddressValid(IN PVOID VirtualAddress);
+            STATIC XTAPI VOID FlushSystemPteCache(VOID);
+            STATIC XTAPI PFN_NUMBER GetMappedPageFrame(IN PVOID VirtualAddress);
             STATIC XTAPI PFN_COUNT GetPtesPerPage(VOID);
             STATIC XTAPI PMMPTE GetSystemPteBaseAddress(VOID);
             STATIC XTAPI PMMPTE GetValidPte(VOID);
@@ -36,6 +43,9 @@ namespace MM
                                                       IN PFN_COUNT NumberOfPtes,
                                                       IN MMSYSTEM_PTE_POOL_TYPE PoolType);
             STATIC XTAPI VOID InitializeSystemPteSpace(VOID);
+            STATIC XTAPI VOID MapLargePages(IN PVOID StartAddress,
+                                            IN PVOID EndAddress,
+                                            IN PMMPTE TemplatePte);
             STATIC XTAPI VOID MapP5E(IN PVOID StartAddress,
                                      IN PVOID EndAddress,
                                      IN PMMP5E TemplateP5e);
@@ -58,11 +68,31 @@ namespace MM
                                                   IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
 
         private:
-            STATIC XTAPI BOOLEAN FindFreeCluster(IN PFN_COUNT NumberOfPtes,
-                                                 IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType,
-                                                 OUT PMMPTE *FoundCluster,
-                                                 OUT PMMPTE *PreviousClusterNode);
+            STATIC XTAPI PMMPTE AllocateCachedSystemPtes(IN PFN_COUNT NumberOfPtes,
+                                                         IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI PMMPTE AllocateSystemPtes(IN PFN_COUNT NumberOfPtes,
+                                                   IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI PMMPTE FindFreeCluster(IN PFN_COUNT NumberOfPtes,
+                                                IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI BOOLEAN FreeCachedSystemPtes(IN PMMPTE StartingPte,
+                                                      IN PFN_COUNT NumberOfPtes,
+                                                      IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI VOID FreeSystemPtes(IN PMMPTE StartingPte,
+                                             IN PFN_COUNT NumberOfPtes,
+                                             IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI VOID GetClusterIndex(IN PFN_COUNT NumberOfPtes,
+                                              OUT PULONG FirstLevel,
+                                              OUT PULONG SecondLevel);
             STATIC XTAPI ULONG GetClusterSize(IN PMMPTE Pte);
+            STATIC XTAPI VOID InsertFreeCluster(IN PMMPTE StartingPte,
+                                                IN PFN_COUNT NumberOfPtes,
+                                                IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI BOOLEAN PageTableEmpty(IN PMMPDE PointerPde);
+            STATIC XTAPI VOID RefillSystemPteCache(IN PMMSYSTEM_PTE_CACHE Cache,
+                                                   IN PFN_COUNT NumberOfPtes,
+                                                   IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
+            STATIC XTAPI VOID RemoveFreeCluster(IN PMMPTE ClusterPte,
+                                                IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType);
     };
 }
 
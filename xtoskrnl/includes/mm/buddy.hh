@@ -0,0 +1,41 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/includes/mm/buddy.hh
+ * DESCRIPTION:     Memory Manager buddy index of free physical page blocks
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#ifndef __XTOSKRNL_MM_BUDDY_HH
+#define __XTOSKRNL_MM_BUDDY_HH
+
+#include <xtos.hh>
+
+
+/* Memory Manager */
+namespace MM
+{
+    class Buddy
+    {
+        private:
+            STATIC PUCHAR BlockTree;
+            STATIC PFN_NUMBER LeafCount;
+            STATIC ULONG MaximumOrder;
+
+        public:
+            STATIC XTAPI BOOLEAN FindFreeBlock(IN ULONG Order,
+                                               IN PFN_NUMBER HighestPage,
+                                               OUT PPFN_NUMBER BasePage);
+            STATIC XTAPI ULONG GetBlockOrder(IN PFN_NUMBER PageCount,
+                                             IN PFN_NUMBER Alignment);
+            STATIC XTAPI VOID InitializeBuddyIndex(VOID);
+            STATIC XTAPI VOID InsertPage(IN PFN_NUMBER PageFrameIndex);
+            STATIC XTAPI BOOLEAN IsIndexInitialized(VOID);
+            STATIC XTAPI VOID RemovePage(IN PFN_NUMBER PageFrameIndex);
+
+        private:
+            STATIC XTAPI VOID UpdateBlockTree(IN PFN_NUMBER Index);
+    };
+}
+
+#endif /* __XTOSKRNL_MM_BUDDY_HH */
@@ -19,19 +19,26 @@ namespace MM
     {
         private:
             STATIC PMMCOLOR_TABLES FreePages[FreePageList + 1];
-            STATIC MMPFNLIST ModifiedPages[MM_PAGING_COLORS];
+            STATIC PMMPFNLIST ModifiedPages;
+            STATIC ULONG NextColor;
             STATIC ULONG PagingColors;
             STATIC ULONG PagingColorsMask;
 
         public:
             STATIC XTAPI VOID ComputePageColoring(VOID);
             STATIC XTAPI PMMCOLOR_TABLES GetFreePages(IN MMPAGELISTS PageList,
+                                                      IN ULONG Node,
                                                       IN ULONG Color);
             STATIC XTAPI PMMPFNLIST GetModifiedPages(IN ULONG Color);
             STATIC XTAPI ULONG GetNextColor(VOID);
             STATIC XTAPI ULONG GetPagingColors(VOID);
             STATIC XTAPI ULONG GetPagingColorsMask(VOID);
             STATIC XTAPI VOID InitializeColorTables(VOID);
+
+        private:
+            STATIC XTAPI ULONG DetectPagingColors(OUT PULONG CacheLevel,
+                                                  OUT PULONG CacheSize,
+                                                  OUT PULONG CacheWays);
     };
 }
 
@@ -21,27 +21,30 @@ namespace MM
     {
         private:
             BOOLEAN Locked;
-            MMPOOL_TYPE LockPoolType;
+            PPOOL_DESCRIPTOR LockDescriptor;
             KRUNLEVEL PreviousRunLevel;
 
         public:
-            PoolLockGuard(IN MMPOOL_TYPE PoolType)
+            PoolLockGuard(IN PPOOL_DESCRIPTOR PoolDescriptor)
             {
-                LockPoolType = PoolType;
+                LockDescriptor = PoolDescriptor;
 
-                /* Determine the appropriate synchronization mechanism based on the requested pool type */
-                if(LockPoolType == NonPagedPool)
+                /* Determine the appropriate synchronization mechanism based on the descriptor pool type */
+                if((LockDescriptor->PoolType & MM_POOL_TYPE_MASK) == NonPagedPool)
                 {
                     /* Elevate the runlevel to DISPATCH_LEVEL */
                     PreviousRunLevel = KE::RunLevel::RaiseRunLevel(DISPATCH_LEVEL);
 
-                    /* Acquire the global queued spinlock protecting the non-paged pool */
-                    KE::SpinLock::AcquireQueuedSpinLock(NonPagedPoolLock);
+                    /* Acquire the spinlock protecting the free lists of this non-paged pool descriptor */
+                    KE::SpinLock::AcquireSpinLock((PKSPIN_LOCK)LockDescriptor->LockAddress);
                 }
                 else
                 {
-                    /* Paged pool requires a mutex, currently unimplemented */
-                    UNIMPLEMENTED;
+                    /* Elevate the runlevel to APC_LEVEL only, as the paged pool free lists may page fault */
+                    PreviousRunLevel = KE::RunLevel::RaiseRunLevel(APC_LEVEL);
+
+                    /* Acquire the paged pool descriptor lock, spinning on contention until waits are supported */
+                    KE::SpinLock::AcquireSpinLock((PKSPIN_LOCK)LockDescriptor->LockAddress);
                 }
 
                 /* Mark the guard as actively holding the lock */
@@ -66,18 +69,9 @@ namespace MM
                     return;
                 }
 
-                /* Determine the appropriate synchronization mechanism based on the requested pool type */
-                if(LockPoolType == NonPagedPool)
-                {
-                    /* Release the non-paged pool spinlock and subsequently restore the original runlevel */
-                    KE::SpinLock::ReleaseQueuedSpinLock(NonPagedPoolLock);
-                    KE::RunLevel::LowerRunLevel(PreviousRunLevel);
-                }
-                else
-                {
-                    /* Paged pool requires a mutex, currently unimplemented */
-                    UNIMPLEMENTED;
-                }
+                /* Release the descriptor lock and subsequently restore the original runlevel */
+                KE::SpinLock::ReleaseSpinLock((PKSPIN_LOCK)LockDescriptor->LockAddress);
+                KE::RunLevel::LowerRunLevel(PreviousRunLevel);
 
                 /* Update the internal state, indicating that the lock is no longer held */
                 Locked = FALSE;
@@ -19,7 +19,9 @@ namespace MM
     {
         private:
             STATIC LOADER_MEMORY_DESCRIPTOR HardwareAllocationDescriptors[MM_HARDWARE_ALLOCATION_DESCRIPTORS];
-            STATIC PVOID HardwareHeapStart;
+            STATIC RTL_BITMAP HardwareHeapBitMap;
+            STATIC ULONG_PTR HardwareHeapBitMapBuffer[MM_HARDWARE_HEAP_PAGES / (sizeof(ULONG_PTR) * 8)];
+            STATIC KSPIN_LOCK HardwareHeapLock;
             STATIC ULONG UsedHardwareAllocationDescriptors;
 
         public:
@@ -33,6 +35,8 @@ namespace MM
                                                     IN PFN_NUMBER PageCount,
                                                     IN BOOLEAN FlushTlb,
                                                     OUT PVOID *VirtualAddress);
+            STATIC XTAPI VOID MarkHardwareMemoryWriteCombined(IN PVOID VirtualAddress,
+                                                              IN PFN_NUMBER PageCount);
             STATIC XTAPI VOID MarkHardwareMemoryWriteThrough(IN PVOID VirtualAddress,
                                                              IN PFN_NUMBER PageCount);
             STATIC XTAPI VOID RemapHardwareMemory(IN PVOID VirtualAddress,
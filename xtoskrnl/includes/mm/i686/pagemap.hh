@@ -48,6 +48,7 @@ namespace MM
             VIRTUAL XTAPI PVOID GetPteVirtualAddress(IN PMMPTE PtePointer) = 0;
             XTAPI BOOLEAN GetXpaStatus();
             VIRTUAL XTAPI VOID InitializePageMapInfo(VOID) = 0;
+            VIRTUAL XTAPI BOOLEAN PteLargePage(IN PMMPTE PtePointer) = 0;
             VIRTUAL XTAPI BOOLEAN PteValid(IN PMMPTE PtePointer) = 0;
             VIRTUAL XTAPI VOID SetNextEntry(IN PMMPTE Pte,
                                             IN ULONG_PTR Value) = 0;
@@ -88,6 +89,7 @@ namespace MM
             XTAPI ULONG GetPteSoftwareTransition(IN PMMPTE PtePointer);
             XTAPI PVOID GetPteVirtualAddress(IN PMMPTE PtePointer);
             XTAPI VOID InitializePageMapInfo(VOID);
+            XTAPI BOOLEAN PteLargePage(IN PMMPTE PtePointer);
             XTAPI BOOLEAN PteValid(IN PMMPTE PtePointer);
             XTAPI VOID SetNextEntry(IN PMMPTE Pte,
                                     IN ULONG_PTR Value);
@@ -127,6 +129,7 @@ namespace MM
             XTAPI ULONG GetPteSoftwareTransition(IN PMMPTE PtePointer);
             XTAPI PVOID GetPteVirtualAddress(IN PMMPTE PtePointer);
             XTAPI VOID InitializePageMapInfo(VOID);
+            XTAPI BOOLEAN PteLargePage(IN PMMPTE PtePointer);
             XTAPI BOOLEAN PteValid(IN PMMPTE PtePointer);
             XTAPI VOID SetNextEntry(IN PMMPTE Pte,
                                     IN ULONG_PTR Value);
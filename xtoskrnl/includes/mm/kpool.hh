@@ -17,13 +17,31 @@ namespace MM
 {
     class KernelPool
     {
+        private:
+            STATIC ULONG KernelStackCacheDepth;
+            STATIC ULONG KernelStackFlushGeneration;
+
         public:
             STATIC XTAPI XTSTATUS AllocateKernelStack(OUT PVOID *Stack,
                                                       IN ULONG StackSize);
-            STATIC XTAPI XTSTATUS AllocateProcessorStructures(OUT PVOID *StructuresData);
+            STATIC XTAPI XTSTATUS AllocateProcessorStructures(IN ULONG CpuNumber,
+                                                              OUT PVOID *StructuresData);
+            STATIC XTAPI VOID FlushKernelStackCache(VOID);
             STATIC XTAPI VOID FreeKernelStack(IN PVOID Stack,
                                               IN ULONG StackSize);
             STATIC XTAPI VOID FreeProcessorStructures(IN PVOID StructuresData);
+            STATIC XTAPI VOID InitializeKernelStackCache(VOID);
+            STATIC XTAPI VOID RefillKernelStackCache(VOID);
+#ifdef DBG
+            STATIC XTAPI VOID VerifyStackRelease(VOID);
+#endif
+
+        private:
+            STATIC XTAPI XTSTATUS CreateKernelStack(OUT PVOID *Stack,
+                                                    IN PFN_COUNT StackPages);
+            STATIC XTAPI VOID DestroyKernelStack(IN PVOID Stack,
+                                                 IN PFN_COUNT StackPages);
+            STATIC XTAPI VOID TrimKernelStackCache(VOID);
     };
 }
 
@@ -0,0 +1,50 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/includes/mm/numa.hh
+ * DESCRIPTION:     Memory manager NUMA topology support
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#ifndef __XTOSKRNL_MM_NUMA_HH
+#define __XTOSKRNL_MM_NUMA_HH
+
+#include <xtos.hh>
+
+
+/* Memory Manager */
+namespace MM
+{
+    class Numa
+    {
+        private:
+            STATIC ULONG MemoryRangeCount;
+            STATIC MMNUMA_MEMORY_RANGE MemoryRanges[MM_MAXIMUM_NUMA_MEMORY_RANGES];
+            STATIC ULONG NodeCount;
+            STATIC UCHAR NodeDistances[MM_MAXIMUM_NUMA_NODES][MM_MAXIMUM_NUMA_NODES];
+            STATIC UCHAR NodeOrder[MM_MAXIMUM_NUMA_NODES][MM_MAXIMUM_NUMA_NODES];
+            STATIC UCHAR ProcessorNodes[MAXIMUM_PROCESSORS];
+            STATIC ULONG ProximityDomains[MM_MAXIMUM_NUMA_NODES];
+
+        public:
+            STATIC XTAPI ULONG GetCurrentNode(VOID);
+            STATIC XTAPI ULONG GetNodeCount(VOID);
+            STATIC XTAPI ULONG GetNodeDistance(IN ULONG SourceNode,
+                                               IN ULONG TargetNode);
+            STATIC XTAPI PUCHAR GetNodeOrder(IN ULONG Node);
+            STATIC XTAPI ULONG GetPageNode(IN PFN_NUMBER PageFrameIndex);
+            STATIC XTAPI ULONG GetProcessorNode(IN ULONG CpuNumber);
+            STATIC XTAPI VOID InitializeNuma(VOID);
+
+        private:
+            STATIC XTAPI VOID ComputeNodeOrder(VOID);
+            STATIC XTAPI ULONG GetProximityNode(IN ULONG ProximityDomain);
+            STATIC XTAPI VOID ReadAffinityTable(VOID);
+            STATIC XTAPI VOID ReadDistanceTable(VOID);
+            STATIC XTAPI VOID RegisterProcessorNode(IN ULONG ApicId,
+                                                    IN ULONG Node);
+            STATIC XTAPI VOID SortMemoryRanges(VOID);
+    };
+}
+
+#endif /* __XTOSKRNL_MM_NUMA_HH */
@@ -0,0 +1,45 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/includes/mm/objcache.hh
+ * DESCRIPTION:     Typed object caches for fixed-size kernel objects
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#ifndef __XTOSKRNL_MM_OBJCACHE_HH
+#define __XTOSKRNL_MM_OBJCACHE_HH
+
+#include <xtos.hh>
+
+
+/* Memory Manager */
+namespace MM
+{
+    class ObjectCache
+    {
+        public:
+            STATIC XTAPI XTSTATUS AllocateObject(IN PMMOBJECT_CACHE Cache,
+                                                 OUT PVOID *Object);
+            STATIC XTAPI XTSTATUS CreateCache(IN ULONG ObjectSize,
+                                              IN ULONG Tag,
+                                              IN PMMOBJECT_CONSTRUCTOR Constructor,
+                                              IN PVOID Context,
+                                              OUT PMMOBJECT_CACHE *Cache);
+            STATIC XTAPI XTSTATUS DestroyCache(IN PMMOBJECT_CACHE Cache);
+            STATIC XTAPI VOID FreeObject(IN PMMOBJECT_CACHE Cache,
+                                         IN PVOID Object);
+            STATIC XTAPI VOID TrimCache(IN PMMOBJECT_CACHE Cache);
+
+        private:
+            STATIC XTAPI PVOID AllocateSlabObject(IN PMMOBJECT_CACHE Cache);
+            STATIC XTAPI XTSTATUS CreateSlab(IN PMMOBJECT_CACHE Cache);
+            STATIC XTAPI VOID FlushMagazine(IN PMMOBJECT_CACHE Cache,
+                                            IN PMMOBJECT_MAGAZINE Magazine,
+                                            IN ULONG Count);
+            STATIC XTAPI VOID FreeSlabObject(IN PMMOBJECT_CACHE Cache,
+                                             IN PVOID Object);
+            STATIC XTAPI PMMOBJECT_MAGAZINE GetProcessorMagazine(IN PMMOBJECT_CACHE Cache);
+    };
+}
+
+#endif /* __XTOSKRNL_MM_OBJCACHE_HH */
@@ -0,0 +1,59 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/includes/mm/pagemap.hh
+ * DESCRIPTION:     Page map range routines common to all page map levels
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#ifndef __XTOSKRNL_MM_PAGEMAP_HH
+#define __XTOSKRNL_MM_PAGEMAP_HH
+
+#include <xtos.hh>
+#include XTOS_ARCH_HEADER(mm, pagemap.hh)
+
+
+/* Memory Manager */
+namespace MM
+{
+    typedef struct _PAGEMAP_RANGE_ROUTINES
+    {
+        VOID (XTAPI *MapContiguousPtes)(IN PPAGEMAP PageMap,
+                                        IN PMMPTE StartPte,
+                                        IN PFN_NUMBER PageFrameNumber,
+                                        IN PFN_COUNT NumberOfPtes,
+                                        IN ULONGLONG Attributes);
+        VOID (XTAPI *MapPtes)(IN PPAGEMAP PageMap,
+                              IN PMMPTE StartPte,
+                              IN PPFN_NUMBER PageFrames,
+                              IN PFN_COUNT NumberOfPtes,
+                              IN PMMPTE TemplatePte);
+        VOID (XTAPI *UnmapPtes)(IN PPAGEMAP PageMap,
+                                IN PMMPTE StartPte,
+                                IN PFN_COUNT NumberOfPtes,
+                                OUT PPFN_NUMBER PageFrames);
+    } PAGEMAP_RANGE_ROUTINES, *PPAGEMAP_RANGE_ROUTINES;
+
+    template <class PageMapLevel>
+    class PageMapRange
+    {
+        public:
+            STATIC XTAPI VOID InitializeRoutines(OUT PPAGEMAP_RANGE_ROUTINES Routines);
+            STATIC XTAPI VOID MapContiguousPtes(IN PPAGEMAP PageMap,
+                                                IN PMMPTE StartPte,
+                                                IN PFN_NUMBER PageFrameNumber,
+                                                IN PFN_COUNT NumberOfPtes,
+                                                IN ULONGLONG Attributes);
+            STATIC XTAPI VOID MapPtes(IN PPAGEMAP PageMap,
+                                      IN PMMPTE StartPte,
+                                      IN PPFN_NUMBER PageFrames,
+                                      IN PFN_COUNT NumberOfPtes,
+                                      IN PMMPTE TemplatePte);
+            STATIC XTAPI VOID UnmapPtes(IN PPAGEMAP PageMap,
+                                        IN PMMPTE StartPte,
+                                        IN PFN_COUNT NumberOfPtes,
+                                        OUT PPFN_NUMBER PageFrames);
+    };
+}
+
+#endif /* __XTOSKRNL_MM_PAGEMAP_HH */
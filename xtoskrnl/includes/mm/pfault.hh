@@ -19,6 +19,12 @@ namespace MM
     {
         public:
             STATIC XTFASTCALL XTSTATUS CheckPdeForPagedPool(IN PVOID VirtualAddress);
+            STATIC XTAPI XTSTATUS HandlePageFault(IN PVOID VirtualAddress,
+                                                  IN ULONG_PTR ErrorCode);
+
+        private:
+            STATIC XTAPI XTSTATUS MapPageTable(IN PMMPTE PointerPte);
+            STATIC XTAPI BOOLEAN PagedPoolAddress(IN PVOID VirtualAddress);
     };
 }
 
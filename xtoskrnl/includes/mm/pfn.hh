@@ -20,6 +20,16 @@ namespace MM
         private:
             STATIC PFN_NUMBER AvailablePages;
             STATIC MMPFNLIST BadPagesList;
+            STATIC LOADER_MEMORY_DESCRIPTOR BootstrapPaddingDescriptor;
+            STATIC LONG CompletedDeferredChunks;
+            STATIC PFN_NUMBER ContiguousReserveBase;
+            STATIC PFN_NUMBER ContiguousReservePages;
+            STATIC BOOLEAN DeferHighMemory;
+            STATIC LONG DeferredChunkCount;
+            STATIC PFN_NUMBER DeferredPageCount;
+            STATIC ULONG DeferredRunCount;
+            STATIC PHYSICAL_MEMORY_RUN DeferredRuns[MM_MAXIMUM_DEFERRED_PFN_RUNS];
+            STATIC ULONGLONG DeferredStartCycles;
             STATIC PLOADER_MEMORY_DESCRIPTOR FreeDescriptor;
             STATIC MMPFNLIST FreePagesList;
             STATIC ULONG_PTR HighestPhysicalPage;
@@ -27,6 +37,8 @@ namespace MM
             STATIC ULONG_PTR LowestPhysicalPage;
             STATIC MMPFNLIST ModifiedPagesList;
             STATIC MMPFNLIST ModifiedReadOnlyPagesList;
+            STATIC LONG NextDeferredChunk;
+            STATIC ULONG NextZeroPageColor;
             STATIC ULONGLONG NumberOfPhysicalPages;
             STATIC LOADER_MEMORY_DESCRIPTOR OriginalFreeDescriptor;
             STATIC PMMPFNLIST PageLocationList[];
@@ -36,8 +48,30 @@ namespace MM
             STATIC MMPFNLIST ZeroedPagesList;
 
         public:
+            STATIC XTAPI XTSTATUS AllocateBootstrapAlignedPages(IN PFN_NUMBER NumberOfPages,
+                                                                IN PFN_NUMBER Alignment,
+                                                                OUT PPFN_NUMBER PageFrameNumber);
             STATIC XTAPI PFN_NUMBER AllocateBootstrapPages(IN PFN_NUMBER NumberOfPages);
+            STATIC XTAPI XTSTATUS AllocateContiguousPages(IN PFN_NUMBER PageCount,
+                                                          IN PFN_NUMBER Alignment,
+                                                          IN PFN_NUMBER HighestPage,
+                                                          OUT PPFN_NUMBER BasePage);
+            STATIC XTAPI PFN_NUMBER AllocateMagazinePage(IN ULONG Color);
+            STATIC XTAPI XTSTATUS AllocateMappedPages(IN PMMPTE StartPte,
+                                                      IN PFN_COUNT Pages,
+                                                      IN ULONG Node,
+                                                      IN PMMPTE TemplatePte);
             STATIC XTAPI PFN_NUMBER AllocatePhysicalPage(IN ULONG Color);
+            STATIC XTAPI PFN_NUMBER AllocatePhysicalPage(IN ULONG Node,
+                                                         IN ULONG Color);
+            STATIC XTAPI XTSTATUS AllocatePhysicalPages(IN ULONG Color,
+                                                        IN PFN_COUNT Pages,
+                                                        OUT PPFN_NUMBER PageFrames);
+            STATIC XTAPI XTSTATUS AllocatePhysicalPages(IN ULONG Node,
+                                                        IN ULONG Color,
+                                                        IN PFN_COUNT Pages,
+                                                        OUT PPFN_NUMBER PageFrames);
+            STATIC XTAPI PFN_NUMBER AllocateZeroedPage(IN ULONG Color);
             STATIC XTAPI VOID ComputePfnDatabaseSize(OUT PPFN_NUMBER DatabaseSize);
             STATIC XTAPI VOID DecrementReferenceCount(IN PMMPFN Pfn1,
                                                       IN PFN_NUMBER PageFrameIndex,
@@ -45,11 +79,19 @@ namespace MM
             STATIC XTAPI VOID DecrementShareCount(IN PMMPFN Pfn1,
                                                   IN PFN_NUMBER PageFrameIndex,
                                                   IN BOOLEAN BeginStandbyList = FALSE);
+            STATIC XTAPI VOID FlushPageMagazine(VOID);
+            STATIC XTAPI VOID FreeContiguousPages(IN PFN_NUMBER BasePage,
+                                                  IN PFN_NUMBER PageCount);
+            STATIC XTAPI VOID FreeMagazinePage(IN PFN_NUMBER PageFrameIndex);
+            STATIC XTAPI VOID FreeMappedPages(IN PMMPTE StartPte,
+                                              IN PFN_COUNT Pages);
             STATIC XTAPI VOID FreePhysicalPage(IN PMMPTE PointerPte);
             STATIC XTAPI PFN_NUMBER GetAvailablePages(VOID);
             STATIC XTAPI ULONG_PTR GetHighestPhysicalPage(VOID);
             STATIC XTAPI ULONGLONG GetNumberOfPhysicalPages(VOID);
             STATIC XTAPI PMMPFN GetPfnEntry(IN PFN_NUMBER Pfn);
+            STATIC XTAPI VOID InitializeContiguousMemory(VOID);
+            STATIC XTAPI VOID InitializeDeferredPages(VOID);
             STATIC XTAPI VOID InitializePfnBitmap(VOID);
             STATIC XTAPI VOID InitializePfnDatabase(VOID);
             STATIC XTAPI VOID LinkPfn(IN PFN_NUMBER PageFrameIndex,
@@ -58,27 +100,46 @@ namespace MM
             STATIC XTAPI VOID LinkPfnWithParent(IN PFN_NUMBER PageFrameIndex,
                                                 IN PMMPTE PointerPte,
                                                 IN PFN_NUMBER ParentFrame);
+            STATIC XTAPI VOID QueryPageLists(OUT PPFN_NUMBER ListPages);
             STATIC XTAPI VOID ScanMemoryDescriptors(VOID);
+            STATIC XTAPI PFN_COUNT ZeroFreePages(IN PFN_COUNT Pages);
 
         private:
             STATIC XTAPI VOID DecrementAvailablePages(VOID);
+            STATIC XTAPI BOOLEAN DeferFreePages(IN PFN_NUMBER BasePage,
+                                                IN PFN_NUMBER PageCount);
             STATIC XTAPI VOID IncrementAvailablePages(VOID);
+            STATIC XTAPI VOID InitializeBootstrapPagePfns(VOID);
             STATIC XTAPI VOID InitializePageDirectory(IN PMMPDE StartingPde,
                                                       IN PMMPDE EndingPde);
             STATIC XTAPI VOID InitializePageTablePfns(VOID);
             STATIC XTAPI VOID LinkFreePage(IN PFN_NUMBER PageFrameIndex);
+            STATIC XTAPI VOID LinkFreePageRun(IN PFN_NUMBER BasePage,
+                                              IN PFN_NUMBER PageCount,
+                                              IN PMMCOLOR_TABLES LocalTables);
             STATIC XTAPI VOID LinkPage(IN PMMPFNLIST ListHead,
                                        IN PFN_NUMBER PageFrameIndex);
             STATIC XTAPI VOID LinkPfnForPageTable(IN PFN_NUMBER PageFrameIndex,
                                                   IN PMMPTE PointerPte);
             STATIC XTFASTCALL VOID LinkStandbyPage(IN PFN_NUMBER PageFrameIndex);
+            STATIC XTAPI VOID LinkZeroedPage(IN PFN_NUMBER PageFrameIndex);
             STATIC XTAPI VOID ProcessMemoryDescriptor(IN PFN_NUMBER BasePage,
                                                       IN PFN_NUMBER PageCount,
                                                       IN LOADER_MEMORY_TYPE MemoryType);
+            STATIC XTAPI VOID RefillPageMagazine(IN PMMPAGE_MAGAZINE Magazine,
+                                                 IN ULONG Color);
             STATIC XTAPI VOID ScanPageTable(IN PMMPTE PointerPte,
                                             IN ULONG Level);
             STATIC XTAPI PFN_NUMBER UnlinkFreePage(IN PFN_NUMBER PageFrameIndex,
                                                    IN ULONG Color);
+            STATIC XTAPI PFN_COUNT UnlinkFreePages(IN MMPAGELISTS PageList,
+                                                   IN ULONG Node,
+                                                   IN ULONG Color,
+                                                   IN PFN_COUNT Pages,
+                                                   IN PFN_COUNT Stride,
+                                                   OUT PPFN_NUMBER PageFrames);
+            STATIC XTAPI XTSTATUS ZeroPhysicalPages(IN PPFN_NUMBER PageFrames,
+                                                    IN PFN_COUNT Pages);
     };
 }
 
@@ -18,32 +18,56 @@ namespace MM
     class Pool
     {
         protected:
-            STATIC POOL_DESCRIPTOR NonPagedPoolDescriptor;
+            STATIC RTL_BITMAP GuardPoolBitMap;
+            STATIC ULONG_PTR GuardPoolBitMapBuffer[MM_POOL_GUARD_PTES / (sizeof(ULONG_PTR) * 8)];
+            STATIC ULONG_PTR GuardPoolHint;
+            STATIC KSPIN_LOCK GuardPoolLock;
+            STATIC PVOID GuardPoolStart;
+            STATIC ULONG GuardPoolTag;
+            STATIC POOL_DESCRIPTOR NonPagedPoolDescriptors[MM_MAXIMUM_NUMA_NODES];
+            STATIC KSPIN_LOCK NonPagedPoolDescriptorLocks[MM_MAXIMUM_NUMA_NODES];
             STATIC PFN_NUMBER NonPagedPoolFrameEnd;
             STATIC PFN_NUMBER NonPagedPoolFrameStart;
-            STATIC LIST_ENTRY NonPagedPoolFreeList[MM_MAX_FREE_PAGE_LIST_HEADS];
+            STATIC LIST_ENTRY NonPagedPoolFreeList[MM_FREE_PAGE_RUN_LISTS];
+            STATIC ULONG NonPagedPoolFreeListBitmap;
+            STATIC ULONG NonPagedPoolFreeListSubBitmap[MM_FREE_PAGE_RUN_FIRST_LEVELS];
+            STATIC ULONG NonPagedPoolNode;
+            STATIC RTL_BITMAP PagedPoolAllocationMap;
+            STATIC POOL_DESCRIPTOR PagedPoolDescriptor;
+            STATIC KSPIN_LOCK PagedPoolDescriptorLock;
+            STATIC RTL_BITMAP PagedPoolEndOfAllocationMap;
+            STATIC ULONG_PTR PagedPoolHint;
+            STATIC KSPIN_LOCK PagedPoolLock;
             STATIC ULONG PoolSecureCookie;
             STATIC PPOOL_DESCRIPTOR PoolVector[2];
+            STATIC ULONG PoolVerificationLevel;
 
         public:
             STATIC XTAPI MMPOOL_TYPE DeterminePoolType(IN PVOID VirtualAddress);
             STATIC XTAPI VOID InitializeNonPagedPool(VOID);
             STATIC XTAPI VOID InitializePagedPool(VOID);
             STATIC XTAPI VOID InitializePoolSecurity(VOID);
+            STATIC XTAPI VOID InitializePoolVerification(VOID);
 
         protected:
             STATIC XTAPI PLIST_ENTRY DecodePoolLink(IN PLIST_ENTRY PoolLink);
             STATIC XTAPI PLIST_ENTRY EncodePoolLink(IN PLIST_ENTRY PoolLink);
+            STATIC XTAPI PMMFREE_POOL_ENTRY FindFreePageRun(IN PFN_COUNT Pages);
             STATIC XTAPI PPOOL_HEADER GetPoolBlock(IN PPOOL_HEADER Header, IN SSIZE_T Index);
+            STATIC XTAPI PPOOL_DESCRIPTOR GetPoolDescriptor(IN MMPOOL_TYPE PoolType);
+            STATIC XTAPI PPOOL_DESCRIPTOR GetPoolDescriptor(IN PPOOL_HEADER Header);
             STATIC XTAPI PPOOL_HEADER GetPoolEntry(IN PVOID Payload);
             STATIC XTAPI PLIST_ENTRY GetPoolFreeBlock(IN PPOOL_HEADER Header);
             STATIC XTAPI PPOOL_HEADER GetPoolNextBlock(IN PPOOL_HEADER Header);
             STATIC XTAPI PPOOL_HEADER GetPoolPreviousBlock(IN PPOOL_HEADER Header);
+            STATIC XTAPI BOOLEAN GuardPoolAddress(IN PVOID VirtualAddress);
+            STATIC XTAPI VOID InsertFreePageRun(IN PMMFREE_POOL_ENTRY FreePage);
             STATIC XTAPI VOID InsertPoolHeadList(IN PLIST_ENTRY ListHead,
                                                  IN PLIST_ENTRY Entry);
             STATIC XTAPI VOID InsertPoolTailList(IN PLIST_ENTRY ListHead,
                                                  IN PLIST_ENTRY Entry);
             STATIC XTAPI BOOLEAN PoolListEmpty(IN PLIST_ENTRY ListHead);
+            STATIC XTAPI VOID RemoveFreePageRun(IN PMMFREE_POOL_ENTRY FreePage);
             STATIC XTAPI VOID RemovePoolEntryList(IN PLIST_ENTRY Entry);
             STATIC XTAPI PLIST_ENTRY RemovePoolHeadList(IN PLIST_ENTRY ListHead);
             STATIC XTAPI PLIST_ENTRY RemovePoolTailList(IN PLIST_ENTRY ListHead);
@@ -55,6 +79,9 @@ namespace MM
                                              IN PVOID Entry);
 
         private:
+            STATIC XTAPI VOID GetFreePageRunIndex(IN PFN_COUNT Pages,
+                                                  OUT PULONG FirstLevel,
+                                                  OUT PULONG SecondLevel);
             STATIC XTAPI VOID InitializePoolDescriptor(IN PPOOL_DESCRIPTOR Descriptor,
                                                        IN MMPOOL_TYPE PoolType,
                                                        IN ULONG Index,
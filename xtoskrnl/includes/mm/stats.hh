@@ -0,0 +1,35 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/includes/mm/stats.hh
+ * DESCRIPTION:     Memory Manager performance counters
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#ifndef __XTOSKRNL_MM_STATS_HH
+#define __XTOSKRNL_MM_STATS_HH
+
+#include <xtos.hh>
+
+
+/* Memory Manager */
+namespace MM
+{
+    class Statistics
+    {
+        private:
+            STATIC ULONGLONG MonitorDeadline;
+            STATIC ULONGLONG MonitorInterval;
+
+        public:
+            STATIC XTAPI VOID AddCounter(IN MMPERFORMANCE_COUNTER Counter,
+                                         IN ULONG_PTR Value);
+            STATIC XTAPI VOID DumpPerformanceInformation(VOID);
+            STATIC XTAPI VOID IncrementCounter(IN MMPERFORMANCE_COUNTER Counter);
+            STATIC XTAPI VOID InitializeStatistics(VOID);
+            STATIC XTAPI VOID MonitorPerformance(VOID);
+            STATIC XTAPI VOID QueryPerformanceInformation(OUT PMMPERFORMANCE_INFORMATION Information);
+    };
+}
+
+#endif /* __XTOSKRNL_MM_STATS_HH */
@@ -0,0 +1,52 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/includes/mm/tlb.hh
+ * DESCRIPTION:     Translation Lookaside Buffer (TLB) shootdown support
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#ifndef __XTOSKRNL_MM_TLB_HH
+#define __XTOSKRNL_MM_TLB_HH
+
+#include <xtos.hh>
+
+
+/* Memory Manager */
+namespace MM
+{
+    class Tlb
+    {
+        private:
+            STATIC KSPIN_LOCK AddressSpaceIdLock;
+            STATIC RTL_BITMAP AddressSpaceIdMap;
+            STATIC ULONG_PTR AddressSpaceIdMapBuffer[MM_ADDRESS_SPACE_IDS / (sizeof(ULONG_PTR) * 8)];
+            STATIC BOOLEAN AddressSpaceIdSupport;
+            STATIC LONG ShootdownLock;
+            STATIC VOLATILE KAFFINITY ShootdownPending;
+            STATIC VOLATILE KAFFINITY ShootdownProcessors;
+            STATIC MMTLB_FLUSH_BATCH ShootdownRequest;
+
+        public:
+            STATIC XTAPI USHORT AllocateAddressSpaceId(VOID);
+            STATIC XTAPI VOID FlushBatch(IN OUT PMMTLB_FLUSH_BATCH Batch);
+            STATIC XTAPI VOID FlushRange(IN PVOID VirtualAddress,
+                                         IN PFN_COUNT NumberOfPages);
+            STATIC XTAPI VOID FreeAddressSpaceId(IN USHORT AddressSpaceId);
+            STATIC XTCDECL VOID HandleShootdownInterrupt(IN PKTRAP_FRAME TrapFrame);
+            STATIC XTAPI VOID InitializeBatch(OUT PMMTLB_FLUSH_BATCH Batch);
+            STATIC XTAPI VOID QueueFlush(IN OUT PMMTLB_FLUSH_BATCH Batch,
+                                         IN PVOID VirtualAddress,
+                                         IN PFN_COUNT NumberOfPages);
+            STATIC XTAPI VOID RegisterProcessor(VOID);
+            STATIC XTAPI VOID SwitchAddressSpace(IN PKPROCESS Process);
+            STATIC XTAPI VOID UnregisterProcessor(VOID);
+
+        private:
+            STATIC XTAPI VOID EnableAddressSpaceIds(VOID);
+            STATIC XTAPI VOID FlushLocalTlb(IN PMMTLB_FLUSH_BATCH Batch);
+            STATIC XTAPI VOID ServiceShootdownRequest(VOID);
+    };
+}
+
+#endif /* __XTOSKRNL_MM_TLB_HH */
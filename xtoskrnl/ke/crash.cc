@@ -20,6 +20,9 @@ XTAPI
 VOID
 KE::Crash::HaltSystem(VOID)
 {
+    /* Stop servicing TLB shootdowns, as interrupts are going to be disabled */
+    MM::Tlb::UnregisterProcessor();
+
     /* Enter infinite loop */
     for(;;)
     {
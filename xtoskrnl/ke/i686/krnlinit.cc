@@ -45,6 +45,12 @@ KE::KernelInit::BootstrapApplicationProcessor(IN PPROCESSOR_START_BLOCK StartBlo
     /* Initialize CPU power state structures */
     PO::Idle::InitializeProcessorIdleState(ControlBlock);
 
+    /* Initialize pool lookaside lists for this CPU */
+    MM::Allocator::InitializeLookasideLists();
+
+    /* Enable TLB shootdowns for this CPU */
+    MM::Tlb::RegisterProcessor();
+
     /* Save processor state */
     KE::Processor::SaveProcessorState(&ControlBlock->ProcessorState);
 
@@ -54,10 +60,13 @@ KE::KernelInit::BootstrapApplicationProcessor(IN PPROCESSOR_START_BLOCK StartBlo
     /* Initialize local clock for this CPU */
     HL::Timer::InitializeLocalClock();
 
-    /* Enter infinite loop */
-    DebugPrint(L"KernelInit::BootstrapApplicationProcessor() finished for CPU #%lu. Entering infinite loop.\n",
+    /* Help initializing the deferred part of the PFN database */
+    MM::Pfn::InitializeDeferredPages();
+
+    /* Enter idle loop */
+    DebugPrint(L"KernelInit::BootstrapApplicationProcessor() finished for CPU #%lu. Entering idle loop.\n",
                ControlBlock->CpuNumber);
-    KE::Crash::HaltSystem();
+    EnterIdleLoop();
 }
 
 /**
@@ -126,9 +135,12 @@ KE::KernelInit::BootstrapKernel(VOID)
     KE::Processor::InitializeProcessorBlocks();
     HL::Cpu::StartAllProcessors();
 
-    /* Enter infinite loop */
-    DebugPrint(L"KernelInit::BootstrapKernel() finished. Entering infinite loop.\n");
-    KE::Crash::HaltSystem();
+    /* Initialize the deferred part of the PFN database along with application processors */
+    MM::Pfn::InitializeDeferredPages();
+
+    /* Enter idle loop */
+    DebugPrint(L"KernelInit::BootstrapKernel() finished. Entering idle loop.\n");
+    EnterIdleLoop();
 }
 
 /**
@@ -175,6 +187,9 @@ KE::KernelInit::InitializeMachine(VOID)
     /* Initialize page map support */
     MM::Paging::InitializePageMapSupport();
 
+    /* Map frame buffer as write-combining memory */
+    HL::FrameBuffer::EnableWriteCombining();
+
     /* Initialize Kernel Shared Data (KSD) */
     KE::SharedData::InitializeKernelSharedData();
 
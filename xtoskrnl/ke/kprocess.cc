@@ -65,6 +65,9 @@ KE::KProcess::InitializeProcess(IN OUT PKPROCESS Process,
     Process->DirectoryTable[1] = DirectoryTable[1];
     Process->StackCount = MAXSHORT;
 
+    /* Tag the address space with a hardware identifier, if it has its own page directory */
+    Process->AddressSpaceId = DirectoryTable[0] ? MM::Tlb::AllocateAddressSpaceId() : 0;
+
     /* Set thread quantum */
     Process->Quantum = THREAD_QUANTUM;
 
@@ -12,6 +12,30 @@
 /* Use routines from Kernel Library */
 using namespace KE;
 
+/**
+ * Runs the idle loop of the current processor, once it has nothing else to do.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+KE::KernelInit::EnterIdleLoop(VOID)
+{
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+
+    /* Get current processor control block */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+
+    /* Enter infinite loop */
+    for(;;)
+    {
+        /* Do the idle work and wait for the next interrupt */
+        Prcb->PowerState.IdleFunction(&Prcb->PowerState);
+    }
+}
+
 /**
  * This routine starts up the XT kernel. It is called by boot loader.
  *
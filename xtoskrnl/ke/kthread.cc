@@ -158,7 +158,7 @@ KE::KThread::InitializeThread(IN PKPROCESS Process,
         if(Allocation)
         {
             /* Deallocate stack */
-            MM::KernelPool::FreeKernelStack(Stack, FALSE);
+            MM::KernelPool::FreeKernelStack(Stack, KERNEL_STACK_SIZE);
             Thread->InitialStack = NULLPTR;
             Thread->StackBase = NULLPTR;
         }
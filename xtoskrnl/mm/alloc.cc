@@ -10,13 +10,79 @@
 
 
 /**
- * Allocates pages from the non-paged pool.
+ * Adjusts the depth of a per-processor pool lookaside list based on its recent hit rate.
  *
- * @param Pages
- *        Specifies the number of pages to allocate.
+ * @param LookasideList
+ *        Supplies a pointer to the lookaside list to adjust.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Allocator::AdjustLookasideDepth(IN PMMPOOL_LOOKASIDE_LIST LookasideList)
+{
+    ULONG Allocates, Misses, Ratio, Target;
+
+    /* Compute the number of allocations and misses since the last adjustment */
+    Allocates = LookasideList->TotalAllocates - LookasideList->LastTotalAllocates;
+    Misses = LookasideList->AllocateMisses - LookasideList->LastAllocateMisses;
+
+    /* Save the current counters for the next adjustment */
+    LookasideList->LastTotalAllocates = LookasideList->TotalAllocates;
+    LookasideList->LastAllocateMisses = LookasideList->AllocateMisses;
+
+    /* Make sure there were any allocations since the last adjustment */
+    if(Allocates == 0)
+    {
+        /* Nothing to adjust, return */
+        return;
+    }
+
+    /* Compute the miss ratio, expressed in tenths of a percent */
+    Ratio = (Misses * 1000) / Allocates;
+
+    /* Check if the lookaside list satisfies almost all allocations */
+    if(Ratio < 5)
+    {
+        /* Slowly shrink the list depth, but never below the minimum */
+        Target = (LookasideList->Depth > MM_POOL_LOOKASIDE_MINIMUM_DEPTH) ? LookasideList->Depth - 1
+                                                                          : MM_POOL_LOOKASIDE_MINIMUM_DEPTH;
+    }
+    else
+    {
+        /* Grow the list depth proportionally to the miss ratio */
+        Target = LookasideList->Depth + ((Ratio * LookasideList->MaximumDepth) / 2000) + 5;
+    }
+
+    /* Check if the new depth exceeds the maximum */
+    if(Target > LookasideList->MaximumDepth)
+    {
+        /* Limit the depth to the maximum */
+        Target = LookasideList->MaximumDepth;
+    }
+
+    /* Set the new list depth */
+    LookasideList->Depth = (USHORT)Target;
+}
+
+/**
+ * Allocates a pool block from the guard page pool. The block is placed at the very end of its pages and is followed
+ * by an unmapped guard page, so that any buffer overrun faults immediately, while the unused space in front of the
+ * block is filled with a pattern, that is verified when the block is freed.
+ *
+ * @param PoolType
+ *        Specifies the type of pool the block was requested from.
+ *
+ * @param Bytes
+ *        Specifies the number of bytes to allocate.
  *
  * @param Memory
- *        Supplies a pointer to the allocated pool of pages.
+ *        Supplies a pointer to the allocated memory.
+ *
+ * @param Tag
+ *        Specifies the allocation identifying tag.
  *
  * @return This routine returns a status code.
  *
@@ -24,163 +90,227 @@
  */
 XTAPI
 XTSTATUS
-MM::Allocator::AllocateNonPagedPoolPages(IN PFN_COUNT Pages,
-                                         OUT PVOID *Memory)
+MM::Allocator::AllocateGuardPool(IN MMPOOL_TYPE PoolType,
+                                 IN SIZE_T Bytes,
+                                 OUT PVOID *Memory,
+                                 IN ULONG Tag)
 {
-    PMMPTE CurrentPte, PointerPte, ValidPte;
-    PLIST_ENTRY Entry, LastHead, ListHead;
-    PMMFREE_POOL_ENTRY FreePage;
-    PFN_NUMBER PageFrameNumber;
-    PVOID BaseAddress;
-    ULONG Index;
-    PMMPFN Pfn;
+    PPOOL_HEADER PoolEntry;
+    PVOID VirtualAddress;
+    ULONG_PTR StartBit;
+    SIZE_T BlockBytes;
+    PFN_COUNT Pages;
+    PMMPTE BasePte;
+    MMPTE TempPte;
 
-    /* Calculate the free list index based on the requested page count, capped at the maximum list head index */
-    Index = MIN(Pages, MM_MAX_FREE_PAGE_LIST_HEADS) - 1;
+    /* Initialize the output parameter */
+    *Memory = NULLPTR;
+
+    /* Round the size up to the pool block size, so that the block stays properly aligned */
+    BlockBytes = (Bytes + (MM_POOL_BLOCK_SIZE - 1)) & ~((SIZE_T)MM_POOL_BLOCK_SIZE - 1);
+
+    /* Make sure the block, along with its header and the guard page, fits into the guard page pool */
+    if(BlockBytes + sizeof(POOL_HEADER) >= ((SIZE_T)MM_POOL_GUARD_PTES << MM_PAGE_SHIFT) / 2)
+    {
+        /* Allocation too large for the guard page pool, return error */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
 
-    /* Set the starting list head and the boundary for the search loop */
-    ListHead = &NonPagedPoolFreeList[Index];
-    LastHead = &NonPagedPoolFreeList[MM_MAX_FREE_PAGE_LIST_HEADS];
+    /* Calculate the number of pages backing the block */
+    Pages = (PFN_COUNT)SIZE_TO_PAGES(BlockBytes + sizeof(POOL_HEADER));
 
     /* Start a guarded code block */
     {
-        /* Acquire the Non-Paged pool lock and raise runlevel to DISPATCH level */
+        /* Acquire the guard page pool lock and raise runlevel to DISPATCH level */
         KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-        KE::QueuedSpinLockGuard NonPagedPoolSpinLock(NonPagedPoolLock);
+        KE::SpinLockGuard GuardPoolSpinLock(&GuardPoolLock);
 
-        /* Iterate through the free lists */
-        do
+        /* Find a run of free PTEs for the block pages and the trailing guard page, starting from the hint */
+        StartBit = RTL::BitMap::FindClearBits(&GuardPoolBitMap, Pages + 1, GuardPoolHint);
+        if(StartBit == MAXULONG_PTR)
         {
-            /* Iterate through the free entries in the current list */
-            Entry = ListHead->Flink;
-            while(Entry != ListHead)
-            {
-                /* Get the free pool entry structure from the list entry */
-                FreePage = CONTAIN_RECORD(Entry, MMFREE_POOL_ENTRY, List);
+            /* Guard page pool virtual space exhausted, return error */
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
 
-                /* Check if this block is large enough to satisfy the request */
-                if(FreePage->Size >= Pages)
-                {
-                    /* Adjust the size of the free block to account for the allocated pages */
-                    FreePage->Size -= Pages;
+        /* Reserve the PTEs and continue the next search right after them, to delay reuse of freed addresses */
+        RTL::BitMap::SetBits(&GuardPoolBitMap, StartBit, Pages + 1);
+        GuardPoolHint = StartBit + Pages + 1;
+    }
 
-                    /* Calculate the base address of the allocated block */
-                    BaseAddress = (PVOID)((ULONG_PTR)FreePage + (FreePage->Size  << MM_PAGE_SHIFT));
+    /* Get the first PTE and the virtual address of the block pages */
+    BasePte = MM::Paging::AdvancePte(MM::Paging::GetPteAddress(GuardPoolStart), StartBit);
+    VirtualAddress = MM::Paging::GetPteVirtualAddress(BasePte);
 
-                    /* Remove the entry from the free list */
-                    RTL::LinkedList::RemoveEntryList(&FreePage->List);
+    /* Set up a template for a valid, writable PTE */
+    MM::Paging::ClearPte(&TempPte);
+    MM::Paging::SetPte(&TempPte, 0, MM_PTE_READWRITE | MM_PTE_CACHE_ENABLE);
 
-                    /* Check if there is remaining space in the entry */
-                    if(FreePage->Size != 0)
-                    {
-                        /* Calculate the new list index for the remaining fragment */
-                        Index = MIN(FreePage->Size, MM_MAX_FREE_PAGE_LIST_HEADS) - 1;
+    /* Map each page of the block with physical pages acquired in bulk, leaving the guard page PTE invalid */
+    if(MM::Pfn::AllocateMappedPages(BasePte, Pages, MM::Numa::GetCurrentNode(), &TempPte) != STATUS_SUCCESS)
+    {
+        /* Acquire the guard page pool lock and raise runlevel to DISPATCH level */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard GuardPoolSpinLock(&GuardPoolLock);
 
-                        /* Insert the entry into the free list */
-                        RTL::LinkedList::InsertTailList(&NonPagedPoolFreeList[Index], &FreePage->List);
-                    }
+        /* Release the reserved PTEs and return error */
+        RTL::BitMap::ClearBits(&GuardPoolBitMap, StartBit, Pages + 1);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
 
-                    /* Get the PTE for the allocated address */
-                    PointerPte = MM::Paging::GetPteAddress(BaseAddress);
+    /* Place the block at the end of its pages, right in front of the guard page */
+    PoolEntry = (PPOOL_HEADER)((ULONG_PTR)VirtualAddress + ((SIZE_T)Pages << MM_PAGE_SHIFT) - BlockBytes) - 1;
 
-                    /* Get the PFN database entry for the corresponding physical page */
-                    Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
+    /* Fill the unused space in front of the block with a pattern, so that buffer underruns can be detected */
+    RTL::Memory::SetMemory(VirtualAddress, MM_POOL_GUARD_PATTERN, (ULONG_PTR)PoolEntry - (ULONG_PTR)VirtualAddress);
 
-                    /* Denote allocation boundaries */
-                    Pfn->u3.e1.ReadInProgress = 1;
+    /* Initialize the pool header, the block size holds the number of pages backing the block */
+    PoolEntry->Long = 0;
+    PoolEntry->BlockSize = (USHORT)Pages;
+    PoolEntry->PoolType = PoolType + 1;
+    PoolEntry->PoolTag = Tag;
 
-                    /* Check if multiple pages were requested */
-                    if(Pages != 1)
-                    {
-                        /* Advance to the PTE of the last page in the allocation */
-                        PointerPte = MM::Paging::AdvancePte(PointerPte, Pages - 1);
+    /* Register the allocation in the tracking table */
+    RegisterAllocationTag(Tag, (SIZE_T)Pages << MM_PAGE_SHIFT, PoolType);
 
-                        /* Get the PFN entry for the last page */
-                        Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
-                    }
+    /* Supply the allocated address and return success */
+    *Memory = (PVOID)(PoolEntry + 1);
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Takes a cached pool block of the requested size from the current processor's lookaside list.
+ *
+ * @param Index
+ *        Specifies the block size, in pool blocks, including the pool header.
+ *
+ * @return This routine returns a pointer to the cached pool block header, or NULLPTR if the list is empty.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PPOOL_HEADER
+MM::Allocator::AllocateLookasidePoolBlock(IN USHORT Index)
+{
+    PMMPOOL_LOOKASIDE_LIST LookasideList;
+    PSINGLE_LIST_ENTRY Entry;
 
-                    /* Denote allocation boundaries */
-                    Pfn->u3.e1.WriteInProgress = 1;
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
 
-                    /* Set the allocated memory address and return success */
-                    *Memory = BaseAddress;
-                    return STATUS_SUCCESS;
-                }
+    /* Get the lookaside list for the requested block size */
+    LookasideList = &KE::Processor::GetCurrentProcessorControlBlock()->PoolLookasideList[Index - 1];
 
-                /* Move to the next entry in the free list */
-                Entry = FreePage->List.Flink;
-            }
-        }
-        while(++ListHead < LastHead);
+    /* Take the first cached block from the list */
+    LookasideList->TotalAllocates++;
+    Entry = RTL::SinglyList::TakeFirstEntry(&LookasideList->ListHead);
+    if(!Entry)
+    {
+        /* Lookaside list is empty, count a miss */
+        LookasideList->AllocateMisses++;
     }
 
-    /* No suitable free block found; try to expand the pool by reserving system PTEs */
-    PointerPte = MM::Pte::ReserveSystemPtes(Pages, NonPagedPoolExpansion);
-    if(PointerPte == NULLPTR)
+    /* Check if the list depth should be adjusted */
+    if((LookasideList->TotalAllocates - LookasideList->LastTotalAllocates) >= MM_POOL_LOOKASIDE_ADJUST_INTERVAL)
     {
-        /* PTE reservation failed, return insufficient resources */
-        return STATUS_INSUFFICIENT_RESOURCES;
+        /* Adjust the list depth to the recent hit rate */
+        AdjustLookasideDepth(LookasideList);
     }
 
-    /* Acquire the Non-Paged pool lock and raise runlevel to DISPATCH level */
-    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-    KE::QueuedSpinLockGuard NonPagedPoolSpinLock(NonPagedPoolLock);
+    /* Return the pool block header, if any */
+    return Entry ? GetPoolEntry(Entry) : NULLPTR;
+}
 
-    /* Acquire the PFN database lock */
-    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+/**
+ * Allocates pages from the non-paged pool.
+ *
+ * @param Pages
+ *        Specifies the number of pages to allocate.
+ *
+ * @param Node
+ *        Supplies the NUMA node, whose physical pages should back the allocation.
+ *
+ * @param Memory
+ *        Supplies a pointer to the allocated pool of pages.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note The initial non-paged pool is used only by the node owning its physical pages. Other nodes expand the pool
+ *       with pages of their own, and fall back to the initial non-paged pool only when the expansion fails.
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::AllocateNonPagedPoolPages(IN PFN_COUNT Pages,
+                                         IN ULONG Node,
+                                         OUT PVOID *Memory)
+{
+    PMMFREE_POOL_ENTRY FreePage;
+    PVOID BaseAddress;
+    XTSTATUS Status;
+    PMMPFN Pfn;
 
-    /* Check if there are enough available physical pages to back the allocation */
-    if(Pages >= MM::Pfn::GetAvailablePages())
+    /* Check if the initial non-paged pool is backed by the physical pages of the requested node */
+    if(Node == NonPagedPoolNode)
     {
-        /* Not enough physical pages, release the reserved system PTEs */
-        MM::Pte::ReleaseSystemPtes(PointerPte, Pages, NonPagedPoolExpansion);
+        /* Acquire the Non-Paged pool lock and raise runlevel to DISPATCH level */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::QueuedSpinLockGuard NonPagedPoolSpinLock(NonPagedPoolLock);
 
-        /* Return failure due to insufficient resources */
-        return STATUS_INSUFFICIENT_RESOURCES;
-    }
+        /* Look up the free runs index for a block large enough to satisfy the request */
+        FreePage = FindFreePageRun(Pages);
+        if(FreePage != NULLPTR)
+        {
+            /* Remove the entry from the free list before its size changes */
+            RemoveFreePageRun(FreePage);
 
-    /* Set the tracking pointer to iterate through the reserved PTE space */
-    CurrentPte = PointerPte;
+            /* Adjust the size of the free block to account for the allocated pages */
+            FreePage->Size -= Pages;
 
-    /* Get a template valid PTE and loop through the allocation to map physical pages */
-    ValidPte = MM::Pte::GetValidPte();
-    do
-    {
-        /* Allocate a physical page */
-        PageFrameNumber = MM::Pfn::AllocatePhysicalPage(MM::Colors::GetNextColor());
+            /* Calculate the base address of the allocated block */
+            BaseAddress = (PVOID)((ULONG_PTR)FreePage + (FreePage->Size  << MM_PAGE_SHIFT));
 
-        /* Initialize the PFN entry for the allocated physical page */
-        Pfn = MM::Pfn::GetPfnEntry(PageFrameNumber);
-        MM::Paging::SetPte(&Pfn->OriginalPte, 0, MM_READWRITE << MM_PROTECT_FIELD_SHIFT);
-        Pfn->PteAddress = CurrentPte;
-        Pfn->u2.ShareCount = 1;
-        Pfn->u3.e1.PageLocation = ActiveAndValid;
-        Pfn->u3.e2.ReferenceCount = 1;
-        Pfn->u4.PteFrame = MM::Paging::GetPageFrameNumber(MM::Paging::GetPteAddress(CurrentPte));
+            /* Check if there is remaining space in the entry */
+            if(FreePage->Size != 0)
+            {
+                /* Insert the remaining fragment into the free list matching its size */
+                InsertFreePageRun(FreePage);
+            }
 
-        /* Build a valid PTE pointing to the allocated page frame */
-        MM::Paging::SetPte(ValidPte, PageFrameNumber, 0);
+            /* Get the PFN database entry for the physical page backing the allocated address */
+            Pfn = MM::Pfn::GetPfnEntry(MM::Pte::GetMappedPageFrame(BaseAddress));
 
-        /* Write the valid PTE into the system PTE range and advance to the next PTE */
-        *CurrentPte = *ValidPte;
-        CurrentPte = MM::Paging::GetNextPte(CurrentPte);
-    }
-    while(--Pages > 0);
+            /* Denote allocation boundaries */
+            Pfn->u3.e1.ReadInProgress = 1;
 
-    /* Dnote allocation boundaries */
-    Pfn->u3.e1.WriteInProgress = 1;
+            /* Check if multiple pages were requested */
+            if(Pages != 1)
+            {
+                /* Get the PFN entry for the last page in the allocation */
+                Pfn = MM::Pfn::GetPfnEntry(MM::Pte::GetMappedPageFrame((PVOID)((ULONG_PTR)BaseAddress +
+                                                                               ((Pages - 1) << MM_PAGE_SHIFT))));
+            }
 
-    /* Get the PFN entry for the first page of the allocation */
-    Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
+            /* Denote allocation boundaries */
+            Pfn->u3.e1.WriteInProgress = 1;
 
-    /* Denote allocation boundaries */
-    Pfn->u3.e1.ReadInProgress = 1;
+            /* Set the allocated memory address and return success */
+            *Memory = BaseAddress;
+            return STATUS_SUCCESS;
+        }
+    }
 
-    /* Convert the PTE address to the virtual address and store in the buffer */
-    *Memory = MM::Paging::GetPteVirtualAddress(PointerPte);
+    /* No suitable free block found; try to expand the pool with the physical pages of the requested node */
+    Status = ExpandNonPagedPool(Pages, Node, Memory);
+    if(Status != STATUS_SUCCESS && Node != NonPagedPoolNode)
+    {
+        /* Pool expansion failed, fall back to the initial non-paged pool */
+        return AllocateNonPagedPoolPages(Pages, NonPagedPoolNode, Memory);
+    }
 
-    /* Return success */
-    return STATUS_SUCCESS;
+    /* Return the status */
+    return Status;
 }
 
 /**
@@ -201,10 +331,86 @@ XTSTATUS
 MM::Allocator::AllocatePagedPoolPages(IN PFN_COUNT Pages,
                                       OUT PVOID *Memory)
 {
-    UNIMPLEMENTED;
+    PMMPTE FirstPte, LastPte, PointerPte;
+    PMMMEMORY_LAYOUT MemoryLayout;
+    PVOID VirtualAddress;
+    MMPTE DemandZeroPte;
+    ULONG_PTR StartBit;
+    XTSTATUS Status;
+
+    /* Initialize the output parameter */
+    *Memory = NULLPTR;
+
+    /* Retrieve memory layout */
+    MemoryLayout = MM::Manager::GetMemoryLayout();
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the paged pool lock and raise runlevel to DISPATCH level */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard PagedPoolSpinLock(&PagedPoolLock);
+
+        /* Find a run of free paged pool pages, starting from the hint */
+        StartBit = RTL::BitMap::FindClearBits(&PagedPoolAllocationMap, Pages, PagedPoolHint);
+        if(StartBit == MAXULONG_PTR)
+        {
+            /* Paged pool virtual space exhausted, return error */
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+
+        /* Reserve the pages and denote the allocation boundary */
+        RTL::BitMap::SetBits(&PagedPoolAllocationMap, StartBit, Pages);
+        RTL::BitMap::SetBit(&PagedPoolEndOfAllocationMap, StartBit + Pages - 1);
+
+        /* Continue the next search right after this allocation */
+        PagedPoolHint = StartBit + Pages;
+    }
+
+    /* Get the virtual address of the allocation and the range of PTEs mapping it */
+    VirtualAddress = (PVOID)((ULONG_PTR)MemoryLayout->PagedPoolStart + (StartBit << MM_PAGE_SHIFT));
+    FirstPte = MM::Paging::GetPteAddress(VirtualAddress);
+    LastPte = MM::Paging::AdvancePte(FirstPte, Pages - 1);
 
-    /* Return not implemented status code */
-    return STATUS_NOT_IMPLEMENTED;
+    /* Set up a template for a demand-zero PTE, not backed by any physical page yet */
+    MM::Paging::ClearPte(&DemandZeroPte);
+    MM::Paging::SetPte(&DemandZeroPte, MM_READWRITE << MM_PROTECT_FIELD_SHIFT);
+
+    /* Iterate over all PTEs of the allocation */
+    for(PointerPte = FirstPte; PointerPte <= LastPte; PointerPte = MM::Paging::GetNextPte(PointerPte))
+    {
+        /* Make sure the page table is resident, when the first PTE or a new page table is reached */
+        if(PointerPte == FirstPte || ((ULONG_PTR)PointerPte & MM_PAGE_MASK) == 0)
+        {
+            /* Create the page table if needed */
+            Status = MM::PageFault::CheckPdeForPagedPool(MM::Paging::GetPteVirtualAddress(PointerPte));
+            if(Status != STATUS_SUCCESS)
+            {
+                /* Unable to create the page table, clear all PTEs written so far */
+                while(PointerPte > FirstPte)
+                {
+                    /* Clear the previous PTE */
+                    PointerPte = MM::Paging::AdvancePte(PointerPte, -1);
+                    MM::Paging::ClearPte(PointerPte);
+                }
+
+                /* Acquire the paged pool lock and raise runlevel to DISPATCH level */
+                KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+                KE::SpinLockGuard PagedPoolSpinLock(&PagedPoolLock);
+
+                /* Release the reserved virtual space and return error */
+                RTL::BitMap::ClearBits(&PagedPoolAllocationMap, StartBit, Pages);
+                RTL::BitMap::ClearBit(&PagedPoolEndOfAllocationMap, StartBit + Pages - 1);
+                return Status;
+            }
+        }
+
+        /* Write the demand-zero PTE, physical page will be committed on first access */
+        MM::Paging::WritePte(PointerPte, DemandZeroPte);
+    }
+
+    /* Return the allocated virtual address */
+    *Memory = VirtualAddress;
+    return STATUS_SUCCESS;
 }
 
 /**
@@ -249,7 +455,7 @@ MM::Allocator::AllocatePages(IN MMPOOL_TYPE PoolType,
     {
         case NonPagedPool:
             /* Allocate non-paged pool */
-            return AllocateNonPagedPoolPages(Pages, Memory);
+            return AllocateNonPagedPoolPages(Pages, MM::Numa::GetCurrentNode(), Memory);
         case PagedPool:
             /* Allocate paged pool */
             return AllocatePagedPoolPages(Pages, Memory);
@@ -327,6 +533,17 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
         Bytes = 1;
     }
 
+    /* Check if the allocation tag has been selected for the guard page pool */
+    if(GuardPoolTag && (Tag & ~MM_POOL_PROTECTED) == GuardPoolTag)
+    {
+        /* Attempt to serve the allocation from the guard page pool */
+        if(AllocateGuardPool(PoolType, Bytes, Memory, Tag) == STATUS_SUCCESS)
+        {
+            /* Allocation succeeded, return success */
+            return STATUS_SUCCESS;
+        }
+    }
+
     /* Retrieve the specific pool descriptor based on the masked pool type */
     PoolDescriptor = PoolVector[PoolType & MM_POOL_TYPE_MASK];
 
@@ -365,6 +582,40 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
     /* Calculate the required block index */
     Index = (USHORT)((Bytes + sizeof(POOL_HEADER) + (MM_POOL_BLOCK_SIZE - 1)) / MM_POOL_BLOCK_SIZE);
 
+    /* Carve small blocks out of the pool descriptor of the current NUMA node */
+    PoolDescriptor = GetPoolDescriptor(PoolType);
+
+    /* Check if the request can be satisfied from the per-processor lookaside list */
+    if((PoolType & MM_POOL_TYPE_MASK) == NonPagedPool && Index <= MM_POOL_LOOKASIDE_LISTS)
+    {
+        /* Attempt to take a cached block of the exact size */
+        PoolEntry = AllocateLookasidePoolBlock(Index);
+        if(PoolEntry)
+        {
+            /* Update the active pool type */
+            PoolEntry->PoolType = PoolType + 1;
+
+            /* Update the statistical counters of the pool descriptor owning the block */
+            PoolDescriptor = GetPoolDescriptor(PoolEntry);
+            RTL::Atomic::ExchangeAdd64((PLONG_PTR)&PoolDescriptor->TotalBytes, (LONG_PTR)(Index * MM_POOL_BLOCK_SIZE));
+            RTL::Atomic::Increment32((PLONG)&PoolDescriptor->RunningAllocations);
+
+            /* Register the allocation in the tracking table */
+            RegisterAllocationTag(Tag, PoolEntry->BlockSize * MM_POOL_BLOCK_SIZE, PoolType);
+
+            /* Assign the specified identification tag */
+            PoolEntry->PoolTag = Tag;
+
+            /* Clear the internal list links */
+            (GetPoolFreeBlock(PoolEntry))->Flink = NULLPTR;
+            (GetPoolFreeBlock(PoolEntry))->Blink = NULLPTR;
+
+            /* Supply the allocated address and return success */
+            *Memory = GetPoolFreeBlock(PoolEntry);
+            return STATUS_SUCCESS;
+        }
+    }
+
     /* Resolve the appropriate list head for the calculated block index */
     ListHead = &PoolDescriptor->ListHeads[Index];
     while(ListHead != &PoolDescriptor->ListHeads[MM_POOL_LISTS_PER_PAGE])
@@ -375,7 +626,7 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
             /* Start a guarded code block */
             {
                 /* Acquire the pool lock */
-                PoolLockGuard PoolLock((MMPOOL_TYPE)(PoolDescriptor->PoolType & MM_POOL_TYPE_MASK));
+                PoolLockGuard PoolLock(PoolDescriptor);
 
                 /* Re-evaluate the list emptiness to prevent race conditions */
                 if(PoolListEmpty(ListHead))
@@ -404,6 +655,7 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
                         PoolRemainder = GetPoolBlock(PoolEntry, Index);
                         PoolRemainder->BlockSize = PoolEntry->BlockSize - Index;
                         PoolRemainder->PreviousSize = Index;
+                        PoolRemainder->PoolIndex = PoolEntry->PoolIndex;
 
                         /* Resolve the subsequent block and update its previous size field */
                         NextPoolEntry = GetPoolNextBlock(PoolRemainder);
@@ -422,6 +674,7 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
                         /* Advance the pointer to the new block and update its previous size */
                         PoolEntry = GetPoolNextBlock(PoolEntry);
                         PoolEntry->PreviousSize = PoolRemainder->BlockSize;
+                        PoolEntry->PoolIndex = PoolRemainder->PoolIndex;
 
                         /* Resolve the adjacent next block and adjust its previous size */
                         NextPoolEntry = GetPoolBlock(PoolEntry, Index);
@@ -478,7 +731,16 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
     }
 
     /* Allocate a new page to fulfill the request */
-    Status = AllocatePages(PoolType, MM_PAGE_SIZE, (PVOID *)&PoolEntry);
+    if((PoolType & MM_POOL_TYPE_MASK) == NonPagedPool)
+    {
+        /* Back the non-paged pool descriptor with a page of its own NUMA node */
+        Status = AllocateNonPagedPoolPages(1, PoolDescriptor->PoolIndex, (PVOID *)&PoolEntry);
+    }
+    else
+    {
+        /* Allocate a paged pool page */
+        Status = AllocatePages(PoolType, MM_PAGE_SIZE, (PVOID *)&PoolEntry);
+    }
     if(Status != STATUS_SUCCESS || !PoolEntry)
     {
         /* Allocation failed, clear the output pointer and return the error status */
@@ -489,6 +751,7 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
     /* Initialize the structural header */
     PoolEntry->Long = 0;
     PoolEntry->BlockSize = Index;
+    PoolEntry->PoolIndex = PoolDescriptor->PoolIndex;
     PoolEntry->PoolType = PoolType + 1;
 
     /* Calculate the block size of the remaining unused space */
@@ -498,6 +761,7 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
     PoolRemainder = GetPoolBlock(PoolEntry, Index);
     PoolRemainder->Long = 0;
     PoolRemainder->BlockSize = BlockSize;
+    PoolRemainder->PoolIndex = PoolDescriptor->PoolIndex;
     PoolRemainder->PreviousSize = Index;
 
     /* Update the pool descriptor statistical counters */
@@ -508,7 +772,7 @@ MM::Allocator::AllocatePool(IN MMPOOL_TYPE PoolType,
     if(PoolRemainder->BlockSize != 1)
     {
         /* Acquire the pool lock */
-        PoolLockGuard PoolLock((MMPOOL_TYPE)(PoolDescriptor->PoolType & MM_POOL_TYPE_MASK));
+        PoolLockGuard PoolLock(PoolDescriptor);
 
         /* Validate the target free list structure */
         VerifyPoolLinks(&PoolDescriptor->ListHeads[BlockSize - 1]);
@@ -594,26 +858,72 @@ MM::Allocator::ComputeHash(IN ULONG Tag,
 }
 
 /**
- * Expands the big allocation tracking table to accommodate additional large allocations.
+ * Prints the pool tag statistics to the kernel debugger.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Allocator::DumpPoolTagStatistics(VOID)
+{
+    POOL_TAG_STATISTICS Statistics;
+    ULONG Index;
+
+    /* Print the table header */
+    DebugPrint(L"Pool tag statistics:\n"
+               L"Tag   NP Allocs  NP Frees   NP Bytes   NP Peak    P Allocs   P Frees    P Bytes    P Peak\n");
+
+    /* Iterate through all tracked tags */
+    for(Index = 0; Index < AllocationsTrackingTableSize + AllocationsTrackingExpansionTableSize; Index++)
+    {
+        /* Merge the statistics of the tag */
+        if(!GetTagStatistics(Index, &Statistics))
+        {
+            /* Slot not in use, skip it */
+            continue;
+        }
+
+        /* Print the tag statistics */
+        DebugPrint(L"%c%c%c%c  %-10ld %-10ld %-10zu %-10zu %-10ld %-10ld %-10zu %zu\n",
+                   (WCHAR)(Statistics.Tag & 0xFF), (WCHAR)((Statistics.Tag >> 8) & 0xFF),
+                   (WCHAR)((Statistics.Tag >> 16) & 0xFF), (WCHAR)((Statistics.Tag >> 24) & 0xFF),
+                   Statistics.NonPagedAllocations, Statistics.NonPagedFrees,
+                   Statistics.NonPagedBytes, Statistics.NonPagedPeakBytes,
+                   Statistics.PagedAllocations, Statistics.PagedFrees,
+                   Statistics.PagedBytes, Statistics.PagedPeakBytes);
+    }
+}
+
+/**
+ * Expands a big allocation tracking table shard to accommodate additional large allocations.
+ *
+ * @param Shard
+ *        Supplies a pointer to the tracking table shard to expand.
  *
  * @return This routine returns TRUE if the table was successfully expanded, FALSE otherwise.
  *
  * @since XT 1.0
+ *
+ * @note The new table is published immediately, while the live entries are moved over incrementally
+ *       by subsequent insertions, so expansion never stalls the lock-free lookups.
  */
 XTAPI
 BOOLEAN
-MM::Allocator::ExpandBigAllocationsTable(VOID)
+MM::Allocator::ExpandBigAllocationsTable(IN PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard)
 {
-    PPOOL_TRACKING_BIG_ALLOCATIONS NewTable, OldTable;
+    PPOOL_TRACKING_BIG_ALLOCATIONS NewTable, ReleasedTable;
     SIZE_T AllocationBytes, OldSize, NewSize;
-    ULONG Hash, HashMask, Index;
-    PFN_NUMBER PagesFreed;
     XTSTATUS Status;
-    BOOLEAN Abort;
+    BOOLEAN Abort, Expanded;
+    ULONG Index;
 
-    /* Initialize the abort flag and snapshot current table capacity */
+    /* Initialize the state flags and snapshot current table capacity */
     Abort = FALSE;
-    OldSize = BigAllocationsTrackingTableSize;
+    Expanded = TRUE;
+    ReleasedTable = NULLPTR;
+    OldSize = Shard->TableSize;
 
     /* Check if doubling the size would cause an integer overflow */
     if(OldSize > ((~(SIZE_T)0) / 2))
@@ -626,7 +936,7 @@ MM::Allocator::ExpandBigAllocationsTable(VOID)
     NewSize = OldSize * 2;
 
     /* Ensure the new capacity does not result in fractional memory pages */
-    NewSize = ROUND_DOWN(NewSize, MM_PAGE_SIZE / sizeof(POOL_TRACKING_BIG_ALLOCATIONS));
+    NewSize = ROUND_UP(NewSize, MM_PAGE_SIZE / sizeof(POOL_TRACKING_BIG_ALLOCATIONS));
 
     /* Check if calculating the total byte size would cause an integer overflow */
     if(NewSize > ((~(SIZE_T)0) / sizeof(POOL_TRACKING_BIG_ALLOCATIONS)))
@@ -658,73 +968,332 @@ MM::Allocator::ExpandBigAllocationsTable(VOID)
 
     /* Start a guarded code block */
     {
-        /* Acquire the tracking table lock and raise runlevel to DISPATCH level */
+        /* Acquire the shard lock and raise runlevel to DISPATCH level */
         KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-        KE::SpinLockGuard TrackingTableLock(&BigAllocationsTrackingTableLock);
+        KE::SpinLockGuard ShardLock(&Shard->Lock);
+
+        /* Finish any migration still in progress, as only a single table can be drained at a time */
+        if(Shard->MigrationTable)
+        {
+            /* Move all remaining entries into the current table */
+            MigrateBigAllocations(Shard, (SIZE_T)~0);
+        }
+
+        /* Check if a previously retired table is no longer visible to any lock-free lookup */
+        if(Shard->RetiredTable && !Shard->Readers)
+        {
+            /* Detach the retired table, it will be released once the lock is dropped */
+            ReleasedTable = Shard->RetiredTable;
+            Shard->RetiredTable = NULLPTR;
+        }
 
         /* Verify if another thread has already expanded the table concurrently */
-        if(BigAllocationsTrackingTableSize >= NewSize)
+        if(Shard->TableSize >= NewSize)
         {
             /* Another thread has already expanded the table, discard changes */
             Abort = TRUE;
         }
-        else
+        else if(Shard->RetiredTable)
         {
-            /* Cache the legacy table pointer and calculate new hash mask */
-            HashMask = NewSize - 1;
-            OldTable = BigAllocationsTrackingTable;
-
-            /* Rehash and migrate all active entries from the old table */
-            for(Index = 0; Index < OldSize; Index++)
-            {
-                /* Bypass unallocated entries in the legacy table */
-                if((ULONG_PTR)OldTable[Index].VirtualAddress & MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE)
-                {
-                    /* Skip to the next entry */
-                    continue;
-                }
-
-                /* Compute the updated hash index */
-                Hash = ComputeHash(OldTable[Index].VirtualAddress) & HashMask;
+            /* Lookups are still walking the retired table, it cannot be replaced yet */
+            Abort = TRUE;
+            Expanded = FALSE;
+        }
+        else
+        {
+            /* Mark the shard tables as being updated */
+            RTL::Atomic::Increment32(&Shard->Generation);
 
-                /* Resolve hash collisions using linear probing */
-                while(!((ULONG_PTR)NewTable[Hash].VirtualAddress & MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE))
-                {
-                    /* Advance the bucket index and check for table boundary overflow */
-                    if(++Hash == NewSize)
-                    {
-                        /* Wrap the probing index back to the beginning */
-                        Hash = 0;
-                    }
-                }
+            /* Turn the current table into the migration source and publish the new table */
+            Shard->MigrationTable = Shard->Table;
+            Shard->MigrationTableSize = Shard->TableSize;
+            Shard->MigrationIndex = 0;
+            Shard->Table = NewTable;
+            Shard->TableSize = NewSize;
 
-                /* Migrate the active entry to its new hash bucket */
-                NewTable[Hash] = OldTable[Index];
-            }
+            /* Mark the shard tables update as completed */
+            RTL::Atomic::Increment32(&Shard->Generation);
 
-            /* Activate the newly populated table globally */
-            BigAllocationsTrackingTable = NewTable;
-            BigAllocationsTrackingTableHash = NewSize - 1;
-            BigAllocationsTrackingTableSize = NewSize;
+            /* Move the first batch of entries into the new table */
+            MigrateBigAllocations(Shard, MM_POOL_BIG_ALLOCATIONS_MIGRATION_BATCH);
         }
     }
 
-    /* Check if another thread has already expanded the table concurrently */
+    /* Check if a retired table has been detached */
+    if(ReleasedTable)
+    {
+        /* Free memory allocated for the retired table */
+        FreeBigAllocationsTable(ReleasedTable);
+    }
+
+    /* Check if the new table has not been published */
     if(Abort)
     {
         /* Free memory allocated for the new table and return */
         FreePages(NewTable);
-        return TRUE;
+        return Expanded;
     }
 
-    /* Free memory allocated for the legacy table */
-    FreePages(OldTable, &PagesFreed);
-
     /* Update the pool tracking statistics */
-    UnregisterAllocationTag(SIGNATURE32('M', 'M', 'g', 'r'), PagesFreed << MM_PAGE_SHIFT, (MMPOOL_TYPE)0);
-    RegisterAllocationTag(SIGNATURE32('M', 'M', 'g', 'r'), ROUND_UP(NewSize, MM_PAGE_SIZE), (MMPOOL_TYPE)0);
+    RegisterAllocationTag(SIGNATURE32('M', 'M', 'g', 'r'), AllocationBytes, (MMPOOL_TYPE)0);
+
+    /* Return success */
+    return TRUE;
+}
+
+/**
+ * Expands the non-paged pool by mapping new physical pages into the non-paged pool expansion area.
+ *
+ * @param Pages
+ *        Specifies the number of pages to allocate.
+ *
+ * @param Node
+ *        Supplies the preferred NUMA node of the physical pages backing the allocation.
+ *
+ * @param Memory
+ *        Supplies a pointer to the allocated pool of pages.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::ExpandNonPagedPool(IN PFN_COUNT Pages,
+                                  IN ULONG Node,
+                                  OUT PVOID *Memory)
+{
+    PMMPTE PointerPte;
+    MMPTE ValidPte;
+    PMMPFN Pfn;
+
+    /* Try to expand the pool by reserving system PTEs */
+    PointerPte = MM::Pte::ReserveSystemPtes(Pages, NonPagedPoolExpansion);
+    if(PointerPte == NULLPTR)
+    {
+        /* PTE reservation failed, return insufficient resources */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Acquire the Non-Paged pool lock and raise runlevel to DISPATCH level */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::QueuedSpinLockGuard NonPagedPoolSpinLock(NonPagedPoolLock);
+
+    /* Check if there are enough available physical pages to back the allocation */
+    if(Pages >= MM::Pfn::GetAvailablePages())
+    {
+        /* Not enough physical pages, release the reserved system PTEs */
+        MM::Pte::ReleaseSystemPtes(PointerPte, Pages, NonPagedPoolExpansion);
+
+        /* Return failure due to insufficient resources */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Account the pool expansion */
+    MM::Statistics::IncrementCounter(PoolExpansions);
+
+    /* Map the allocation with physical pages acquired in bulk */
+    ValidPte = *MM::Pte::GetValidPte();
+    if(MM::Pfn::AllocateMappedPages(PointerPte, Pages, Node, &ValidPte) != STATUS_SUCCESS)
+    {
+        /* Out of physical pages, release the reserved system PTEs and return failure */
+        MM::Pte::ReleaseSystemPtes(PointerPte, Pages, NonPagedPoolExpansion);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Get the PFN entry for the last page of the allocation */
+    Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(MM::Paging::AdvancePte(PointerPte, Pages - 1)));
+
+    /* Dnote allocation boundaries */
+    Pfn->u3.e1.WriteInProgress = 1;
+
+    /* Get the PFN entry for the first page of the allocation */
+    Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
+
+    /* Denote allocation boundaries */
+    Pfn->u3.e1.ReadInProgress = 1;
+
+    /* Convert the PTE address to the virtual address and store in the buffer */
+    *Memory = MM::Paging::GetPteVirtualAddress(PointerPte);
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Requests all processors to return the blocks cached in their pool lookaside lists back to the pool descriptors.
+ * The lookaside lists of the current processor are drained immediately.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Lookaside lists are not interlocked, thus other processors drain their own lists, when they notice
+ *       the request on the next freed block or in their idle loop.
+ */
+XTAPI
+VOID
+MM::Allocator::FlushLookasideLists(VOID)
+{
+    /* Publish a new flush request to all processors */
+    RTL::Atomic::Increment32((PLONG)&LookasideFlushGeneration);
+
+    /* Drain the lookaside lists of the current processor */
+    TrimLookasideLists();
+}
+
+/**
+ * Releases the memory backing a retired big allocation tracking table.
+ *
+ * @param Table
+ *        Supplies a pointer to the tracking table to release.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Allocator::FreeBigAllocationsTable(IN PPOOL_TRACKING_BIG_ALLOCATIONS Table)
+{
+    PFN_NUMBER PagesFreed;
+
+    /* Free memory allocated for the table */
+    if(FreePages(Table, &PagesFreed) == STATUS_SUCCESS)
+    {
+        /* Update the pool tracking statistics */
+        UnregisterAllocationTag(SIGNATURE32('M', 'M', 'g', 'r'), PagesFreed << MM_PAGE_SHIFT, (MMPOOL_TYPE)0);
+    }
+}
+
+/**
+ * Frees a pool block allocated from the guard page pool, verifying the pattern in front of the block.
+ *
+ * @param VirtualAddress
+ *        Supplies the address of the pool block to free.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::FreeGuardPool(IN PVOID VirtualAddress)
+{
+    PPOOL_HEADER PoolEntry;
+    MMPOOL_TYPE PoolType;
+    PUCHAR BaseAddress;
+    ULONG_PTR StartBit;
+    PFN_COUNT Pages;
+    PUCHAR Pattern;
+    PMMPTE BasePte;
+    ULONG Tag;
+
+    /* Resolve the pool header and the first page of the block */
+    PoolEntry = (PPOOL_HEADER)VirtualAddress - 1;
+    BaseAddress = (PUCHAR)PAGE_ALIGN(PoolEntry);
+    Pages = PoolEntry->BlockSize;
+
+    /* Make sure the block is mapped and its header describes the pages ending right at the guard page */
+    if(Pages == 0 || !GuardPoolAddress(BaseAddress + ((SIZE_T)Pages << MM_PAGE_SHIFT)) ||
+       !MM::Paging::PteValid(MM::Paging::GetPteAddress(BaseAddress)) ||
+       MM::Paging::PteValid(MM::Paging::GetPteAddress(BaseAddress + ((SIZE_T)Pages << MM_PAGE_SHIFT))))
+    {
+        /* Corrupted guard page pool header, kernel panic */
+        KE::Crash::Panic(0xC1, (ULONG_PTR)VirtualAddress, (ULONG_PTR)BaseAddress, Pages, 0x20);
+    }
+
+    /* Determine the pool type and verify run level for it */
+    PoolType = (MMPOOL_TYPE)((PoolEntry->PoolType - 1) & MM_POOL_TYPE_MASK);
+    VerifyRunLevel(PoolType, 0, VirtualAddress);
+
+    /* Verify the pattern in front of the block */
+    for(Pattern = BaseAddress; Pattern < (PUCHAR)PoolEntry; Pattern++)
+    {
+        /* Check if the pattern has been overwritten */
+        if(*Pattern != MM_POOL_GUARD_PATTERN)
+        {
+            /* Buffer underrun detected, kernel panic */
+            KE::Crash::Panic(0xC1, (ULONG_PTR)VirtualAddress, (ULONG_PTR)Pattern, *Pattern, 0x21);
+        }
+    }
+
+    /* Remove the allocation from the tracking table */
+    Tag = PoolEntry->PoolTag & ~MM_POOL_PROTECTED;
+    UnregisterAllocationTag(Tag, (SIZE_T)Pages << MM_PAGE_SHIFT, PoolType);
+
+    /* Get the first PTE of the block and its index within the guard page pool */
+    BasePte = MM::Paging::GetPteAddress(BaseAddress);
+    StartBit = ((ULONG_PTR)BaseAddress - (ULONG_PTR)GuardPoolStart) >> MM_PAGE_SHIFT;
+
+    /* Clear the PTEs of the block, so that any use after free faults, and return its physical pages */
+    MM::Pfn::FreeMappedPages(BasePte, Pages);
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the guard page pool lock and raise runlevel to DISPATCH level */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard GuardPoolSpinLock(&GuardPoolLock);
+
+        /* Release the PTEs, including the guard page */
+        RTL::BitMap::ClearBits(&GuardPoolBitMap, StartBit, Pages + 1);
+    }
 
     /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Caches a freed pool block in the current processor's lookaside list.
+ *
+ * @param PoolEntry
+ *        Supplies a pointer to the header of the pool block being freed.
+ *
+ * @return This routine returns TRUE if the block has been cached, or FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::Allocator::FreeLookasidePoolBlock(IN PPOOL_HEADER PoolEntry)
+{
+    PMMPOOL_LOOKASIDE_LIST LookasideList;
+
+    /* Check if the system is running low on memory */
+    if(MM::Pfn::GetAvailablePages() < MM_POOL_LOOKASIDE_LOW_MEMORY_PAGES)
+    {
+        /* Return all cached blocks on every processor, so that empty pool pages can be released */
+        FlushLookasideLists();
+        return FALSE;
+    }
+
+    /* Return all cached blocks, if flushing the lookaside lists has been requested by another processor */
+    TrimLookasideLists();
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Check if the block has been carved out for a remote NUMA node */
+    if(PoolEntry->PoolIndex != MM::Numa::GetCurrentNode())
+    {
+        /* Return the block to its own node's pool descriptor instead */
+        return FALSE;
+    }
+
+    /* Get the lookaside list for the block size */
+    LookasideList = &KE::Processor::GetCurrentProcessorControlBlock()->PoolLookasideList[PoolEntry->BlockSize - 1];
+
+    /* Check if the lookaside list is already full */
+    LookasideList->TotalFrees++;
+    if(LookasideList->ListHead.Depth >= LookasideList->Depth)
+    {
+        /* List is full, count a miss */
+        LookasideList->FreeMisses++;
+        return FALSE;
+    }
+
+    /* Cache the block in the lookaside list */
+    RTL::SinglyList::InsertHeadList(&LookasideList->ListHead, (PSINGLE_LIST_ENTRY)GetPoolFreeBlock(PoolEntry));
     return TRUE;
 }
 
@@ -749,17 +1318,13 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
     PMMFREE_POOL_ENTRY FreePage, NextPage, LastPage;
     PMMMEMORY_LAYOUT MemoryLayout;
     PFN_COUNT FreePages, Pages;
-    PFN_NUMBER PageFrameNumber;
     PMMPFN Pfn, FirstPfn;
-    PMMPTE PointerPte;
-    ULONG Index;
 
     /* Retrieve memory layout */
     MemoryLayout = MM::Manager::GetMemoryLayout();
 
-    /* Get the first PTE of the allocation */
-    PointerPte = MM::Paging::GetPteAddress(VirtualAddress);
-    Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
+    /* Get the PFN entry for the first page of the allocation */
+    Pfn = MM::Pfn::GetPfnEntry(MM::Pte::GetMappedPageFrame(VirtualAddress));
 
     /* Verify that the address is within the non-paged pool */
     if((VirtualAddress < MemoryLayout->NonPagedPoolStart ||
@@ -785,9 +1350,9 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
     /* Seek to the end of the allocation */
     while(Pfn->u3.e1.WriteInProgress == 0)
     {
-        /* Get the next PTE and its PFN */
-        PointerPte = MM::Paging::GetNextPte(PointerPte);
-        Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
+        /* Get the PFN for the next page */
+        Pfn = MM::Pfn::GetPfnEntry(MM::Pte::GetMappedPageFrame((PVOID)((ULONG_PTR)VirtualAddress +
+                                                                       (Pages << MM_PAGE_SHIFT))));
 
         /* Increment the page count */
         Pages++;
@@ -810,27 +1375,8 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
         /* Check if the allocation spans more than 3 pages and should be reclaimed */
         if(Pages > 3)
         {
-            /* Get the first PTE of the allocation and iterate over all pages */
-            PointerPte = MM::Paging::GetPteAddress(VirtualAddress);
-            for(Index = 0; Index < Pages; Index++)
-            {
-                /* Get the page frame number from the PTE */
-                PageFrameNumber = MM::Paging::GetPageFrameNumber(PointerPte);
-                Pfn = MM::Pfn::GetPfnEntry(PageFrameNumber);
-
-                /* Clear PFN shared count and mark the PFN as ready for removal */
-                Pfn->u2.ShareCount = 0;
-                Pfn->PteAddress = (PMMPTE)((ULONG_PTR)Pfn->PteAddress | 0x1);
-
-                /* Decrement the reference count of the page table */
-                MM::Pfn::DecrementReferenceCount(Pfn, PageFrameNumber, FALSE);
-
-                /* Invalidate the PTE */
-                MM::Paging::ClearPte(PointerPte);
-
-                /* Get the next PTE */
-                PointerPte = MM::Paging::GetNextPte(PointerPte);
-            }
+            /* Unmap all pages of the allocation and return them to the per-processor page magazine */
+            MM::Pfn::FreeMappedPages(MM::Paging::GetPteAddress(VirtualAddress), Pages);
 
             /* Release reserved system PTEs back to the pool */
             MM::Pte::ReleaseSystemPtes(MM::Paging::GetPteAddress(VirtualAddress), Pages, NonPagedPoolExpansion);
@@ -847,9 +1393,6 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
         }
     }
 
-    /* Get the next PTE */
-    PointerPte = MM::Paging::GetNextPte(PointerPte);
-
     /* Check if the end of the initial nonpaged pool has been reached */
     if(Pfn - MemoryLayout->PfnDatabase == NonPagedPoolFrameEnd)
     {
@@ -858,17 +1401,9 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
     }
     else
     {
-        /* Check if the PTE is valid */
-        if(MM::Paging::PteValid(PointerPte))
-        {
-            /* Get the PFN entry for the page laying in either the expansion or initial non-paged pool */
-            Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
-        }
-        else
-        {
-            /* Ignore the last page of the non-paged expansion pool */
-            Pfn = NULLPTR;
-        }
+        /* Get the PFN entry for the page laying in either the expansion or initial non-paged pool, if mapped */
+        Pfn = MM::Pfn::GetPfnEntry(MM::Pte::GetMappedPageFrame((PVOID)((ULONG_PTR)VirtualAddress +
+                                                                       (Pages << MM_PAGE_SHIFT))));
     }
 
     /* Check if the adjacent physical page following the allocation is free */
@@ -880,8 +1415,8 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
         /* Absorb the adjacent free block's pages into the current free page count */
         FreePages += FreePage->Size;
 
-        /* Unlink the adjacent free block from its current segregated free list */
-        RTL::LinkedList::RemoveEntryList(&FreePage->List);
+        /* Unlink the adjacent free block from its current size class free list */
+        RemoveFreePageRun(FreePage);
     }
 
     /* Get the free pool entry structure from the list entry */
@@ -895,20 +1430,8 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
     }
     else
     {
-        /* Calculate the PTE address for the page immediately preceding the allocation */
-        PointerPte = MM::Paging::AdvancePte(PointerPte, -Pages - 1);
-
-        /* Check if the PTE is valid */
-        if(MM::Paging::PteValid(PointerPte))
-        {
-            /* Get the PFN entry for the page laying in either the expansion or initial nonpaged pool */
-            Pfn = MM::Pfn::GetPfnEntry(MM::Paging::GetPageFrameNumber(PointerPte));
-        }
-        else
-        {
-            /* Ignore the first page of the expansion nonpaged pool */
-            Pfn = NULLPTR;
-        }
+        /* Get the PFN entry for the page immediately preceding the allocation, if mapped */
+        Pfn = MM::Pfn::GetPfnEntry(MM::Pte::GetMappedPageFrame((PVOID)((ULONG_PTR)VirtualAddress - MM_PAGE_SIZE)));
     }
 
     /* Check if the adjacent physical page preceding the allocation is free */
@@ -918,26 +1441,14 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
         FreePage = (PMMFREE_POOL_ENTRY)((ULONG_PTR)VirtualAddress - MM_PAGE_SIZE);
         FreePage = FreePage->Owner;
 
-        /* Check if the allocation is small enough */
-        if(FreePage->Size < MM_MAX_FREE_PAGE_LIST_HEADS)
-        {
-            /* Remove the entry from the list */
-            RTL::LinkedList::RemoveEntryList(&FreePage->List);
-
-            /* Adjust the size of the free block to account for the allocated pages */
-            FreePage->Size += FreePages;
+        /* Remove the entry from its current size class free list */
+        RemoveFreePageRun(FreePage);
 
-            /* Calculate the new list index */
-            Index = MIN(FreePage->Size, MM_MAX_FREE_PAGE_LIST_HEADS) - 1;
+        /* Adjust the size of the free block to account for the allocated pages */
+        FreePage->Size += FreePages;
 
-            /* Insert the entry into the head of the list */
-            RTL::LinkedList::InsertHeadList(&NonPagedPoolFreeList[Index], &FreePage->List);
-        }
-        else
-        {
-            /* Adjust the size of the free block to account for the allocated pages */
-            FreePage->Size += FreePages;
-        }
+        /* Insert the entry into the free list matching its new size */
+        InsertFreePageRun(FreePage);
     }
 
     /* Check if backward coalescing failed, requiring the freed block to become a new list head */
@@ -946,11 +1457,8 @@ MM::Allocator::FreeNonPagedPoolPages(IN PVOID VirtualAddress,
         /* Adjust the size of the free block to account for the allocated pages */
         FreePage->Size = FreePages;
 
-        /* Calculate the new list index */
-        Index = MIN(FreePage->Size, MM_MAX_FREE_PAGE_LIST_HEADS) - 1;
-
-        /* Insert the entry into the head of the list */
-        RTL::LinkedList::InsertHeadList(&NonPagedPoolFreeList[Index], &FreePage->List);
+        /* Insert the entry into the free list matching its size */
+        InsertFreePageRun(FreePage);
     }
 
     /* Calculate the start and end boundaries for updating the owner pointers */
@@ -993,55 +1501,134 @@ XTAPI
 XTSTATUS
 MM::Allocator::FreePagedPoolPages(IN PVOID VirtualAddress,
                                   OUT PPFN_NUMBER PagesFreed)
-{
-    UNIMPLEMENTED;
-
-    /* Return not implemented status code */
-    return STATUS_NOT_IMPLEMENTED;
-}
-
-/**
- * Frees a previously allocated block of pages.
- *
- * @param VirtualAddress
- *        Supplies the base virtual address of the pages allocation to free.
- *
- * @return This routine returns a status code.
- *
- * @since XT 1.0
- */
-XTAPI
-XTSTATUS
-MM::Allocator::FreePages(IN PVOID VirtualAddress)
-{
-    return FreePages(VirtualAddress, NULLPTR);
-}
-
-/**
- * Frees a previously allocated block of pages.
- *
- * @param VirtualAddress
- *        Supplies the base virtual address of the pages allocation to free.
- *
- * @param PagesFreed
- *        Supplies a pointer to a variable that will receive the number of pages freed.
- *
- * @return This routine returns a status code.
- *
- * @since XT 1.0
- */
-XTAPI
-XTSTATUS
-MM::Allocator::FreePages(IN PVOID VirtualAddress,
-                         OUT PPFN_NUMBER PagesFreed)
 {
     PMMMEMORY_LAYOUT MemoryLayout;
+    ULONG_PTR StartBit;
+    PMMPTE PointerPte;
+    PFN_COUNT Pages;
+    ULONG Index;
 
     /* Retrieve memory layout */
     MemoryLayout = MM::Manager::GetMemoryLayout();
 
-    /* Check if the address is in the paged pool */
-    if(VirtualAddress >= MemoryLayout->PagedPoolStart && VirtualAddress < MemoryLayout->PagedPoolEnd)
+    /* Get the index of the first page of the allocation */
+    StartBit = ((ULONG_PTR)VirtualAddress - (ULONG_PTR)MemoryLayout->PagedPoolStart) >> MM_PAGE_SHIFT;
+
+    /* Basic sanity check to prevent double-frees or freeing unallocated memory */
+    if(((ULONG_PTR)VirtualAddress & MM_PAGE_MASK) || StartBit >= PagedPoolAllocationMap.Size ||
+       !RTL::BitMap::TestBit(&PagedPoolAllocationMap, StartBit) ||
+       (StartBit && RTL::BitMap::TestBit(&PagedPoolAllocationMap, StartBit - 1) &&
+        !RTL::BitMap::TestBit(&PagedPoolEndOfAllocationMap, StartBit - 1)))
+    {
+        /* Address is not an allocation head, raise kernel panic */
+        KE::Crash::Panic(0xC2, 0x41, (ULONG_PTR)VirtualAddress, StartBit, 0);
+    }
+
+    /* Seek to the end of the allocation */
+    Pages = 1;
+    while(!RTL::BitMap::TestBit(&PagedPoolEndOfAllocationMap, StartBit + Pages - 1))
+    {
+        /* Increment the page count */
+        Pages++;
+    }
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the PFN database lock and raise runlevel to DISPATCH level */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::QueuedSpinLockGuard SpinLock(PfnLock);
+
+        /* Loop through each page of the allocation */
+        PointerPte = MM::Paging::GetPteAddress(VirtualAddress);
+        for(Index = 0; Index < Pages; Index++)
+        {
+            /* Check if the page has ever been touched and thus is backed by a physical page */
+            if(MM::Paging::PteValid(PointerPte))
+            {
+                /* Free the physical page */
+                MM::Pfn::FreePhysicalPage(PointerPte);
+            }
+
+            /* Clear the PTE, so that any further access faults */
+            MM::Paging::ClearPte(PointerPte);
+            PointerPte = MM::Paging::GetNextPte(PointerPte);
+        }
+    }
+
+    /* Invalidate the allocation translations on all processors */
+    MM::Tlb::FlushRange(VirtualAddress, Pages);
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the paged pool lock and raise runlevel to DISPATCH level */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard PagedPoolSpinLock(&PagedPoolLock);
+
+        /* Release the virtual space */
+        RTL::BitMap::ClearBits(&PagedPoolAllocationMap, StartBit, Pages);
+        RTL::BitMap::ClearBit(&PagedPoolEndOfAllocationMap, StartBit + Pages - 1);
+
+        /* Move the hint back, to keep the paged pool compact */
+        if(StartBit < PagedPoolHint)
+        {
+            /* Start the next search from the released space */
+            PagedPoolHint = StartBit;
+        }
+    }
+
+    /* Check if a page count was requested */
+    if(PagesFreed != NULLPTR)
+    {
+        /* Return the number of pages freed */
+        *PagesFreed = Pages;
+    }
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Frees a previously allocated block of pages.
+ *
+ * @param VirtualAddress
+ *        Supplies the base virtual address of the pages allocation to free.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::FreePages(IN PVOID VirtualAddress)
+{
+    return FreePages(VirtualAddress, NULLPTR);
+}
+
+/**
+ * Frees a previously allocated block of pages.
+ *
+ * @param VirtualAddress
+ *        Supplies the base virtual address of the pages allocation to free.
+ *
+ * @param PagesFreed
+ *        Supplies a pointer to a variable that will receive the number of pages freed.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::FreePages(IN PVOID VirtualAddress,
+                         OUT PPFN_NUMBER PagesFreed)
+{
+    PMMMEMORY_LAYOUT MemoryLayout;
+
+    /* Retrieve memory layout */
+    MemoryLayout = MM::Manager::GetMemoryLayout();
+
+    /* Check if the address is in the paged pool */
+    if(VirtualAddress >= MemoryLayout->PagedPoolStart && VirtualAddress < MemoryLayout->PagedPoolEnd)
     {
         /* Free pages from the paged pool */
         return FreePagedPoolPages(VirtualAddress, PagesFreed);
@@ -1089,14 +1676,20 @@ XTSTATUS
 MM::Allocator::FreePool(IN PVOID VirtualAddress,
                         IN ULONG Tag)
 {
-    PPOOL_HEADER PoolEntry, NextPoolEntry;
     PFN_NUMBER PageCount, RealPageCount;
     PPOOL_DESCRIPTOR PoolDescriptor;
+    PPOOL_HEADER PoolEntry;
     MMPOOL_TYPE PoolType;
     USHORT BlockSize;
-    BOOLEAN Combined;
     XTSTATUS Status;
 
+    /* Check if the allocation has been served from the guard page pool */
+    if(GuardPoolAddress(VirtualAddress))
+    {
+        /* Free the guard page pool block */
+        return FreeGuardPool(VirtualAddress);
+    }
+
     /* Determine if the allocation is page-aligned */
     if(PAGE_ALIGN(VirtualAddress) == VirtualAddress)
     {
@@ -1149,16 +1742,15 @@ MM::Allocator::FreePool(IN PVOID VirtualAddress,
     /* Extract the structural block size from the pool header */
     BlockSize = PoolEntry->BlockSize;
 
-    /* Determine the underlying pool type and resolve its corresponding pool descriptor */
+    /* Determine the underlying pool type and resolve the pool descriptor owning the block */
     PoolType = (MMPOOL_TYPE)((PoolEntry->PoolType - 1) & MM_POOL_TYPE_MASK);
-    PoolDescriptor = PoolVector[PoolType];
+    PoolDescriptor = GetPoolDescriptor(PoolEntry);
 
     /* Verify run level for the specified pool */
     VerifyRunLevel(PoolType, 0, VirtualAddress);
 
-    /* Extract the allocation identifying tag and initialize the consolidation flag */
+    /* Extract the allocation identifying tag */
     Tag = PoolEntry->PoolTag;
-    Combined = FALSE;
 
     /* Check if the allocation tag carries the protected pool modifier */
     if(Tag & MM_POOL_PROTECTED)
@@ -1170,15 +1762,59 @@ MM::Allocator::FreePool(IN PVOID VirtualAddress,
     /* Remove the allocation from the tracking table */
     UnregisterAllocationTag(Tag, BlockSize * MM_POOL_BLOCK_SIZE, (MMPOOL_TYPE)(PoolEntry->PoolType - 1));
 
-    /* Locate the adjacent forward pool block */
-    NextPoolEntry = GetPoolBlock(PoolEntry, BlockSize);
-
-    /* Update the pool descriptor statistical counters */
+    /* Update the pool descriptor statistical counters, as the block is no longer in use even if it gets cached */
     RTL::Atomic::Increment32((PLONG)&PoolDescriptor->RunningFrees);
     RTL::Atomic::ExchangeAdd64((PLONG_PTR)&PoolDescriptor->TotalBytes, (LONG_PTR)(-BlockSize * MM_POOL_BLOCK_SIZE));
 
+    /* Check if the block is small enough to be cached in the per-processor lookaside list */
+    if(PoolType == NonPagedPool && BlockSize <= MM_POOL_LOOKASIDE_LISTS)
+    {
+        /* Attempt to cache the block for a subsequent allocation of the same size */
+        if(FreeLookasidePoolBlock(PoolEntry))
+        {
+            /* Block cached, return success */
+            return STATUS_SUCCESS;
+        }
+    }
+
+    /* Return the block back to the pool descriptor */
+    return FreePoolBlock(PoolDescriptor, PoolEntry);
+}
+
+/**
+ * Returns a pool block back to the free lists of its pool descriptor, coalescing it with adjacent free blocks.
+ *
+ * @param PoolDescriptor
+ *        Supplies a pointer to the pool descriptor owning the block.
+ *
+ * @param PoolEntry
+ *        Supplies a pointer to the header of the pool block being freed.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note The pool descriptor statistics are updated by the caller, when the block is freed, so that blocks returned
+ *       from the lookaside lists later on are not accounted twice.
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::FreePoolBlock(IN PPOOL_DESCRIPTOR PoolDescriptor,
+                             IN PPOOL_HEADER PoolEntry)
+{
+    PPOOL_HEADER NextPoolEntry;
+    USHORT BlockSize;
+    BOOLEAN Combined;
+
+    /* Extract the structural block size from the pool header and initialize the consolidation flag */
+    BlockSize = PoolEntry->BlockSize;
+    Combined = FALSE;
+
+    /* Locate the adjacent forward pool block */
+    NextPoolEntry = GetPoolBlock(PoolEntry, BlockSize);
+
     /* Acquire the pool lock */
-    PoolLockGuard PoolLock((MMPOOL_TYPE)(PoolDescriptor->PoolType & MM_POOL_TYPE_MASK));
+    PoolLockGuard PoolLock(PoolDescriptor);
 
     /* Validate the structural integrity of the base block */
     VerifyPoolBlocks(PoolEntry);
@@ -1279,6 +1915,109 @@ MM::Allocator::FreePool(IN PVOID VirtualAddress,
     return STATUS_SUCCESS;
 }
 
+/**
+ * Merges the statistics of a single pool tag from all processor tracking tables.
+ *
+ * @param Index
+ *        Supplies the tracking table slot. Slots past the end of the tracking table refer to the expansion table.
+ *
+ * @param Statistics
+ *        Supplies a pointer to a structure that receives the merged statistics.
+ *
+ * @return This routine returns TRUE if the slot tracks a pool tag, FALSE otherwise.
+ *
+ * @since XT 1.0
+ *
+ * @note Counters are read without locking out allocations, so a snapshot taken under load reflects the allocations
+ *       completed at the time each processor table was visited. Peak usage is the highest value seen by snapshots.
+ */
+XTAPI
+BOOLEAN
+MM::Allocator::GetTagStatistics(IN ULONG Index,
+                                OUT PPOOL_TAG_STATISTICS Statistics)
+{
+    PPOOL_TRACKING_TABLE CpuEntry, Entry;
+    ULONG Processor;
+
+    /* Check if the slot belongs to the expansion table */
+    if(Index >= AllocationsTrackingTableSize)
+    {
+        /* Acquire the tracking table lock */
+        KE::SpinLockGuard TrackingTableLock(&AllocationsTrackingTableLock);
+
+        /* Get the expansion table entry */
+        Index -= AllocationsTrackingTableSize;
+        if(Index >= AllocationsTrackingExpansionTableSize || !AllocationsTrackingExpansionTable[Index].Tag)
+        {
+            /* Slot not in use */
+            return FALSE;
+        }
+
+        /* Expansion table is global, update the peak usage */
+        Entry = &AllocationsTrackingExpansionTable[Index];
+        UpdatePeakBytes(&Entry->NonPagedPeakBytes, Entry->NonPagedBytes);
+        UpdatePeakBytes(&Entry->PagedPeakBytes, Entry->PagedBytes);
+
+        /* Copy the statistics */
+        Statistics->Tag = Entry->Tag;
+        Statistics->NonPagedAllocations = Entry->NonPagedAllocations;
+        Statistics->NonPagedFrees = Entry->NonPagedFrees;
+        Statistics->NonPagedBytes = Entry->NonPagedBytes;
+        Statistics->NonPagedPeakBytes = Entry->NonPagedPeakBytes;
+        Statistics->PagedAllocations = Entry->PagedAllocations;
+        Statistics->PagedFrees = Entry->PagedFrees;
+        Statistics->PagedBytes = Entry->PagedBytes;
+        Statistics->PagedPeakBytes = Entry->PagedPeakBytes;
+        return TRUE;
+    }
+
+    /* Get the global tracking table entry, which owns the tag slot */
+    Entry = &AllocationsTrackingTable[Index];
+    if(!Entry->Tag)
+    {
+        /* Slot not in use */
+        return FALSE;
+    }
+
+    /* Initialize the statistics */
+    RTL::Memory::ZeroMemory(Statistics, sizeof(POOL_TAG_STATISTICS));
+    Statistics->Tag = Entry->Tag;
+
+    /* Iterate through all processor tracking tables */
+    for(Processor = 0; Processor < MM_POOL_TRACKING_TABLES; Processor++)
+    {
+        /* Check if the processor has its own tracking table */
+        if(!TagTables[Processor])
+        {
+            /* Skip processor */
+            continue;
+        }
+
+        /* Check if the processor has already seen this tag */
+        CpuEntry = &TagTables[Processor][Index];
+        if(CpuEntry->Tag != Statistics->Tag)
+        {
+            /* No allocations tracked on this processor */
+            continue;
+        }
+
+        /* Accumulate the processor counters, byte counts balance out when freed on another processor */
+        Statistics->NonPagedAllocations += CpuEntry->NonPagedAllocations;
+        Statistics->NonPagedFrees += CpuEntry->NonPagedFrees;
+        Statistics->NonPagedBytes += CpuEntry->NonPagedBytes;
+        Statistics->PagedAllocations += CpuEntry->PagedAllocations;
+        Statistics->PagedFrees += CpuEntry->PagedFrees;
+        Statistics->PagedBytes += CpuEntry->PagedBytes;
+    }
+
+    /* Record the peak usage in the global tracking table */
+    Statistics->NonPagedPeakBytes = UpdatePeakBytes(&Entry->NonPagedPeakBytes, Statistics->NonPagedBytes);
+    Statistics->PagedPeakBytes = UpdatePeakBytes(&Entry->PagedPeakBytes, Statistics->PagedBytes);
+
+    /* Return success */
+    return TRUE;
+}
+
 /**
  * Initializes the allocations tracking table during early system boot.
  *
@@ -1290,8 +2029,9 @@ XTAPI
 VOID
 MM::Allocator::InitializeAllocationsTracking(VOID)
 {
+    ULONG Index, MonitorInterval;
+    WCHAR ParameterValue[16];
     SIZE_T TableSize;
-    ULONG Index;
     XTSTATUS Status;
     PMMMEMORY_LAYOUT MemoryLayout;
 
@@ -1337,172 +2077,476 @@ MM::Allocator::InitializeAllocationsTracking(VOID)
         AllocationsTrackingTableSize = MAX(1 << Index, 64);
     }
 
-    /* Iteratively attempt to allocate the tracking table */
-    while(TRUE)
+    /* Iteratively attempt to allocate the tracking table */
+    while(TRUE)
+    {
+        /* Prevent integer overflow when calculating the required byte size for the table */
+        if(AllocationsTrackingTableSize + 1 > (MAXULONG_PTR / sizeof(POOL_TRACKING_TABLE)))
+        {
+            /* Halve the requested entry count and restart the evaluation */
+            AllocationsTrackingTableSize >>= 1;
+            continue;
+        }
+
+        /* Attempt to allocate physical memory for the table */
+        Status = MM::Allocator::AllocatePages(NonPagedPool,
+                                              (AllocationsTrackingTableSize + 1) *
+                                              sizeof(POOL_TRACKING_TABLE), (PVOID *)&AllocationsTrackingTable);
+
+        /* Check if the allocation succeeded */
+        if(Status != STATUS_SUCCESS || !AllocationsTrackingTable)
+        {
+            /* Check if the allocation failed duefor a single entry */
+            if(AllocationsTrackingTableSize == 1)
+            {
+                /* Failed to initialize the pool tracker, raise kernel panic */
+                KE::Crash::Panic(0x41, TableSize, (ULONG_PTR)~0, (ULONG_PTR)~0, (ULONG_PTR)~0);
+            }
+
+            /* Halve the requested entry count */
+            AllocationsTrackingTableSize >>= 1;
+        }
+        else
+        {
+            /* Allocation succeeded */
+            break;
+        }
+    }
+
+    /* Increment the table size to account for the overflow bucket entry */
+    AllocationsTrackingTableSize++;
+
+    /* Zero the entire memory used by the table */
+    RtlZeroMemory(AllocationsTrackingTable, AllocationsTrackingTableSize * sizeof(POOL_TRACKING_TABLE));
+
+    /* Assign the global tracking table as the local table for the bootstrap processor */
+    TagTables[0] = AllocationsTrackingTable;
+
+    /* Calculate and store the hash mask */
+    AllocationsTrackingTableMask = AllocationsTrackingTableSize - 2;
+
+    /* Initialize the spinlock used to synchronize concurrent modifications to the tracking table */
+    KE::SpinLock::InitializeSpinLock(&AllocationsTrackingTableLock);
+
+    /* Check if user requested periodic pool tag statistics dumps */
+    if(KE::BootInformation::GetKernelParameterValue(L"POOLMON", ParameterValue, 16) == STATUS_SUCCESS)
+    {
+        /* Convert the interval in seconds to 100ns units */
+        if(RTL::WideString::WideStringToNumber(ParameterValue, 0, &MonitorInterval) == STATUS_SUCCESS)
+        {
+            /* Enable the pool monitor and schedule the first dump */
+            PoolTagMonitorInterval = (ULONGLONG)MonitorInterval * 10000000;
+            PoolTagMonitorDeadline = KE::SharedData::GetInterruptTime().QuadPart + PoolTagMonitorInterval;
+        }
+    }
+}
+
+/**
+ * Initializes the big allocations tracking table during early system boot.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Allocator::InitializeBigAllocationsTracking(VOID)
+{
+    SIZE_T ShardEntries, ShardSize, TableSize, TotalSize;
+    PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard;
+    ULONG Index, ShardIndex;
+    XTSTATUS Status;
+    PMMMEMORY_LAYOUT MemoryLayout;
+
+    /* Not fully implemented yet, HIVE support needed */
+    UNIMPLEMENTED;
+
+    /* Retrieve memory layout */
+    MemoryLayout = MM::Manager::GetMemoryLayout();
+
+    /* TODO: Retrieve initial big allocation table size from the HIVE */
+    TotalSize = 0;
+
+    /* Calculate the target table size */
+    TableSize = MIN(TotalSize, (MemoryLayout->NonPagedPoolSize * MM_PAGE_SIZE) >> 12);
+
+    /* Perform a bit-scan to determine the highest set bit */
+    for(Index = 0; Index < 32; Index++)
+    {
+        /* Check if the lowest bit is currently set */
+        if(TableSize & 1)
+        {
+            /* Verify if this is the only remaining set bit */
+            if(!(TableSize & ~1))
+            {
+                /* Exit the loop as the highest bit has been found */
+                break;
+            }
+        }
+
+        /* Shift the size down by one bit to evaluate higher bits */
+        TableSize >>= 1;
+    }
+
+    /* Check if the bit-scan completed without finding any set bits */
+    if(Index == 32)
+    {
+        /* Apply the default size of 4096 entries */
+        TotalSize = 4096;
+    }
+    else
+    {
+        /* Calculate the aligned power of two size, enforcing a minimum of 64 entries */
+        TotalSize = MAX(1 << Index, 64);
+    }
+
+    /* Spread the entries across all shards, giving each shard at least a single page worth of entries */
+    ShardEntries = MAX(TotalSize / MM_POOL_BIG_ALLOCATIONS_SHARDS, MM_PAGE_SIZE / sizeof(POOL_TRACKING_BIG_ALLOCATIONS));
+
+    /* Iterate through all shards */
+    for(ShardIndex = 0; ShardIndex < MM_POOL_BIG_ALLOCATIONS_SHARDS; ShardIndex++)
+    {
+        /* Get the shard and reset its state */
+        Shard = &BigAllocationsShards[ShardIndex];
+        RTL::Memory::ZeroMemory(Shard, sizeof(POOL_TRACKING_BIG_ALLOCATIONS_SHARD));
+        ShardSize = ShardEntries;
+
+        /* Iteratively attempt to allocate the shard table */
+        while(TRUE)
+        {
+            /* Prevent integer overflow when calculating the required byte size for the table */
+            if((ShardSize + 1) > (MAXULONG_PTR / sizeof(POOL_TRACKING_BIG_ALLOCATIONS)))
+            {
+                /* Halve the requested entry count and restart the evaluation */
+                ShardSize >>= 1;
+                continue;
+            }
+
+            /* Attempt to allocate physical memory for the table */
+            Status = AllocatePages(NonPagedPool,
+                                   ShardSize * sizeof(POOL_TRACKING_BIG_ALLOCATIONS),
+                                   (PVOID*)&Shard->Table);
+
+            /* Check if the allocation succeeded */
+            if(Status != STATUS_SUCCESS || !Shard->Table)
+            {
+                /* Check if the allocation failed duefor a single entry */
+                if(ShardSize == 1)
+                {
+                    /* Failed to initialize the pool tracker, raise kernel panic */
+                    KE::Crash::Panic(0x41, TableSize, (ULONG_PTR)~0, (ULONG_PTR)~0, (ULONG_PTR)~0);
+                }
+
+                /* Halve the requested entry count */
+                ShardSize >>= 1;
+            }
+            else
+            {
+                /* Allocation succeeded */
+                break;
+            }
+        }
+
+        /* Zero the entire memory used by the table */
+        RtlZeroMemory(Shard->Table, ShardSize * sizeof(POOL_TRACKING_BIG_ALLOCATIONS));
+
+        /* Iterate through the newly allocated table */
+        for(Index = 0; Index < ShardSize; Index++)
+        {
+            /* Mark the individual pool tracker entry as free and available */
+            Shard->Table[Index].VirtualAddress = (PVOID)MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE;
+        }
+
+        /* Store the table capacity */
+        Shard->TableSize = ShardSize;
+
+        /* Initialize the spinlock used to synchronize concurrent modifications to the shard */
+        KE::SpinLock::InitializeSpinLock(&Shard->Lock);
+
+        /* Register the allocation in the tracking table */
+        RegisterAllocationTag(SIGNATURE32('M', 'M', 'g', 'r'),
+                              SIZE_TO_PAGES(ShardSize * sizeof(POOL_TRACKING_BIG_ALLOCATIONS)),
+                              NonPagedPool);
+    }
+}
+
+/**
+ * Initializes the pool lookaside lists of the current processor.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Allocator::InitializeLookasideLists(VOID)
+{
+    PMMPOOL_LOOKASIDE_LIST LookasideList;
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+    ULONG Index;
+
+    /* Get current processor control block */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+
+    /* Iterate through all lookaside lists */
+    for(Index = 0; Index < MM_POOL_LOOKASIDE_LISTS; Index++)
+    {
+        /* Reset the lookaside list */
+        LookasideList = &Prcb->PoolLookasideList[Index];
+        RTL::Memory::ZeroMemory(LookasideList, sizeof(MMPOOL_LOOKASIDE_LIST));
+        RTL::SinglyList::InitializeListHead(&LookasideList->ListHead);
+
+        /* Set initial and maximum list depth */
+        LookasideList->Depth = MM_POOL_LOOKASIDE_MINIMUM_DEPTH;
+        LookasideList->MaximumDepth = MM_POOL_LOOKASIDE_MAXIMUM_DEPTH;
+    }
+}
+
+/**
+ * Looks up a big allocation within a single tracking table without acquiring any lock.
+ *
+ * @param Table
+ *        Supplies a pointer to the tracking table to search, or NULLPTR.
+ *
+ * @param TableSize
+ *        Supplies the number of entries in the tracking table.
+ *
+ * @param Hash
+ *        Supplies the shard-local hash of the virtual address.
+ *
+ * @param VirtualAddress
+ *        Supplies the virtual address of the big allocation to look up.
+ *
+ * @return This routine returns a pointer to the matching tracker entry, or NULLPTR if not found.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PPOOL_TRACKING_BIG_ALLOCATIONS
+MM::Allocator::LookupBigAllocation(IN PPOOL_TRACKING_BIG_ALLOCATIONS Table,
+                                   IN SIZE_T TableSize,
+                                   IN ULONG Hash,
+                                   IN PVOID VirtualAddress)
+{
+    SIZE_T Index, StartIndex;
+
+    /* Check if the table exists */
+    if(!Table)
+    {
+        /* Nothing to search */
+        return NULLPTR;
+    }
+
+    /* Mask the hash and record the starting bucket */
+    Index = Hash & (TableSize - 1);
+    StartIndex = Index;
+
+    /* Traverse the hash table using linear probing */
+    do
+    {
+        /* Check if the bucket contains the target virtual address */
+        if(*(volatile PVOID*)&Table[Index].VirtualAddress == VirtualAddress)
+        {
+            /* Order the metadata reads after the address match */
+            AR::CpuFunctions::ReadWriteBarrier();
+
+            /* Return the matching entry */
+            return &Table[Index];
+        }
+
+        /* Advance to the next bucket */
+        if(++Index >= TableSize)
+        {
+            /* Wrap the index back to the beginning of the table */
+            Index = 0;
+        }
+    }
+    while(Index != StartIndex);
+
+    /* The allocation is not tracked in this table */
+    return NULLPTR;
+}
+
+/**
+ * Moves a batch of live entries from the shard migration table into its current table.
+ *
+ * @param Shard
+ *        Supplies a pointer to the tracking table shard being resized.
+ *
+ * @param Entries
+ *        Supplies the maximum number of migration table entries to process.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The shard lock must be held by the caller. Every entry is published in the new table before it is
+ *       withdrawn from the old one, so a concurrent lookup walking the old table first can never miss it.
+ */
+XTAPI
+VOID
+MM::Allocator::MigrateBigAllocations(IN PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard,
+                                     IN SIZE_T Entries)
+{
+    PPOOL_TRACKING_BIG_ALLOCATIONS Entry, Target;
+    PVOID VirtualAddress;
+    SIZE_T Index;
+
+    /* Process the requested number of entries */
+    while(Entries-- && Shard->MigrationIndex < Shard->MigrationTableSize)
     {
-        /* Prevent integer overflow when calculating the required byte size for the table */
-        if(AllocationsTrackingTableSize + 1 > (MAXULONG_PTR / sizeof(POOL_TRACKING_TABLE)))
+        /* Retrieve the next entry from the migration table */
+        Entry = &Shard->MigrationTable[Shard->MigrationIndex++];
+        VirtualAddress = *(volatile PVOID*)&Entry->VirtualAddress;
+
+        /* Bypass unallocated entries */
+        if((ULONG_PTR)VirtualAddress & MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE)
         {
-            /* Halve the requested entry count and restart the evaluation */
-            AllocationsTrackingTableSize >>= 1;
+            /* Skip to the next entry */
             continue;
         }
 
-        /* Attempt to allocate physical memory for the table */
-        Status = MM::Allocator::AllocatePages(NonPagedPool,
-                                              (AllocationsTrackingTableSize + 1) *
-                                              sizeof(POOL_TRACKING_TABLE), (PVOID *)&AllocationsTrackingTable);
+        /* Compute the bucket index within the current table */
+        Index = (ComputeHash(VirtualAddress) >> MM_POOL_BIG_ALLOCATIONS_SHARD_SHIFT) & (Shard->TableSize - 1);
 
-        /* Check if the allocation succeeded */
-        if(Status != STATUS_SUCCESS || !AllocationsTrackingTable)
+        /* Resolve hash collisions using linear probing */
+        while(!((ULONG_PTR)Shard->Table[Index].VirtualAddress & MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE))
         {
-            /* Check if the allocation failed duefor a single entry */
-            if(AllocationsTrackingTableSize == 1)
+            /* Advance the bucket index and check for table boundary overflow */
+            if(++Index == Shard->TableSize)
             {
-                /* Failed to initialize the pool tracker, raise kernel panic */
-                KE::Crash::Panic(0x41, TableSize, (ULONG_PTR)~0, (ULONG_PTR)~0, (ULONG_PTR)~0);
+                /* Wrap the probing index back to the beginning */
+                Index = 0;
             }
-
-            /* Halve the requested entry count */
-            AllocationsTrackingTableSize >>= 1;
         }
-        else
+
+        /* Copy the allocation metadata and publish the entry in the current table */
+        Target = &Shard->Table[Index];
+        Target->NumberOfPages = Entry->NumberOfPages;
+        Target->QuotaObject = Entry->QuotaObject;
+        Target->Tag = Entry->Tag;
+        RTL::Atomic::ExchangePointer(&Target->VirtualAddress, VirtualAddress);
+
+        /* Withdraw the entry from the migration table */
+        if(RTL::Atomic::CompareExchangePointer(&Entry->VirtualAddress,
+                                               VirtualAddress,
+                                               (PVOID)MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE) != VirtualAddress)
         {
-            /* Allocation succeeded */
-            break;
+            /* The allocation has been freed concurrently, drop the copy */
+            RTL::Atomic::ExchangePointer(&Target->VirtualAddress, (PVOID)MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE);
         }
     }
 
-    /* Increment the table size to account for the overflow bucket entry */
-    AllocationsTrackingTableSize++;
-
-    /* Zero the entire memory used by the table */
-    RtlZeroMemory(AllocationsTrackingTable, AllocationsTrackingTableSize * sizeof(POOL_TRACKING_TABLE));
-
-    /* Assign the global tracking table as the local table for the bootstrap processor */
-    TagTables[0] = AllocationsTrackingTable;
+    /* Check if the whole migration table has been drained */
+    if(Shard->MigrationTable && Shard->MigrationIndex >= Shard->MigrationTableSize)
+    {
+        /* Mark the shard tables as being updated */
+        RTL::Atomic::Increment32(&Shard->Generation);
 
-    /* Calculate and store the hash mask */
-    AllocationsTrackingTableMask = AllocationsTrackingTableSize - 2;
+        /* Retire the migration table until no lock-free lookup can observe it */
+        Shard->RetiredTable = Shard->MigrationTable;
+        Shard->MigrationTable = NULLPTR;
+        Shard->MigrationTableSize = 0;
+        Shard->MigrationIndex = 0;
 
-    /* Initialize the spinlock used to synchronize concurrent modifications to the tracking table */
-    KE::SpinLock::InitializeSpinLock(&AllocationsTrackingTableLock);
+        /* Mark the shard tables update as completed */
+        RTL::Atomic::Increment32(&Shard->Generation);
+    }
 }
 
 /**
- * Initializes the big allocations tracking table during early system boot.
+ * Periodically prints the pool tag statistics, if enabled with the POOLMON kernel parameter.
  *
  * @return This routine does not return any value.
  *
  * @since XT 1.0
+ *
+ * @note This routine is called by the idle loop of every processor, on each clock tick the processor is idle.
+ *       Only the bootstrap processor prints the statistics.
  */
 XTAPI
 VOID
-MM::Allocator::InitializeBigAllocationsTracking(VOID)
+MM::Allocator::MonitorPoolTags(VOID)
 {
-    SIZE_T TableSize;
-    ULONG Index;
-    XTSTATUS Status;
-    PMMMEMORY_LAYOUT MemoryLayout;
-
-    /* Not fully implemented yet, HIVE support needed */
-    UNIMPLEMENTED;
-
-    /* Retrieve memory layout */
-    MemoryLayout = MM::Manager::GetMemoryLayout();
-
-    /* TODO: Retrieve initial big allocation table size from the HIVE */
-    BigAllocationsTrackingTableSize = 0;
-
-    /* Calculate the target table size */
-    TableSize = MIN(BigAllocationsTrackingTableSize, (MemoryLayout->NonPagedPoolSize * MM_PAGE_SIZE) >> 12);
+    ULONGLONG CurrentTime;
 
-    /* Perform a bit-scan to determine the highest set bit */
-    for(Index = 0; Index < 32; Index++)
+    /* Check if the pool monitor is enabled and let the bootstrap processor do the work */
+    if(!PoolTagMonitorInterval || KE::Processor::GetCurrentProcessorNumber() != 0)
     {
-        /* Check if the lowest bit is currently set */
-        if(TableSize & 1)
-        {
-            /* Verify if this is the only remaining set bit */
-            if(!(TableSize & ~1))
-            {
-                /* Exit the loop as the highest bit has been found */
-                break;
-            }
-        }
-
-        /* Shift the size down by one bit to evaluate higher bits */
-        TableSize >>= 1;
+        /* Nothing to do */
+        return;
     }
 
-    /* Check if the bit-scan completed without finding any set bits */
-    if(Index == 32)
+    /* Check if the monitor interval has elapsed */
+    CurrentTime = KE::SharedData::GetInterruptTime().QuadPart;
+    if(CurrentTime < PoolTagMonitorDeadline)
     {
-        /* Apply the default size of 4096 entries */
-        BigAllocationsTrackingTableSize = 4096;
+        /* Not yet */
+        return;
     }
-    else
+
+    /* Schedule the next dump and print the statistics */
+    PoolTagMonitorDeadline = CurrentTime + PoolTagMonitorInterval;
+    DumpPoolTagStatistics();
+}
+
+/**
+ * Takes a snapshot of the pool tag statistics, merged from all processor tracking tables.
+ *
+ * @param Statistics
+ *        Supplies a pointer to a buffer that receives the statistics of all tracked pool tags.
+ *
+ * @param Count
+ *        Supplies the number of entries the buffer can hold.
+ *
+ * @param ReturnedCount
+ *        Supplies a pointer to a variable that receives the number of tracked pool tags.
+ *
+ * @return This routine returns a status code. STATUS_BUFFER_TOO_SMALL is returned if not all tags fit in the buffer.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Allocator::QueryPoolTagStatistics(OUT PPOOL_TAG_STATISTICS Statistics,
+                                      IN ULONG Count,
+                                      OUT PULONG ReturnedCount)
+{
+    POOL_TAG_STATISTICS TagStatistics;
+    ULONG Entries, Index;
+
+    /* Validate parameters */
+    if(!ReturnedCount || (Count && !Statistics))
     {
-        /* Calculate the aligned power of two size, enforcing a minimum of 64 entries */
-        BigAllocationsTrackingTableSize = MAX(1 << Index, 64);
+        /* Invalid parameter passed */
+        return STATUS_INVALID_PARAMETER;
     }
 
-    /* Iteratively attempt to allocate the tracking table */
-    while(TRUE)
+    /* Iterate through all tracked tags */
+    Entries = 0;
+    for(Index = 0; Index < AllocationsTrackingTableSize + AllocationsTrackingExpansionTableSize; Index++)
     {
-        /* Prevent integer overflow when calculating the required byte size for the table */
-        if((BigAllocationsTrackingTableSize + 1) > (MAXULONG_PTR / sizeof(POOL_TRACKING_BIG_ALLOCATIONS)))
+        /* Merge the statistics of the tag */
+        if(!GetTagStatistics(Index, &TagStatistics))
         {
-            /* Halve the requested entry count and restart the evaluation */
-            BigAllocationsTrackingTableSize >>= 1;
+            /* Slot not in use, skip it */
             continue;
         }
 
-        /* Attempt to allocate physical memory for the table */
-        Status = AllocatePages(NonPagedPool,
-                               BigAllocationsTrackingTableSize * sizeof(POOL_TRACKING_BIG_ALLOCATIONS),
-                               (PVOID*)&BigAllocationsTrackingTable);
-
-        /* Check if the allocation succeeded */
-        if(Status != STATUS_SUCCESS || !BigAllocationsTrackingTable)
-        {
-            /* Check if the allocation failed duefor a single entry */
-            if(BigAllocationsTrackingTableSize == 1)
-            {
-                /* Failed to initialize the pool tracker, raise kernel panic */
-                KE::Crash::Panic(0x41, TableSize, (ULONG_PTR)~0, (ULONG_PTR)~0, (ULONG_PTR)~0);
-            }
-
-            /* Halve the requested entry count */
-            BigAllocationsTrackingTableSize >>= 1;
-        }
-        else
+        /* Check if there is room left in the buffer */
+        if(Entries < Count)
         {
-            /* Allocation succeeded */
-            break;
+            /* Store the tag statistics */
+            Statistics[Entries] = TagStatistics;
         }
-    }
-
-    /* Zero the entire memory used by the table */
-    RtlZeroMemory(BigAllocationsTrackingTable, BigAllocationsTrackingTableSize * sizeof(POOL_TRACKING_BIG_ALLOCATIONS));
 
-    /* Iterate through the newly allocated table */
-    for(Index = 0; Index < BigAllocationsTrackingTableSize; Index++)
-    {
-        /* Mark the individual pool tracker entry as free and available */
-        BigAllocationsTrackingTable[Index].VirtualAddress = (PVOID)MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE;
+        /* Count the tag */
+        Entries++;
     }
 
-    /* Calculate and store the hash mask */
-    BigAllocationsTrackingTableHash = BigAllocationsTrackingTableSize - 1;
-
-    /* Initialize the spinlock used to synchronize concurrent modifications to the tracking table */
-    KE::SpinLock::InitializeSpinLock(&BigAllocationsTrackingTableLock);
-
-    /* Register the allocation in the tracking table */
-    RegisterAllocationTag(SIGNATURE32('M', 'M', 'g', 'r'),
-                          SIZE_TO_PAGES(BigAllocationsTrackingTableSize * sizeof(POOL_TRACKING_BIG_ALLOCATIONS)),
-                          NonPagedPool);
+    /* Return the number of tracked tags */
+    *ReturnedCount = Entries;
+    return (Entries > Count) ? STATUS_BUFFER_TOO_SMALL : STATUS_SUCCESS;
 }
 
 /**
@@ -1801,9 +2845,16 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
                                         IN ULONG Pages,
                                         IN MMPOOL_TYPE PoolType)
 {
-    PPOOL_TRACKING_BIG_ALLOCATIONS Entry;
+    PPOOL_TRACKING_BIG_ALLOCATIONS Entry, ReleasedTable;
+    PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard;
     BOOLEAN Inserted, RequiresExpansion;
-    ULONG Hash, StartHash;
+    SIZE_T Index, StartIndex;
+    ULONG Hash;
+
+    /* Calculate the hash and select the shard owning the virtual address */
+    Hash = ComputeHash(VirtualAddress);
+    Shard = &BigAllocationsShards[Hash & (MM_POOL_BIG_ALLOCATIONS_SHARDS - 1)];
+    Hash >>= MM_POOL_BIG_ALLOCATIONS_SHARD_SHIFT;
 
     /* Wrap the insertion logic in a retry loop */
     while(TRUE)
@@ -1811,25 +2862,38 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
         /* Initialize local variables */
         Inserted = FALSE;
         RequiresExpansion = FALSE;
-
-        /* Calculate the initial hash bucket index */
-        Hash = ComputeHash(VirtualAddress);
+        ReleasedTable = NULLPTR;
 
         /* Start a guarded code block */
         {
-            /* Acquire the tracking table lock and raise runlevel to DISPATCH level */
+            /* Acquire the shard lock and raise runlevel to DISPATCH level */
             KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-            KE::SpinLockGuard TrackingTableLock(&BigAllocationsTrackingTableLock);
+            KE::SpinLockGuard ShardLock(&Shard->Lock);
+
+            /* Check if a previously retired table is no longer visible to any lock-free lookup */
+            if(Shard->RetiredTable && !Shard->Readers)
+            {
+                /* Detach the retired table, it will be released once the lock is dropped */
+                ReleasedTable = Shard->RetiredTable;
+                Shard->RetiredTable = NULLPTR;
+            }
 
-            /* Retrieve the tracker entry */
-            Hash &= BigAllocationsTrackingTableHash;
-            StartHash = Hash;
+            /* Check if the shard is being resized */
+            if(Shard->MigrationTable)
+            {
+                /* Move another batch of entries into the current table */
+                MigrateBigAllocations(Shard, MM_POOL_BIG_ALLOCATIONS_MIGRATION_BATCH);
+            }
+
+            /* Retrieve the initial bucket index */
+            Index = Hash & (Shard->TableSize - 1);
+            StartIndex = Index;
 
             /* Traverse the hash table */
             do
             {
                 /* Retrieve the tracker entry */
-                Entry = &BigAllocationsTrackingTable[Hash];
+                Entry = &Shard->Table[Index];
 
                 /* Check if the current bucket is marked as free */
                 if((ULONG_PTR)Entry->VirtualAddress & MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE)
@@ -1837,13 +2901,12 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
                     /* Populate the available bucket with the allocation metadata */
                     Entry->NumberOfPages = Pages;
                     Entry->Tag = Tag;
-                    Entry->VirtualAddress = VirtualAddress;
 
-                    /* Increment the global usage counter */
-                    BigAllocationsInUse++;
+                    /* Publish the entry to the lock-free lookups */
+                    RTL::Atomic::ExchangePointer(&Entry->VirtualAddress, VirtualAddress);
 
                     /* Determine if the table capacity has reached the critical 75% threshold */
-                    if(BigAllocationsInUse > (BigAllocationsTrackingTableSize * 3 / 4))
+                    if((SIZE_T)RTL::Atomic::Increment32(&Shard->InUse) > (Shard->TableSize * 3 / 4))
                     {
                         /* Flag the table for expansion */
                         RequiresExpansion = TRUE;
@@ -1855,20 +2918,20 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
                 }
 
                 /* Advance to the next bucket */
-                if(++Hash >= BigAllocationsTrackingTableSize)
+                if(++Index >= Shard->TableSize)
                 {
                     /* Wrap the index back to the beginning of the table */
-                    Hash = 0;
-                }
-
-                /* If the traversal has wrapped entirely back to the starting index, the table is saturated */
-                if(Hash == StartHash)
-                {
-                    /* Break out of the probing loop */
-                    break;
+                    Index = 0;
                 }
             }
-            while(Hash != StartHash);
+            while(Index != StartIndex);
+        }
+
+        /* Check if a retired table has been detached */
+        if(ReleasedTable)
+        {
+            /* Free memory allocated for the retired table */
+            FreeBigAllocationsTable(ReleasedTable);
         }
 
         /* Check if the insertion succeeded */
@@ -1877,8 +2940,8 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
             /* Check if a table expansion is required */
             if(RequiresExpansion)
             {
-                /* Trigger a table expansion asynchronously */
-                ExpandBigAllocationsTable();
+                /* Expand the shard, entries will be migrated incrementally */
+                ExpandBigAllocationsTable(Shard);
             }
 
             /* Return success */
@@ -1886,7 +2949,7 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
         }
 
         /* The table is completely saturated, attempt to expand the table */
-        if(ExpandBigAllocationsTable())
+        if(ExpandBigAllocationsTable(Shard))
         {
             /* The table was successfully expanded, retry the insertion */
             continue;
@@ -1900,6 +2963,57 @@ MM::Allocator::RegisterBigAllocationTag(IN PVOID VirtualAddress,
     return FALSE;
 }
 
+/**
+ * Returns all blocks cached in the current processor's pool lookaside lists back to the pool descriptors, if another
+ * processor requested the lookaside lists to be flushed.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Allocator::TrimLookasideLists(VOID)
+{
+    PMMPOOL_LOOKASIDE_LIST LookasideList;
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+    PSINGLE_LIST_ENTRY Entry;
+    PPOOL_HEADER PoolEntry;
+    ULONG Generation, Index;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get current processor control block */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+
+    /* Check if the lookaside lists have been flushed since the last request */
+    Generation = LookasideFlushGeneration;
+    if(Prcb->PoolLookasideGeneration == Generation)
+    {
+        /* Nothing to do */
+        return;
+    }
+
+    /* Mark the request as handled by the current processor */
+    Prcb->PoolLookasideGeneration = Generation;
+
+    /* Iterate through all lookaside lists */
+    for(Index = 0; Index < MM_POOL_LOOKASIDE_LISTS; Index++)
+    {
+        /* Get the lookaside list */
+        LookasideList = &Prcb->PoolLookasideList[Index];
+
+        /* Drain all cached blocks from the list */
+        while((Entry = RTL::SinglyList::TakeFirstEntry(&LookasideList->ListHead)) != NULLPTR)
+        {
+            /* Resolve the pool header and return the block to its pool descriptor */
+            PoolEntry = GetPoolEntry(Entry);
+            FreePoolBlock(GetPoolDescriptor(PoolEntry), PoolEntry);
+        }
+    }
+}
+
 /**
  * Unregisters a pool memory allocation in the tracking table.
  *
@@ -2089,6 +3203,9 @@ MM::Allocator::UnregisterAllocationTagExpansion(IN ULONG Tag,
  * @return This routine returns the allocation pool tag if found, or a default signature otherwise.
  *
  * @since XT 1.0
+ *
+ * @note The lookup does not acquire the shard lock. The entry is claimed with an atomic exchange of its address,
+ *       while a generation count detects a concurrent table switch and restarts the lookup.
  */
 XTAPI
 ULONG
@@ -2096,71 +3213,100 @@ MM::Allocator::UnregisterBigAllocationTag(IN PVOID VirtualAddress,
                                           OUT PULONG_PTR Pages,
                                           IN MMPOOL_TYPE PoolType)
 {
-    ULONG Hash, StartHash;
-    ULONG PoolTag;
+    PPOOL_TRACKING_BIG_ALLOCATIONS Entry, MigrationTable, Table;
+    PPOOL_TRACKING_BIG_ALLOCATIONS_SHARD Shard;
+    SIZE_T MigrationTableSize, TableSize;
+    LONG Generation;
+    ULONG_PTR NumberOfPages;
+    ULONG Hash, PoolTag;
     BOOLEAN Found;
-    PPOOL_TRACKING_BIG_ALLOCATIONS Entry;
 
     /* Initialize default state */
     Found = FALSE;
 
-    /* Calculate the initial hash bucket index */
+    /* Calculate the hash and select the shard owning the virtual address */
     Hash = ComputeHash(VirtualAddress);
+    Shard = &BigAllocationsShards[Hash & (MM_POOL_BIG_ALLOCATIONS_SHARDS - 1)];
+    Hash >>= MM_POOL_BIG_ALLOCATIONS_SHARD_SHIFT;
 
-    /* Start a guarded code block */
+    /* Announce the lookup, so that no table observed by it gets released */
+    RTL::Atomic::Increment32(&Shard->Readers);
+
+    /* Retry the lookup until it completes against a stable set of tables */
+    while(TRUE)
     {
-        /* Acquire the tracking table lock and raise runlevel to DISPATCH level */
-        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-        KE::SpinLockGuard TrackingTableLock(&BigAllocationsTrackingTableLock);
+        /* Snapshot the shard generation */
+        Generation = *(volatile LONG*)&Shard->Generation;
+        if(Generation & 1)
+        {
+            /* The shard tables are being switched, wait for the update to complete */
+            AR::CpuFunctions::YieldProcessor();
+            continue;
+        }
 
-        /* Mask the computed hash and record the starting bucket */
-        Hash &= BigAllocationsTrackingTableHash;
-        StartHash = Hash;
+        /* Capture the shard tables */
+        AR::CpuFunctions::ReadWriteBarrier();
+        MigrationTable = Shard->MigrationTable;
+        MigrationTableSize = Shard->MigrationTableSize;
+        Table = Shard->Table;
+        TableSize = Shard->TableSize;
+        AR::CpuFunctions::ReadWriteBarrier();
 
-        /* Traverse the hash table using linear probing to pinpoint the exact allocation address */
-        while(TRUE)
+        /* Make sure the captured tables are consistent */
+        if(*(volatile LONG*)&Shard->Generation != Generation)
         {
-            /* Retrieve the tracker entry */
-            Entry = &BigAllocationsTrackingTable[Hash];
+            /* The shard tables have been switched, retry the lookup */
+            continue;
+        }
 
-            /* Check if the bucket contains the target virtual address */
-            if(Entry->VirtualAddress == VirtualAddress)
-            {
-                /* Capture the allocation metadata */
-                *Pages = Entry->NumberOfPages;
-                PoolTag = Entry->Tag;
+        /* Search the table being drained first, then the current table */
+        Entry = LookupBigAllocation(MigrationTable, MigrationTableSize, Hash, VirtualAddress);
+        if(!Entry)
+        {
+            /* Search the current table */
+            Entry = LookupBigAllocation(Table, TableSize, Hash, VirtualAddress);
+        }
 
-                /* Invalidate the entry */
-                Entry->VirtualAddress = (PVOID)MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE;
+        /* Check if the allocation has been found */
+        if(!Entry)
+        {
+            /* Check if the shard tables have been switched during the lookup */
+            if(*(volatile LONG*)&Shard->Generation != Generation)
+            {
+                /* The entry might have moved, retry the lookup */
+                continue;
+            }
 
-                /* Decrement the global usage counter */
-                BigAllocationsInUse--;
+            /* The allocation is not tracked */
+            break;
+        }
 
-                /* Update the found flag and break out of the probing loop */
-                Found = TRUE;
-                break;
-            }
+        /* Capture the allocation metadata */
+        NumberOfPages = Entry->NumberOfPages;
+        PoolTag = Entry->Tag;
 
-            /* Advance to the next bucket */
-            if(++Hash >= BigAllocationsTrackingTableSize)
-            {
-                /* Wrap the hash index back to zero */
-                Hash = 0;
-            }
+        /* Claim the entry by marking it as free, a failure means it has been migrated concurrently */
+        if(RTL::Atomic::CompareExchangePointer(&Entry->VirtualAddress,
+                                               VirtualAddress,
+                                               (PVOID)MM_POOL_BIG_ALLOCATIONS_ENTRY_FREE) == VirtualAddress)
+        {
+            /* Decrement the shard usage counter */
+            RTL::Atomic::Decrement32(&Shard->InUse);
 
-            /* Check if the traversal has wrapped entirely back to the starting index */
-            if(Hash == StartHash)
-            {
-                /* Abort the search */
-                break;
-            }
+            /* Update the found flag and break out of the lookup loop */
+            Found = TRUE;
+            break;
         }
     }
 
+    /* Finish the lookup */
+    RTL::Atomic::Decrement32(&Shard->Readers);
+
     /* Evaluate the result of the table traversal */
     if(Found)
     {
         /* Return the original tag captured from the tracker */
+        *Pages = NumberOfPages;
         return PoolTag;
     }
 
@@ -2168,3 +3314,98 @@ MM::Allocator::UnregisterBigAllocationTag(IN PVOID VirtualAddress,
     *Pages = 0;
     return SIGNATURE32('B', 'i', 'g', 'A');
 }
+
+/**
+ * Raises a recorded peak usage to the given value.
+ *
+ * @param PeakBytes
+ *        Supplies a pointer to the recorded peak usage.
+ *
+ * @param Bytes
+ *        Supplies the current usage.
+ *
+ * @return This routine returns the updated peak usage.
+ *
+ * @since XT 1.0
+ */
+XTINLINE
+SIZE_T
+MM::Allocator::UpdatePeakBytes(IN OUT PSIZE_T PeakBytes,
+                               IN SIZE_T Bytes)
+{
+    SIZE_T Peak, PreviousPeak;
+
+    /* Retry until the recorded peak is at least the current usage */
+    Peak = *PeakBytes;
+    while((LONG_PTR)Bytes > (LONG_PTR)Peak)
+    {
+        /* Attempt to store the new peak usage */
+        PreviousPeak = (SIZE_T)RTL::Atomic::CompareExchange64((PLONG_PTR)PeakBytes, (LONG_PTR)Peak, (LONG_PTR)Bytes);
+        if(PreviousPeak == Peak)
+        {
+            /* Peak usage updated */
+            return Bytes;
+        }
+
+        /* Another snapshot updated the peak concurrently, re-evaluate */
+        Peak = PreviousPeak;
+    }
+
+    /* Return the recorded peak usage */
+    return Peak;
+}
+
+#ifdef DBG
+/**
+ * Verifies that a physical page committed to a paged pool page on its first access is returned to the free page
+ * lists, once the allocation is freed, and reports the result to the debugger.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The page magazine of the current processor is flushed before each sample, so that the number of available
+ *       pages accounts for the committed page only.
+ */
+XTAPI
+VOID
+MM::Allocator::VerifyPageRelease(VOID)
+{
+    PFN_NUMBER AllocatedPages, FreedPages, TouchedPages;
+    PVOID Memory;
+
+    /* Allocate a paged pool page, which is not backed by any physical page yet */
+    if(AllocatePages(PagedPool, MM_PAGE_SIZE, &Memory) != STATUS_SUCCESS)
+    {
+        /* Unable to allocate the paged pool page, skip the check */
+        DebugPrint(L"Page release check skipped, unable to allocate a paged pool page\n");
+        return;
+    }
+
+    /* Sample the number of available pages after the allocation */
+    MM::Pfn::FlushPageMagazine();
+    AllocatedPages = MM::Pfn::GetAvailablePages();
+
+    /* Touch the page, committing a physical page to it, and sample the number of available pages again */
+    RTL::Memory::ZeroMemory(Memory, sizeof(ULONG_PTR));
+    MM::Pfn::FlushPageMagazine();
+    TouchedPages = MM::Pfn::GetAvailablePages();
+
+    /* Free the allocation and sample the number of available pages once more */
+    FreePages(Memory);
+    MM::Pfn::FlushPageMagazine();
+    FreedPages = MM::Pfn::GetAvailablePages();
+
+    /* Make sure the committed page has been taken on touch and returned on free */
+    if(TouchedPages >= AllocatedPages || FreedPages != AllocatedPages)
+    {
+        /* The committed page has not been returned to the free page lists */
+        DebugPrint(L"Page release check failed: %zu pages available after allocation, %zu after touch, "
+                   L"%zu after free\n", AllocatedPages, TouchedPages, FreedPages);
+        return;
+    }
+
+    /* The committed page has been returned to the free page lists */
+    DebugPrint(L"Page release check passed: %zu pages available\n", FreedPages);
+}
+#endif
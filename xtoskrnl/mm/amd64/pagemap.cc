@@ -492,6 +492,24 @@ MM::PageMap::GetXpaStatus()
     return PageMapInfo.Xpa;
 }
 
+/**
+ * Checks whether the given page directory entry (PDE) maps a large page.
+ *
+ * @param PtePointer
+ *        Pointer to the page directory entry (PDE) to check.
+ *
+ * @return Returns TRUE if the entry maps a large page, FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::PageMap::PteLargePage(IN PMMPTE PtePointer)
+{
+    /* Check if PDE maps a large page */
+    return (BOOLEAN)PtePointer->Hardware.LargePage;
+}
+
 /**
  * Checks whether the given PML2 page table entry (PTE) is valid.
  *
@@ -186,3 +186,42 @@ MM::Paging::ZeroPages(IN PVOID Address,
                        "ecx",
                        "memory");
 }
+
+/**
+ * Fills a section of memory with zeroes using non-temporal stores, bypassing the CPU caches.
+ *
+ * @param Address
+ *        Supplies an address of the page to be filled with zeroes.
+ *
+ * @param Size
+ *        Number of bytes to be filled with zeros. This always should be a multiply of page size.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTFASTCALL
+VOID
+MM::Paging::ZeroPagesNonTemporal(IN PVOID Address,
+                                 IN ULONG Size)
+{
+    __asm__ volatile("xor %%rax, %%rax\n"
+                     "1:\n"
+                     "movnti %%rax, 0(%0)\n"
+                     "movnti %%rax, 8(%0)\n"
+                     "movnti %%rax, 16(%0)\n"
+                     "movnti %%rax, 24(%0)\n"
+                     "movnti %%rax, 32(%0)\n"
+                     "movnti %%rax, 40(%0)\n"
+                     "movnti %%rax, 48(%0)\n"
+                     "movnti %%rax, 56(%0)\n"
+                     "add $64, %0\n"
+                     "sub $64, %1\n"
+                     "jnz 1b\n"
+                     "sfence\n"
+                     : "+r" (Address),
+                       "+r" (Size)
+                     :
+                     : "rax",
+                       "memory");
+}
@@ -10,17 +10,71 @@
 
 
 /**
- * Evaluates the PDE for for paged pool and per-session mappings.
+ * Makes the page table hierarchy mapping the given paged pool address resident, creating missing page tables.
  *
  * @param VirtualAddress
- *        Specifies the virtual address to verify.
+ *        Specifies the paged pool virtual address to verify.
  *
- * @return This routine returns ACCESS_VIOLATION regardless PML4 or PML5 is used.
+ * @return This routine returns STATUS_SUCCESS if the PDE is valid, or an error status code otherwise.
+ *
+ * @since XT 1.0
  */
 XTFASTCALL
 XTSTATUS
 MM::PageFault::CheckPdeForPagedPool(IN PVOID VirtualAddress)
 {
-    /* Return access violation */
-    return STATUS_ACCESS_VIOLATION;
+    XTSTATUS Status;
+
+    /* Make sure the address belongs to the paged pool */
+    if(!PagedPoolAddress(VirtualAddress))
+    {
+        /* Return access violation */
+        return STATUS_ACCESS_VIOLATION;
+    }
+
+    /* Check if XPA is enabled and P5E is not valid */
+    if(MM::Paging::GetXpaStatus() && !MM::Paging::PteValid(MM::Paging::GetP5eAddress(VirtualAddress)))
+    {
+        /* Create the PML4 table */
+        Status = MapPageTable(MM::Paging::GetP5eAddress(VirtualAddress));
+        if(Status != STATUS_SUCCESS)
+        {
+            /* Failed to create the page table, return error */
+            return Status;
+        }
+    }
+
+    /* Check if PXE is valid */
+    if(!MM::Paging::PteValid(MM::Paging::GetPxeAddress(VirtualAddress)))
+    {
+        /* Create the page directory pointer table */
+        Status = MapPageTable(MM::Paging::GetPxeAddress(VirtualAddress));
+        if(Status != STATUS_SUCCESS)
+        {
+            /* Failed to create the page table, return error */
+            return Status;
+        }
+    }
+
+    /* Check if PPE is valid */
+    if(!MM::Paging::PteValid(MM::Paging::GetPpeAddress(VirtualAddress)))
+    {
+        /* Create the page directory */
+        Status = MapPageTable(MM::Paging::GetPpeAddress(VirtualAddress));
+        if(Status != STATUS_SUCCESS)
+        {
+            /* Failed to create the page table, return error */
+            return Status;
+        }
+    }
+
+    /* Check if PDE is valid */
+    if(!MM::Paging::PteValid(MM::Paging::GetPdeAddress(VirtualAddress)))
+    {
+        /* Create the page table */
+        return MapPageTable(MM::Paging::GetPdeAddress(VirtualAddress));
+    }
+
+    /* Page table is resident, return success */
+    return STATUS_SUCCESS;
 }
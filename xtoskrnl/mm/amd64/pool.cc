@@ -25,10 +25,14 @@ MM::Pool::MapNonPagedPool(VOID)
     /* Retrieve memory layout */
     MemoryLayout = MM::Manager::GetMemoryLayout();
 
-    /* Map PPE and PDE for whole non-paged pool */
+    /* Map PPE for whole non-paged pool */
     MM::Pte::MapPPE(MemoryLayout->NonPagedPoolStart, MemoryLayout->NonPagedExpansionPoolEnd, MM::Pte::GetValidPte());
-    MM::Pte::MapPDE(MemoryLayout->NonPagedPoolStart, MemoryLayout->NonPagedExpansionPoolEnd, MM::Pte::GetValidPte());
 
-    /* Map PTE only for the base of the non-paged pool */
-    MM::Pte::MapPTE(MemoryLayout->NonPagedPoolStart, (PCHAR)MemoryLayout->NonPagedPoolEnd - 1, MM::Pte::GetValidPte());
+    /* Map the base of the non-paged pool, using large pages wherever possible */
+    MM::Pte::MapLargePages(MemoryLayout->NonPagedPoolStart,
+                           (PCHAR)MemoryLayout->NonPagedPoolEnd - 1,
+                           MM::Pte::GetValidPte());
+
+    /* Map the remaining PDEs for whole non-paged pool */
+    MM::Pte::MapPDE(MemoryLayout->NonPagedPoolStart, MemoryLayout->NonPagedExpansionPoolEnd, MM::Pte::GetValidPte());
 }
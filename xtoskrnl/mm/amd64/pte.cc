@@ -34,13 +34,20 @@ MM::Pte::AddressValid(IN PVOID VirtualAddress)
         }
     }
 
-    /* Check if PXE, PPE, PDE and PTE are valid */
+    /* Check if PXE, PPE and PDE are valid */
     if(!MM::Paging::PteValid(MM::Paging::GetPxeAddress(VirtualAddress)) ||
        !MM::Paging::PteValid(MM::Paging::GetPpeAddress(VirtualAddress)) ||
-       !MM::Paging::PteValid(MM::Paging::GetPdeAddress(VirtualAddress)) ||
+       !MM::Paging::PteValid(MM::Paging::GetPdeAddress(VirtualAddress)))
+    {
+        /* Invalid PXE, PPE or PDE, return FALSE */
+        return FALSE;
+    }
+
+    /* Check if PDE does not map a large page and PTE is valid */
+    if(!MM::Paging::PteLargePage(MM::Paging::GetPdeAddress(VirtualAddress)) &&
        !MM::Paging::PteValid(MM::Paging::GetPteAddress(VirtualAddress)))
     {
-        /* Invalid PXE, PPE, PDE or PTE, return FALSE */
+        /* Invalid PTE, return FALSE */
         return FALSE;
     }
 
@@ -101,6 +108,9 @@ MM::Pte::InitializePageTable(VOID)
     /* Enable the Global Paging (PGE) feature */
     AR::CpuFunctions::WriteControlRegister(4, AR::CpuFunctions::ReadControlRegister(4) | CR4_PGE);
 
+    /* Large pages are architecturally supported in long mode */
+    LargePageSupport = TRUE;
+
     /* Check XPA status */
     if(Xpa)
     {
@@ -0,0 +1,205 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/amd64/tlb.cc
+ * DESCRIPTION:     Translation Lookaside Buffer (TLB) support for AMD64 architecture
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Enables process-context identifiers (PCIDs) on the current processor, if supported.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note PCIDs are used only together with INVPCID, which is required to invalidate translations of address spaces
+ *       that are not currently loaded. Otherwise, the TLB is flushed on every address space switch.
+ */
+XTAPI
+VOID
+MM::Tlb::EnableAddressSpaceIds(VOID)
+{
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+    BOOLEAN Supported;
+
+    /* Check if the processor supports both PCID and INVPCID */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+    Supported = ((Prcb->CpuId.FeatureBits & (KCF_PCID | KCF_INVPCID)) == (KCF_PCID | KCF_INVPCID));
+
+    /* Check if this is the boot processor, registering before any other one */
+    if(ShootdownProcessors == 0)
+    {
+        /* Check if address space identifiers are supported */
+        if(Supported)
+        {
+            /* Initialize the identifiers bitmap and reserve identifier 0 for untagged address spaces */
+            KE::SpinLock::InitializeSpinLock(&AddressSpaceIdLock);
+            RTL::BitMap::InitializeBitMap(&AddressSpaceIdMap, AddressSpaceIdMapBuffer, MM_ADDRESS_SPACE_IDS);
+            RTL::BitMap::ClearAllBits(&AddressSpaceIdMap);
+            RTL::BitMap::SetBits(&AddressSpaceIdMap, 0, 1);
+
+            /* Enable address space identifiers */
+            AddressSpaceIdSupport = TRUE;
+        }
+    }
+
+    /* Check if address space identifiers are in use */
+    if(AddressSpaceIdSupport)
+    {
+        /* All processors must be able to handle tagged address spaces */
+        if(!Supported)
+        {
+            /* Unsupported processor configuration */
+            KE::Crash::Panic(0x5D, KCF_PCID | KCF_INVPCID, Prcb->CpuId.FeatureBits, 0, 0);
+        }
+
+        /* Enable PCIDs, the kernel address space is loaded with identifier 0 */
+        AR::CpuFunctions::WriteControlRegister(4, AR::CpuFunctions::ReadControlRegister(4) | CR4_PCIDE);
+        Prcb->AddressSpaceId = 0;
+        Prcb->StaleAddressSpaceIds = FALSE;
+    }
+}
+
+/**
+ * Invalidates the translations of the current processor queued in a TLB flush batch.
+ *
+ * @param Batch
+ *        Supplies a pointer to the TLB flush batch to process.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::FlushLocalTlb(IN PMMTLB_FLUSH_BATCH Batch)
+{
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+    PVOID VirtualAddress;
+    PFN_COUNT Page;
+    ULONG Index;
+
+    /* Get current processor control block */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+
+    /* Check if the entire TLB should be flushed */
+    if(Batch->FlushEntireTlb)
+    {
+        /* Check if address space identifiers are in use */
+        if(AddressSpaceIdSupport)
+        {
+            /* Flush translations of all address spaces, including global entries */
+            AR::CpuFunctions::InvalidateTlbContext(INVPCID_ALL_CONTEXTS_GLOBAL, 0, NULLPTR);
+            Prcb->StaleAddressSpaceIds = FALSE;
+        }
+        else
+        {
+            /* Flush the entire TLB, including global entries */
+            MM::Paging::FlushTlb();
+        }
+
+        /* Nothing more to flush */
+        return;
+    }
+
+    /* Iterate through all queued ranges */
+    for(Index = 0; Index < Batch->Count; Index++)
+    {
+        /* Get the first address of the range */
+        VirtualAddress = Batch->Ranges[Index].VirtualAddress;
+
+        /* Check if address space identifiers are in use */
+        if(AddressSpaceIdSupport)
+        {
+            /* Check if the range belongs to the user space */
+            if(VirtualAddress <= MM::Manager::GetMemoryLayout()->UserSpaceEnd)
+            {
+                /* Check if the address space is tagged */
+                if(Batch->AddressSpaceId != 0)
+                {
+                    /* Invalidate each page in the tagged address space, whether it is loaded or not */
+                    for(Page = 0; Page < Batch->Ranges[Index].NumberOfPages; Page++)
+                    {
+                        /* Invalidate the TLB entry */
+                        AR::CpuFunctions::InvalidateTlbContext(INVPCID_INDIVIDUAL_ADDRESS, Batch->AddressSpaceId,
+                                                               (PVOID)((ULONG_PTR)VirtualAddress +
+                                                                       ((ULONG_PTR)Page << MM_PAGE_SHIFT)));
+                    }
+
+                    /* Continue with the next range */
+                    continue;
+                }
+            }
+            else if(Prcb->StaleAddressSpaceIds)
+            {
+                /* Kernel translations may also be cached under identifiers loaded earlier, flush all of them */
+                AR::CpuFunctions::InvalidateTlbContext(INVPCID_ALL_CONTEXTS_GLOBAL, 0, NULLPTR);
+                Prcb->StaleAddressSpaceIds = FALSE;
+                return;
+            }
+        }
+
+        /* Invalidate each page in the range */
+        for(Page = 0; Page < Batch->Ranges[Index].NumberOfPages; Page++)
+        {
+            /* Invalidate the TLB entry */
+            AR::CpuFunctions::InvalidateTlbEntry((PVOID)((ULONG_PTR)VirtualAddress +
+                                                         ((ULONG_PTR)Page << MM_PAGE_SHIFT)));
+        }
+    }
+}
+
+/**
+ * Loads the address space of the specified process on the current processor.
+ *
+ * @param Process
+ *        Supplies a pointer to the process whose address space will be loaded.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must run at DISPATCH_LEVEL or above. Tagged address spaces keep their translations across
+ *       the switch, untagged ones are flushed.
+ */
+XTAPI
+VOID
+MM::Tlb::SwitchAddressSpace(IN PKPROCESS Process)
+{
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+
+    /* Check if address space identifiers are in use */
+    if(!AddressSpaceIdSupport)
+    {
+        /* Load the page directory, flushing all non-global translations */
+        AR::CpuFunctions::WriteControlRegister(3, Process->DirectoryTable[0]);
+        return;
+    }
+
+    /* Get current processor control block */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+
+    /* Check if a different identifier is going to be loaded */
+    if(Prcb->AddressSpaceId != Process->AddressSpaceId)
+    {
+        /* Translations tagged with the previous identifier stay cached */
+        Prcb->StaleAddressSpaceIds = TRUE;
+        Prcb->AddressSpaceId = Process->AddressSpaceId;
+    }
+
+    /* Check if the address space is tagged */
+    if(Process->AddressSpaceId != 0)
+    {
+        /* Load the page directory, preserving translations cached under its identifier */
+        AR::CpuFunctions::WriteControlRegister(3, Process->DirectoryTable[0] | Process->AddressSpaceId | CR3_NOFLUSH);
+    }
+    else
+    {
+        /* Load the page directory, flushing untagged translations */
+        AR::CpuFunctions::WriteControlRegister(3, Process->DirectoryTable[0]);
+    }
+}
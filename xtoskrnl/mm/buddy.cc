@@ -0,0 +1,284 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/buddy.cc
+ * DESCRIPTION:     Memory Manager buddy index of free physical page blocks
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Finds a naturally aligned block of free physical pages of the given order.
+ *
+ * @param Order
+ *        Specifies the order of the block, which spans 2^Order pages.
+ *
+ * @param HighestPage
+ *        Supplies the highest acceptable page frame number of the block.
+ *
+ * @param BasePage
+ *        Supplies a pointer to a variable that receives the first page frame number of the block.
+ *
+ * @return This routine returns TRUE if a free block was found, or FALSE otherwise.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the PFN database lock. Requests not limited by the physical address get the highest
+ *       free block, while limited requests get the lowest one, so that low memory is left for constrained devices.
+ */
+XTAPI
+BOOLEAN
+MM::Buddy::FindFreeBlock(IN ULONG Order,
+                         IN PFN_NUMBER HighestPage,
+                         OUT PPFN_NUMBER BasePage)
+{
+    BOOLEAN PreferHighest;
+    PFN_NUMBER Index;
+    ULONG Height;
+
+    /* Make sure the index is initialized and describes a free block big enough */
+    if(!BlockTree || Order > MaximumOrder || BlockTree[1] <= Order)
+    {
+        /* No suitable free block, return failure */
+        return FALSE;
+    }
+
+    /* Check whether the request is limited by the physical address */
+    PreferHighest = (HighestPage >= LeafCount - 1) ? TRUE : FALSE;
+
+    /* Descend from the root towards a free block of the requested order */
+    Index = 1;
+    for(Height = MaximumOrder; Height > Order; Height--)
+    {
+        /* Move to the left child */
+        Index <<= 1;
+
+        /* Check which child should be preferred */
+        if(PreferHighest)
+        {
+            /* Move to the right child, if it holds a free block big enough */
+            if(BlockTree[Index + 1] > Order)
+            {
+                /* Take the right child */
+                Index++;
+            }
+        }
+        else if(BlockTree[Index] <= Order)
+        {
+            /* The left child does not hold a free block big enough, take the right child */
+            Index++;
+        }
+    }
+
+    /* Calculate the first page of the block */
+    *BasePage = (Index - (LeafCount >> Order)) << Order;
+
+    /* Make sure the whole block lies below the highest acceptable page */
+    if(*BasePage + ((PFN_NUMBER)1 << Order) - 1 > HighestPage)
+    {
+        /* The lowest free block is above the limit, return failure */
+        return FALSE;
+    }
+
+    /* Return success */
+    return TRUE;
+}
+
+/**
+ * Calculates the order of the smallest block, which satisfies the given size and alignment.
+ *
+ * @param PageCount
+ *        Supplies the number of pages the block must span.
+ *
+ * @param Alignment
+ *        Supplies the required alignment of the block, in pages. Must be a power of two.
+ *
+ * @return This routine returns the order of the block.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Buddy::GetBlockOrder(IN PFN_NUMBER PageCount,
+                         IN PFN_NUMBER Alignment)
+{
+    ULONG Order;
+
+    /* Find the smallest power of two covering both the size and the alignment */
+    Order = 0;
+    while(Order < (sizeof(PFN_NUMBER) * 8) - 1 &&
+          (((PFN_NUMBER)1 << Order) < PageCount || ((PFN_NUMBER)1 << Order) < Alignment))
+    {
+        /* Try the next order */
+        Order++;
+    }
+
+    /* Return the block order */
+    return Order;
+}
+
+/**
+ * Allocates and clears the buddy index, covering every physical page in the system.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The index is a complete binary tree, where every node holds one more than the order of the largest free
+ *       block found below it. It takes two bytes per physical page.
+ */
+XTAPI
+VOID
+MM::Buddy::InitializeBuddyIndex(VOID)
+{
+    PFN_NUMBER HighestPage;
+    XTSTATUS Status;
+    PUCHAR Tree;
+    ULONG Order;
+
+    /* Get the highest physical page and find the number of leaves covering it */
+    HighestPage = MM::Pfn::GetHighestPhysicalPage();
+    Order = 0;
+    while(((PFN_NUMBER)1 << Order) <= HighestPage)
+    {
+        /* Try the next order */
+        Order++;
+    }
+
+    /* Allocate memory for the tree */
+    Status = MM::Allocator::AllocatePool(NonPagedPool,
+                                         ((PFN_NUMBER)1 << Order) * 2,
+                                         (PVOID *)&Tree,
+                                         SIGNATURE32('M', 'M', 'g', 'r'));
+    if(Status != STATUS_SUCCESS || !Tree)
+    {
+        /* Memory allocation failed, kernel panic */
+        DebugPrint(L"Insufficient memory for the buddy index! Install additional memory\n");
+        KE::Crash::Panic(0x7D, MM::Pfn::GetNumberOfPhysicalPages(), 0, HighestPage, 0x103);
+    }
+
+    /* Mark all pages as being in use */
+    RTL::Memory::ZeroMemory(Tree, ((PFN_NUMBER)1 << Order) * 2);
+
+    /* Publish the tree */
+    LeafCount = (PFN_NUMBER)1 << Order;
+    MaximumOrder = Order;
+    BlockTree = Tree;
+}
+
+/**
+ * Records a free physical page in the buddy index, merging it with its free buddies.
+ *
+ * @param PageFrameIndex
+ *        Supplies the page frame number of the free page.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the PFN database lock. Page 0 is never recorded, as it cannot be told apart from
+ *       a failed allocation.
+ */
+XTAPI
+VOID
+MM::Buddy::InsertPage(IN PFN_NUMBER PageFrameIndex)
+{
+    /* Make sure the index is initialized and covers the page */
+    if(!BlockTree || PageFrameIndex == 0 || PageFrameIndex >= LeafCount)
+    {
+        /* Nothing to record */
+        return;
+    }
+
+    /* Mark the page as free and update its ancestors */
+    BlockTree[LeafCount + PageFrameIndex] = 1;
+    UpdateBlockTree(LeafCount + PageFrameIndex);
+}
+
+/**
+ * Checks whether the buddy index has been initialized.
+ *
+ * @return This routine returns TRUE if the buddy index is available, or FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::Buddy::IsIndexInitialized(VOID)
+{
+    /* Check if the tree has been published */
+    return (BlockTree != NULLPTR) ? TRUE : FALSE;
+}
+
+/**
+ * Removes a physical page, that is no longer free, from the buddy index, splitting the blocks containing it.
+ *
+ * @param PageFrameIndex
+ *        Supplies the page frame number of the page.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the PFN database lock.
+ */
+XTAPI
+VOID
+MM::Buddy::RemovePage(IN PFN_NUMBER PageFrameIndex)
+{
+    /* Make sure the index is initialized and covers the page */
+    if(!BlockTree || PageFrameIndex >= LeafCount)
+    {
+        /* Nothing to remove */
+        return;
+    }
+
+    /* Mark the page as being in use and update its ancestors */
+    BlockTree[LeafCount + PageFrameIndex] = 0;
+    UpdateBlockTree(LeafCount + PageFrameIndex);
+}
+
+/**
+ * Propagates a change of a leaf in the buddy index towards the root.
+ *
+ * @param Index
+ *        Supplies the index of the changed leaf.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The walk stops at the first ancestor, whose value did not change, so that linking a run of pages costs
+ *       a constant amount of work per page on average.
+ */
+XTAPI
+VOID
+MM::Buddy::UpdateBlockTree(IN PFN_NUMBER Index)
+{
+    UCHAR Left, Right, Value;
+    ULONG Height;
+
+    /* Walk up the tree, starting from the leaf */
+    for(Height = 0; Index > 1; Height++)
+    {
+        /* Get the values of the node and its buddy */
+        Left = BlockTree[Index & ~(PFN_NUMBER)1];
+        Right = BlockTree[Index | 1];
+
+        /* Merge both buddies when they are entirely free, otherwise take the larger free block */
+        Value = (Left == Height + 1 && Right == Height + 1) ? (UCHAR)(Height + 2) : MAX(Left, Right);
+
+        /* Move to the parent node and check if its value changes */
+        Index >>= 1;
+        if(BlockTree[Index] == Value)
+        {
+            /* The remaining ancestors are up to date */
+            break;
+        }
+
+        /* Update the parent node */
+        BlockTree[Index] = Value;
+    }
+}
@@ -20,19 +20,176 @@ XTAPI
 VOID
 MM::Colors::ComputePageColoring(VOID)
 {
-    UNIMPLEMENTED;
+    ULONG CacheLevel, CacheSize, CacheWays, Colors;
+    WCHAR ParameterValue[16];
 
-    /* Compute L2 paging colors and mask */
-    PagingColors = MM_PAGING_COLORS;
+    /* Derive the number of colors from the cache geometry reported by the processor */
+    Colors = DetectPagingColors(&CacheLevel, &CacheSize, &CacheWays);
+
+    /* Check if user forced a specific number of page colors */
+    if(KE::BootInformation::GetKernelParameterValue(L"PAGECOLORS", ParameterValue, 16) == STATUS_SUCCESS)
+    {
+        /* Convert string value to number */
+        if(RTL::WideString::WideStringToNumber(ParameterValue, 0, &Colors) == STATUS_SUCCESS)
+        {
+            /* Drop the detected cache geometry, so that the override is reported */
+            CacheLevel = 0;
+        }
+    }
+
+    /* Check if the number of colors is known */
+    if(Colors == 0)
+    {
+        /* Cache geometry unavailable, fall back to the default number of colors */
+        Colors = MM_PAGING_COLORS;
+        CacheLevel = 0;
+    }
+
+    /* Clamp the number of colors to the supported range */
+    Colors = MIN(Colors, MM_MAXIMUM_PAGING_COLORS);
+
+    /* Round the number of colors down to a power of two, so that colors can be computed with a mask */
+    PagingColors = 1 << (31 - RTL::Math::CountLeadingZeroes32(Colors));
     PagingColorsMask = PagingColors - 1;
+
+    /* Report the chosen page coloring */
+    if(CacheLevel)
+    {
+        /* Colors derived from the cache geometry */
+        DebugPrint(L"Using %lu page colors for %lu KB, %lu-way L%lu cache\n",
+                   PagingColors, CacheSize, CacheWays, CacheLevel);
+    }
+    else
+    {
+        /* Colors forced by user or the default value */
+        DebugPrint(L"Using %lu page colors\n", PagingColors);
+    }
+}
+
+/**
+ * Derives the number of page colors from the cache geometry reported by CPUID. The L2 cache is preferred, otherwise
+ * the highest level data or unified cache is used.
+ *
+ * @param CacheLevel
+ *        Supplies a pointer to a variable that will receive the level of the selected cache, or 0 if none found.
+ *
+ * @param CacheSize
+ *        Supplies a pointer to a variable that will receive the size of the selected cache, in kilobytes.
+ *
+ * @param CacheWays
+ *        Supplies a pointer to a variable that will receive the associativity of the selected cache.
+ *
+ * @return This routine returns the number of page colors, or 0 if the cache geometry is unavailable.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Colors::DetectPagingColors(OUT PULONG CacheLevel,
+                               OUT PULONG CacheSize,
+                               OUT PULONG CacheWays)
+{
+    ULONG Colors, Leaf, Level, LineSize, MaximumExtendedLeaf, MaximumLeaf, Partitions, Sets, SubLeaf, Type, Ways;
+    PKPROCESSOR_CONTROL_BLOCK Prcb;
+    CPUID_REGISTERS CpuRegisters;
+    ULONG Leaves[2];
+    ULONG Index;
+
+    /* Assume no cache information is available */
+    *CacheLevel = 0;
+    *CacheSize = 0;
+    *CacheWays = 0;
+    Colors = 0;
+
+    /* Get the highest standard and extended CPUID leaves recorded at processor identification */
+    Prcb = KE::Processor::GetCurrentProcessorControlBlock();
+    MaximumExtendedLeaf = Prcb->CpuId.MaxExtendedLeaf;
+    MaximumLeaf = Prcb->CpuId.MaxStandardLeaf;
+
+    /* Use the deterministic cache parameters leaf, or its extended counterpart on AMD processors */
+    Leaves[0] = (MaximumLeaf >= CPUID_GET_CACHE_TOPOLOGY) ? CPUID_GET_CACHE_TOPOLOGY : 0;
+    Leaves[1] = 0;
+
+    /* Check if the extended cache topology leaf is available */
+    if(MaximumExtendedLeaf >= CPUID_GET_EXTENDED_CACHE_TOPOLOGY)
+    {
+        /* Check if topology extensions are supported */
+        if(Prcb->CpuId.ExtendedFeatureBits & KCF_TOPOEXT)
+        {
+            /* Extended cache topology leaf is available */
+            Leaves[1] = CPUID_GET_EXTENDED_CACHE_TOPOLOGY;
+        }
+    }
+
+    /* Try both leaves, until a cache is found */
+    for(Index = 0; Index < 2 && *CacheLevel == 0; Index++)
+    {
+        /* Skip unavailable leaf */
+        Leaf = Leaves[Index];
+        if(Leaf == 0)
+        {
+            /* Leaf not supported */
+            continue;
+        }
+
+        /* Enumerate all caches reported by the leaf */
+        for(SubLeaf = 0; SubLeaf < 16; SubLeaf++)
+        {
+            /* Get the cache parameters */
+            CpuRegisters.Leaf = Leaf;
+            CpuRegisters.SubLeaf = SubLeaf;
+            AR::CpuFunctions::CpuId(&CpuRegisters);
+
+            /* Get the cache type and check if there are no more caches */
+            Type = CpuRegisters.Eax & 0x1F;
+            if(Type == 0)
+            {
+                /* End of the cache list */
+                break;
+            }
+
+            /* Skip instruction caches */
+            if(Type != 1 && Type != 3)
+            {
+                /* Not a data or unified cache */
+                continue;
+            }
+
+            /* Prefer the L2 cache, otherwise take the highest level cache */
+            Level = (CpuRegisters.Eax >> 5) & 0x7;
+            if(*CacheLevel == 2 || (Level != 2 && Level <= *CacheLevel))
+            {
+                /* Better cache already selected */
+                continue;
+            }
+
+            /* Decode the cache geometry */
+            Ways = (CpuRegisters.Ebx >> 22) + 1;
+            Partitions = ((CpuRegisters.Ebx >> 12) & 0x3FF) + 1;
+            LineSize = (CpuRegisters.Ebx & 0xFFF) + 1;
+            Sets = CpuRegisters.Ecx + 1;
+
+            /* Each color covers the cache sets mapped by one page, so the number of colors is the way size in pages */
+            *CacheLevel = Level;
+            *CacheSize = (Ways * Partitions * LineSize * Sets) / 1024;
+            *CacheWays = Ways;
+            Colors = (Partitions * LineSize * Sets) / MM_PAGE_SIZE;
+        }
+    }
+
+    /* Return the number of colors */
+    return Colors;
 }
 
 /**
- * Retrieves a pointer to the color table for a specific page list and color.
+ * Retrieves a pointer to the color table for a specific page list, NUMA node and color.
  *
  * @param PageList
  *        The page list type (e.g., FreePageList, ZeroedPageList).
  *
+ * @param Node
+ *        Supplies the NUMA node owning the pages.
+ *
  * @param Color
  *        Supplies the specific color index.
  *
@@ -43,10 +200,11 @@ MM::Colors::ComputePageColoring(VOID)
 XTAPI
 PMMCOLOR_TABLES
 MM::Colors::GetFreePages(IN MMPAGELISTS PageList,
+                         IN ULONG Node,
                          IN ULONG Color)
 {
-    /* Return a pointer to the requested color table entry */
-    return &FreePages[PageList][Color];
+    /* Return a pointer to the requested color table entry, each node having its own set of colors */
+    return &FreePages[PageList][(Node * PagingColors) + Color];
 }
 
 /**
@@ -63,7 +221,8 @@ XTAPI
 PMMPFNLIST
 MM::Colors::GetModifiedPages(IN ULONG Color)
 {
-    return &ModifiedPages[Color];
+    /* Return the modified page list, wrapping the color into the configured range */
+    return &ModifiedPages[Color & PagingColorsMask];
 }
 
 /**
@@ -77,8 +236,8 @@ XTAPI
 ULONG
 MM::Colors::GetNextColor(VOID)
 {
-    /* Increment the color counter and wrap it around using the mask */
-    return ((++PagingColors) & PagingColorsMask);
+    /* Increment the color counter, without touching the number of colors, and wrap it around using the mask */
+    return (RTL::Atomic::Increment32((PLONG)&NextColor) & PagingColorsMask);
 }
 
 /**
@@ -123,47 +282,28 @@ VOID
 MM::Colors::InitializeColorTables(VOID)
 {
     PMMMEMORY_LAYOUT MemoryLayout;
-    PMMPTE PointerPte, LastPte;
-    ULONG Color;
-    PMMPTE ValidPte;
+    ULONG Color, NodeColors;
 
-    /* Get the memory layout */
+    /* Get the memory layout and the number of colors in all NUMA nodes */
     MemoryLayout = MM::Manager::GetMemoryLayout();
+    NodeColors = PagingColors * MM::Numa::GetNodeCount();
 
     /* Set the base address of the color tables to start right after the PFN database */
     FreePages[0] = (PMMCOLOR_TABLES)&((PMMPFN)MemoryLayout->PfnDatabase)[MM::Pfn::GetHighestPhysicalPage() + 1];
 
-    /* Calculate the virtual address range for both color tables */
-    PointerPte = MM::Paging::GetPteAddress(&FreePages[0][0]);
-    LastPte = MM::Paging::GetPteAddress((PVOID)((ULONG_PTR)FreePages[0] +
-                                        (2 * PagingColors * sizeof(MMCOLOR_TABLES)) - 1));
-
-    /* Get a pointer to a PTE template */
-    ValidPte = MM::Pte::GetValidPte();
-
-    /* Ensure the entire virtual address range for the color tables is mapped */
-    while(PointerPte <= LastPte)
-    {
-        /* Check if a page in the range is not mapped */
-        if(!MM::Paging::PteValid(PointerPte))
-        {
-            /* Use the bootstrap allocator to get a physical page */
-            MM::Paging::SetPte(ValidPte, MM::Pfn::AllocateBootstrapPages(1), 0);
-            *PointerPte = *ValidPte;
-
-            /* Zero out the newly mapped page */
-            RTL::Memory::ZeroMemory(MM::Paging::GetPteVirtualAddress(PointerPte), MM_PAGE_SIZE);
-        }
-
-        /* Move to the next PTE in the range */
-        PointerPte = MM::Paging::GetNextPte(PointerPte);
-    }
+    /* Ensure the entire virtual address range for the color tables is mapped, using large pages wherever possible */
+    MM::Pte::MapLargePages(&FreePages[0][0],
+                           (PVOID)((ULONG_PTR)FreePages[0] +
+                                   (2 * NodeColors * sizeof(MMCOLOR_TABLES)) +
+                                   (PagingColors * sizeof(MMPFNLIST)) - 1),
+                           MM::Pte::GetValidPte());
 
-    /* Set the pointer for the second list */
-    FreePages[1] = &FreePages[0][PagingColors];
+    /* Set the pointer for the second list and place the modified page lists right after it */
+    FreePages[1] = &FreePages[0][NodeColors];
+    ModifiedPages = (PMMPFNLIST)&FreePages[1][NodeColors];
 
     /* Initialize all entries in both color tables */
-    for(Color = 0; Color < PagingColors; Color++)
+    for(Color = 0; Color < NodeColors; Color++)
     {
         /* Initialize the FreePageList entry for the current color */
         FreePages[FreePageList][Color].Flink = MAXULONG_PTR;
@@ -175,4 +315,14 @@ MM::Colors::InitializeColorTables(VOID)
         FreePages[ZeroedPageList][Color].Blink = (PVOID)MAXULONG_PTR;
         FreePages[ZeroedPageList][Color].Count = 0;
     }
+
+    /* Initialize the modified page lists, which are not split by NUMA node */
+    for(Color = 0; Color < PagingColors; Color++)
+    {
+        /* Initialize the modified page list for the current color */
+        ModifiedPages[Color].Total = 0;
+        ModifiedPages[Color].ListName = ModifiedPageList;
+        ModifiedPages[Color].Flink = MAXULONG_PTR;
+        ModifiedPages[Color].Blink = MAXULONG_PTR;
+    }
 }
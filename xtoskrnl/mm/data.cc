@@ -27,29 +27,38 @@ SIZE_T MM::Allocator::AllocationsTrackingTableMask;
 /* Total number of entries in the global allocations tracking table */
 SIZE_T MM::Allocator::AllocationsTrackingTableSize;
 
-/* Active number of big allocations to trigger table expansion */
-ULONG MM::Allocator::BigAllocationsInUse;
+/* Lock-striped shards of the hash table tracking page-aligned memory */
+POOL_TRACKING_BIG_ALLOCATIONS_SHARD MM::Allocator::BigAllocationsShards[MM_POOL_BIG_ALLOCATIONS_SHARDS];
 
-/* Pointer to the hash table for tracking page-aligned memory */
-PPOOL_TRACKING_BIG_ALLOCATIONS MM::Allocator::BigAllocationsTrackingTable;
+/* Generation number of the pool lookaside lists flush requests */
+ULONG MM::Allocator::LookasideFlushGeneration;
 
-/* Bitmask used for fast modulo arithmetic during hash bucket lookups */
-SIZE_T MM::Allocator::BigAllocationsTrackingTableHash;
+/* Interrupt time at which the pool monitor prints the next pool tag statistics */
+ULONGLONG MM::Allocator::PoolTagMonitorDeadline;
 
-/* Spinlock protecting the big allocations table */
-KSPIN_LOCK MM::Allocator::BigAllocationsTrackingTableLock;
-
-/* Maximum capacity of the tracking hash table */
-SIZE_T MM::Allocator::BigAllocationsTrackingTableSize;
+/* Interval between the pool tag statistics dumps, in 100ns units, or 0 if disabled */
+ULONGLONG MM::Allocator::PoolTagMonitorInterval;
 
 /* Array of CPU-local tracking tables */
 PPOOL_TRACKING_TABLE MM::Allocator::TagTables[MM_POOL_TRACKING_TABLES];
 
+/* Buddy index of free physical page blocks, laid out as a complete binary tree */
+PUCHAR MM::Buddy::BlockTree;
+
+/* Number of leaves of the buddy index, each describing a single physical page */
+PFN_NUMBER MM::Buddy::LeafCount;
+
+/* Order of the largest block described by the buddy index */
+ULONG MM::Buddy::MaximumOrder;
+
 /* Array of free page lists segregated by cache color */
 PMMCOLOR_TABLES MM::Colors::FreePages[FreePageList + 1];
 
 /* Array of modified pages segregated by cache color */
-MMPFNLIST MM::Colors::ModifiedPages[MM_PAGING_COLORS] = {{0, ModifiedPageList, MAXULONG_PTR, MAXULONG_PTR}};
+PMMPFNLIST MM::Colors::ModifiedPages;
+
+/* Counter used to hand out page colors in a round-robin fashion */
+ULONG MM::Colors::NextColor;
 
 /* Number of supported page colors */
 ULONG MM::Colors::PagingColors;
@@ -60,12 +69,24 @@ ULONG MM::Colors::PagingColorsMask;
 /* Allocation descriptors dedicated for hardware layer */
 LOADER_MEMORY_DESCRIPTOR MM::HardwarePool::HardwareAllocationDescriptors[MM_HARDWARE_ALLOCATION_DESCRIPTORS];
 
-/* Live address of kernel's hardware heap */
-PVOID MM::HardwarePool::HardwareHeapStart = MM_HARDWARE_HEAP_START_ADDRESS;
+/* Bitmap of the kernel's hardware heap pages in use */
+RTL_BITMAP MM::HardwarePool::HardwareHeapBitMap = {MM_HARDWARE_HEAP_PAGES, MM::HardwarePool::HardwareHeapBitMapBuffer};
+
+/* Buffer backing the hardware heap bitmap */
+ULONG_PTR MM::HardwarePool::HardwareHeapBitMapBuffer[MM_HARDWARE_HEAP_PAGES / (sizeof(ULONG_PTR) * 8)];
+
+/* Spinlock protecting the hardware heap bitmap */
+KSPIN_LOCK MM::HardwarePool::HardwareHeapLock;
 
 /* Number of used hardware allocation descriptors */
 ULONG MM::HardwarePool::UsedHardwareAllocationDescriptors = 0;
 
+/* Number of kernel stacks kept in each processor's kernel stack cache */
+ULONG MM::KernelPool::KernelStackCacheDepth;
+
+/* Generation number of the kernel stack caches flush requests */
+ULONG MM::KernelPool::KernelStackFlushGeneration;
+
 /* Global structure describing the virtual memory layout of the system */
 MMMEMORY_LAYOUT MM::Manager::MemoryLayout;
 
@@ -75,6 +96,30 @@ PFN_NUMBER MM::Manager::NumberOfSystemPtes;
 /* Physical memory block descriptor */
 PPHYSICAL_MEMORY_DESCRIPTOR MM::Manager::PhysicalMemoryBlock;
 
+/* Number of memory ranges described by the affinity table */
+ULONG MM::Numa::MemoryRangeCount;
+
+/* Physical memory ranges and NUMA nodes owning them */
+MMNUMA_MEMORY_RANGE MM::Numa::MemoryRanges[MM_MAXIMUM_NUMA_MEMORY_RANGES];
+
+/* Number of NUMA nodes */
+ULONG MM::Numa::NodeCount;
+
+/* Relative memory access distances between NUMA nodes */
+UCHAR MM::Numa::NodeDistances[MM_MAXIMUM_NUMA_NODES][MM_MAXIMUM_NUMA_NODES];
+
+/* Per-node list of NUMA nodes sorted by their distance */
+UCHAR MM::Numa::NodeOrder[MM_MAXIMUM_NUMA_NODES][MM_MAXIMUM_NUMA_NODES];
+
+/* NUMA node of each processor */
+UCHAR MM::Numa::ProcessorNodes[MAXIMUM_PROCESSORS];
+
+/* ACPI proximity domains backing the NUMA nodes */
+ULONG MM::Numa::ProximityDomains[MM_MAXIMUM_NUMA_NODES];
+
+/* Page map range routines bound to the current PML level */
+MM::PAGEMAP_RANGE_ROUTINES MM::Paging::PmlRangeRoutines;
+
 /* Instance of the page map routines for the current PML level */
 MM::PPAGEMAP MM::Paging::PmlRoutines;
 
@@ -84,6 +129,36 @@ PFN_NUMBER MM::Pfn::AvailablePages;
 /* Head of the list containing physical pages marked as defective */
 MMPFNLIST MM::Pfn::BadPagesList = {0, BadPageList, MAXULONG_PTR, MAXULONG_PTR};
 
+/* Pages skipped by aligned bootstrap allocations, reused for subsequent bootstrap allocations */
+LOADER_MEMORY_DESCRIPTOR MM::Pfn::BootstrapPaddingDescriptor;
+
+/* Number of deferred PFN database chunks already initialized */
+LONG MM::Pfn::CompletedDeferredChunks;
+
+/* First page of the region reserved for physically contiguous allocations */
+PFN_NUMBER MM::Pfn::ContiguousReserveBase;
+
+/* Number of pages in the region reserved for physically contiguous allocations */
+PFN_NUMBER MM::Pfn::ContiguousReservePages;
+
+/* Indicates whether initialization of high memory is deferred until application processors are up */
+BOOLEAN MM::Pfn::DeferHighMemory;
+
+/* Number of chunks the deferred PFN database runs are split into */
+LONG MM::Pfn::DeferredChunkCount;
+
+/* Number of free pages whose PFN database initialization has been deferred */
+PFN_NUMBER MM::Pfn::DeferredPageCount;
+
+/* Number of deferred PFN database runs */
+ULONG MM::Pfn::DeferredRunCount;
+
+/* Free physical memory runs whose PFN database initialization has been deferred */
+PHYSICAL_MEMORY_RUN MM::Pfn::DeferredRuns[MM_MAXIMUM_DEFERRED_PFN_RUNS];
+
+/* Time stamp counter value at the start of the deferred PFN database initialization */
+ULONGLONG MM::Pfn::DeferredStartCycles;
+
 /* Biggest free memory descriptor */
 PLOADER_MEMORY_DESCRIPTOR MM::Pfn::FreeDescriptor;
 
@@ -102,6 +177,12 @@ MMPFNLIST MM::Pfn::ModifiedPagesList = {0, ModifiedPageList, MAXULONG_PTR, MAXUL
 /* List containing modified pages mapped as read-only */
 MMPFNLIST MM::Pfn::ModifiedReadOnlyPagesList = {0, ModifiedReadOnlyPageList, MAXULONG_PTR, MAXULONG_PTR};
 
+/* Next deferred PFN database chunk to be claimed by a processor */
+LONG MM::Pfn::NextDeferredChunk;
+
+/* Color of the next free page to be zeroed by the idle zero page worker */
+ULONG MM::Pfn::NextZeroPageColor;
+
 /* Number of physical pages */
 ULONGLONG MM::Pfn::NumberOfPhysicalPages;
 
@@ -130,8 +211,29 @@ MMPFNLIST MM::Pfn::StandbyPagesList = {0, StandbyPageList, MAXULONG_PTR, MAXULON
 /* List containing free physical pages that have been zeroed out */
 MMPFNLIST MM::Pfn::ZeroedPagesList = {0, ZeroedPageList, MAXULONG_PTR, MAXULONG_PTR};
 
-/* Non-paged pool descriptor */
-POOL_DESCRIPTOR MM::Pool::NonPagedPoolDescriptor;
+/* Bitmap of the guard page pool PTEs in use */
+RTL_BITMAP MM::Pool::GuardPoolBitMap = {MM_POOL_GUARD_PTES, MM::Pool::GuardPoolBitMapBuffer};
+
+/* Buffer backing the guard page pool bitmap */
+ULONG_PTR MM::Pool::GuardPoolBitMapBuffer[MM_POOL_GUARD_PTES / (sizeof(ULONG_PTR) * 8)];
+
+/* Guard page pool PTE at which the next allocation search starts */
+ULONG_PTR MM::Pool::GuardPoolHint;
+
+/* Spinlock protecting the guard page pool bitmap */
+KSPIN_LOCK MM::Pool::GuardPoolLock;
+
+/* Virtual address of the PTEs reserved for the guard page pool */
+PVOID MM::Pool::GuardPoolStart;
+
+/* Pool tag served from the guard page pool, or 0 if the guard page pool is disabled */
+ULONG MM::Pool::GuardPoolTag;
+
+/* Per-node non-paged pool descriptors */
+POOL_DESCRIPTOR MM::Pool::NonPagedPoolDescriptors[MM_MAXIMUM_NUMA_NODES];
+
+/* Per-node spinlocks protecting the free block lists of the non-paged pool descriptors */
+KSPIN_LOCK MM::Pool::NonPagedPoolDescriptorLocks[MM_MAXIMUM_NUMA_NODES];
 
 /* PFN marking the initial non-paged pool end boundary */
 PFN_NUMBER MM::Pool::NonPagedPoolFrameEnd;
@@ -139,8 +241,35 @@ PFN_NUMBER MM::Pool::NonPagedPoolFrameEnd;
 /* PFN marking the initial non-paged pool start boundary */
 PFN_NUMBER MM::Pool::NonPagedPoolFrameStart;
 
-/* Array of non-paged pool free list heads */
-LIST_ENTRY MM::Pool::NonPagedPoolFreeList[MM_MAX_FREE_PAGE_LIST_HEADS];
+/* Array of non-paged pool free list heads, indexed by free run size class */
+LIST_ENTRY MM::Pool::NonPagedPoolFreeList[MM_FREE_PAGE_RUN_LISTS];
+
+/* Bitmap of non-paged pool free run first level size classes containing free runs */
+ULONG MM::Pool::NonPagedPoolFreeListBitmap;
+
+/* Bitmaps of non-paged pool free run second level size classes containing free runs */
+ULONG MM::Pool::NonPagedPoolFreeListSubBitmap[MM_FREE_PAGE_RUN_FIRST_LEVELS];
+
+/* NUMA node owning the physical pages backing the initial non-paged pool */
+ULONG MM::Pool::NonPagedPoolNode;
+
+/* Bitmap of paged pool pages reserved by allocations */
+RTL_BITMAP MM::Pool::PagedPoolAllocationMap;
+
+/* Paged pool descriptor */
+POOL_DESCRIPTOR MM::Pool::PagedPoolDescriptor;
+
+/* Lock protecting the free block lists of the paged pool descriptor, acquired at APC_LEVEL */
+KSPIN_LOCK MM::Pool::PagedPoolDescriptorLock;
+
+/* Bitmap of paged pool pages ending an allocation */
+RTL_BITMAP MM::Pool::PagedPoolEndOfAllocationMap;
+
+/* Paged pool page to start the search for free virtual space from */
+ULONG_PTR MM::Pool::PagedPoolHint;
+
+/* Lock protecting the paged pool allocation bitmaps */
+KSPIN_LOCK MM::Pool::PagedPoolLock;
 
 /* Random cookie used to obfuscate pool links */
 ULONG MM::Pool::PoolSecureCookie;
@@ -148,12 +277,30 @@ ULONG MM::Pool::PoolSecureCookie;
 /* Array of pool descriptors */
 PPOOL_DESCRIPTOR MM::Pool::PoolVector[2];
 
-/* Array of lists for available System PTEs, separated by pool type */
-MMPTE MM::Pte::FirstSystemFreePte[MaximumPtePoolTypes];
+/* Level of the pool integrity checks performed on every pool operation */
+ULONG MM::Pool::PoolVerificationLevel = MM_POOL_VERIFY_HEADERS;
+
+/* Indicates whether large pages can be used to map kernel memory */
+BOOLEAN MM::Pte::LargePageSupport;
+
+/* Back links of the free System PTE clusters, indexed by the offset of their first PTE in the pool */
+PULONG MM::Pte::SystemPteBackLinks[MaximumPtePoolTypes];
 
 /* Virtual base address of the System PTE space */
 PMMPTE MM::Pte::SystemPteBase;
 
+/* Bitmaps tracking free System PTEs, separated by pool type */
+RTL_BITMAP MM::Pte::SystemPteBitMap[MaximumPtePoolTypes];
+
+/* Size segregated lists of free System PTE clusters, separated by pool type */
+MMPTE MM::Pte::SystemPteFreeList[MaximumPtePoolTypes][MM_SYSTEM_PTE_LISTS];
+
+/* Bitmaps of System PTE free cluster first level size classes containing free clusters */
+ULONG MM::Pte::SystemPteFreeListBitmap[MaximumPtePoolTypes];
+
+/* Bitmaps of System PTE free cluster second level size classes containing free clusters */
+ULONG MM::Pte::SystemPteFreeListSubBitmap[MaximumPtePoolTypes][MM_SYSTEM_PTE_FIRST_LEVELS];
+
 /* End addresses for the System PTE ranges */
 PMMPTE MM::Pte::SystemPtesEnd[MaximumPtePoolTypes];
 
@@ -165,3 +312,33 @@ PFN_COUNT MM::Pte::TotalSystemFreePtes[MaximumPtePoolTypes];
 
 /* Template PTE entry containing standard flags for a valid, present kernel page */
 MMPTE MM::Pte::ValidPte;
+
+/* Interrupt time of the next periodic performance information dump */
+ULONGLONG MM::Statistics::MonitorDeadline;
+
+/* Interval between periodic performance information dumps, in 100ns units */
+ULONGLONG MM::Statistics::MonitorInterval;
+
+/* Lock protecting the address space identifiers bitmap */
+KSPIN_LOCK MM::Tlb::AddressSpaceIdLock;
+
+/* Bitmap of allocated hardware address space identifiers (PCIDs) */
+RTL_BITMAP MM::Tlb::AddressSpaceIdMap;
+
+/* Buffer backing the address space identifiers bitmap */
+ULONG_PTR MM::Tlb::AddressSpaceIdMapBuffer[MM_ADDRESS_SPACE_IDS / (sizeof(ULONG_PTR) * 8)];
+
+/* Indicates whether address spaces are tagged with hardware identifiers (PCIDs) */
+BOOLEAN MM::Tlb::AddressSpaceIdSupport;
+
+/* Lock serializing TLB shootdown requests */
+LONG MM::Tlb::ShootdownLock;
+
+/* Set of processors that have not completed the current TLB shootdown request yet */
+VOLATILE KAFFINITY MM::Tlb::ShootdownPending;
+
+/* Set of processors able to service TLB shootdown requests */
+VOLATILE KAFFINITY MM::Tlb::ShootdownProcessors;
+
+/* Current TLB shootdown request */
+MMTLB_FLUSH_BATCH MM::Tlb::ShootdownRequest;
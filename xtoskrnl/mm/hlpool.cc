@@ -11,7 +11,8 @@
 
 
 /**
- * Allocates physical memory for kernel hardware layer before memory manager gets initialized.
+ * Allocates physical memory for kernel hardware layer. Before memory manager gets initialized, the memory is carved
+ * out of the boot loader memory descriptors, later it is taken from the buddy index of free page blocks.
  *
  * @param PageCount
  *        Supplies the number of pages to be allocated.
@@ -38,8 +39,9 @@ MM::HardwarePool::AllocateHardwareMemory(IN PFN_NUMBER PageCount,
 {
     PLOADER_MEMORY_DESCRIPTOR Descriptor, ExtraDescriptor, HardwareDescriptor;
     PLIST_ENTRY ListEntry, LoaderMemoryDescriptors;
-    PFN_NUMBER Alignment, MaxPage;
+    PFN_NUMBER Alignment, BasePage, MaxPage;
     ULONGLONG PhysicalAddress;
+    XTSTATUS Status;
 
     /* Assume failure */
     (*Buffer).QuadPart = 0;
@@ -47,6 +49,22 @@ MM::HardwarePool::AllocateHardwareMemory(IN PFN_NUMBER PageCount,
     /* Calculate maximum page address based on the requested limit */
     MaxPage = MaximumAddress >> MM_PAGE_SHIFT;
 
+    /* Check if memory manager has already consumed the boot loader memory descriptors */
+    if(MM::Buddy::IsIndexInitialized())
+    {
+        /* Allocate physically contiguous pages below the maximum page address from the buddy index */
+        Status = MM::Pfn::AllocateContiguousPages(PageCount, Aligned ? 0x10 : 1, MaxPage - 1, &BasePage);
+        if(Status != STATUS_SUCCESS)
+        {
+            /* Failed to allocate memory, return error */
+            return Status;
+        }
+
+        /* Return physical address */
+        (*Buffer).QuadPart = (ULONGLONG)BasePage << MM_PAGE_SHIFT;
+        return STATUS_SUCCESS;
+    }
+
     /* Make sure there are at least 2 descriptors available */
     if((UsedHardwareAllocationDescriptors + 2) > MM_HARDWARE_ALLOCATION_DESCRIPTORS)
     {
@@ -210,6 +228,8 @@ MM::HardwarePool::AllocateRealModeMemory(IN PFN_NUMBER PageCount,
  * @return This routine returns a status code.
  *
  * @since XT 1.0
+ *
+ * @note Free ranges are looked up in the hardware heap bitmap, pages mapped by other means are skipped.
  */
 XTAPI
 XTSTATUS
@@ -218,67 +238,68 @@ MM::HardwarePool::MapHardwareMemory(IN PHYSICAL_ADDRESS PhysicalAddress,
                                     IN BOOLEAN FlushTlb,
                                     OUT PVOID *VirtualAddress)
 {
-    PVOID BaseAddress, ReturnAddress;
-    PFN_NUMBER MappedPages;
+    ULONG_PTR Index, Page;
+    PVOID BaseAddress;
     PMMPTE PtePointer;
 
-    /* Initialize variables */
-    BaseAddress = HardwareHeapStart;
-    MappedPages = 0;
-    ReturnAddress = BaseAddress;
+    /* Initialize the output virtual address */
     *VirtualAddress = NULLPTR;
 
-    /* Iterate through all pages */
-    while(MappedPages < PageCount)
+    /* Start a guarded code block */
     {
-        /* Check if address overflows */
-        if(BaseAddress == NULLPTR)
-        {
-            /* Not enough free pages, return error */
-            return STATUS_INSUFFICIENT_RESOURCES;
-        }
+        /* Raise runlevel to DISPATCH_LEVEL and acquire the hardware heap lock */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard HeapLock(&HardwareHeapLock);
 
-        /* Get PTE pointer and advance to next page */
-        PtePointer = MM::Paging::GetPteAddress(ReturnAddress);
-        ReturnAddress = (PVOID)((ULONG_PTR)ReturnAddress + MM_PAGE_SIZE);
-
-        /* Check if PTE is valid */
-        if(MM::Paging::PteValid(PtePointer))
+        /* Look for a free range of virtual addresses */
+        while(TRUE)
         {
-            /* PTE is not available, go to the next one */
-            BaseAddress = ReturnAddress;
-            MappedPages = 0;
-            continue;
-        }
-
-        /* Increase number of mapped pages */
-        MappedPages++;
-    }
+            /* Find the lowest range of free pages large enough to hold the mapping */
+            Index = RTL::BitMap::FindClearBits(&HardwareHeapBitMap, PageCount, 0);
+            if(Index == MAXULONG_PTR)
+            {
+                /* Not enough free pages, return error */
+                return STATUS_INSUFFICIENT_RESOURCES;
+            }
 
-    /* Take the actual base address with an offset */
-    ReturnAddress = (PVOID)((ULONG_PTR)BaseAddress + PAGE_OFFSET(PhysicalAddress.LowPart));
+            /* Get the base address of the range and its first PTE */
+            BaseAddress = (PVOID)((ULONG_PTR)MM_HARDWARE_HEAP_START_ADDRESS + (Index << MM_PAGE_SHIFT));
+            PtePointer = MM::Paging::GetPteAddress(BaseAddress);
 
-    /* Check if base address starts at the beginning of the heap */
-    if(BaseAddress == HardwareHeapStart)
-    {
-        /* Move heap beyond base address */
-        HardwareHeapStart = (PVOID)((ULONG_PTR)BaseAddress + ((ULONG_PTR)PageCount << MM_PAGE_SHIFT));
-    }
+            /* Make sure none of the pages is already mapped */
+            for(Page = 0; Page < PageCount; Page++)
+            {
+                /* Check if PTE is valid */
+                if(MM::Paging::PteValid(PtePointer))
+                {
+                    /* PTE is not available */
+                    break;
+                }
+
+                /* Get the next PTE */
+                PtePointer = MM::Paging::GetNextPte(PtePointer);
+            }
 
-    /* Iterate through mapped pages */
-    while(MappedPages--)
-    {
-        /* Get PTE pointer */
-        PtePointer = MM::Paging::GetPteAddress(BaseAddress);
+            /* Check if the whole range is available */
+            if(Page == PageCount)
+            {
+                /* Free range found */
+                break;
+            }
 
-        /* Fill the PTE */
-        MM::Paging::SetPte(PtePointer, (PFN_NUMBER)(PhysicalAddress.QuadPart >> MM_PAGE_SHIFT), MM_PTE_READWRITE);
+            /* Page mapped outside of the hardware heap, mark it as permanently in use and look again */
+            RTL::BitMap::SetBit(&HardwareHeapBitMap, Index + Page);
+        }
 
-        /* Advance to the next address */
-        PhysicalAddress.QuadPart += MM_PAGE_SIZE;
-        BaseAddress = (PVOID)((ULONG_PTR)BaseAddress + MM_PAGE_SIZE);
+        /* Mark the range as in use */
+        RTL::BitMap::SetBits(&HardwareHeapBitMap, Index, PageCount);
     }
 
+    /* Fill all PTEs mapping the contiguous physical range */
+    MM::Paging::MapContiguousPtes(MM::Paging::GetPteAddress(BaseAddress),
+                                  (PFN_NUMBER)(PhysicalAddress.QuadPart >> MM_PAGE_SHIFT),
+                                  (PFN_COUNT)PageCount, MM_PTE_READWRITE);
+
     /* Check if TLB needs to be flushed */
     if(FlushTlb)
     {
@@ -286,11 +307,57 @@ MM::HardwarePool::MapHardwareMemory(IN PHYSICAL_ADDRESS PhysicalAddress,
         MM::Paging::FlushTlb();
     }
 
-    /* Return virtual address */
-    *VirtualAddress = ReturnAddress;
+    /* Return virtual address with an offset */
+    *VirtualAddress = (PVOID)((ULONG_PTR)BaseAddress + PAGE_OFFSET(PhysicalAddress.LowPart));
     return STATUS_SUCCESS;
 }
 
+/**
+ * Marks existing mapping as write-combining, so that streaming writes to device memory are not serialized.
+ *
+ * @param VirtualAddress
+ *        Supplies the virtual address region to mark as write-combining.
+ *
+ * @param PageCount
+ *        Supplies the number of mapped pages.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Write-combining is available through the Page Attribute Table only. Without it, the region is marked as
+ *       uncached instead.
+ */
+XTAPI
+VOID
+MM::HardwarePool::MarkHardwareMemoryWriteCombined(IN PVOID VirtualAddress,
+                                                  IN PFN_NUMBER PageCount)
+{
+    BOOLEAN CacheDisable;
+    PMMPTE PtePointer;
+    PFN_NUMBER Page;
+
+    /* Align virtual address down to page boundary */
+    VirtualAddress = (PVOID)((ULONG_PTR)VirtualAddress & ~(MM_PAGE_SIZE - 1));
+
+    /* PWT alone selects write-combining in the PAT, fall back to uncached memory if PAT is not supported */
+    CacheDisable = !AR::ProcessorSupport::HasFeature(KCF_PAT);
+
+    /* Get PTE address from virtual address */
+    PtePointer = MM::Paging::GetPteAddress(VirtualAddress);
+
+    /* Iterate through mapped pages */
+    for(Page = 0; Page < PageCount; Page++)
+    {
+        /* Mark page as write-combining */
+        MM::Paging::SetPteCaching(PtePointer, CacheDisable, TRUE);
+        PtePointer = MM::Paging::GetNextPte(PtePointer);
+    }
+
+    /* Invalidate the old translations on all processors */
+    MM::Tlb::FlushRange(VirtualAddress, PageCount);
+}
+
 /**
  * Marks existing mapping as CD/WT to avoid delays in write-back cache.
  *
@@ -320,7 +387,7 @@ MM::HardwarePool::MarkHardwareMemoryWriteThrough(IN PVOID VirtualAddress,
     {
         /* Mark pages as CD/WT */
         MM::Paging::SetPteCaching(PtePointer, TRUE, TRUE);
-        MM::Paging::GetNextEntry(PtePointer);
+        PtePointer = MM::Paging::GetNextEntry(PtePointer);
     }
 }
 
@@ -357,8 +424,8 @@ MM::HardwarePool::RemapHardwareMemory(IN PVOID VirtualAddress,
     /* Check if TLB needs to be flushed */
     if(FlushTlb)
     {
-        /* Flush the TLB */
-        MM::Paging::FlushTlb();
+        /* Invalidate the old translation on all processors */
+        MM::Tlb::FlushRange(VirtualAddress, 1);
     }
 }
 
@@ -384,9 +451,6 @@ MM::HardwarePool::UnmapHardwareMemory(IN PVOID VirtualAddress,
                                       IN PFN_NUMBER PageCount,
                                       IN BOOLEAN FlushTlb)
 {
-    PMMPTE PtePointer;
-    PFN_NUMBER Page;
-
     /* Check if address is valid hardware memory */
     if(VirtualAddress < (PVOID)MM_HARDWARE_VA_START)
     {
@@ -397,29 +461,27 @@ MM::HardwarePool::UnmapHardwareMemory(IN PVOID VirtualAddress,
     /* Align virtual address down to page boundary */
     VirtualAddress = (PVOID)((ULONG_PTR)VirtualAddress & ~(MM_PAGE_SIZE - 1));
 
-    /* Get PTE address from virtual address */
-    PtePointer = MM::Paging::GetPteAddress(VirtualAddress);
-
-    /* Iterate through mapped pages */
-    for(Page = 0; Page < PageCount; Page++)
-    {
-        /* Unmap the PTE and get the next one */
-        MM::Paging::ClearPte(PtePointer);
-        PtePointer++;
-    }
+    /* Unmap all PTEs of the hardware memory region */
+    MM::Paging::UnmapPtes(MM::Paging::GetPteAddress(VirtualAddress), (PFN_COUNT)PageCount, NULLPTR);
 
     /* Check if TLB needs to be flushed */
     if(FlushTlb)
     {
-        /* Flush the TLB */
-        MM::Paging::FlushTlb();
+        /* Invalidate the unmapped range on all processors */
+        MM::Tlb::FlushRange(VirtualAddress, PageCount);
     }
 
-    /* Check if heap can be reused */
-    if(HardwareHeapStart > VirtualAddress)
+    /* Check if the range belongs to the hardware heap */
+    if(VirtualAddress >= MM_HARDWARE_HEAP_START_ADDRESS)
     {
-        /* Free VA space */
-        HardwareHeapStart = VirtualAddress;
+        /* Raise runlevel to DISPATCH_LEVEL and acquire the hardware heap lock */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard HeapLock(&HardwareHeapLock);
+
+        /* Return the range to the hardware heap, merging it with adjacent free pages */
+        RTL::BitMap::ClearBits(&HardwareHeapBitMap,
+                               ((ULONG_PTR)VirtualAddress - (ULONG_PTR)MM_HARDWARE_HEAP_START_ADDRESS) >> MM_PAGE_SHIFT,
+                               PageCount);
     }
 
     /* Return success */
@@ -466,6 +466,24 @@ MM::PageMapBasic::InitializePageMapInfo(VOID)
     PageMapInfo.PteShift = MM_PTE_LEGACY_SHIFT;
 }
 
+/**
+ * Checks whether the given PML2 page directory entry (PDE) maps a large page.
+ *
+ * @param PtePointer
+ *        Pointer to the page directory entry (PDE) to check.
+ *
+ * @return Returns TRUE if the entry maps a large page, FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::PageMapBasic::PteLargePage(IN PMMPTE PtePointer)
+{
+    /* Check if PDE maps a large page */
+    return (BOOLEAN)PtePointer->Pml2.Hardware.LargePage;
+}
+
 /**
  * Checks whether the given PML2 page table entry (PTE) is valid.
  *
@@ -936,6 +954,24 @@ MM::PageMapXpa::InitializePageMapInfo(VOID)
     PageMapInfo.PteShift = MM_PTE_SHIFT;
 }
 
+/**
+ * Checks whether the given PML3 page directory entry (PDE) maps a large page.
+ *
+ * @param PtePointer
+ *        Pointer to the page directory entry (PDE) to check.
+ *
+ * @return Returns TRUE if the entry maps a large page, FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::PageMapXpa::PteLargePage(IN PMMPTE PtePointer)
+{
+    /* Check if PDE maps a large page */
+    return (BOOLEAN)PtePointer->Pml3.Hardware.LargePage;
+}
+
 /**
  * Checks whether the given PML3 page table entry (PTE) is valid.
  *
@@ -108,3 +108,50 @@ MM::Paging::ZeroPages(IN PVOID Address,
                        "a"(0)
                      : "memory");
 }
+
+/**
+ * Fills a section of memory with zeroes using non-temporal stores, bypassing the CPU caches.
+ *
+ * @param Address
+ *        Supplies an address of the page to be filled with zeroes.
+ *
+ * @param Size
+ *        Number of bytes to be filled with zeros. This always should be a multiply of page size.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTFASTCALL
+VOID
+MM::Paging::ZeroPagesNonTemporal(IN PVOID Address,
+                                 IN ULONG Size)
+{
+    /* Check if SSE2 is supported, as it provides the non-temporal store instruction */
+    if(!AR::ProcessorSupport::HasFeature(KCF_SSE2))
+    {
+        /* Non-temporal stores not available, fall back to regular stores */
+        ZeroPages(Address, Size);
+        return;
+    }
+
+    __asm__ volatile("xor %%eax, %%eax\n"
+                     "1:\n"
+                     "movnti %%eax, 0(%0)\n"
+                     "movnti %%eax, 4(%0)\n"
+                     "movnti %%eax, 8(%0)\n"
+                     "movnti %%eax, 12(%0)\n"
+                     "movnti %%eax, 16(%0)\n"
+                     "movnti %%eax, 20(%0)\n"
+                     "movnti %%eax, 24(%0)\n"
+                     "movnti %%eax, 28(%0)\n"
+                     "add $32, %0\n"
+                     "sub $32, %1\n"
+                     "jnz 1b\n"
+                     "sfence\n"
+                     : "+r" (Address),
+                       "+r" (Size)
+                     :
+                     : "eax",
+                       "memory");
+}
@@ -10,27 +10,35 @@
 
 
 /**
- * Evaluates the PDE for for paged pool and per-session mappings.
+ * Makes the page table mapping the given paged pool address resident, creating it if missing.
  *
  * @param VirtualAddress
- *        Specifies the virtual address to verify.
+ *        Specifies the paged pool virtual address to verify.
  *
- * @return This routine returns ACCESS_VIOLATION on PML3 or status code on PML2.
+ * @return This routine returns STATUS_SUCCESS if the PDE is valid, or an error status code otherwise.
+ *
+ * @since XT 1.0
+ *
+ * @note With PML3 all page directories are always present, thus only the PDE is checked regardless of XPA status.
  */
 XTFASTCALL
 XTSTATUS
 MM::PageFault::CheckPdeForPagedPool(IN PVOID VirtualAddress)
 {
-    /* Check if XPA is enabled */
-    if(MM::Paging::GetXpaStatus())
+    /* Make sure the address belongs to the paged pool */
+    if(!PagedPoolAddress(VirtualAddress))
     {
-        /* Access violation for PML3 */
+        /* Return access violation */
         return STATUS_ACCESS_VIOLATION;
     }
 
-    /* Unimplemented path for PML2 */
-    UNIMPLEMENTED;
+    /* Check if PDE is valid */
+    if(!MM::Paging::PteValid(MM::Paging::GetPdeAddress(VirtualAddress)))
+    {
+        /* Create the page table */
+        return MapPageTable(MM::Paging::GetPdeAddress(VirtualAddress));
+    }
 
-    /* Temporarily, just return access violation */
-    return STATUS_ACCESS_VIOLATION;
+    /* Page table is resident, return success */
+    return STATUS_SUCCESS;
 }
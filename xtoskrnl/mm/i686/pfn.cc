@@ -47,12 +47,16 @@ MM::Pfn::InitializePfnDatabase(VOID)
     PLIST_ENTRY ListEntry;
     PMMMEMORY_LAYOUT MemoryLayout;
     PUCHAR PfnDatabaseEnd;
+    ULONGLONG StartCycles;
     PMMPTE ValidPte;
 
     /* Raise runlevel and acquire PFN lock */
     KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
     KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
 
+    /* Record the time stamp counter value at the start of the initialization */
+    StartCycles = AR::CpuFunctions::ReadTimeStampCounter();
+
     /* Get the kernel initialization block */
     InitializationBlock = KE::BootInformation::GetInitializationBlock();
 
@@ -65,9 +69,8 @@ MM::Pfn::InitializePfnDatabase(VOID)
     /* Get a template PTE for mapping the PFN database pages */
     ValidPte = MM::Pte::GetValidPte();
 
-    /* Map the Page Directory and Page Directory Pointer tables for the PFN database */
-    MM::Pte::MapPDE(MemoryLayout->PfnDatabase, PfnDatabaseEnd, ValidPte);
-    MM::Pte::MapPTE(MemoryLayout->PfnDatabase, PfnDatabaseEnd, ValidPte);
+    /* Map the PFN database, using large pages wherever possible */
+    MM::Pte::MapLargePages(MemoryLayout->PfnDatabase, PfnDatabaseEnd, ValidPte);
 
     /* Zero PFN database virtual space */
     RTL::Memory::ZeroMemory(MemoryLayout->PfnDatabase, MemoryLayout->PfnDatabaseSize * MM_PAGE_SIZE);
@@ -115,16 +118,18 @@ MM::Pfn::InitializePfnDatabase(VOID)
     /* Initialize PFNs for the free memory */
     ProcessMemoryDescriptor(FreeDescriptor->BasePage, FreeDescriptor->PageCount, LoaderFree);
 
-    /* Initialize PFNs for the physical pages backing the PFN database */
-    ProcessMemoryDescriptor(OriginalFreeDescriptor.BasePage,
-                            FreeDescriptor->BasePage - OriginalFreeDescriptor.BasePage,
-                            LoaderMemoryData);
+    /* Initialize PFNs for the physical pages consumed by the bootstrap allocator */
+    InitializeBootstrapPagePfns();
 
     /* Restore original free descriptor */
     *FreeDescriptor = OriginalFreeDescriptor;
 
     /* Initialize PFNs backing page tables */
     InitializePageTablePfns();
+
+    /* Report the time taken to initialize the PFN database */
+    DebugPrint(L"Initialized PFN database in %llu cycles (%llu pages deferred)\n",
+               AR::CpuFunctions::ReadTimeStampCounter() - StartCycles, (ULONGLONG)DeferredPageCount);
 }
 
 /**
@@ -221,8 +226,8 @@ MM::Pfn::ScanPageTable(IN PMMPTE PointerPte,
     /* Iterate through all entries in the current page table */
     for(Index = 0; Index < PtesPerPage; Index++)
     {
-        /* Check if the page table entry is present */
-        if(MM::Paging::PteValid(PointerPte))
+        /* Check if the page table entry is present and does not map a large page */
+        if(MM::Paging::PteValid(PointerPte) && (Level != 2 || !MM::Paging::PteLargePage(PointerPte)))
         {
             /* Mark the PFN pointed to by this entry as active */
             LinkPfnForPageTable(MM::Paging::GetPageFrameNumber(PointerPte), PointerPte);
@@ -25,7 +25,8 @@ MM::Pool::MapNonPagedPool(VOID)
     /* Retrieve memory layout */
     MemoryLayout = MM::Manager::GetMemoryLayout();
 
-    /* Map PDE and PTE for the base of the non-paged pool */
-    MM::Pte::MapPDE(MemoryLayout->NonPagedPoolStart, (PCHAR)MemoryLayout->NonPagedPoolEnd - 1, MM::Pte::GetValidPte());
-    MM::Pte::MapPTE(MemoryLayout->NonPagedPoolStart, (PCHAR)MemoryLayout->NonPagedPoolEnd - 1, MM::Pte::GetValidPte());
+    /* Map the base of the non-paged pool, using large pages wherever possible */
+    MM::Pte::MapLargePages(MemoryLayout->NonPagedPoolStart,
+                           (PCHAR)MemoryLayout->NonPagedPoolEnd - 1,
+                           MM::Pte::GetValidPte());
 }
@@ -23,11 +23,18 @@ XTAPI
 BOOLEAN
 MM::Pte::AddressValid(IN PVOID VirtualAddress)
 {
-    /* Check if PDE and PTE are valid */
-    if(!MM::Paging::PteValid(MM::Paging::GetPdeAddress(VirtualAddress)) ||
+    /* Check if PDE is valid */
+    if(!MM::Paging::PteValid(MM::Paging::GetPdeAddress(VirtualAddress)))
+    {
+        /* Invalid PDE, return FALSE */
+        return FALSE;
+    }
+
+    /* Check if PDE does not map a large page and PTE is valid */
+    if(!MM::Paging::PteLargePage(MM::Paging::GetPdeAddress(VirtualAddress)) &&
        !MM::Paging::PteValid(MM::Paging::GetPteAddress(VirtualAddress)))
     {
-        /* Invalid PDE or PTE, return FALSE */
+        /* Invalid PTE, return FALSE */
         return FALSE;
     }
 
@@ -62,23 +69,31 @@ MM::Pte::InitializePageTable(VOID)
 {
     PMMPTE EndSpacePte, PointerPte;
     PMMMEMORY_LAYOUT MemoryLayout;
-    CPUID_REGISTERS CpuRegisters;
     MMPTE TemplatePte;
 
     /* Retrieve current paging mode and memory layout */
     MemoryLayout = MM::Manager::GetMemoryLayout();
 
-    /* Get CPU features */
-    CpuRegisters.Leaf = CPUID_GET_STANDARD1_FEATURES;
-    AR::CpuFunctions::CpuId(&CpuRegisters);
-
     /* Check if Paging Global Extensions (PGE) is supported */
-    if(CpuRegisters.Edx & CPUID_FEATURES_EDX_PGE)
+    if(AR::ProcessorSupport::HasFeature(KCF_GLOBAL_PAGE))
     {
         /* Enable the Global Paging (PGE) feature */
         AR::CpuFunctions::WriteControlRegister(4, AR::CpuFunctions::ReadControlRegister(4) | CR4_PGE);
     }
 
+    /* Check if PAE is enabled */
+    if(MM::Paging::GetXpaStatus())
+    {
+        /* Large pages are always supported with PAE paging */
+        LargePageSupport = TRUE;
+    }
+    else if(AR::ProcessorSupport::HasFeature(KCF_LARGE_PAGE))
+    {
+        /* Enable the Page Size Extensions (PSE) feature to allow large pages with legacy paging */
+        AR::CpuFunctions::WriteControlRegister(4, AR::CpuFunctions::ReadControlRegister(4) | CR4_PSE);
+        LargePageSupport = TRUE;
+    }
+
     /* Get the PD user-space range for both legacy and PAE paging */
     PointerPte = (PMMPTE)MM::Paging::GetPdeAddress(0);
     EndSpacePte = (PMMPTE)MM::Paging::GetPdeAddress(MemoryLayout->UserSpaceEnd);
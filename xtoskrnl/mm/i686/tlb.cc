@@ -0,0 +1,85 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/i686/tlb.cc
+ * DESCRIPTION:     Translation Lookaside Buffer (TLB) support for i686 architecture
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Enables process-context identifiers (PCIDs) on the current processor, if supported.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note PCIDs are available in long mode only, thus the TLB is always flushed on address space switch.
+ */
+XTAPI
+VOID
+MM::Tlb::EnableAddressSpaceIds(VOID)
+{
+    /* Address space identifiers are not supported */
+    AddressSpaceIdSupport = FALSE;
+}
+
+/**
+ * Invalidates the translations of the current processor queued in a TLB flush batch.
+ *
+ * @param Batch
+ *        Supplies a pointer to the TLB flush batch to process.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::FlushLocalTlb(IN PMMTLB_FLUSH_BATCH Batch)
+{
+    PFN_COUNT Page;
+    ULONG Index;
+
+    /* Check if the entire TLB should be flushed */
+    if(Batch->FlushEntireTlb)
+    {
+        /* Flush the entire TLB, including global entries */
+        MM::Paging::FlushTlb();
+        return;
+    }
+
+    /* Iterate through all queued ranges */
+    for(Index = 0; Index < Batch->Count; Index++)
+    {
+        /* Invalidate each page in the range */
+        for(Page = 0; Page < Batch->Ranges[Index].NumberOfPages; Page++)
+        {
+            /* Invalidate the TLB entry */
+            AR::CpuFunctions::InvalidateTlbEntry((PVOID)((ULONG_PTR)Batch->Ranges[Index].VirtualAddress +
+                                                         ((ULONG_PTR)Page << MM_PAGE_SHIFT)));
+        }
+    }
+}
+
+/**
+ * Loads the address space of the specified process on the current processor.
+ *
+ * @param Process
+ *        Supplies a pointer to the process whose address space will be loaded.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must run at DISPATCH_LEVEL or above.
+ */
+XTAPI
+VOID
+MM::Tlb::SwitchAddressSpace(IN PKPROCESS Process)
+{
+    /* Load the page directory, flushing all non-global translations */
+    AR::CpuFunctions::WriteControlRegister(3, Process->DirectoryTable[0]);
+}
@@ -22,23 +22,152 @@
  * @return This routine returns a status code.
  *
  * @since XT 1.0
+ *
+ * @note Stacks of the default size are taken from the current processor's kernel stack cache whenever possible,
+ *       so that no page tables need to be updated.
  */
 XTAPI
 XTSTATUS
 MM::KernelPool::AllocateKernelStack(OUT PVOID *Stack,
                                     IN ULONG StackSize)
 {
-    PFN_COUNT StackPages;
-    PMMPTE PointerPte, StackPte;
-    MMPTE TempPte, InvalidPte;
-    PFN_NUMBER PageFrameIndex;
-    ULONG Index;
+    PMMKERNEL_STACK_CACHE Cache;
+    BOOLEAN Dirty;
 
     /* Initialize the output stack pointer to NULLPTR */
     *Stack = NULLPTR;
+    Dirty = FALSE;
+
+    /* Check if the stack can be taken from the kernel stack cache */
+    if(StackSize == KERNEL_STACK_SIZE && KernelStackCacheDepth != 0)
+    {
+        /* Start a guarded code block */
+        {
+            /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+            KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+            /* Get the kernel stack cache of the current processor */
+            Cache = &KE::Processor::GetCurrentProcessorControlBlock()->KernelStackCache;
+
+            /* Check if any zeroed stack is available */
+            if(Cache->Count != 0)
+            {
+                /* Take the most recently zeroed stack */
+                Cache->Count--;
+                *Stack = Cache->Stacks[Cache->Count];
+            }
+            else if(Cache->DirtyCount != 0)
+            {
+                /* Take a recycled stack, that has not been zeroed yet */
+                Cache->DirtyCount--;
+                *Stack = Cache->DirtyStacks[Cache->DirtyCount];
+                Dirty = TRUE;
+            }
+        }
+
+        /* Check if a cached stack has been taken */
+        if(*Stack != NULLPTR)
+        {
+            /* Check if the stack needs to be zeroed */
+            if(Dirty)
+            {
+                /* Zero the recycled stack memory, its guard page stays in place */
+                RTL::Memory::ZeroMemory((PVOID)((ULONG_PTR)*Stack - KERNEL_STACK_SIZE), KERNEL_STACK_SIZE);
+            }
+
+            /* Return success */
+            return STATUS_SUCCESS;
+        }
+    }
+
+    /* Create a new kernel stack */
+    return CreateKernelStack(Stack, SIZE_TO_PAGES(StackSize));
+}
+
+/**
+ * Allocates a buffer for structures needed by a processor and assigns it to a corresponding CPU.
+ *
+ * @param CpuNumber
+ *        Supplies the number of the processor the structures are allocated for.
+ *
+ * @param StructuresData
+ *        Supplies a pointer to the memory area that will contain the allocated buffer.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note The buffer is backed by physical pages of the processor's own NUMA node whenever possible, as its stacks
+ *       and processor block are accessed by that processor only.
+ */
+XTAPI
+XTSTATUS
+MM::KernelPool::AllocateProcessorStructures(IN ULONG CpuNumber,
+                                            OUT PVOID *StructuresData)
+{
+    PMMPTE StructuresPte;
+    PFN_COUNT Pages;
+    MMPTE TempPte;
+    ULONG Node;
+
+    /* Initialize the output pointer to NULLPTR */
+    *StructuresData = NULLPTR;
+
+    /* Convert the structures size into a page count and get the NUMA node of the processor */
+    Pages = SIZE_TO_PAGES(KPROCESSOR_STRUCTURES_SIZE);
+    Node = MM::Numa::GetProcessorNode(CpuNumber);
+
+    /* Reserve PTEs for the processor structures */
+    StructuresPte = MM::Pte::ReserveSystemPtes(Pages, SystemPteSpace);
+    if(!StructuresPte)
+    {
+        /* Failed to reserve PTEs for the processor structures */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Set up a template for a valid, writable PTE */
+    MM::Paging::ClearPte(&TempPte);
+    MM::Paging::SetPte(&TempPte, 0, MM_PTE_READWRITE | MM_PTE_CACHE_ENABLE);
+
+    /* Map the processor structures with physical pages of the processor's node, acquired in bulk */
+    if(MM::Pfn::AllocateMappedPages(StructuresPte, Pages, Node, &TempPte) != STATUS_SUCCESS)
+    {
+        /* Out of physical pages, release the reserved PTEs and return error */
+        MM::Pte::ReleaseSystemPtes(StructuresPte, Pages, SystemPteSpace);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Make sure all structures are zeroed */
+    *StructuresData = MM::Paging::GetPteVirtualAddress(StructuresPte);
+    RTL::Memory::ZeroMemory(*StructuresData, KPROCESSOR_STRUCTURES_SIZE);
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Maps a new kernel stack, backed by freshly allocated physical pages and protected by a guard page.
+ *
+ * @param Stack
+ *        Supplies a pointer to the memory area that will contain a new kernel stack.
+ *
+ * @param StackPages
+ *        Supplies the number of pages of the stack to be created.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::KernelPool::CreateKernelStack(OUT PVOID *Stack,
+                                  IN PFN_COUNT StackPages)
+{
+    PMMPTE StackPte;
+    MMPTE TempPte;
 
-    /* Convert the requested stack size into a page count */
-    StackPages = SIZE_TO_PAGES(StackSize);
+    /* Initialize the output stack pointer to NULLPTR */
+    *Stack = NULLPTR;
 
     /* Reserve PTEs for the stack pages, plus a guard page */
     StackPte = MM::Pte::ReserveSystemPtes(StackPages + 1, SystemPteSpace);
@@ -48,36 +177,17 @@ MM::KernelPool::AllocateKernelStack(OUT PVOID *Stack,
         return STATUS_INSUFFICIENT_RESOURCES;
     }
 
-    /* Set up a template for an invalid PTE */
-    MM::Paging::SetPte(&InvalidPte, 0, MM_PTE_GUARDED);
-
     /* Set up a template for a valid, writable stack PTE */
     MM::Paging::ClearPte(&TempPte);
     MM::Paging::SetPte(&TempPte, 0, MM_PTE_READWRITE | MM_PTE_CACHE_ENABLE);
 
-    /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
-    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-    KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
-
-    /* Start iterating from the base of the reserved PTE block */
-    PointerPte = StackPte;
-
-    /* Loop through each page of the stack that needs to be allocated */
-    for(Index = 0; Index < StackPages; Index++)
+    /* Map the stack pages above the guard page with physical pages acquired in bulk */
+    if(MM::Pfn::AllocateMappedPages(MM::Paging::GetNextPte(StackPte), StackPages, MM::Numa::GetCurrentNode(),
+                                    &TempPte) != STATUS_SUCCESS)
     {
-        /* Advance to the next PTE */
-        PointerPte = MM::Paging::GetNextPte(PointerPte);
-
-        /* Allocate a physical page and temporarily mark the PTE as invalid */
-        PageFrameIndex = MM::Pfn::AllocatePhysicalPage(MM::Colors::GetNextColor());
-        *PointerPte = InvalidPte;
-
-        /* Associate the physical page with its corresponding PTE in the PFN database */
-        MM::Pfn::LinkPfn(PageFrameIndex, PointerPte, TRUE);
-
-        /* Make the PTE valid, mapping the virtual address to the physical page */
-        MM::Paging::SetPte(&TempPte, PageFrameIndex, 0);
-        *PointerPte = TempPte;
+        /* Out of physical pages, release the reserved PTEs and return error */
+        MM::Pte::ReleaseSystemPtes(StackPte, StackPages + 1, SystemPteSpace);
+        return STATUS_INSUFFICIENT_RESOURCES;
     }
 
     /* Zero the newly allocated stack memory, skipping the guard page */
@@ -90,38 +200,55 @@ MM::KernelPool::AllocateKernelStack(OUT PVOID *Stack,
 }
 
 /**
- * Allocates a buffer for structures needed by a processor and assigns it to a corresponding CPU.
+ * Unmaps a kernel stack, frees its physical pages and releases its page table entries, including the guard page.
  *
- * @param StructuresData
- *        Supplies a pointer to the memory area that will contain the allocated buffer.
+ * @param Stack
+ *        Supplies a pointer to the memory area containing a kernel stack.
  *
- * @return This routine returns a status code.
+ * @param StackPages
+ *        Supplies the number of pages of the stack to be destroyed.
+ *
+ * @return This routine does not return any value.
  *
  * @since XT 1.0
  */
 XTAPI
-XTSTATUS
-MM::KernelPool::AllocateProcessorStructures(OUT PVOID *StructuresData)
+VOID
+MM::KernelPool::DestroyKernelStack(IN PVOID Stack,
+                                   IN PFN_COUNT StackPages)
 {
-    PVOID ProcessorStructures;
-    XTSTATUS Status;
+    PMMPTE StackPte;
 
-    /* Assign memory for processor structures */
-    Status = MM::Allocator::AllocatePool(NonPagedPool, KPROCESSOR_STRUCTURES_SIZE, &ProcessorStructures);
-    if(Status != STATUS_SUCCESS)
-    {
-        /* Failed to allocate memory, return status code */
-        return Status;
-    }
+    /* Get the PTE of the guard page, right below the lowest stack page */
+    StackPte = MM::Paging::AdvancePte(MM::Paging::GetPteAddress(Stack), -(LONG)(StackPages + 1));
 
-    /* Make sure all structures are zeroed */
-    RTL::Memory::ZeroMemory(ProcessorStructures, KPROCESSOR_STRUCTURES_SIZE);
+    /* Unmap the stack pages and return them to the page magazine */
+    MM::Pfn::FreeMappedPages(MM::Paging::GetNextPte(StackPte), StackPages);
 
-    /* Return pointer to the processor structures */
-    *StructuresData = ProcessorStructures;
+    /* Release all system PTEs used by the stack, including the guard page */
+    MM::Pte::ReleaseSystemPtes(StackPte, StackPages + 1, SystemPteSpace);
+}
 
-    /* Return success */
-    return STATUS_SUCCESS;
+/**
+ * Requests all processors to return the kernel stacks kept in their kernel stack caches back to the system.
+ * The kernel stack cache of the current processor is trimmed immediately.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Kernel stack caches are not interlocked, thus other processors trim their own caches, when they notice
+ *       the request on the next freed stack or in their idle loop.
+ */
+XTAPI
+VOID
+MM::KernelPool::FlushKernelStackCache(VOID)
+{
+    /* Publish a new flush request to all processors */
+    RTL::Atomic::Increment32((PLONG)&KernelStackFlushGeneration);
+
+    /* Trim the kernel stack cache of the current processor */
+    TrimKernelStackCache();
 }
 
 /**
@@ -136,44 +263,50 @@ MM::KernelPool::AllocateProcessorStructures(OUT PVOID *StructuresData)
  * @return This routine does not return any value.
  *
  * @since XT 1.0
+ *
+ * @note Stacks of the default size are kept mapped, together with their guard page, in the current processor's
+ *       kernel stack cache, unless the cache is full or the system is running low on memory.
  */
 XTAPI
 VOID
 MM::KernelPool::FreeKernelStack(IN PVOID Stack,
                                 IN ULONG StackSize)
 {
-    PFN_COUNT StackPages;
-    PMMPTE PointerPte;
-    ULONG Index;
+    PMMKERNEL_STACK_CACHE Cache;
 
-    /* Get the PTE for the top of the stack, including the guard page */
-    PointerPte = MM::Paging::AdvancePte(MM::Paging::GetPteAddress(Stack), -1);
+    /* Check if the stack can be recycled through the kernel stack cache */
+    if(StackSize == KERNEL_STACK_SIZE && KernelStackCacheDepth != 0)
+    {
+        /* Check if the system is running low on memory */
+        if(MM::Pfn::GetAvailablePages() < MM_KERNEL_STACK_CACHE_LOW_MEMORY_PAGES)
+        {
+            /* Trim the cache, so that its pages can be reused */
+            FlushKernelStackCache();
+        }
+        else
+        {
+            /* Handle any pending flush request before caching the stack */
+            TrimKernelStackCache();
 
-    /* Convert the stack size into a page count */
-    StackPages = SIZE_TO_PAGES(StackSize);
+            /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+            KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
 
-    /* Start a guarded code block */
-    {
-        /* Acquire the PFN database lock */
-        KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+            /* Get the kernel stack cache of the current processor */
+            Cache = &KE::Processor::GetCurrentProcessorControlBlock()->KernelStackCache;
 
-        /* Loop through each page of the stack that needs to be freed */
-        for(Index = 0; Index < StackPages; Index++)
-        {
-            /* Ensure the PTE is valid */
-            if(MM::Paging::PteValid(PointerPte))
+            /* Check if the cache is full */
+            if(Cache->Count + Cache->DirtyCount < KernelStackCacheDepth)
             {
-                /* Free the physical page */
-                MM::Pfn::FreePhysicalPage(PointerPte);
+                /* Cache the stack, it will be zeroed in the background */
+                Cache->DirtyStacks[Cache->DirtyCount] = Stack;
+                Cache->DirtyCount++;
+                return;
             }
-
-            /* Advance to the next PTE */
-            PointerPte = MM::Paging::AdvancePte(PointerPte, -1);
         }
     }
 
-    /* Release all system PTEs used by the stack, including the guard page */
-    MM::Pte::ReleaseSystemPtes(PointerPte, StackPages + 1, SystemPteSpace);
+    /* Destroy the kernel stack */
+    DestroyKernelStack(Stack, SIZE_TO_PAGES(StackSize));
 }
 
 /**
@@ -190,10 +323,272 @@ XTAPI
 VOID
 MM::KernelPool::FreeProcessorStructures(IN PVOID StructuresData)
 {
+    PMMPTE StructuresPte;
+    PFN_COUNT Pages;
+
     /* Check if the provided pointer is valid */
-    if(StructuresData != NULLPTR)
+    if(StructuresData == NULLPTR)
     {
-        /* Release the contiguous memory block back */
-        MM::Allocator::FreePool(StructuresData);
+        /* Nothing to free */
+        return;
     }
+
+    /* Get the PTE of the first page and convert the structures size into a page count */
+    StructuresPte = MM::Paging::GetPteAddress(StructuresData);
+    Pages = SIZE_TO_PAGES(KPROCESSOR_STRUCTURES_SIZE);
+
+    /* Unmap the processor structures and return their pages to the page magazine */
+    MM::Pfn::FreeMappedPages(StructuresPte, Pages);
+
+    /* Release all system PTEs used by the processor structures */
+    MM::Pte::ReleaseSystemPtes(StructuresPte, Pages, SystemPteSpace);
+}
+
+/**
+ * Initializes the per-processor kernel stack caches.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::KernelPool::InitializeKernelStackCache(VOID)
+{
+    WCHAR ParameterValue[16];
+    ULONG Depth;
+
+    /* Use the default cache depth */
+    Depth = MM_KERNEL_STACK_CACHE_DEFAULT_DEPTH;
+
+    /* Check if user requested a specific number of cached kernel stacks */
+    if(KE::BootInformation::GetKernelParameterValue(L"STACKCACHE", ParameterValue, 16) == STATUS_SUCCESS)
+    {
+        /* Convert string value to number */
+        if(RTL::WideString::WideStringToNumber(ParameterValue, 0, &Depth) != STATUS_SUCCESS)
+        {
+            /* Invalid value, fall back to the default cache depth */
+            Depth = MM_KERNEL_STACK_CACHE_DEFAULT_DEPTH;
+        }
+    }
+
+    /* Clamp the cache depth to the supported range, 0 disables the cache */
+    KernelStackCacheDepth = MIN(Depth, MM_KERNEL_STACK_CACHE_DEPTH);
+}
+
+/**
+ * Prepares kernel stacks for the current processor's kernel stack cache in the background.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note This routine is called from the idle loop. It either zeroes a single recycled stack or creates a new one,
+ *       and requests all caches to be trimmed when the system is running low on memory.
+ */
+XTAPI
+VOID
+MM::KernelPool::RefillKernelStackCache(VOID)
+{
+    PMMKERNEL_STACK_CACHE Cache;
+    BOOLEAN Create;
+    PVOID Stack;
+
+    /* Check if the kernel stack cache is enabled */
+    if(KernelStackCacheDepth == 0)
+    {
+        /* Nothing to do */
+        return;
+    }
+
+    /* Handle any flush request published by another processor */
+    TrimKernelStackCache();
+
+    /* Check if the system is running low on memory */
+    if(MM::Pfn::GetAvailablePages() < MM_KERNEL_STACK_CACHE_LOW_MEMORY_PAGES)
+    {
+        /* Trim the caches of all processors, so that their pages can be reused */
+        FlushKernelStackCache();
+        return;
+    }
+
+    /* Initialize variables */
+    Create = FALSE;
+    Stack = NULLPTR;
+
+    /* Start a guarded code block */
+    {
+        /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+        /* Get the kernel stack cache of the current processor */
+        Cache = &KE::Processor::GetCurrentProcessorControlBlock()->KernelStackCache;
+
+        /* Check if any recycled stack needs to be zeroed */
+        if(Cache->DirtyCount != 0)
+        {
+            /* Take the recycled stack out of the cache */
+            Cache->DirtyCount--;
+            Stack = Cache->DirtyStacks[Cache->DirtyCount];
+        }
+        else if(Cache->Count < KernelStackCacheDepth)
+        {
+            /* Cache not full, a new stack needs to be created */
+            Create = TRUE;
+        }
+    }
+
+    /* Check if a recycled stack has been taken */
+    if(Stack != NULLPTR)
+    {
+        /* Zero the recycled stack memory, its guard page stays in place */
+        RTL::Memory::ZeroMemory((PVOID)((ULONG_PTR)Stack - KERNEL_STACK_SIZE), KERNEL_STACK_SIZE);
+    }
+    else if(!Create || CreateKernelStack(&Stack, SIZE_TO_PAGES(KERNEL_STACK_SIZE)) != STATUS_SUCCESS)
+    {
+        /* Nothing to prepare or the stack could not be created */
+        return;
+    }
+
+    /* Start a guarded code block */
+    {
+        /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+        /* Get the kernel stack cache of the current processor */
+        Cache = &KE::Processor::GetCurrentProcessorControlBlock()->KernelStackCache;
+
+        /* Check if the cache has been filled up in the meantime */
+        if(Cache->Count + Cache->DirtyCount < KernelStackCacheDepth)
+        {
+            /* Put the zeroed stack into the cache */
+            Cache->Stacks[Cache->Count] = Stack;
+            Cache->Count++;
+            return;
+        }
+    }
+
+    /* Cache is full, destroy the prepared stack */
+    DestroyKernelStack(Stack, SIZE_TO_PAGES(KERNEL_STACK_SIZE));
+}
+
+/**
+ * Returns all kernel stacks cached by the current processor back to the system, if a flush of the kernel stack
+ * caches has been requested since the cache was last trimmed.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::KernelPool::TrimKernelStackCache(VOID)
+{
+    PVOID Stacks[2 * MM_KERNEL_STACK_CACHE_DEPTH];
+    PMMKERNEL_STACK_CACHE Cache;
+    ULONG Count, Generation, Index;
+
+    /* Start a guarded code block */
+    {
+        /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+        /* Get the kernel stack cache of the current processor */
+        Cache = &KE::Processor::GetCurrentProcessorControlBlock()->KernelStackCache;
+
+        /* Check if the cache has been trimmed since the last request */
+        Generation = KernelStackFlushGeneration;
+        if(Cache->FlushGeneration == Generation)
+        {
+            /* Nothing to do */
+            return;
+        }
+
+        /* Mark the request as handled by the current processor */
+        Cache->FlushGeneration = Generation;
+
+        /* Take all zeroed stacks out of the cache */
+        Count = 0;
+        while(Cache->Count != 0)
+        {
+            /* Take the next stack */
+            Cache->Count--;
+            Stacks[Count++] = Cache->Stacks[Cache->Count];
+        }
+
+        /* Take all recycled stacks out of the cache */
+        while(Cache->DirtyCount != 0)
+        {
+            /* Take the next stack */
+            Cache->DirtyCount--;
+            Stacks[Count++] = Cache->DirtyStacks[Cache->DirtyCount];
+        }
+    }
+
+    /* Destroy all stacks taken out of the cache */
+    for(Index = 0; Index < Count; Index++)
+    {
+        /* Unmap the stack and release its pages */
+        DestroyKernelStack(Stacks[Index], SIZE_TO_PAGES(KERNEL_STACK_SIZE));
+    }
+}
+
+#ifdef DBG
+/**
+ * Verifies that the physical pages of a kernel stack kept in the kernel stack cache are returned to the free page
+ * lists, once the cache is trimmed, and reports the result to the debugger.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The page magazine of the current processor is flushed before each sample, so that the number of available
+ *       pages accounts for the stack pages only.
+ */
+XTAPI
+VOID
+MM::KernelPool::VerifyStackRelease(VOID)
+{
+    PFN_NUMBER AllocatedPages, FreedPages, InitialPages;
+    PVOID Stack;
+
+    /* Check if the kernel stack cache is enabled */
+    if(KernelStackCacheDepth == 0)
+    {
+        /* Kernel stacks are not cached, skip the check */
+        return;
+    }
+
+    /* Sample the number of available pages before the allocation */
+    MM::Pfn::FlushPageMagazine();
+    InitialPages = MM::Pfn::GetAvailablePages();
+
+    /* Allocate a kernel stack and sample the number of available pages again */
+    if(AllocateKernelStack(&Stack, KERNEL_STACK_SIZE) != STATUS_SUCCESS)
+    {
+        /* Unable to allocate the kernel stack, skip the check */
+        DebugPrint(L"Kernel stack release check skipped, unable to allocate a kernel stack\n");
+        return;
+    }
+    MM::Pfn::FlushPageMagazine();
+    AllocatedPages = MM::Pfn::GetAvailablePages();
+
+    /* Free the stack into the kernel stack cache, trim the cache and sample the number of available pages once more */
+    FreeKernelStack(Stack, KERNEL_STACK_SIZE);
+    FlushKernelStackCache();
+    MM::Pfn::FlushPageMagazine();
+    FreedPages = MM::Pfn::GetAvailablePages();
+
+    /* Make sure the stack pages have been taken on allocation and returned on trim */
+    if(AllocatedPages >= InitialPages || FreedPages != InitialPages)
+    {
+        /* The stack pages have not been returned to the free page lists */
+        DebugPrint(L"Kernel stack release check failed: %zu pages available initially, %zu after allocation, "
+                   L"%zu after trim\n", InitialPages, AllocatedPages, FreedPages);
+        return;
+    }
+
+    /* The stack pages have been returned to the free page lists */
+    DebugPrint(L"Kernel stack release check passed: %zu pages available\n", FreedPages);
 }
+#endif
@@ -246,6 +246,9 @@ MM::Manager::InitializeMemoryManager(VOID)
     /* Compute page colors to reduce CPU cache conflicts */
     MM::Colors::ComputePageColoring();
 
+    /* Discover NUMA nodes, so that free page lists can be split per node */
+    MM::Numa::InitializeNuma();
+
     /* Initialize and dump memory layout */
     InitializeMemoryLayout();
     DumpMemoryLayout();
@@ -268,18 +271,45 @@ MM::Manager::InitializeMemoryManager(VOID)
     /* Initialize PFN database */
     MM::Pfn::InitializePfnDatabase();
 
+    /* Initialize pool verification */
+    MM::Pool::InitializePoolVerification();
+
+    /* Initialize performance monitor */
+    MM::Statistics::InitializeStatistics();
+
     /* Initialize allocations tracking tables */
     MM::Allocator::InitializeAllocationsTracking();
     MM::Allocator::InitializeBigAllocationsTracking();
 
+    /* Initialize pool lookaside lists for the bootstrap processor */
+    MM::Allocator::InitializeLookasideLists();
+
+    /* Enable TLB shootdowns for the bootstrap processor */
+    MM::Tlb::RegisterProcessor();
+
     /* Initialize PFN bitmap */
     MM::Pfn::InitializePfnBitmap();
 
+    /* Initialize buddy index and physically contiguous memory reserve */
+    MM::Pfn::InitializeContiguousMemory();
+
     /* Initialize paged pool */
     MM::Pool::InitializePagedPool();
 
+    /* Initialize kernel stack cache */
+    MM::KernelPool::InitializeKernelStackCache();
+
     /* Flush TLB */
     AR::CpuFunctions::FlushTlb();
+
+#ifdef DBG
+    /* Measure page map routines */
+    MM::Paging::MeasurePageMapRoutines();
+
+    /* Verify that freed pages are returned to the free page lists */
+    MM::Allocator::VerifyPageRelease();
+    MM::KernelPool::VerifyStackRelease();
+#endif
 }
 
 /**
@@ -0,0 +1,551 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/numa.cc
+ * DESCRIPTION:     Memory manager NUMA topology support
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Sorts the nodes by their distance from each node, building the order in which node-local lists are scanned.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Numa::ComputeNodeOrder(VOID)
+{
+    ULONG Index, Node, Position;
+    PUCHAR Order;
+    UCHAR Target;
+
+    /* Build the fallback order for each node */
+    for(Node = 0; Node < NodeCount; Node++)
+    {
+        /* Start with the node itself, followed by all other nodes in ascending order */
+        Order = NodeOrder[Node];
+        Order[0] = (UCHAR)Node;
+        for(Index = 0, Position = 1; Index < NodeCount; Index++)
+        {
+            /* Skip the node itself */
+            if(Index != Node)
+            {
+                /* Append the node */
+                Order[Position++] = (UCHAR)Index;
+            }
+        }
+
+        /* Sort the nodes by distance, keeping the original order of equally distant nodes */
+        for(Index = 2; Index < NodeCount; Index++)
+        {
+            /* Shift all farther nodes up and insert the current node after the closer ones */
+            Target = Order[Index];
+            for(Position = Index;
+                Position > 1 && NodeDistances[Node][Order[Position - 1]] > NodeDistances[Node][Target];
+                Position--)
+            {
+                /* Move the farther node up */
+                Order[Position] = Order[Position - 1];
+            }
+
+            /* Insert the node */
+            Order[Position] = Target;
+        }
+    }
+}
+
+/**
+ * Retrieves the NUMA node of the current processor.
+ *
+ * @return This routine returns the node number of the current processor.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Numa::GetCurrentNode(VOID)
+{
+    /* Return the node of the current processor */
+    return ProcessorNodes[KE::Processor::GetCurrentProcessorNumber()];
+}
+
+/**
+ * Retrieves the number of NUMA nodes in the system.
+ *
+ * @return This routine returns the number of NUMA nodes.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Numa::GetNodeCount(VOID)
+{
+    /* Return the number of NUMA nodes */
+    return NodeCount;
+}
+
+/**
+ * Retrieves the relative memory access distance between two NUMA nodes.
+ *
+ * @param SourceNode
+ *        Supplies the node accessing the memory.
+ *
+ * @param TargetNode
+ *        Supplies the node owning the memory.
+ *
+ * @return This routine returns the distance, where MM_NUMA_LOCAL_DISTANCE denotes a local memory access.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Numa::GetNodeDistance(IN ULONG SourceNode,
+                          IN ULONG TargetNode)
+{
+    /* Return the distance between nodes */
+    return NodeDistances[SourceNode][TargetNode];
+}
+
+/**
+ * Retrieves the order in which the memory of other nodes should be used, when the given node runs out of memory.
+ *
+ * @param Node
+ *        Supplies the node number.
+ *
+ * @return This routine returns a pointer to an array of node numbers sorted by their distance, starting with
+ *         the node itself.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PUCHAR
+MM::Numa::GetNodeOrder(IN ULONG Node)
+{
+    /* Return the fallback order for the node */
+    return NodeOrder[Node];
+}
+
+/**
+ * Retrieves the NUMA node owning the given physical page.
+ *
+ * @param PageFrameIndex
+ *        Supplies the page frame number.
+ *
+ * @return This routine returns the node number, or 0 if the page is not described by the affinity table.
+ *
+ * @since XT 1.0
+ *
+ * @note This routine is called for every page linked into the free and zeroed page lists, with the PFN lock held.
+ */
+XTAPI
+ULONG
+MM::Numa::GetPageNode(IN PFN_NUMBER PageFrameIndex)
+{
+    ULONG High, Low, Middle;
+
+    /* Check if the system has a single node */
+    if(NodeCount == 1)
+    {
+        /* All memory is local */
+        return 0;
+    }
+
+    /* Binary search the memory ranges, sorted by their base page, for the range containing the page */
+    Low = 0;
+    High = MemoryRangeCount;
+    while(Low < High)
+    {
+        /* Check the range in the middle of the remaining interval */
+        Middle = Low + ((High - Low) / 2);
+        if(PageFrameIndex < MemoryRanges[Middle].BasePage)
+        {
+            /* Page lies below the range, continue with the lower half */
+            High = Middle;
+        }
+        else if(PageFrameIndex >= MemoryRanges[Middle].EndPage)
+        {
+            /* Page lies above the range, continue with the upper half */
+            Low = Middle + 1;
+        }
+        else
+        {
+            /* Return the node owning the range */
+            return MemoryRanges[Middle].Node;
+        }
+    }
+
+    /* Page not described by the affinity table, assume the first node */
+    return 0;
+}
+
+/**
+ * Retrieves the NUMA node of the specified processor.
+ *
+ * @param CpuNumber
+ *        Supplies the processor number.
+ *
+ * @return This routine returns the node number of the processor.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Numa::GetProcessorNode(IN ULONG CpuNumber)
+{
+    /* Check if the processor number is valid */
+    if(CpuNumber >= MAXIMUM_PROCESSORS)
+    {
+        /* Unknown processor, assume the first node */
+        return 0;
+    }
+
+    /* Return the node of the processor */
+    return ProcessorNodes[CpuNumber];
+}
+
+/**
+ * Translates an ACPI proximity domain into a NUMA node number, assigning a new node to an unknown domain.
+ *
+ * @param ProximityDomain
+ *        Supplies the ACPI proximity domain.
+ *
+ * @return This routine returns the node number.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+ULONG
+MM::Numa::GetProximityNode(IN ULONG ProximityDomain)
+{
+    ULONG Node;
+
+    /* Look up the node already assigned to the proximity domain */
+    for(Node = 0; Node < NodeCount; Node++)
+    {
+        /* Check the proximity domain */
+        if(ProximityDomains[Node] == ProximityDomain)
+        {
+            /* Node found */
+            return Node;
+        }
+    }
+
+    /* Check if the maximum number of nodes has been reached */
+    if(NodeCount == MM_MAXIMUM_NUMA_NODES)
+    {
+        /* Too many nodes, fold the proximity domain into the first node */
+        return 0;
+    }
+
+    /* Assign a new node to the proximity domain */
+    ProximityDomains[NodeCount] = ProximityDomain;
+    return NodeCount++;
+}
+
+/**
+ * Discovers the NUMA topology of the system from the ACPI SRAT and SLIT tables.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The system is treated as a single node if the SRAT table is not present or the NONUMA parameter is set.
+ */
+XTAPI
+VOID
+MM::Numa::InitializeNuma(VOID)
+{
+    PCWSTR KernelParameter;
+
+    /* Check if the user disabled NUMA support via boot parameters */
+    if(KE::BootInformation::GetKernelParameter(L"NONUMA", &KernelParameter) != STATUS_SUCCESS)
+    {
+        /* Read the processor and memory affinity and sort the memory ranges for a fast page lookup */
+        ReadAffinityTable();
+        SortMemoryRanges();
+    }
+
+    /* Check if more than one node has been found */
+    if(NodeCount <= 1)
+    {
+        /* Treat the whole system as a single node */
+        RTL::Memory::ZeroMemory(ProcessorNodes, sizeof(ProcessorNodes));
+        MemoryRangeCount = 0;
+        NodeCount = 1;
+    }
+
+    /* Read the node distances and sort the nodes by distance */
+    ReadDistanceTable();
+    ComputeNodeOrder();
+
+    /* Report the NUMA topology */
+    DebugPrint(L"Found %lu NUMA node(s) with %lu memory affinity range(s)\n", NodeCount, MemoryRangeCount);
+}
+
+/**
+ * Reads the processor and memory affinity from the ACPI Static Resource Affinity Table (SRAT).
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Numa::ReadAffinityTable(VOID)
+{
+    PACPI_SRAT_X2APIC_CPU_AFFINITY X2ApicAffinity;
+    PACPI_SRAT_MEMORY_AFFINITY MemoryAffinity;
+    PACPI_SRAT_CPU_AFFINITY CpuAffinity;
+    PACPI_SUBTABLE_HEADER SubTable;
+    ULONG ProximityDomain;
+    ULONG_PTR SratTable;
+    PACPI_SRAT Srat;
+
+    /* Get Static Resource Affinity Table (SRAT) */
+    if(HL::Acpi::GetAcpiTable(ACPI_SRAT_SIGNATURE, (PACPI_DESCRIPTION_HEADER*)&Srat) != STATUS_SUCCESS)
+    {
+        /* No affinity information available */
+        return;
+    }
+
+    /* Set SRAT table traverse pointer */
+    SratTable = (ULONG_PTR)Srat->AffinityTables;
+
+    /* Traverse all SRAT subtables */
+    while(SratTable < ((ULONG_PTR)Srat + Srat->Header.Length))
+    {
+        /* Get current SRAT subtable header */
+        SubTable = (PACPI_SUBTABLE_HEADER)SratTable;
+
+        /* Prevent infinite loops if BIOS provides 0 length */
+        if(SubTable->Length == 0)
+        {
+            /* Broken ACPI table, abort traversal */
+            break;
+        }
+
+        /* Check the subtable type */
+        if(SubTable->Type == ACPI_SRAT_TYPE_CPU_AFFINITY && SubTable->Length >= sizeof(ACPI_SRAT_CPU_AFFINITY))
+        {
+            /* Get processor local APIC affinity subtable */
+            CpuAffinity = (PACPI_SRAT_CPU_AFFINITY)SratTable;
+
+            /* Make sure, the affinity structure is enabled */
+            if(CpuAffinity->Flags & ACPI_SRAT_AFFINITY_ENABLED)
+            {
+                /* Assemble the proximity domain and assign the processor to its node */
+                ProximityDomain = CpuAffinity->ProximityDomainLow |
+                                  (CpuAffinity->ProximityDomainHigh[0] << 8) |
+                                  (CpuAffinity->ProximityDomainHigh[1] << 16) |
+                                  (CpuAffinity->ProximityDomainHigh[2] << 24);
+                RegisterProcessorNode(CpuAffinity->ApicId, GetProximityNode(ProximityDomain));
+            }
+        }
+        else if(SubTable->Type == ACPI_SRAT_TYPE_MEMORY_AFFINITY &&
+                SubTable->Length >= sizeof(ACPI_SRAT_MEMORY_AFFINITY))
+        {
+            /* Get memory affinity subtable */
+            MemoryAffinity = (PACPI_SRAT_MEMORY_AFFINITY)SratTable;
+
+            /* Make sure, the affinity structure is enabled and describes any memory */
+            if((MemoryAffinity->Flags & ACPI_SRAT_AFFINITY_ENABLED) && MemoryAffinity->Length != 0 &&
+               MemoryRangeCount < MM_MAXIMUM_NUMA_MEMORY_RANGES)
+            {
+                /* Store the memory range and the node owning it */
+                MemoryRanges[MemoryRangeCount].BasePage = (PFN_NUMBER)(MemoryAffinity->BaseAddress >> MM_PAGE_SHIFT);
+                MemoryRanges[MemoryRangeCount].EndPage = (PFN_NUMBER)((MemoryAffinity->BaseAddress +
+                                                                       MemoryAffinity->Length) >> MM_PAGE_SHIFT);
+                MemoryRanges[MemoryRangeCount].Node = GetProximityNode(MemoryAffinity->ProximityDomain);
+
+                /* Increment number of memory ranges */
+                MemoryRangeCount++;
+            }
+        }
+        else if(SubTable->Type == ACPI_SRAT_TYPE_X2APIC_CPU_AFFINITY &&
+                SubTable->Length >= sizeof(ACPI_SRAT_X2APIC_CPU_AFFINITY))
+        {
+            /* Get processor local X2APIC affinity subtable */
+            X2ApicAffinity = (PACPI_SRAT_X2APIC_CPU_AFFINITY)SratTable;
+
+            /* Make sure, the affinity structure is enabled */
+            if(X2ApicAffinity->Flags & ACPI_SRAT_AFFINITY_ENABLED)
+            {
+                /* Assign the processor to its node */
+                RegisterProcessorNode(X2ApicAffinity->ApicId, GetProximityNode(X2ApicAffinity->ProximityDomain));
+            }
+        }
+
+        /* Safely advance pointer using proper subtable length */
+        SratTable += SubTable->Length;
+    }
+}
+
+/**
+ * Reads the relative distances between NUMA nodes from the ACPI System Locality Distance Information Table (SLIT).
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Numa::ReadDistanceTable(VOID)
+{
+    ULONG SourceNode, TargetNode;
+    ULONGLONG LocalityCount;
+    PACPI_SLIT Slit;
+
+    /* Assume the default distances, remote memory being twice as far as local memory */
+    for(SourceNode = 0; SourceNode < NodeCount; SourceNode++)
+    {
+        /* Set the distances from the current node */
+        for(TargetNode = 0; TargetNode < NodeCount; TargetNode++)
+        {
+            /* Set the default distance */
+            NodeDistances[SourceNode][TargetNode] = (SourceNode == TargetNode) ? MM_NUMA_LOCAL_DISTANCE :
+                                                                                 MM_NUMA_REMOTE_DISTANCE;
+        }
+    }
+
+    /* Check if the system has a single node */
+    if(NodeCount == 1)
+    {
+        /* No distances to read */
+        return;
+    }
+
+    /* Get System Locality Distance Information Table (SLIT) */
+    if(HL::Acpi::GetAcpiTable(ACPI_SLIT_SIGNATURE, (PACPI_DESCRIPTION_HEADER*)&Slit) != STATUS_SUCCESS)
+    {
+        /* No distance information available, keep the default distances */
+        return;
+    }
+
+    /* Make sure, the distance matrix fits within the table */
+    LocalityCount = Slit->LocalityCount;
+    if(LocalityCount > 0xFF || Slit->Header.Length < sizeof(ACPI_SLIT) + (LocalityCount * LocalityCount))
+    {
+        /* Broken ACPI table, keep the default distances */
+        return;
+    }
+
+    /* Read the distances between all nodes described by the table */
+    for(SourceNode = 0; SourceNode < NodeCount; SourceNode++)
+    {
+        /* Set the distances from the current node */
+        for(TargetNode = 0; TargetNode < NodeCount; TargetNode++)
+        {
+            /* Make sure, both proximity domains are described by the table */
+            if(ProximityDomains[SourceNode] < LocalityCount && ProximityDomains[TargetNode] < LocalityCount)
+            {
+                /* Store the distance */
+                NodeDistances[SourceNode][TargetNode] = Slit->Entries[(ProximityDomains[SourceNode] * LocalityCount) +
+                                                                      ProximityDomains[TargetNode]];
+            }
+        }
+    }
+}
+
+/**
+ * Assigns the processor with the given APIC ID to a NUMA node.
+ *
+ * @param ApicId
+ *        Supplies the APIC ID of the processor.
+ *
+ * @param Node
+ *        Supplies the node number.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Processor numbers are assigned in the same order, as the application processors are started.
+ */
+XTAPI
+VOID
+MM::Numa::RegisterProcessorNode(IN ULONG ApicId,
+                                IN ULONG Node)
+{
+    PACPI_SYSTEM_INFO SysInfo;
+    ULONG BspApicId, CpuNumber, Index;
+
+    /* Get the APIC ID of the bootstrap processor */
+    BspApicId = HL::Pic::GetCpuApicId();
+
+    /* Check if this is the bootstrap processor */
+    if(ApicId == BspApicId)
+    {
+        /* Bootstrap processor is always the first one */
+        ProcessorNodes[0] = (UCHAR)Node;
+        return;
+    }
+
+    /* Get ACPI system information */
+    HL::Acpi::GetSystemInformation(&SysInfo);
+
+    /* Loop over all CPUs, numbering the application processors */
+    CpuNumber = 0;
+    for(Index = 0; Index < SysInfo->CpuCount; Index++)
+    {
+        /* Skip the bootstrap processor */
+        if(SysInfo->CpuInfo[Index].ApicId == BspApicId)
+        {
+            /* Bootstrap processor already numbered */
+            continue;
+        }
+
+        /* Increment CPU number and check if this is the processor */
+        CpuNumber++;
+        if(SysInfo->CpuInfo[Index].ApicId == ApicId)
+        {
+            /* Make sure, the processor number is supported */
+            if(CpuNumber < MAXIMUM_PROCESSORS)
+            {
+                /* Assign the processor to the node */
+                ProcessorNodes[CpuNumber] = (UCHAR)Node;
+            }
+
+            /* Processor found */
+            return;
+        }
+    }
+}
+
+/**
+ * Sorts the NUMA memory ranges by their base page, allowing the owner of a page to be found with a binary search.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Numa::SortMemoryRanges(VOID)
+{
+    MMNUMA_MEMORY_RANGE Range;
+    ULONG Index, Position;
+
+    /* Insertion sort the memory ranges, as there are only a few of them */
+    for(Index = 1; Index < MemoryRangeCount; Index++)
+    {
+        /* Save the current range */
+        Range = MemoryRanges[Index];
+        Position = Index;
+
+        /* Shift all ranges with a higher base page up by one slot */
+        while(Position > 0 && MemoryRanges[Position - 1].BasePage > Range.BasePage)
+        {
+            /* Move the range */
+            MemoryRanges[Position] = MemoryRanges[Position - 1];
+            Position--;
+        }
+
+        /* Store the saved range in its final slot */
+        MemoryRanges[Position] = Range;
+    }
+}
@@ -0,0 +1,625 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/objcache.cc
+ * DESCRIPTION:     Typed object caches for fixed-size kernel objects
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Allocates a constructed object from the specified object cache.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache to allocate from.
+ *
+ * @param Object
+ *        Supplies a pointer to a variable that will receive the allocated object.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::ObjectCache::AllocateObject(IN PMMOBJECT_CACHE Cache,
+                                OUT PVOID *Object)
+{
+    PMMOBJECT_MAGAZINE Magazine;
+    PVOID SlabObject;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the magazine that belongs to the current processor */
+    Magazine = GetProcessorMagazine(Cache);
+    if(Magazine)
+    {
+        /* Update allocation statistics */
+        Magazine->TotalAllocates++;
+
+        /* Check if the magazine holds any cached objects */
+        if(Magazine->Count)
+        {
+            /* Pop the most recently freed object from the magazine */
+            Magazine->Count--;
+            *Object = Magazine->Objects[Magazine->Count];
+
+            /* Return success */
+            return STATUS_SUCCESS;
+        }
+
+        /* Magazine is empty, fall back to the slab layer */
+        Magazine->AllocateMisses++;
+    }
+
+    /* Acquire the cache lock */
+    KE::SpinLockGuard CacheLock(&Cache->Lock);
+
+    /* Check if the current processor has a magazine */
+    if(Magazine)
+    {
+        /* Refill the magazine with a batch of objects taken from the slabs */
+        while(Magazine->Count < MM_OBJECT_CACHE_MAGAZINE_BATCH)
+        {
+            /* Take an object from the slab layer */
+            SlabObject = AllocateSlabObject(Cache);
+            if(!SlabObject)
+            {
+                /* Out of memory, stop refilling */
+                break;
+            }
+
+            /* Store the object in the magazine */
+            Magazine->Objects[Magazine->Count] = SlabObject;
+            Magazine->Count++;
+        }
+
+        /* Check if the magazine has been refilled */
+        if(!Magazine->Count)
+        {
+            /* Failed to allocate any object, return error */
+            *Object = NULLPTR;
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+
+        /* Pop an object from the refilled magazine */
+        Magazine->Count--;
+        *Object = Magazine->Objects[Magazine->Count];
+    }
+    else
+    {
+        /* Take an object directly from the slab layer */
+        *Object = AllocateSlabObject(Cache);
+        if(!*Object)
+        {
+            /* Failed to allocate the object, return error */
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+    }
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Takes a single object from the slabs owned by the specified object cache, creating a new slab if needed.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache to allocate from.
+ *
+ * @return This routine returns a pointer to the object, or NULLPTR if no memory is available.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the cache lock.
+ */
+XTAPI
+PVOID
+MM::ObjectCache::AllocateSlabObject(IN PMMOBJECT_CACHE Cache)
+{
+    PLIST_ENTRY SlabEntry;
+    PMMOBJECT_SLAB Slab;
+    PVOID Object;
+
+    /* Prefer partially used slabs to keep the number of active slabs low */
+    if(RTL::LinkedList::ListEmpty(&Cache->PartialSlabs))
+    {
+        /* No partial slab available, check for a free one */
+        if(RTL::LinkedList::ListEmpty(&Cache->FreeSlabs))
+        {
+            /* No free slab available, create a new one */
+            if(CreateSlab(Cache) != STATUS_SUCCESS)
+            {
+                /* Failed to create a new slab, return NULLPTR */
+                return NULLPTR;
+            }
+        }
+
+        /* Use the first free slab */
+        SlabEntry = Cache->FreeSlabs.Flink;
+    }
+    else
+    {
+        /* Use the first partially used slab */
+        SlabEntry = Cache->PartialSlabs.Flink;
+    }
+
+    /* Get the slab and pop the index of a free object from its stack */
+    Slab = CONTAIN_RECORD(SlabEntry, MMOBJECT_SLAB, ListEntry);
+    Slab->FreeCount--;
+    Object = (PVOID)((ULONG_PTR)Slab->Objects + (Slab->FreeStack[Slab->FreeCount] * Cache->ObjectSize));
+
+    /* Move the slab to the list matching its new state */
+    RTL::LinkedList::RemoveEntryList(&Slab->ListEntry);
+    RTL::LinkedList::InsertHeadList(Slab->FreeCount ? &Cache->PartialSlabs : &Cache->FullSlabs, &Slab->ListEntry);
+
+    /* Update cache statistics and return the object */
+    Cache->ActiveObjects++;
+    return Object;
+}
+
+/**
+ * Creates a new object cache for fixed-size objects.
+ *
+ * @param ObjectSize
+ *        Supplies the size of a single object, in bytes.
+ *
+ * @param Tag
+ *        Supplies the pool tag used for the cache descriptor.
+ *
+ * @param Constructor
+ *        Supplies an optional routine that initializes each object once, when its slab is created.
+ *
+ * @param Context
+ *        Supplies an optional context passed to the constructor.
+ *
+ * @param Cache
+ *        Supplies a pointer to a variable that will receive the new object cache.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note Objects must be returned to the cache in their constructed state.
+ */
+XTAPI
+XTSTATUS
+MM::ObjectCache::CreateCache(IN ULONG ObjectSize,
+                             IN ULONG Tag,
+                             IN PMMOBJECT_CONSTRUCTOR Constructor,
+                             IN PVOID Context,
+                             OUT PMMOBJECT_CACHE *Cache)
+{
+    ULONG MagazineCount, ObjectsOffset, ObjectsPerSlab;
+    PACPI_SYSTEM_INFO SystemInfo;
+    PMMOBJECT_CACHE NewCache;
+    XTSTATUS Status;
+
+    /* Initialize the output cache pointer to NULLPTR */
+    *Cache = NULLPTR;
+
+    /* Validate the object size */
+    if(ObjectSize == 0)
+    {
+        /* Invalid object size, return error */
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    /* Align the object size to the pool block size */
+    ObjectSize = ROUND_UP(ObjectSize, MM_POOL_BLOCK_SIZE);
+
+    /* Calculate the number of objects fitting in a single slab page */
+    ObjectsPerSlab = (MM_PAGE_SIZE - FIELD_OFFSET(MMOBJECT_SLAB, FreeStack)) / (ObjectSize + sizeof(USHORT));
+    while(ObjectsPerSlab)
+    {
+        /* Calculate the offset of the first object, past the slab header and its free stack */
+        ObjectsOffset = ROUND_UP(FIELD_OFFSET(MMOBJECT_SLAB, FreeStack) + (ObjectsPerSlab * sizeof(USHORT)),
+                                 MM_POOL_BLOCK_SIZE);
+
+        /* Check if all objects fit in the slab page */
+        if(ObjectsOffset + (ObjectsPerSlab * ObjectSize) <= MM_PAGE_SIZE)
+        {
+            /* Slab layout found */
+            break;
+        }
+
+        /* Objects do not fit, try with one object less */
+        ObjectsPerSlab--;
+    }
+
+    /* Make sure at least one object fits in a slab */
+    if(ObjectsPerSlab == 0)
+    {
+        /* Object too large for the object cache, return error */
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    /* Get the number of installed processors to size the magazines array */
+    HL::Acpi::GetSystemInformation(&SystemInfo);
+    MagazineCount = SystemInfo->CpuCount;
+
+    /* Allocate the cache descriptor along with the per-processor magazines */
+    Status = MM::Allocator::AllocatePool(NonPagedPool,
+                                         sizeof(MMOBJECT_CACHE) + (MagazineCount * sizeof(MMOBJECT_MAGAZINE)),
+                                         (PVOID*)&NewCache,
+                                         Tag);
+    if(Status != STATUS_SUCCESS)
+    {
+        /* Failed to allocate memory, return error */
+        return Status;
+    }
+
+    /* Zero the cache descriptor and magazines */
+    RTL::Memory::ZeroMemory(NewCache, sizeof(MMOBJECT_CACHE) + (MagazineCount * sizeof(MMOBJECT_MAGAZINE)));
+
+    /* Initialize the cache descriptor */
+    KE::SpinLock::InitializeSpinLock(&NewCache->Lock);
+    NewCache->Tag = Tag;
+    NewCache->ObjectSize = ObjectSize;
+    NewCache->ObjectsPerSlab = ObjectsPerSlab;
+    NewCache->ObjectsOffset = ObjectsOffset;
+    NewCache->Constructor = Constructor;
+    NewCache->Context = Context;
+
+    /* Use the slack space left at the end of each slab to color object offsets in cache line steps */
+    NewCache->MaximumColor = ROUND_DOWN(MM_PAGE_SIZE - ObjectsOffset - (ObjectsPerSlab * ObjectSize), CACHE_ALIGNMENT);
+
+    /* Initialize the slab lists */
+    RTL::LinkedList::InitializeListHead(&NewCache->FullSlabs);
+    RTL::LinkedList::InitializeListHead(&NewCache->PartialSlabs);
+    RTL::LinkedList::InitializeListHead(&NewCache->FreeSlabs);
+
+    /* Set up the per-processor magazines, stored right after the cache descriptor */
+    NewCache->MagazineCount = MagazineCount;
+    NewCache->Magazines = (PMMOBJECT_MAGAZINE)(NewCache + 1);
+
+    /* Return the new object cache */
+    *Cache = NewCache;
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Allocates a new slab for the specified object cache and constructs all of its objects.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache to grow.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the cache lock.
+ */
+XTAPI
+XTSTATUS
+MM::ObjectCache::CreateSlab(IN PMMOBJECT_CACHE Cache)
+{
+    PMMOBJECT_SLAB Slab;
+    XTSTATUS Status;
+    ULONG Index;
+
+    /* Allocate a single page for the slab */
+    Status = MM::Allocator::AllocatePages(NonPagedPool, MM_PAGE_SIZE, (PVOID*)&Slab);
+    if(Status != STATUS_SUCCESS)
+    {
+        /* Failed to allocate memory, return error */
+        return Status;
+    }
+
+    /* Initialize the slab header and place its objects at the current color offset */
+    Slab->Cache = Cache;
+    Slab->Objects = (PVOID)((ULONG_PTR)Slab + Cache->ObjectsOffset + Cache->NextColor);
+    Slab->FreeCount = (USHORT)Cache->ObjectsPerSlab;
+
+    /* Advance the color, so that consecutive slabs start their objects on different cache lines */
+    Cache->NextColor += CACHE_ALIGNMENT;
+    if(Cache->NextColor > Cache->MaximumColor)
+    {
+        /* Wrap around to the first color */
+        Cache->NextColor = 0;
+    }
+
+    /* Iterate over all objects in the slab */
+    for(Index = 0; Index < Cache->ObjectsPerSlab; Index++)
+    {
+        /* Push the object index, so that objects are handed out in ascending address order */
+        Slab->FreeStack[Index] = (USHORT)(Cache->ObjectsPerSlab - Index - 1);
+
+        /* Check if the cache has a constructor */
+        if(Cache->Constructor)
+        {
+            /* Construct the object */
+            Cache->Constructor((PVOID)((ULONG_PTR)Slab->Objects + (Index * Cache->ObjectSize)), Cache->Context);
+        }
+    }
+
+    /* Insert the slab into the free slabs list */
+    RTL::LinkedList::InsertHeadList(&Cache->FreeSlabs, &Slab->ListEntry);
+    Cache->TotalSlabs++;
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Destroys an object cache and releases all of its slabs.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache to destroy.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must guarantee that the cache is no longer in use on any processor.
+ */
+XTAPI
+XTSTATUS
+MM::ObjectCache::DestroyCache(IN PMMOBJECT_CACHE Cache)
+{
+    PLIST_ENTRY SlabEntry;
+    ULONG Index;
+
+    /* Start a guarded code block */
+    {
+        /* Raise runlevel to DISPATCH_LEVEL and acquire the cache lock */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard CacheLock(&Cache->Lock);
+
+        /* Return all objects cached in per-processor magazines to their slabs */
+        for(Index = 0; Index < Cache->MagazineCount; Index++)
+        {
+            /* Flush the magazine */
+            FlushMagazine(Cache, &Cache->Magazines[Index], MM_OBJECT_CACHE_MAGAZINE_SIZE);
+        }
+
+        /* Make sure no objects are still in use */
+        if(Cache->ActiveObjects)
+        {
+            /* Cache still in use, return error */
+            return STATUS_UNSUCCESSFUL;
+        }
+    }
+
+    /* Release all slabs, which are free at this point */
+    while(!RTL::LinkedList::ListEmpty(&Cache->FreeSlabs))
+    {
+        /* Remove the slab from the list and free its page */
+        SlabEntry = Cache->FreeSlabs.Flink;
+        RTL::LinkedList::RemoveEntryList(SlabEntry);
+        MM::Allocator::FreePages(CONTAIN_RECORD(SlabEntry, MMOBJECT_SLAB, ListEntry));
+    }
+
+    /* Free the cache descriptor */
+    return MM::Allocator::FreePool(Cache, Cache->Tag);
+}
+
+/**
+ * Returns objects cached in a per-processor magazine to their slabs.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache owning the magazine.
+ *
+ * @param Magazine
+ *        Supplies a pointer to the magazine to flush.
+ *
+ * @param Count
+ *        Supplies the maximum number of objects to return.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the cache lock.
+ */
+XTAPI
+VOID
+MM::ObjectCache::FlushMagazine(IN PMMOBJECT_CACHE Cache,
+                               IN PMMOBJECT_MAGAZINE Magazine,
+                               IN ULONG Count)
+{
+    /* Return objects until the requested number is reached or the magazine is empty */
+    while(Count && Magazine->Count)
+    {
+        /* Pop the oldest objects last, returning the coldest ones first */
+        Magazine->Count--;
+        FreeSlabObject(Cache, Magazine->Objects[Magazine->Count]);
+        Count--;
+    }
+}
+
+/**
+ * Returns an object to the specified object cache.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache the object was allocated from.
+ *
+ * @param Object
+ *        Supplies a pointer to the object, which must be in its constructed state.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::ObjectCache::FreeObject(IN PMMOBJECT_CACHE Cache,
+                            IN PVOID Object)
+{
+    PMMOBJECT_MAGAZINE Magazine;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the magazine that belongs to the current processor */
+    Magazine = GetProcessorMagazine(Cache);
+    if(Magazine)
+    {
+        /* Update free statistics */
+        Magazine->TotalFrees++;
+
+        /* Check if the magazine has room for another object */
+        if(Magazine->Count < MM_OBJECT_CACHE_MAGAZINE_SIZE)
+        {
+            /* Push the object into the magazine */
+            Magazine->Objects[Magazine->Count] = Object;
+            Magazine->Count++;
+            return;
+        }
+
+        /* Magazine is full, fall back to the slab layer */
+        Magazine->FreeMisses++;
+    }
+
+    /* Acquire the cache lock */
+    KE::SpinLockGuard CacheLock(&Cache->Lock);
+
+    /* Check if the current processor has a magazine */
+    if(Magazine)
+    {
+        /* Return a batch of objects to the slabs and push the object into the magazine */
+        FlushMagazine(Cache, Magazine, MM_OBJECT_CACHE_MAGAZINE_BATCH);
+        Magazine->Objects[Magazine->Count] = Object;
+        Magazine->Count++;
+    }
+    else
+    {
+        /* Return the object directly to its slab */
+        FreeSlabObject(Cache, Object);
+    }
+}
+
+/**
+ * Returns a single object to the slab it was allocated from.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache owning the object.
+ *
+ * @param Object
+ *        Supplies a pointer to the object to return.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the cache lock.
+ */
+XTAPI
+VOID
+MM::ObjectCache::FreeSlabObject(IN PMMOBJECT_CACHE Cache,
+                                IN PVOID Object)
+{
+    PMMOBJECT_SLAB Slab;
+    ULONG_PTR Offset;
+
+    /* Slabs are a single page long, so the slab header is found at the page base */
+    Slab = (PMMOBJECT_SLAB)PAGE_ALIGN(Object);
+    Offset = (ULONG_PTR)Object - (ULONG_PTR)Slab->Objects;
+
+    /* Make sure the object belongs to this cache and points to the start of an object */
+    if(Slab->Cache != Cache || (ULONG_PTR)Object < (ULONG_PTR)Slab->Objects || (Offset % Cache->ObjectSize) != 0 ||
+       Slab->FreeCount >= Cache->ObjectsPerSlab)
+    {
+        /* Invalid object freed, crash the system */
+        KE::Crash::Panic(0xC2, 0x48, (ULONG_PTR)Object, (ULONG_PTR)Cache, (ULONG_PTR)Slab);
+    }
+
+    /* Push the object index back on the slab free stack */
+    Slab->FreeStack[Slab->FreeCount] = (USHORT)(Offset / Cache->ObjectSize);
+    Slab->FreeCount++;
+
+    /* Move the slab to the list matching its new state */
+    RTL::LinkedList::RemoveEntryList(&Slab->ListEntry);
+    RTL::LinkedList::InsertHeadList((Slab->FreeCount == Cache->ObjectsPerSlab) ? &Cache->FreeSlabs : &Cache->PartialSlabs,
+                                    &Slab->ListEntry);
+
+    /* Update cache statistics */
+    Cache->ActiveObjects--;
+}
+
+/**
+ * Gets the magazine of the specified object cache that belongs to the current processor.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache.
+ *
+ * @return This routine returns a pointer to the magazine, or NULLPTR if the processor has no magazine.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PMMOBJECT_MAGAZINE
+MM::ObjectCache::GetProcessorMagazine(IN PMMOBJECT_CACHE Cache)
+{
+    ULONG CpuNumber;
+
+    /* Get the current processor number */
+    CpuNumber = KE::Processor::GetCurrentProcessorNumber();
+    if(CpuNumber >= Cache->MagazineCount)
+    {
+        /* No magazine for this processor */
+        return NULLPTR;
+    }
+
+    /* Return the magazine */
+    return &Cache->Magazines[CpuNumber];
+}
+
+/**
+ * Returns the magazine of the current processor to the slabs and releases all free slabs of the object cache.
+ *
+ * @param Cache
+ *        Supplies a pointer to the object cache to trim.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::ObjectCache::TrimCache(IN PMMOBJECT_CACHE Cache)
+{
+    PMMOBJECT_MAGAZINE Magazine;
+    PLIST_ENTRY SlabEntry;
+    LIST_ENTRY FreeSlabs;
+
+    /* Initialize the list of slabs to release */
+    RTL::LinkedList::InitializeListHead(&FreeSlabs);
+
+    /* Start a guarded code block */
+    {
+        /* Raise runlevel to DISPATCH_LEVEL and acquire the cache lock */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::SpinLockGuard CacheLock(&Cache->Lock);
+
+        /* Get the magazine that belongs to the current processor */
+        Magazine = GetProcessorMagazine(Cache);
+        if(Magazine)
+        {
+            /* Return all objects cached in the magazine to their slabs */
+            FlushMagazine(Cache, Magazine, MM_OBJECT_CACHE_MAGAZINE_SIZE);
+        }
+
+        /* Detach all free slabs from the cache */
+        while(!RTL::LinkedList::ListEmpty(&Cache->FreeSlabs))
+        {
+            /* Move the slab to the local list */
+            SlabEntry = Cache->FreeSlabs.Flink;
+            RTL::LinkedList::RemoveEntryList(SlabEntry);
+            RTL::LinkedList::InsertTailList(&FreeSlabs, SlabEntry);
+            Cache->TotalSlabs--;
+        }
+    }
+
+    /* Release the detached slabs outside of the cache lock */
+    while(!RTL::LinkedList::ListEmpty(&FreeSlabs))
+    {
+        /* Remove the slab from the list and free its page */
+        SlabEntry = FreeSlabs.Flink;
+        RTL::LinkedList::RemoveEntryList(SlabEntry);
+        MM::Allocator::FreePages(CONTAIN_RECORD(SlabEntry, MMOBJECT_SLAB, ListEntry));
+    }
+}
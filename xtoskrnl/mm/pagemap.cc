@@ -0,0 +1,185 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/pagemap.cc
+ * DESCRIPTION:     Page map range routines common to all page map levels
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Fills the page map range routines table with the routines bound to the page map level.
+ *
+ * @param Routines
+ *        Supplies a pointer to the routines table to fill.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+template <class PageMapLevel>
+XTAPI
+VOID
+MM::PageMapRange<PageMapLevel>::InitializeRoutines(OUT PPAGEMAP_RANGE_ROUTINES Routines)
+{
+    /* Bind the routines instantiated for the page map level */
+    Routines->MapContiguousPtes = MapContiguousPtes;
+    Routines->MapPtes = MapPtes;
+    Routines->UnmapPtes = UnmapPtes;
+}
+
+/**
+ * Maps a physically contiguous range of page frames into consecutive page table entries (PTEs).
+ *
+ * @param PageMap
+ *        Supplies a pointer to the page map routines of the page map level.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE to fill.
+ *
+ * @param PageFrameNumber
+ *        Supplies the first page frame number to map.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs to fill.
+ *
+ * @param Attributes
+ *        Specifies the attributes to apply to each PTE.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+template <class PageMapLevel>
+XTAPI
+VOID
+MM::PageMapRange<PageMapLevel>::MapContiguousPtes(IN PPAGEMAP PageMap,
+                                                  IN PMMPTE StartPte,
+                                                  IN PFN_NUMBER PageFrameNumber,
+                                                  IN PFN_COUNT NumberOfPtes,
+                                                  IN ULONGLONG Attributes)
+{
+    PageMapLevel *LevelRoutines;
+    PMMPTE PointerPte;
+    PFN_COUNT Index;
+
+    /* Call the page map level routines directly, without virtual dispatch */
+    LevelRoutines = static_cast<PageMapLevel *>(PageMap);
+
+    /* Fill all PTEs in the range */
+    PointerPte = StartPte;
+    for(Index = 0; Index < NumberOfPtes; Index++)
+    {
+        /* Map the next page frame and advance to the next PTE */
+        LevelRoutines->SetPte(PointerPte, PageFrameNumber + Index, Attributes);
+        PointerPte = LevelRoutines->GetNextPte(PointerPte);
+    }
+}
+
+/**
+ * Maps an array of page frames into consecutive page table entries (PTEs), using a template PTE.
+ *
+ * @param PageMap
+ *        Supplies a pointer to the page map routines of the page map level.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE to write.
+ *
+ * @param PageFrames
+ *        Supplies an array of page frame numbers to map.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs to write.
+ *
+ * @param TemplatePte
+ *        Supplies a pointer to the template PTE, providing the attributes of the mappings.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+template <class PageMapLevel>
+XTAPI
+VOID
+MM::PageMapRange<PageMapLevel>::MapPtes(IN PPAGEMAP PageMap,
+                                        IN PMMPTE StartPte,
+                                        IN PPFN_NUMBER PageFrames,
+                                        IN PFN_COUNT NumberOfPtes,
+                                        IN PMMPTE TemplatePte)
+{
+    PageMapLevel *LevelRoutines;
+    PMMPTE PointerPte;
+    PFN_COUNT Index;
+    MMPTE ValidPte;
+
+    /* Call the page map level routines directly, without virtual dispatch */
+    LevelRoutines = static_cast<PageMapLevel *>(PageMap);
+
+    /* Write all PTEs in the range */
+    ValidPte = *TemplatePte;
+    PointerPte = StartPte;
+    for(Index = 0; Index < NumberOfPtes; Index++)
+    {
+        /* Build a valid PTE pointing to the page frame, write it and advance to the next PTE */
+        LevelRoutines->SetPte(&ValidPte, PageFrames[Index], 0);
+        LevelRoutines->WritePte(PointerPte, ValidPte);
+        PointerPte = LevelRoutines->GetNextPte(PointerPte);
+    }
+}
+
+/**
+ * Clears consecutive page table entries (PTEs), optionally saving the page frames they mapped.
+ *
+ * @param PageMap
+ *        Supplies a pointer to the page map routines of the page map level.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE to clear.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs to clear.
+ *
+ * @param PageFrames
+ *        Supplies an optional array receiving the page frame numbers mapped by the PTEs.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+template <class PageMapLevel>
+XTAPI
+VOID
+MM::PageMapRange<PageMapLevel>::UnmapPtes(IN PPAGEMAP PageMap,
+                                          IN PMMPTE StartPte,
+                                          IN PFN_COUNT NumberOfPtes,
+                                          OUT PPFN_NUMBER PageFrames)
+{
+    PageMapLevel *LevelRoutines;
+    PMMPTE PointerPte;
+    PFN_COUNT Index;
+
+    /* Call the page map level routines directly, without virtual dispatch */
+    LevelRoutines = static_cast<PageMapLevel *>(PageMap);
+
+    /* Clear all PTEs in the range */
+    PointerPte = StartPte;
+    for(Index = 0; Index < NumberOfPtes; Index++)
+    {
+        /* Check if the page frame numbers should be saved */
+        if(PageFrames)
+        {
+            /* Save the page frame number mapped by the PTE */
+            PageFrames[Index] = LevelRoutines->GetPageFrameNumber(PointerPte);
+        }
+
+        /* Clear the PTE and advance to the next one */
+        LevelRoutines->ClearPte(PointerPte);
+        PointerPte = LevelRoutines->GetNextPte(PointerPte);
+    }
+}
+
+/* Instantiate page map range routines for all supported page map levels */
+template class MM::PageMapRange<MM::PageMapBasic>;
+template class MM::PageMapRange<MM::PageMapXpa>;
@@ -78,8 +78,12 @@ XTAPI
 VOID
 MM::Paging::FlushEntireTlb(VOID)
 {
-    /* Temporarily fallback to FlushTlb() as SMP is not supported yet */
-    FlushTlb();
+    MMTLB_FLUSH_BATCH Batch;
+
+    /* Flush the entire TLB on all processors */
+    MM::Tlb::InitializeBatch(&Batch);
+    Batch.FlushEntireTlb = TRUE;
+    MM::Tlb::FlushBatch(&Batch);
 }
 
 /**
@@ -93,7 +97,6 @@ XTAPI
 VOID
 MM::Paging::FlushTlb(VOID)
 {
-    CPUID_REGISTERS CpuRegisters;
     BOOLEAN Interrupts;
     ULONG_PTR Cr4;
 
@@ -101,12 +104,8 @@ MM::Paging::FlushTlb(VOID)
     Interrupts = AR::CpuFunctions::InterruptsEnabled();
     AR::CpuFunctions::ClearInterruptFlag();
 
-    /* Get CPU features */
-    CpuRegisters.Leaf = CPUID_GET_STANDARD1_FEATURES;
-    AR::CpuFunctions::CpuId(&CpuRegisters);
-
     /* Check if Paging Global Extensions (PGE) is supported */
-    if(CpuRegisters.Edx & CPUID_FEATURES_EDX_PGE)
+    if(AR::ProcessorSupport::HasFeature(KCF_GLOBAL_PAGE))
     {
         /* Read CR4 */
         Cr4 = AR::CpuFunctions::ReadControlRegister(4);
@@ -485,7 +484,8 @@ MM::Paging::GetXpaStatus()
 }
 
 /**
- * Detects if eXtended Physical Addressing (XPA) is enabled and initializes page map support.
+ * Detects if eXtended Physical Addressing (XPA) is enabled and initializes page map support. The range routines
+ * instantiated for the detected page map level are bound here once, so that their loops run without virtual dispatch.
  *
  * @return This routine does not return any value.
  *
@@ -500,17 +500,170 @@ MM::Paging::InitializePageMapSupport(VOID)
     {
         /* XPA enabled, use modern paging (PAE / LA57) */
         PmlRoutines = GetPageMapXpaRoutines();
+        MM::PageMapRange<MM::PageMapXpa>::InitializeRoutines(&PmlRangeRoutines);
     }
     else
     {
         /* XPA disabled, use basic paging (PML2 / PML4) */
         PmlRoutines = GetPageMapBasicRoutines();
+        MM::PageMapRange<MM::PageMapBasic>::InitializeRoutines(&PmlRangeRoutines);
     }
 
     /* Set page map information */
     PmlRoutines->InitializePageMapInfo();
 }
 
+/**
+ * Maps a physically contiguous range of page frames into consecutive page table entries (PTEs).
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE to fill.
+ *
+ * @param PageFrameNumber
+ *        Supplies the first page frame number to map.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs to fill.
+ *
+ * @param Attributes
+ *        Specifies the attributes to apply to each PTE.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Paging::MapContiguousPtes(IN PMMPTE StartPte,
+                              IN PFN_NUMBER PageFrameNumber,
+                              IN PFN_COUNT NumberOfPtes,
+                              IN ULONGLONG Attributes)
+{
+    /* Map the range with the routine bound to the current page map level */
+    PmlRangeRoutines.MapContiguousPtes(PmlRoutines, StartPte, PageFrameNumber, NumberOfPtes, Attributes);
+}
+
+/**
+ * Maps an array of page frames into consecutive page table entries (PTEs), using a template PTE.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE to write.
+ *
+ * @param PageFrames
+ *        Supplies an array of page frame numbers to map.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs to write.
+ *
+ * @param TemplatePte
+ *        Supplies a pointer to the template PTE, providing the attributes of the mappings.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Paging::MapPtes(IN PMMPTE StartPte,
+                    IN PPFN_NUMBER PageFrames,
+                    IN PFN_COUNT NumberOfPtes,
+                    IN PMMPTE TemplatePte)
+{
+    /* Map the range with the routine bound to the current page map level */
+    PmlRangeRoutines.MapPtes(PmlRoutines, StartPte, PageFrames, NumberOfPtes, TemplatePte);
+}
+
+#ifdef DBG
+/**
+ * Measures the cost of filling and clearing a batch of PTEs through the per-entry page map routines and through
+ * the range routines bound to the current page map level, and reports both to the debugger.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The measurement operates on a scratch PTE buffer and does not modify any live page table.
+ */
+XTAPI
+VOID
+MM::Paging::MeasurePageMapRoutines(VOID)
+{
+    PFN_NUMBER PageFrames[MM_PAGE_BULK_ALLOCATION_SIZE];
+    MMPTE ScratchPtes[MM_PAGE_BULK_ALLOCATION_SIZE];
+    ULONGLONG DispatchCycles, RangeCycles;
+    PMMPTE PointerPte;
+    ULONG Index, Pass;
+    MMPTE ValidPte;
+
+    /* Prepare the scratch PTEs, the page frames to map and the template PTE */
+    RTL::Memory::ZeroMemory(ScratchPtes, sizeof(ScratchPtes));
+    for(Index = 0; Index < MM_PAGE_BULK_ALLOCATION_SIZE; Index++)
+    {
+        /* Use an arbitrary page frame number */
+        PageFrames[Index] = Index;
+    }
+    ValidPte = *MM::Pte::GetValidPte();
+
+    /* Fill and clear the scratch PTEs, dispatching every entry through the page map routines */
+    DispatchCycles = AR::CpuFunctions::ReadTimeStampCounter();
+    for(Pass = 0; Pass < 16; Pass++)
+    {
+        /* Fill all scratch PTEs */
+        PointerPte = ScratchPtes;
+        for(Index = 0; Index < MM_PAGE_BULK_ALLOCATION_SIZE; Index++)
+        {
+            /* Build a valid PTE, write it and advance to the next PTE */
+            SetPte(&ValidPte, PageFrames[Index], 0);
+            WritePte(PointerPte, ValidPte);
+            PointerPte = GetNextPte(PointerPte);
+        }
+
+        /* Clear all scratch PTEs */
+        PointerPte = ScratchPtes;
+        for(Index = 0; Index < MM_PAGE_BULK_ALLOCATION_SIZE; Index++)
+        {
+            /* Save the page frame number, clear the PTE and advance to the next PTE */
+            PageFrames[Index] = GetPageFrameNumber(PointerPte);
+            ClearPte(PointerPte);
+            PointerPte = GetNextPte(PointerPte);
+        }
+    }
+    DispatchCycles = AR::CpuFunctions::ReadTimeStampCounter() - DispatchCycles;
+
+    /* Fill and clear the scratch PTEs with the range routines */
+    RangeCycles = AR::CpuFunctions::ReadTimeStampCounter();
+    for(Pass = 0; Pass < 16; Pass++)
+    {
+        /* Fill and clear all scratch PTEs */
+        MapPtes(ScratchPtes, PageFrames, MM_PAGE_BULK_ALLOCATION_SIZE, &ValidPte);
+        UnmapPtes(ScratchPtes, MM_PAGE_BULK_ALLOCATION_SIZE, PageFrames);
+    }
+    RangeCycles = AR::CpuFunctions::ReadTimeStampCounter() - RangeCycles;
+
+    /* Report the results */
+    DebugPrint(L"Page map routines: %llu cycles per-entry dispatch, %llu cycles range routines (%u PTEs)\n",
+               DispatchCycles, RangeCycles, 16 * MM_PAGE_BULK_ALLOCATION_SIZE);
+}
+#endif
+
+/**
+ * Checks whether the given page directory entry (PDE) maps a large page.
+ *
+ * @param PtePointer
+ *        Pointer to the page directory entry (PDE) to check.
+ *
+ * @return Returns TRUE if the entry maps a large page, FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::Paging::PteLargePage(IN PMMPTE PtePointer)
+{
+    /* Check if PDE maps a large page */
+    return PmlRoutines->PteLargePage(PtePointer);
+}
+
 /**
  * Checks whether the given PML2 page table entry (PTE) is valid.
  *
@@ -668,6 +821,32 @@ MM::Paging::TransitionPte(IN PMMPTE PointerPte,
     PmlRoutines->TransitionPte(PointerPte, Protection);
 }
 
+/**
+ * Clears consecutive page table entries (PTEs), optionally saving the page frames they mapped.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE to clear.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs to clear.
+ *
+ * @param PageFrames
+ *        Supplies an optional array receiving the page frame numbers mapped by the PTEs.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Paging::UnmapPtes(IN PMMPTE StartPte,
+                      IN PFN_COUNT NumberOfPtes,
+                      OUT PPFN_NUMBER PageFrames)
+{
+    /* Unmap the range with the routine bound to the current page map level */
+    PmlRangeRoutines.UnmapPtes(PmlRoutines, StartPte, NumberOfPtes, PageFrames);
+}
+
 /**
  * Writes a Page Table Entry (PTE) with the specified value.
  *
@@ -0,0 +1,186 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/pfault.cc
+ * DESCRIPTION:     Page fault support
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Resolves a page fault, committing a zeroed physical page to a demand-zero paged pool PTE on its first access.
+ *
+ * @param VirtualAddress
+ *        Supplies the virtual address that caused the page fault.
+ *
+ * @param ErrorCode
+ *        Supplies the error code pushed by the processor for the page fault.
+ *
+ * @return This routine returns STATUS_SUCCESS if the fault has been resolved, or an error status code otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::PageFault::HandlePageFault(IN PVOID VirtualAddress,
+                               IN ULONG_PTR ErrorCode)
+{
+    PFN_NUMBER PageFrameIndex;
+    MMPTE DemandZeroPte, TempPte;
+    PMMPTE PointerPte;
+
+    /* Account the page fault */
+    MM::Statistics::IncrementCounter(PageFaults);
+
+    /* Only accesses to non-present paged pool pages can be resolved */
+    if((ErrorCode & PF_ERROR_PRESENT) || !PagedPoolAddress(VirtualAddress))
+    {
+        /* Protection violation or access outside of the paged pool */
+        return STATUS_ACCESS_VIOLATION;
+    }
+
+    /* Paged pool must not be accessed above APC level */
+    if(KE::RunLevel::GetCurrentRunLevel() > APC_LEVEL)
+    {
+        /* Invalid run level for the paged pool access */
+        return STATUS_ACCESS_VIOLATION;
+    }
+
+    /* Get the PTE and make sure the page table containing it is resident, as it is created on allocation */
+    PointerPte = MM::Paging::GetPteAddress(VirtualAddress);
+    if(!MM::Pte::AddressValid(PointerPte))
+    {
+        /* Page table not present, the address has never been allocated */
+        return STATUS_ACCESS_VIOLATION;
+    }
+
+    /* Set up a template for a demand-zero PTE */
+    MM::Paging::ClearPte(&DemandZeroPte);
+    MM::Paging::SetPte(&DemandZeroPte, MM_READWRITE << MM_PROTECT_FIELD_SHIFT);
+
+    /* Check if the PTE is a demand-zero one */
+    if(MM::Paging::GetPte(PointerPte) != MM::Paging::GetPte(&DemandZeroPte))
+    {
+        /* Fault resolved by another processor meanwhile, or the page is not allocated */
+        return MM::Paging::PteValid(PointerPte) ? STATUS_SUCCESS : STATUS_ACCESS_VIOLATION;
+    }
+
+    /* Allocate a zeroed physical page to back the faulting page */
+    PageFrameIndex = MM::Pfn::AllocateZeroedPage(MM::Colors::GetNextColor());
+    if(!PageFrameIndex)
+    {
+        /* No physical pages are available in the system, return error */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Set up a template for a valid, writable PTE */
+    MM::Paging::ClearPte(&TempPte);
+    MM::Paging::SetPte(&TempPte, PageFrameIndex, MM_PTE_READWRITE | MM_PTE_CACHE_ENABLE);
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::QueuedSpinLockGuard SpinLock(PfnLock);
+
+        /* Make sure the PTE has not changed, while the page was being zeroed */
+        if(MM::Paging::GetPte(PointerPte) == MM::Paging::GetPte(&DemandZeroPte))
+        {
+            /* Associate the physical page with the PTE and make the PTE valid */
+            MM::Pfn::LinkPfn(PageFrameIndex, PointerPte, TRUE);
+            MM::Paging::WritePte(PointerPte, TempPte);
+
+            /* Page fault resolved, return success */
+            return STATUS_SUCCESS;
+        }
+    }
+
+    /* The PTE has been changed by another processor, return the unused page */
+    MM::Pfn::FreeMagazinePage(PageFrameIndex);
+
+    /* Return success if the page is already resident */
+    return MM::Paging::PteValid(PointerPte) ? STATUS_SUCCESS : STATUS_ACCESS_VIOLATION;
+}
+
+/**
+ * Creates a page table and installs it into the given, not present, upper level page table entry.
+ *
+ * @param PointerPte
+ *        Supplies a pointer to the page table entry that will map the new page table.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::PageFault::MapPageTable(IN PMMPTE PointerPte)
+{
+    PFN_NUMBER PageFrameIndex;
+    MMPTE TempPte;
+
+    /* Allocate a zeroed physical page for the page table */
+    PageFrameIndex = MM::Pfn::AllocateZeroedPage(MM::Colors::GetNextColor());
+    if(!PageFrameIndex)
+    {
+        /* No physical pages are available in the system, return error */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Set up the page table entry */
+    TempPte = *MM::Pte::GetValidPte();
+    MM::Paging::SetPte(&TempPte, PageFrameIndex, 0);
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::QueuedSpinLockGuard SpinLock(PfnLock);
+
+        /* Check if the page table has not been created by another processor meanwhile */
+        if(!MM::Paging::PteValid(PointerPte))
+        {
+            /* Link the page table to its parent and make it resident */
+            MM::Pfn::LinkPfnWithParent(PageFrameIndex,
+                                       PointerPte,
+                                       MM::Paging::GetPageFrameNumber(MM::Paging::GetPteAddress(PointerPte)));
+            MM::Paging::WritePte(PointerPte, TempPte);
+
+            /* Return success */
+            return STATUS_SUCCESS;
+        }
+    }
+
+    /* Page table already resident, return the unused page */
+    MM::Pfn::FreeMagazinePage(PageFrameIndex);
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Checks whether the given virtual address belongs to the paged pool.
+ *
+ * @param VirtualAddress
+ *        Supplies the virtual address to check.
+ *
+ * @return This routine returns TRUE if the address lies within the paged pool, or FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::PageFault::PagedPoolAddress(IN PVOID VirtualAddress)
+{
+    PMMMEMORY_LAYOUT MemoryLayout;
+
+    /* Retrieve memory layout */
+    MemoryLayout = MM::Manager::GetMemoryLayout();
+
+    /* Check if the address lies within the paged pool pages */
+    return (VirtualAddress >= MemoryLayout->PagedPoolStart &&
+            (((ULONG_PTR)VirtualAddress - (ULONG_PTR)MemoryLayout->PagedPoolStart) >> MM_PAGE_SHIFT) <
+            MemoryLayout->PagedPoolSize);
+}
@@ -10,6 +10,66 @@
 #include <xtos.hh>
 
 
+/**
+ * Allocates a block of physical pages for early kernel initialization, aligned to the given boundary.
+ *
+ * @param NumberOfPages
+ *        The number of physical pages to allocate.
+ *
+ * @param Alignment
+ *        The required alignment of the base page frame number, in pages. Must be a power of two.
+ *
+ * @param PageFrameNumber
+ *        Supplies a pointer to a variable that receives the base page frame number (PFN) of the allocated block.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note Pages skipped to satisfy the alignment are kept aside and handed out by subsequent bootstrap allocations.
+ */
+XTAPI
+XTSTATUS
+MM::Pfn::AllocateBootstrapAlignedPages(IN PFN_NUMBER NumberOfPages,
+                                       IN PFN_NUMBER Alignment,
+                                       OUT PPFN_NUMBER PageFrameNumber)
+{
+    PFN_NUMBER Padding;
+
+    /* Calculate the number of pages to skip to reach the requested alignment */
+    Padding = ROUND_UP(FreeDescriptor->BasePage, Alignment) - FreeDescriptor->BasePage;
+
+    /* Check if the largest free memory block can satisfy the aligned request */
+    if(Padding + NumberOfPages > FreeDescriptor->PageCount)
+    {
+        /* Not enough physical memory available, return error */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Check if any pages need to be skipped */
+    if(Padding != 0)
+    {
+        /* Only a single padding block can be tracked at a time */
+        if(BootstrapPaddingDescriptor.PageCount != 0)
+        {
+            /* Padding block already in use, return error */
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+
+        /* Keep the skipped pages aside for subsequent bootstrap allocations */
+        BootstrapPaddingDescriptor.BasePage = FreeDescriptor->BasePage;
+        BootstrapPaddingDescriptor.PageCount = Padding;
+    }
+
+    /* Allocate aligned pages from the free descriptor */
+    *PageFrameNumber = FreeDescriptor->BasePage + Padding;
+    FreeDescriptor->BasePage += Padding + NumberOfPages;
+    FreeDescriptor->PageCount -= Padding + NumberOfPages;
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
 /**
  * Allocates a block of physical pages for early kernel initialization.
  *
@@ -26,6 +86,18 @@ MM::Pfn::AllocateBootstrapPages(IN PFN_NUMBER NumberOfPages)
 {
     PFN_NUMBER Pfn;
 
+    /* Check if the request can be satisfied from pages skipped by an aligned allocation */
+    if(NumberOfPages <= BootstrapPaddingDescriptor.PageCount)
+    {
+        /* Allocate pages from the beginning of the padding block */
+        Pfn = BootstrapPaddingDescriptor.BasePage;
+        BootstrapPaddingDescriptor.BasePage += NumberOfPages;
+        BootstrapPaddingDescriptor.PageCount -= NumberOfPages;
+
+        /* Return the base page frame number of the allocated block */
+        return Pfn;
+    }
+
     /* Check if the largest free memory block has enough pages */
     if(NumberOfPages > FreeDescriptor->PageCount)
     {
@@ -47,6 +119,261 @@ MM::Pfn::AllocateBootstrapPages(IN PFN_NUMBER NumberOfPages)
     return Pfn;
 }
 
+/**
+ * Allocates a run of physically contiguous pages, using the buddy index of free page blocks.
+ *
+ * @param PageCount
+ *        Supplies the number of pages to allocate.
+ *
+ * @param Alignment
+ *        Supplies the required alignment of the first page frame number, in pages. Must be a power of two.
+ *
+ * @param HighestPage
+ *        Supplies the highest acceptable page frame number of the allocation.
+ *
+ * @param BasePage
+ *        Supplies a pointer to a variable that receives the first page frame number of the allocated run.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ *
+ * @note The pages are not zeroed and are not mapped. Pages cached in the current processor's page magazine are
+ *       returned to the free lists and the search is retried once, before the allocation fails.
+ */
+XTAPI
+XTSTATUS
+MM::Pfn::AllocateContiguousPages(IN PFN_NUMBER PageCount,
+                                 IN PFN_NUMBER Alignment,
+                                 IN PFN_NUMBER HighestPage,
+                                 OUT PPFN_NUMBER BasePage)
+{
+    ULONG Attempt, Order, PagingColorsMask;
+    PFN_NUMBER PageFrameIndex;
+    PMMPFN Pfn;
+
+    /* Assume failure */
+    *BasePage = 0;
+
+    /* Validate the request and make sure the buddy index is available */
+    if(PageCount == 0 || Alignment == 0 || (Alignment & (Alignment - 1)) != 0 || !MM::Buddy::IsIndexInitialized())
+    {
+        /* Invalid request, return error */
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    /* Get the order of the block satisfying the request and the bitmask used for calculating a page's color */
+    Order = MM::Buddy::GetBlockOrder(PageCount, Alignment);
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+
+    /* Search the buddy index, retrying once with the page magazine flushed */
+    for(Attempt = 0; Attempt < 2; Attempt++)
+    {
+        /* Start a guarded code block */
+        {
+            /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+            KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+            KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+            /* Find a free block of the required order */
+            if(MM::Buddy::FindFreeBlock(Order, HighestPage, BasePage))
+            {
+                /* Take the requested number of pages from the beginning of the block */
+                for(PageFrameIndex = *BasePage; PageFrameIndex < *BasePage + PageCount; PageFrameIndex++)
+                {
+                    /* Check if the page belongs to the reserved region */
+                    if(PageFrameIndex >= ContiguousReserveBase &&
+                       PageFrameIndex < ContiguousReserveBase + ContiguousReservePages)
+                    {
+                        /* Reserved pages are not linked to the free lists, only remove them from the buddy index */
+                        MM::Buddy::RemovePage(PageFrameIndex);
+                    }
+                    else
+                    {
+                        /* Unlink the page from the free lists, which removes it from the buddy index as well */
+                        UnlinkFreePage(PageFrameIndex, PageFrameIndex & PagingColorsMask);
+                    }
+
+                    /* Mark the page as being in use */
+                    Pfn = GetPfnEntry(PageFrameIndex);
+                    Pfn->PteAddress = NULLPTR;
+                    Pfn->u2.ShareCount = 1;
+                    Pfn->u3.e1.CacheAttribute = PfnCached;
+                    Pfn->u3.e1.PageLocation = ActiveAndValid;
+                    Pfn->u3.e2.ReferenceCount = 1;
+                }
+
+                /* Return success */
+                return STATUS_SUCCESS;
+            }
+        }
+
+        /* Return pages cached in the page magazine, which might complete a free block */
+        FlushPageMagazine();
+    }
+
+    /* No suitable free block found, return error */
+    *BasePage = 0;
+    return STATUS_INSUFFICIENT_RESOURCES;
+}
+
+/**
+ * Allocates a physical page from the current processor's page magazine, refilling it in bulk when empty.
+ *
+ * @param Color
+ *        Specifies the preferred page color.
+ *
+ * @return This routine returns the page frame number of the allocated page, or 0 if no page is available.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PFN_NUMBER
+MM::Pfn::AllocateMagazinePage(IN ULONG Color)
+{
+    PFN_NUMBER PageFrameIndex;
+    PMMPAGE_MAGAZINE Magazine;
+    ULONG PagingColorsMask;
+    ULONG Index;
+
+    /* Retrieve the bitmask used for calculating a page's color */
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+    Color &= PagingColorsMask;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the page magazine of the current processor */
+    Magazine = &KE::Processor::GetCurrentProcessorControlBlock()->PageMagazine;
+
+    /* Check if the magazine is empty */
+    if(Magazine->Count == 0)
+    {
+        /* Refill the magazine with a batch of pages */
+        RefillPageMagazine(Magazine, Color);
+        if(Magazine->Count == 0)
+        {
+            /* No physical pages are available in the system, return 0 */
+            return 0;
+        }
+    }
+
+    /* Look for a page of the requested color, starting from the most recently cached one */
+    for(Index = Magazine->Count; Index > 0; Index--)
+    {
+        /* Check the page color */
+        if((Magazine->Pages[Index - 1] & PagingColorsMask) == Color)
+        {
+            /* Page of the requested color found */
+            break;
+        }
+    }
+
+    /* Check if a page of the requested color was found */
+    if(Index == 0)
+    {
+        /* No page of the requested color, take the most recently cached one */
+        Magazine->ColorMisses++;
+        Index = Magazine->Count;
+    }
+
+    /* Take the page out of the magazine, filling the gap with the last cached page */
+    PageFrameIndex = Magazine->Pages[Index - 1];
+    Magazine->Count--;
+    Magazine->Pages[Index - 1] = Magazine->Pages[Magazine->Count];
+
+    /* Return the page frame number */
+    return PageFrameIndex;
+}
+
+/**
+ * Allocates physical pages in bulk and maps them into a run of system PTEs.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE of the run.
+ *
+ * @param Pages
+ *        Supplies the number of pages to allocate and map.
+ *
+ * @param Node
+ *        Supplies the preferred NUMA node.
+ *
+ * @param TemplatePte
+ *        Supplies a pointer to the template PTE, providing the attributes of the mappings.
+ *
+ * @return This routine returns a status code. Either all requested pages are mapped, or none.
+ *
+ * @since XT 1.0
+ *
+ * @note Small runs are served by the page magazine of the current processor, without acquiring the PFN lock. The
+ *       page tables mapping the run must be resident and are not reference counted, thus the pages have to be
+ *       released with FreeMappedPages().
+ */
+XTAPI
+XTSTATUS
+MM::Pfn::AllocateMappedPages(IN PMMPTE StartPte,
+                             IN PFN_COUNT Pages,
+                             IN ULONG Node,
+                             IN PMMPTE TemplatePte)
+{
+    PFN_NUMBER PageFrames[MM_PAGE_BULK_ALLOCATION_SIZE];
+    PFN_COUNT BatchPages, Index, MappedPages;
+    PFN_NUMBER PteFrame;
+    PMMPTE PointerPte;
+    ULONG Color;
+    PMMPFN Pfn;
+
+    /* Start mapping from the first PTE of the run, with the color of the first page */
+    PointerPte = StartPte;
+    MappedPages = 0;
+    Color = MM::Colors::GetNextColor();
+
+    /* Map the run in batches of physical pages acquired in bulk */
+    while(MappedPages < Pages)
+    {
+        /* Acquire a batch of physical pages of consecutive colors */
+        BatchPages = MIN(Pages - MappedPages, MM_PAGE_BULK_ALLOCATION_SIZE);
+        if(AllocatePhysicalPages(Node, Color + MappedPages, BatchPages, PageFrames) != STATUS_SUCCESS)
+        {
+            /* Out of physical pages, unmap and free all pages allocated so far */
+            FreeMappedPages(StartPte, MappedPages);
+            return STATUS_INSUFFICIENT_RESOURCES;
+        }
+
+        /* Write the PTE run of the batch with the routine bound to the current page map level */
+        MM::Paging::MapPtes(PointerPte, PageFrames, BatchPages, TemplatePte);
+
+        /* Initialize the PFN entries of the batch */
+        for(Index = 0; Index < BatchPages; Index++)
+        {
+            /* Look up the page table frame only when the first PTE or a new page table is reached */
+            if(Index == 0 || ((ULONG_PTR)PointerPte & MM_PAGE_MASK) == 0)
+            {
+                /* Get the page frame number of the page table holding the current PTE */
+                PteFrame = MM::Paging::GetPageFrameNumber(MM::Paging::GetPteAddress(PointerPte));
+            }
+
+            /* Initialize the PFN entry for the allocated physical page */
+            Pfn = GetPfnEntry(PageFrames[Index]);
+            MM::Paging::SetPte(&Pfn->OriginalPte, 0, MM_READWRITE << MM_PROTECT_FIELD_SHIFT);
+            Pfn->PteAddress = PointerPte;
+            Pfn->u2.ShareCount = 1;
+            Pfn->u3.e1.PageLocation = ActiveAndValid;
+            Pfn->u3.e2.ReferenceCount = 1;
+            Pfn->u4.PteFrame = PteFrame;
+
+            /* Advance to the next PTE */
+            PointerPte = MM::Paging::GetNextPte(PointerPte);
+        }
+
+        /* Account for the mapped batch */
+        MappedPages += BatchPages;
+    }
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
 /**
  * Allocates a physical page frame (PFN) from one of the system's free page lists.
  *
@@ -61,8 +388,31 @@ XTAPI
 PFN_NUMBER
 MM::Pfn::AllocatePhysicalPage(IN ULONG Color)
 {
+    /* Allocate a physical page, preferring the current processor's NUMA node */
+    return AllocatePhysicalPage(MM::Numa::GetCurrentNode(), Color);
+}
+
+/**
+ * Allocates a physical page frame (PFN) from one of the system's free page lists, preferring the given NUMA node.
+ *
+ * @param Node
+ *        Supplies the preferred NUMA node. Other nodes are used in the order of their distance from this node.
+ *
+ * @param Color
+ *        The preferred page color, used to optimize CPU cache alignment and reduce cache contention.
+ *
+ * @return This routine returns the Page Frame Number (PFN) of the allocated page.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PFN_NUMBER
+MM::Pfn::AllocatePhysicalPage(IN ULONG Node,
+                              IN ULONG Color)
+{
+    ULONG Index, NodeCount, PagingColorsMask;
     PFN_NUMBER PageNumber;
-    ULONG PagingColorsMask;
+    PUCHAR NodeOrder;
 
     /* Check if any physical pages are available in the system */
     if(!AvailablePages)
@@ -74,18 +424,28 @@ MM::Pfn::AllocatePhysicalPage(IN ULONG Color)
     /* Retrieve the bitmask used for calculating a page's color */
     PagingColorsMask = MM::Colors::GetPagingColorsMask();
 
-    /* Attempt to retrieve a page from the colored free page list */
-    PageNumber = MM::Colors::GetFreePages(FreePageList, Color)->Flink;
-    if(PageNumber == MAXULONG_PTR)
+    /* Get the number of NUMA nodes and the order in which they are used by the preferred node */
+    NodeCount = MM::Numa::GetNodeCount();
+    NodeOrder = MM::Numa::GetNodeOrder(Node);
+
+    /* Walk the nodes from the preferred one to the most distant one */
+    PageNumber = MAXULONG_PTR;
+    for(Index = 0; Index < NodeCount && PageNumber == MAXULONG_PTR; Index++)
     {
-        /* No page was found in the colored free page list, check the colored zero page list */
-        PageNumber = MM::Colors::GetFreePages(ZeroedPageList, Color)->Flink;
+        /* Attempt to retrieve a page from the node's colored free page list */
+        PageNumber = MM::Colors::GetFreePages(FreePageList, NodeOrder[Index], Color)->Flink;
+        if(PageNumber == MAXULONG_PTR)
+        {
+            /* No page was found in the colored free page list, check the colored zero page list */
+            PageNumber = MM::Colors::GetFreePages(ZeroedPageList, NodeOrder[Index], Color)->Flink;
+        }
     }
 
     /* Attempt to retrieve a page from the colored zero list */
     if(PageNumber == MAXULONG_PTR)
     {
         /* No page was found in the colored zero page list, check the global free page list */
+        MM::Statistics::IncrementCounter(ColoredListMisses);
         PageNumber = FreePagesList.Flink;
     }
 
@@ -100,6 +460,232 @@ MM::Pfn::AllocatePhysicalPage(IN ULONG Color)
     return UnlinkFreePage(PageNumber, PageNumber & PagingColorsMask);
 }
 
+/**
+ * Allocates a batch of physical pages of consecutive colors in a single pass.
+ *
+ * @param Color
+ *        Specifies the color of the first page.
+ *
+ * @param Pages
+ *        Specifies the number of pages to allocate, up to MM_PAGE_BULK_ALLOCATION_SIZE.
+ *
+ * @param PageFrames
+ *        Supplies a pointer to an array that will receive the page frame numbers of the allocated pages.
+ *
+ * @return This routine returns a status code. Either all requested pages are allocated, or none.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Pfn::AllocatePhysicalPages(IN ULONG Color,
+                               IN PFN_COUNT Pages,
+                               OUT PPFN_NUMBER PageFrames)
+{
+    /* Allocate the physical pages, preferring the current processor's NUMA node */
+    return AllocatePhysicalPages(MM::Numa::GetCurrentNode(), Color, Pages, PageFrames);
+}
+
+/**
+ * Allocates a batch of physical pages of consecutive colors in a single pass, preferring the given NUMA node.
+ *
+ * @param Node
+ *        Supplies the preferred NUMA node. Other nodes are used in the order of their distance from this node.
+ *
+ * @param Color
+ *        Specifies the color of the first page.
+ *
+ * @param Pages
+ *        Specifies the number of pages to allocate, up to MM_PAGE_BULK_ALLOCATION_SIZE.
+ *
+ * @param PageFrames
+ *        Supplies a pointer to an array that will receive the page frame numbers of the allocated pages.
+ *
+ * @return This routine returns a status code. Either all requested pages are allocated, or none.
+ *
+ * @since XT 1.0
+ *
+ * @note Large batches are served under a single PFN lock acquisition, detaching a run of pages from every colored
+ *       list used by the batch in one pass. Page N of the batch has the color of the first page plus N.
+ */
+XTAPI
+XTSTATUS
+MM::Pfn::AllocatePhysicalPages(IN ULONG Node,
+                               IN ULONG Color,
+                               IN PFN_COUNT Pages,
+                               OUT PPFN_NUMBER PageFrames)
+{
+    ULONG NodeCount, NodeIndex, PagingColors, PagingColorsMask;
+    PFN_COUNT Index, Taken, Wanted;
+    PUCHAR NodeOrder;
+
+    /* Validate the number of pages requested */
+    if(Pages == 0 || Pages > MM_PAGE_BULK_ALLOCATION_SIZE)
+    {
+        /* Invalid number of pages, return error */
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    /* Check if the request is small enough to be served by the page magazine of a processor on the node */
+    if(Pages <= MM_PAGE_MAGAZINE_BATCH && Node == MM::Numa::GetCurrentNode())
+    {
+        /* Take the pages from the current processor's page magazine */
+        for(Index = 0; Index < Pages; Index++)
+        {
+            /* Allocate a page of the next color */
+            PageFrames[Index] = AllocateMagazinePage(Color + Index);
+            if(PageFrames[Index] == 0)
+            {
+                /* Out of physical pages, return all pages taken so far */
+                while(Index > 0)
+                {
+                    /* Free the page */
+                    Index--;
+                    FreeMagazinePage(PageFrames[Index]);
+                }
+
+                /* Return failure */
+                return STATUS_INSUFFICIENT_RESOURCES;
+            }
+        }
+
+        /* Return success */
+        return STATUS_SUCCESS;
+    }
+
+    /* Retrieve the number of paging colors and the bitmask used for calculating a page's color */
+    PagingColors = MM::Colors::GetPagingColors();
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+
+    /* Get the number of NUMA nodes and the order in which they are used by the preferred node */
+    NodeCount = MM::Numa::GetNodeCount();
+    NodeOrder = MM::Numa::GetNodeOrder(Node);
+
+    /* Acquire the PFN database lock once for the whole batch */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+    /* Make sure the whole batch can be satisfied */
+    if(AvailablePages < Pages)
+    {
+        /* Not enough physical pages available, return failure */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Visit every color used by the batch only once */
+    for(Index = 0; Index < Pages && Index < PagingColors; Index++)
+    {
+        /* Compute the number of batch slots sharing this color, as the colors wrap around in large batches */
+        Wanted = ((Pages - Index - 1) / PagingColors) + 1;
+        Taken = 0;
+
+        /* Detach runs of pages from the colored free and zeroed lists, starting with the preferred node */
+        for(NodeIndex = 0; NodeIndex < NodeCount && Taken < Wanted; NodeIndex++)
+        {
+            /* Take pages from the colored free list first, then from the colored zeroed list */
+            Taken += UnlinkFreePages(FreePageList, NodeOrder[NodeIndex], (Color + Index) & PagingColorsMask,
+                                     Wanted - Taken, PagingColors, &PageFrames[Index + (Taken * PagingColors)]);
+            Taken += UnlinkFreePages(ZeroedPageList, NodeOrder[NodeIndex], (Color + Index) & PagingColorsMask,
+                                     Wanted - Taken, PagingColors, &PageFrames[Index + (Taken * PagingColors)]);
+        }
+
+        /* Fill the remaining slots of this color from the global lists */
+        for(; Taken < Wanted; Taken++)
+        {
+            /* Allocate any physical page */
+            PageFrames[Index + (Taken * PagingColors)] = AllocatePhysicalPage(Node, (Color + Index) & PagingColorsMask);
+        }
+    }
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * Allocates a physical page that is guaranteed to be filled with zeroes, preferring pages zeroed in advance.
+ *
+ * @param Color
+ *        Specifies the preferred page color.
+ *
+ * @return This routine returns the page frame number of the allocated page, or 0 if no page is available.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PFN_NUMBER
+MM::Pfn::AllocateZeroedPage(IN ULONG Color)
+{
+    ULONG Index, NodeCount, PagingColorsMask;
+    PFN_NUMBER PageNumber;
+    PUCHAR NodeOrder;
+
+    /* Retrieve the bitmask used for calculating a page's color */
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+    Color &= PagingColorsMask;
+
+    /* Raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the PFN database lock */
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+        /* Check if any physical pages are available in the system */
+        if(!AvailablePages)
+        {
+            /* No physical pages are available in the system, return 0 */
+            return 0;
+        }
+
+        /* Get the number of NUMA nodes and the order in which they are used by the current processor */
+        NodeCount = MM::Numa::GetNodeCount();
+        NodeOrder = MM::Numa::GetNodeOrder(MM::Numa::GetCurrentNode());
+
+        /* Attempt to retrieve a page from the colored zero page lists, starting with the local node */
+        PageNumber = MAXULONG_PTR;
+        for(Index = 0; Index < NodeCount && PageNumber == MAXULONG_PTR; Index++)
+        {
+            /* Check the node's colored zero page list */
+            PageNumber = MM::Colors::GetFreePages(ZeroedPageList, NodeOrder[Index], Color)->Flink;
+        }
+
+        /* Check if a page was found in the colored zero page lists */
+        if(PageNumber == MAXULONG_PTR)
+        {
+            /* No page was found in the colored zero page list, check the global zero page list */
+            MM::Statistics::IncrementCounter(ColoredListMisses);
+            PageNumber = ZeroedPagesList.Flink;
+        }
+
+        /* Check if a pre-zeroed page was found */
+        if(PageNumber != MAXULONG_PTR)
+        {
+            /* Remove the page from its list and return its PFN */
+            return UnlinkFreePage(PageNumber, PageNumber & PagingColorsMask);
+        }
+    }
+
+    /* No pre-zeroed page available, take any free page from the page magazine, without the PFN lock */
+    PageNumber = AllocateMagazinePage(Color);
+    if(PageNumber == 0)
+    {
+        /* No physical pages are available in the system, return 0 */
+        return 0;
+    }
+
+    /* Zero the page synchronously */
+    if(ZeroPhysicalPages(&PageNumber, 1) != STATUS_SUCCESS)
+    {
+        /* Unable to map the page, return it to the page magazine */
+        FreeMagazinePage(PageNumber);
+        return 0;
+    }
+
+    /* Return the page frame number */
+    return PageNumber;
+}
+
 /**
  * Calculates the total number of pages required for the PFN database and its associated color tables.
  *
@@ -118,7 +704,8 @@ MM::Pfn::ComputePfnDatabaseSize(OUT PPFN_NUMBER DatabaseSize)
 
     /* Calculate the total number of pages required for the PFN database */
     PfnDatabaseSize = (HighestPhysicalPage + 1) * sizeof(MMPFN);
-    PfnDatabaseSize += (MM::Colors::GetPagingColors() * sizeof(MMCOLOR_TABLES) * 2);
+    PfnDatabaseSize += (MM::Colors::GetPagingColors() * MM::Numa::GetNodeCount() * sizeof(MMCOLOR_TABLES) * 2);
+    PfnDatabaseSize += (MM::Colors::GetPagingColors() * sizeof(MMPFNLIST));
     PfnDatabaseSize = ROUND_UP(PfnDatabaseSize, MM_PAGE_SIZE);
     PfnDatabaseSize >>= MM_PAGE_SHIFT;
 
@@ -268,56 +855,335 @@ MM::Pfn::DecrementShareCount(IN PMMPFN PageFrameNumber,
                          0);
     }
 
-    /* Decrement the PFN share count */
-    PageFrameNumber->u2.ShareCount--;
+    /* Decrement the PFN share count */
+    PageFrameNumber->u2.ShareCount--;
+
+    /* Check if the share count has dropped to zero */
+    if(!PageFrameNumber->u2.ShareCount)
+    {
+        /* Check if this is a prototype PTE */
+        if(PageFrameNumber->u3.e1.PrototypePte)
+        {
+            /* Transition the PTE to invalid state */
+            MM::Paging::TransitionPte(PageFrameNumber->PteAddress,
+                                      MM::Paging::GetPteSoftwareProtection(&PageFrameNumber->OriginalPte));
+        }
+
+        /* Mark the page as being in a transition state */
+        PageFrameNumber->u3.e1.PageLocation = TransitionPage;
+
+        /* Check if there are still outstanding references */
+        if(PageFrameNumber->u3.e2.ReferenceCount == 1)
+        {
+            /* Check if the PTE is marked as being ready for removal */
+            if((ULONG_PTR)PageFrameNumber->PteAddress & 0x1)
+            {
+                /* Reset the reference count */
+                PageFrameNumber->u3.e2.ReferenceCount = 0;
+
+                /* Check the page's cache attribute */
+                if((PageFrameNumber->u3.e1.CacheAttribute != PfnCached) &&
+                   (PageFrameNumber->u3.e1.CacheAttribute != PfnNotMapped))
+                {
+                    /* Flush the TLB to prevent cache attribute conflicts from stale non-cached mappings */
+                    MM::Paging::FlushEntireTlb();
+                }
+
+                /* Mark the page as active and valid again */
+                PageFrameNumber->u3.e1.PageLocation = ActiveAndValid;
+
+                /* The page is no longer needed, free it by linking it to the free list */
+                MM::Pfn::LinkFreePage(PageFrameIndex);
+            }
+            else
+            {
+                /* The PTE can not be removed yet, decrement the reference count */
+                DecrementReferenceCount(PageFrameNumber, PageFrameIndex, BeginStandbyList);
+            }
+        }
+        else
+        {
+            /* There are still some outstanding references, decrement the reference count */
+            PageFrameNumber->u3.e2.ReferenceCount--;
+        }
+    }
+}
+
+/**
+ * Records a run of free physical pages whose PFN database initialization is deferred until application processors
+ * are up and can take part in it.
+ *
+ * @param BasePage
+ *        Supplies the first physical page of the run.
+ *
+ * @param PageCount
+ *        Supplies the number of pages in the run.
+ *
+ * @return This routine returns TRUE if the run has been deferred, or FALSE if it has to be initialized immediately.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::Pfn::DeferFreePages(IN PFN_NUMBER BasePage,
+                        IN PFN_NUMBER PageCount)
+{
+    PPHYSICAL_MEMORY_RUN LastRun;
+
+    /* Check if the run directly follows the previously deferred one */
+    LastRun = (DeferredRunCount != 0) ? &DeferredRuns[DeferredRunCount - 1] : NULLPTR;
+    if(LastRun && (LastRun->BasePage + LastRun->PageCount) == BasePage)
+    {
+        /* Remove the previous run from the chunk count and extend it */
+        DeferredChunkCount -= (LONG)((LastRun->PageCount + MM_DEFERRED_PFN_CHUNK_PAGES - 1) /
+                                     MM_DEFERRED_PFN_CHUNK_PAGES);
+        LastRun->PageCount += PageCount;
+    }
+    else
+    {
+        /* Check if there is room for another deferred run */
+        if(DeferredRunCount >= MM_MAXIMUM_DEFERRED_PFN_RUNS)
+        {
+            /* Too many runs, the pages must be initialized immediately */
+            return FALSE;
+        }
+
+        /* Record a new deferred run */
+        LastRun = &DeferredRuns[DeferredRunCount];
+        LastRun->BasePage = BasePage;
+        LastRun->PageCount = PageCount;
+        DeferredRunCount++;
+    }
+
+    /* Split the run into chunks processed independently by each processor */
+    DeferredChunkCount += (LONG)((LastRun->PageCount + MM_DEFERRED_PFN_CHUNK_PAGES - 1) /
+                                 MM_DEFERRED_PFN_CHUNK_PAGES);
+    DeferredPageCount += PageCount;
+
+    /* Return success */
+    return TRUE;
+}
+
+/**
+ * Returns all physical pages cached in the current processor's page magazine back to the free lists.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pfn::FlushPageMagazine(VOID)
+{
+    PMMPAGE_MAGAZINE Magazine;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the page magazine of the current processor */
+    Magazine = &KE::Processor::GetCurrentProcessorControlBlock()->PageMagazine;
+
+    /* Check if the magazine holds any pages */
+    if(Magazine->Count != 0)
+    {
+        /* Acquire the PFN database lock once for the whole batch */
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+        /* Return all cached pages back to the free lists */
+        while(Magazine->Count != 0)
+        {
+            /* Link the page to the free list */
+            Magazine->Count--;
+            LinkFreePage(Magazine->Pages[Magazine->Count]);
+        }
+    }
+}
+
+/**
+ * Frees a run of physically contiguous pages allocated by AllocateContiguousPages().
+ *
+ * @param BasePage
+ *        Supplies the first page frame number of the run.
+ *
+ * @param PageCount
+ *        Supplies the number of pages in the run.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The pages must not be mapped by any PTE. Freed pages are merged with their free buddies in the buddy index.
+ */
+XTAPI
+VOID
+MM::Pfn::FreeContiguousPages(IN PFN_NUMBER BasePage,
+                             IN PFN_NUMBER PageCount)
+{
+    PFN_NUMBER PageFrameIndex;
+    PMMPFN Pfn;
+
+    /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+    /* Iterate over each page in the run */
+    for(PageFrameIndex = BasePage; PageFrameIndex < BasePage + PageCount; PageFrameIndex++)
+    {
+        /* Reset the PFN entry to the state of a page unlinked from the free lists */
+        Pfn = GetPfnEntry(PageFrameIndex);
+        Pfn->u1.Flink = 0;
+        Pfn->u2.Blink = 0;
+        Pfn->PteAddress = NULLPTR;
+        Pfn->u3.e2.ReferenceCount = 0;
+
+        /* Check if the page belongs to the reserved region */
+        if(PageFrameIndex >= ContiguousReserveBase && PageFrameIndex < ContiguousReserveBase + ContiguousReservePages)
+        {
+            /* Return the page to the reserved region only */
+            Pfn->u3.e1.CacheAttribute = PfnNotMapped;
+            MM::Buddy::InsertPage(PageFrameIndex);
+        }
+        else
+        {
+            /* Link the page to the free lists, which records it in the buddy index as well */
+            LinkFreePage(PageFrameIndex);
+        }
+    }
+}
+
+/**
+ * Returns an unmapped physical page to the current processor's page magazine, flushing a batch when it is full.
+ *
+ * @param PageFrameIndex
+ *        Supplies the page frame number of the page to free. The page must not be mapped by any PTE.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pfn::FreeMagazinePage(IN PFN_NUMBER PageFrameIndex)
+{
+    PMMPAGE_MAGAZINE Magazine;
+    ULONG Node;
+    PMMPFN Pfn;
+
+    /* Get the PFN database entry for the page */
+    Pfn = GetPfnEntry(PageFrameIndex);
+
+    /* Reset the PFN entry to the state of a page unlinked from the free lists */
+    Pfn->u1.Flink = 0;
+    Pfn->u2.Blink = 0;
+    Pfn->PteAddress = NULLPTR;
+    Pfn->u3.e2.ReferenceCount = 0;
+
+    /* Check if the page needs special handling or the system is running low on memory */
+    if(Pfn->u3.e1.Rom || Pfn->u3.e1.RemovalRequested ||
+       (Pfn->u3.e1.CacheAttribute != PfnCached && Pfn->u3.e1.CacheAttribute != PfnNotMapped) ||
+       AvailablePages < MM_PAGE_MAGAZINE_LOW_MEMORY_PAGES)
+    {
+        /* Return all cached pages back to the free lists */
+        FlushPageMagazine();
+
+        /* Check the page's cache attribute */
+        if((Pfn->u3.e1.CacheAttribute != PfnCached) &&
+           (Pfn->u3.e1.CacheAttribute != PfnNotMapped))
+        {
+            /* Flush the TLB to prevent cache attribute conflicts from stale non-cached mappings */
+            MM::Paging::FlushEntireTlb();
+        }
+
+        /* Acquire the PFN database lock and link the page directly to the free list */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+        LinkFreePage(PageFrameIndex);
+        return;
+    }
+
+    /* Clear the page flags, but preserve the NUMA node stored in the page color field */
+    Node = Pfn->u3.e1.PageColor;
+    Pfn->u3.e2.ShortFlags = 0;
+    Pfn->u3.e1.CacheAttribute = PfnNotMapped;
+    Pfn->u3.e1.PageColor = Node;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Check if the page belongs to a remote NUMA node */
+    if(Node != MM::Numa::GetCurrentNode())
+    {
+        /* Do not cache remote pages, return the page directly to its node's free list instead */
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+        LinkFreePage(PageFrameIndex);
+        return;
+    }
+
+    /* Get the page magazine of the current processor */
+    Magazine = &KE::Processor::GetCurrentProcessorControlBlock()->PageMagazine;
 
-    /* Check if the share count has dropped to zero */
-    if(!PageFrameNumber->u2.ShareCount)
+    /* Check if the magazine is full */
+    if(Magazine->Count == MM_PAGE_MAGAZINE_SIZE)
     {
-        /* Check if this is a prototype PTE */
-        if(PageFrameNumber->u3.e1.PrototypePte)
+        /* Acquire the PFN database lock once for the whole batch */
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+        /* Return a batch of the least recently cached pages back to the free lists */
+        while(Magazine->Count > MM_PAGE_MAGAZINE_SIZE - MM_PAGE_MAGAZINE_BATCH)
         {
-            /* Transition the PTE to invalid state */
-            MM::Paging::TransitionPte(PageFrameNumber->PteAddress,
-                                      MM::Paging::GetPteSoftwareProtection(&PageFrameNumber->OriginalPte));
+            /* Link the page to the free list */
+            Magazine->Count--;
+            LinkFreePage(Magazine->Pages[Magazine->Count]);
         }
+    }
 
-        /* Mark the page as being in a transition state */
-        PageFrameNumber->u3.e1.PageLocation = TransitionPage;
+    /* Cache the page in the magazine */
+    Magazine->Pages[Magazine->Count] = PageFrameIndex;
+    Magazine->Count++;
+}
 
-        /* Check if there are still outstanding references */
-        if(PageFrameNumber->u3.e2.ReferenceCount == 1)
-        {
-            /* Check if the PTE is marked as being ready for removal */
-            if((ULONG_PTR)PageFrameNumber->PteAddress & 0x1)
-            {
-                /* Reset the reference count */
-                PageFrameNumber->u3.e2.ReferenceCount = 0;
+/**
+ * Unmaps a run of system PTEs mapped by AllocateMappedPages() and returns their physical pages.
+ *
+ * @param StartPte
+ *        Supplies a pointer to the first PTE of the run.
+ *
+ * @param Pages
+ *        Supplies the number of pages to unmap and free.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Translations of each batch are shot down on all processors before its pages are returned to the page
+ *       magazine of the current processor, so the PFN lock must not be held by the caller.
+ */
+XTAPI
+VOID
+MM::Pfn::FreeMappedPages(IN PMMPTE StartPte,
+                         IN PFN_COUNT Pages)
+{
+    PFN_NUMBER PageFrames[MM_PAGE_BULK_ALLOCATION_SIZE];
+    PFN_COUNT BatchPages, Index, Page;
+    PMMPTE PointerPte;
 
-                /* Check the page's cache attribute */
-                if((PageFrameNumber->u3.e1.CacheAttribute != PfnCached) &&
-                   (PageFrameNumber->u3.e1.CacheAttribute != PfnNotMapped))
-                {
-                    /* Flush the TLB to prevent cache attribute conflicts from stale non-cached mappings */
-                    MM::Paging::FlushEntireTlb();
-                }
+    /* Unmap the run in batches */
+    PointerPte = StartPte;
+    for(Index = 0; Index < Pages; Index += BatchPages)
+    {
+        /* Unmap a batch of pages, saving their page frame numbers */
+        BatchPages = MIN(Pages - Index, MM_PAGE_BULK_ALLOCATION_SIZE);
+        MM::Paging::UnmapPtes(PointerPte, BatchPages, PageFrames);
 
-                /* Mark the page as active and valid again */
-                PageFrameNumber->u3.e1.PageLocation = ActiveAndValid;
+        /* Shoot down stale translations of the batch before any of its pages can be reused */
+        MM::Tlb::FlushRange(MM::Paging::GetPteVirtualAddress(PointerPte), BatchPages);
+        PointerPte = MM::Paging::AdvancePte(PointerPte, BatchPages);
 
-                /* The page is no longer needed, free it by linking it to the free list */
-                MM::Pfn::LinkFreePage(PageFrameIndex);
-            }
-            else
-            {
-                /* The PTE can not be removed yet, decrement the reference count */
-                DecrementReferenceCount(PageFrameNumber, PageFrameIndex, BeginStandbyList);
-            }
-        }
-        else
+        /* Return the unmapped pages to the per-processor page magazine */
+        for(Page = 0; Page < BatchPages; Page++)
         {
-            /* There are still some outstanding references, decrement the reference count */
-            PageFrameNumber->u3.e2.ReferenceCount--;
+            /* Free the page */
+            FreeMagazinePage(PageFrames[Page]);
         }
     }
 }
@@ -350,8 +1216,8 @@ MM::Pfn::FreePhysicalPage(IN PMMPTE PointerPte)
     /* Decrement the share count of the page table */
     MM::Pfn::DecrementShareCount(PageTableFrame, PageTableFrameNumber, FALSE);
 
-    /* Mark the PTE as being ready for removal */
-    MM::Paging::SetPte(PageFrame->PteAddress, MM::Paging::GetPte(PageFrame->PteAddress) | 1);
+    /* Mark the PTE address as being ready for removal, so that the page is returned to the free lists */
+    PageFrame->PteAddress = (PMMPTE)((ULONG_PTR)PageFrame->PteAddress | 1);
 
     /* Decrement the share count of the page */
     MM::Pfn::DecrementShareCount(PageFrame, PageFrameNumber, FALSE);
@@ -454,6 +1320,238 @@ MM::Pfn::IncrementAvailablePages(VOID)
     AvailablePages++;
 }
 
+/**
+ * Initializes the PFN database entries for the physical pages consumed by the bootstrap allocator.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pfn::InitializeBootstrapPagePfns(VOID)
+{
+    PFN_NUMBER PaddingEnd;
+
+    /* Check if any pages skipped by aligned allocations were left unused */
+    if(BootstrapPaddingDescriptor.PageCount == 0)
+    {
+        /* Initialize PFNs for the physical pages backing the PFN database */
+        ProcessMemoryDescriptor(OriginalFreeDescriptor.BasePage,
+                                FreeDescriptor->BasePage - OriginalFreeDescriptor.BasePage,
+                                LoaderMemoryData);
+        return;
+    }
+
+    /* Calculate the end of the unused padding block */
+    PaddingEnd = BootstrapPaddingDescriptor.BasePage + BootstrapPaddingDescriptor.PageCount;
+
+    /* Initialize PFNs for the physical pages backing the PFN database, preceding the padding block */
+    ProcessMemoryDescriptor(OriginalFreeDescriptor.BasePage,
+                            BootstrapPaddingDescriptor.BasePage - OriginalFreeDescriptor.BasePage,
+                            LoaderMemoryData);
+
+    /* Return the unused padding pages to the free memory */
+    ProcessMemoryDescriptor(BootstrapPaddingDescriptor.BasePage, BootstrapPaddingDescriptor.PageCount, LoaderFree);
+
+    /* Initialize PFNs for the physical pages backing the PFN database, following the padding block */
+    ProcessMemoryDescriptor(PaddingEnd, FreeDescriptor->BasePage - PaddingEnd, LoaderMemoryData);
+
+    /* The padding pages are now owned by the PFN database */
+    BootstrapPaddingDescriptor.PageCount = 0;
+}
+
+/**
+ * Builds the buddy index of free page blocks and sets aside the region reserved for physically contiguous
+ * allocations, if requested with the CONTIGMEM kernel parameter (in megabytes).
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Pages of the reserved region are kept off the free lists, so that they are never used by the ordinary page
+ *       allocations, but they stay free in the buddy index.
+ */
+XTAPI
+VOID
+MM::Pfn::InitializeContiguousMemory(VOID)
+{
+    PFN_NUMBER PageFrameIndex, ReservePages;
+    ULONG Megabytes, PagingColorsMask;
+    WCHAR ParameterValue[16];
+
+    /* Allocate the buddy index */
+    MM::Buddy::InitializeBuddyIndex();
+
+    /* Do not reserve any memory by default */
+    Megabytes = 0;
+
+    /* Check if user requested a region reserved for physically contiguous allocations */
+    if(KE::BootInformation::GetKernelParameterValue(L"CONTIGMEM", ParameterValue, 16) == STATUS_SUCCESS)
+    {
+        /* Convert string value to number */
+        if(RTL::WideString::WideStringToNumber(ParameterValue, 0, &Megabytes) != STATUS_SUCCESS)
+        {
+            /* Invalid value, do not reserve any memory */
+            Megabytes = 0;
+        }
+    }
+
+    /* Never reserve more than a half of the physical memory */
+    ReservePages = MIN((PFN_NUMBER)Megabytes << (20 - MM_PAGE_SHIFT), (PFN_NUMBER)(NumberOfPhysicalPages / 2));
+
+    /* Retrieve the bitmask used for calculating a page's color */
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+
+    /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+    /* Record all pages linked to the free list in the buddy index */
+    for(PageFrameIndex = FreePagesList.Flink; PageFrameIndex != MAXULONG_PTR;
+        PageFrameIndex = GetPfnEntry(PageFrameIndex)->u1.Flink)
+    {
+        /* Mark the page as free */
+        MM::Buddy::InsertPage(PageFrameIndex);
+    }
+
+    /* Record all pages linked to the zeroed list in the buddy index */
+    for(PageFrameIndex = ZeroedPagesList.Flink; PageFrameIndex != MAXULONG_PTR;
+        PageFrameIndex = GetPfnEntry(PageFrameIndex)->u1.Flink)
+    {
+        /* Mark the page as free */
+        MM::Buddy::InsertPage(PageFrameIndex);
+    }
+
+    /* Check if any memory should be reserved */
+    if(ReservePages == 0)
+    {
+        /* Nothing more to do */
+        return;
+    }
+
+    /* Find a free block big enough to hold the reserved region */
+    if(!MM::Buddy::FindFreeBlock(MM::Buddy::GetBlockOrder(ReservePages, 1),
+                                 MM_CONTIGUOUS_RESERVE_HIGHEST_PAGE,
+                                 &ContiguousReserveBase))
+    {
+        /* Not enough contiguous memory, continue without the reserved region */
+        DebugPrint(L"Unable to reserve %lu MB of physically contiguous memory\n", Megabytes);
+        ContiguousReserveBase = 0;
+        return;
+    }
+
+    /* Take the pages of the reserved region off the free lists */
+    for(PageFrameIndex = ContiguousReserveBase; PageFrameIndex < ContiguousReserveBase + ReservePages; PageFrameIndex++)
+    {
+        /* Unlink the page from the free lists, but keep it free in the buddy index */
+        UnlinkFreePage(PageFrameIndex, PageFrameIndex & PagingColorsMask);
+        MM::Buddy::InsertPage(PageFrameIndex);
+    }
+
+    /* Publish the reserved region */
+    ContiguousReservePages = ReservePages;
+    DebugPrint(L"Reserved %llu pages of physically contiguous memory at PFN 0x%llX\n",
+               (ULONGLONG)ReservePages, (ULONGLONG)ContiguousReserveBase);
+}
+
+/**
+ * Initializes the PFN database entries of free physical memory deferred at boot time. This routine is executed by
+ * the bootstrap processor and every application processor, each claiming chunks of the deferred runs until none are
+ * left, so that the work scales with the number of processors rather than with the amount of installed memory.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pfn::InitializeDeferredPages(VOID)
+{
+    PFN_NUMBER BasePage, ChunkPages, PageCount;
+    PMMCOLOR_TABLES LocalTables;
+    LONG Chunk, RunChunks;
+    XTSTATUS Status;
+    ULONG Index;
+
+    /* Check if there is any deferred work left */
+    if(NextDeferredChunk >= DeferredChunkCount)
+    {
+        /* Nothing to do */
+        return;
+    }
+
+    /* Allocate local colored free lists, falling back to linking pages one by one on failure */
+    Status = MM::Allocator::AllocatePool(NonPagedPool,
+                                         MM::Colors::GetPagingColors() * sizeof(MMCOLOR_TABLES),
+                                         (PVOID *)&LocalTables,
+                                         SIGNATURE32('M', 'M', 'p', 'f'));
+    if(Status != STATUS_SUCCESS)
+    {
+        /* Allocation failed, use the slow path */
+        LocalTables = NULLPTR;
+    }
+
+    /* Keep claiming chunks until all of them are taken */
+    while(TRUE)
+    {
+        /* Claim the next chunk */
+        Chunk = RTL::Atomic::Increment32(&NextDeferredChunk) - 1;
+        if(Chunk >= DeferredChunkCount)
+        {
+            /* All chunks have been claimed */
+            break;
+        }
+
+        /* Check if this is the very first chunk */
+        if(Chunk == 0)
+        {
+            /* Record the time stamp counter value at the start of the deferred initialization */
+            DeferredStartCycles = AR::CpuFunctions::ReadTimeStampCounter();
+        }
+
+        /* Find the deferred run the chunk belongs to */
+        for(Index = 0; Index < DeferredRunCount; Index++)
+        {
+            /* Get the number of chunks in this run */
+            RunChunks = (LONG)((DeferredRuns[Index].PageCount + MM_DEFERRED_PFN_CHUNK_PAGES - 1) /
+                               MM_DEFERRED_PFN_CHUNK_PAGES);
+            if(Chunk < RunChunks)
+            {
+                /* Chunk found */
+                break;
+            }
+
+            /* Move to the next run */
+            Chunk -= RunChunks;
+        }
+
+        /* Calculate the first page and the number of pages of the chunk */
+        BasePage = DeferredRuns[Index].BasePage + ((PFN_NUMBER)Chunk * MM_DEFERRED_PFN_CHUNK_PAGES);
+        PageCount = DeferredRuns[Index].BasePage + DeferredRuns[Index].PageCount - BasePage;
+        ChunkPages = (PageCount > MM_DEFERRED_PFN_CHUNK_PAGES) ? MM_DEFERRED_PFN_CHUNK_PAGES : PageCount;
+
+        /* Initialize the chunk and splice it into the global free lists */
+        LinkFreePageRun(BasePage, ChunkPages, LocalTables);
+
+        /* Check if this was the last chunk to complete */
+        if(RTL::Atomic::Increment32(&CompletedDeferredChunks) == DeferredChunkCount)
+        {
+            /* Report the time taken by the deferred initialization */
+            DebugPrint(L"Initialized %llu deferred PFN database pages in %llu cycles\n",
+                       (ULONGLONG)DeferredPageCount,
+                       AR::CpuFunctions::ReadTimeStampCounter() - DeferredStartCycles);
+        }
+    }
+
+    /* Check if local colored free lists were allocated */
+    if(LocalTables)
+    {
+        /* Release local colored free lists */
+        MM::Allocator::FreePool(LocalTables);
+    }
+}
+
 /**
  * Initializes the PFN bitmap to track available physical memory.
  *
@@ -522,7 +1620,7 @@ XTAPI
 VOID
 MM::Pfn::LinkFreePage(IN PFN_NUMBER PageFrameIndex)
 {
-    ULONG Color;
+    ULONG Color, Node;
     PMMPFNLIST ListHead;
     PFN_NUMBER LastPage;
     PMMPFN ColoredPfn, PfnEntry;
@@ -585,9 +1683,13 @@ MM::Pfn::LinkFreePage(IN PFN_NUMBER PageFrameIndex)
     PfnEntry->u4.InPageError = 0;
     PfnEntry->u4.Priority = 3;
 
-    /* Insert the page into the colored free list */
+    /* Record the NUMA node owning the page in its page color field */
+    Node = MM::Numa::GetPageNode(PageFrameIndex);
+    PfnEntry->u3.e1.PageColor = Node;
+
+    /* Insert the page into the colored free list of its node */
     Color = PageFrameIndex & MM::Colors::GetPagingColorsMask();
-    ColorTable = MM::Colors::GetFreePages(FreePageList, Color);
+    ColorTable = MM::Colors::GetFreePages(FreePageList, Node, Color);
 
     /* Get the memory layout */
     MemoryLayout = MM::Manager::GetMemoryLayout();
@@ -601,24 +1703,241 @@ MM::Pfn::LinkFreePage(IN PFN_NUMBER PageFrameIndex)
     }
     else
     {
-        /* Get the current last page on the colored list */
-        ColoredPfn = (PMMPFN)ColorTable->Blink;
+        /* Get the current last page on the colored list */
+        ColoredPfn = (PMMPFN)ColorTable->Blink;
+
+        /* Link with the previous last page */
+        MM::Paging::SetPte(&ColoredPfn->OriginalPte, PageFrameIndex);
+        PfnEntry->u4.PteFrame = ColoredPfn - (PMMPFN)MemoryLayout->PfnDatabase;
+    }
+
+    /* Set the page as the new tail of the colored list */
+    ColorTable->Blink = PfnEntry;
+    ColorTable->Count++;
+    MM::Paging::SetPte(&PfnEntry->OriginalPte, MAXULONG_PTR);
+
+    /* Record the page in the buddy index of free page blocks */
+    MM::Buddy::InsertPage(PageFrameIndex);
+    MM::Statistics::IncrementCounter(FreePageFrees);
+
+    /* Increment number of available pages */
+    IncrementAvailablePages();
+}
+
+
+/**
+ * Links a run of free physical pages belonging to a single chunk of the deferred PFN database. The pages are first
+ * chained into local colored free lists without holding any lock, which are then spliced into the global lists
+ * under a single PFN lock acquisition.
+ *
+ * @param BasePage
+ *        Supplies the first physical page of the run.
+ *
+ * @param PageCount
+ *        Supplies the number of pages in the run.
+ *
+ * @param LocalTables
+ *        Supplies a pointer to the local colored free lists, or NULLPTR to link pages one by one.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pfn::LinkFreePageRun(IN PFN_NUMBER BasePage,
+                         IN PFN_NUMBER PageCount,
+                         IN PMMCOLOR_TABLES LocalTables)
+{
+    PFN_NUMBER FirstPage, LastPage, LinkedPages, PageFrameIndex;
+    ULONG Color, Node, PagingColors, PagingColorsMask;
+    PMMCOLOR_TABLES ColorTable;
+    PMMMEMORY_LAYOUT MemoryLayout;
+    PMMPFN ColoredPfn, PfnEntry;
+
+    /* Check if local colored free lists are available */
+    if(!LocalTables)
+    {
+        /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+        KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+        /* Link the pages one by one */
+        for(PageFrameIndex = BasePage; PageFrameIndex < BasePage + PageCount; PageFrameIndex++)
+        {
+            /* Make sure the page is not referenced */
+            if(GetPfnEntry(PageFrameIndex)->u3.e2.ReferenceCount == 0)
+            {
+                /* Add the page to the free lists */
+                LinkFreePage(PageFrameIndex);
+            }
+        }
+
+        /* Nothing more to do */
+        return;
+    }
+
+    /* Get the memory layout, paging colors and the NUMA node the run belongs to */
+    MemoryLayout = MM::Manager::GetMemoryLayout();
+    PagingColors = MM::Colors::GetPagingColors();
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+    Node = MM::Numa::GetPageNode(BasePage);
+
+    /* Initialize the local colored free lists */
+    for(Color = 0; Color < PagingColors; Color++)
+    {
+        /* Mark the list as empty */
+        LocalTables[Color].Flink = MAXULONG_PTR;
+        LocalTables[Color].Blink = NULLPTR;
+        LocalTables[Color].Count = 0;
+    }
+
+    /* Initialize the local free list */
+    FirstPage = MAXULONG_PTR;
+    LastPage = MAXULONG_PTR;
+    LinkedPages = 0;
+
+    /* Iterate over each page in the run */
+    for(PageFrameIndex = BasePage; PageFrameIndex < BasePage + PageCount; PageFrameIndex++)
+    {
+        /* Get the PFN entry for the current page and ensure it is not referenced */
+        PfnEntry = GetPfnEntry(PageFrameIndex);
+        if(PfnEntry->u3.e2.ReferenceCount != 0)
+        {
+            /* Page is in use, skip it */
+            continue;
+        }
+
+        /* Check if the page belongs to a different NUMA node than the run */
+        if(MM::Numa::GetPageNode(PageFrameIndex) != Node)
+        {
+            /* Link the page directly to the global free lists of its own node */
+            KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+            KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+            LinkFreePage(PageFrameIndex);
+            continue;
+        }
+
+        /* Append the page to the local free list */
+        if(LastPage != MAXULONG_PTR)
+        {
+            /* Link with the previous last page */
+            GetPfnEntry(LastPage)->u1.Flink = PageFrameIndex;
+        }
+        else
+        {
+            /* Put the page as the first entry */
+            FirstPage = PageFrameIndex;
+        }
+
+        /* Set the page as the new tail of the local free list */
+        PfnEntry->u1.Flink = MAXULONG_PTR;
+        PfnEntry->u2.Blink = LastPage;
+        PfnEntry->u3.e1.CacheAttribute = PfnNotMapped;
+        PfnEntry->u3.e1.PageColor = Node;
+        PfnEntry->u3.e1.PageLocation = FreePageList;
+        PfnEntry->u4.AweAllocation = 0;
+        PfnEntry->u4.InPageError = 0;
+        PfnEntry->u4.Priority = 3;
+        LastPage = PageFrameIndex;
+        LinkedPages++;
+
+        /* Get the local colored free list for the page */
+        ColorTable = &LocalTables[PageFrameIndex & PagingColorsMask];
+
+        /* Check if the local colored list is empty */
+        if(ColorTable->Flink == MAXULONG_PTR)
+        {
+            /* Put the page as the first entry */
+            ColorTable->Flink = PageFrameIndex;
+            PfnEntry->u4.PteFrame = MM_PFN_PTE_FRAME;
+        }
+        else
+        {
+            /* Link with the previous last page */
+            ColoredPfn = (PMMPFN)ColorTable->Blink;
+            MM::Paging::SetPte(&ColoredPfn->OriginalPte, PageFrameIndex);
+            PfnEntry->u4.PteFrame = ColoredPfn - (PMMPFN)MemoryLayout->PfnDatabase;
+        }
+
+        /* Set the page as the new tail of the local colored list */
+        ColorTable->Blink = PfnEntry;
+        ColorTable->Count++;
+        MM::Paging::SetPte(&PfnEntry->OriginalPte, MAXULONG_PTR);
+    }
+
+    /* Check if any pages were linked to the local lists */
+    if(LinkedPages == 0)
+    {
+        /* Nothing to splice */
+        return;
+    }
+
+    /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+    /* Splice the local free list at the tail of the global free list */
+    if(FreePagesList.Blink != MAXULONG_PTR)
+    {
+        /* Link the global tail with the local head */
+        GetPfnEntry(FreePagesList.Blink)->u1.Flink = FirstPage;
+        GetPfnEntry(FirstPage)->u2.Blink = FreePagesList.Blink;
+    }
+    else
+    {
+        /* The global list is empty, the local head becomes its first entry */
+        FreePagesList.Flink = FirstPage;
+    }
+
+    /* Set the local tail as the new tail of the global free list */
+    FreePagesList.Blink = LastPage;
+    FreePagesList.Total += LinkedPages;
+
+    /* Splice every non-empty local colored list into the colored free list of the node */
+    for(Color = 0; Color < PagingColors; Color++)
+    {
+        /* Skip empty local colored lists */
+        if(LocalTables[Color].Count == 0)
+        {
+            /* Nothing to splice for this color */
+            continue;
+        }
 
-        /* Link with the previous last page */
-        MM::Paging::SetPte(&ColoredPfn->OriginalPte, PageFrameIndex);
-        PfnEntry->u4.PteFrame = ColoredPfn - (PMMPFN)MemoryLayout->PfnDatabase;
+        /* Get the global colored free list */
+        ColorTable = MM::Colors::GetFreePages(FreePageList, Node, Color);
+
+        /* Check if the global colored list is empty */
+        if(ColorTable->Flink == MAXULONG_PTR)
+        {
+            /* The local head becomes the first entry */
+            ColorTable->Flink = LocalTables[Color].Flink;
+        }
+        else
+        {
+            /* Link the global tail with the local head */
+            ColoredPfn = (PMMPFN)ColorTable->Blink;
+            MM::Paging::SetPte(&ColoredPfn->OriginalPte, LocalTables[Color].Flink);
+            GetPfnEntry(LocalTables[Color].Flink)->u4.PteFrame = ColoredPfn - (PMMPFN)MemoryLayout->PfnDatabase;
+        }
+
+        /* Set the local tail as the new tail of the global colored list */
+        ColorTable->Blink = LocalTables[Color].Blink;
+        ColorTable->Count += LocalTables[Color].Count;
     }
 
-    /* Set the page as the new tail of the colored list */
-    ColorTable->Blink = PfnEntry;
-    ColorTable->Count++;
-    MM::Paging::SetPte(&PfnEntry->OriginalPte, MAXULONG_PTR);
+    /* Record the spliced pages, which form the tail of the global free list, in the buddy index */
+    for(PageFrameIndex = FirstPage; PageFrameIndex != MAXULONG_PTR;
+        PageFrameIndex = GetPfnEntry(PageFrameIndex)->u1.Flink)
+    {
+        /* Mark the page as free */
+        MM::Buddy::InsertPage(PageFrameIndex);
+    }
 
-    /* Increment number of available pages */
-    IncrementAvailablePages();
+    /* Make the spliced pages available for allocation */
+    AvailablePages += LinkedPages;
 }
 
-
 /**
  * Links a physical page to the appropriate list.
  *
@@ -698,7 +2017,7 @@ MM::Pfn::LinkPage(IN PMMPFNLIST ListHead,
     if(ListHead == &ModifiedPagesList)
     {
         /* Select the modified list matching the page color */
-        ListHead = MM::Colors::GetModifiedPages(PageFrame->u3.e1.PageColor);
+        ListHead = MM::Colors::GetModifiedPages(PageFrameIndex & MM::Colors::GetPagingColorsMask());
         ListHead->Total++;
     }
     else if((PageFrame->u3.e1.RemovalRequested == 1) && (ListName <= StandbyPageList))
@@ -769,14 +2088,23 @@ MM::Pfn::LinkPage(IN PMMPFNLIST ListHead,
     /* Record the page's current location */
     PageFrame->u3.e1.PageLocation = ListName;
 
+    /* Account the free against the target list, if it is one of the allocatable lists */
+    if(ListName <= ModifiedPageList)
+    {
+        /* Increment the list free counter */
+        MM::Statistics::IncrementCounter((MMPERFORMANCE_COUNTER)(ZeroedPageFrees + ListName));
+    }
+
     /* Handle pages that contribute to the available page count */
     if(ListName <= StandbyPageList)
     {
         /* Increment the system-wide available page counter */
         MM::Pfn::IncrementAvailablePages();
 
-        /* Select the free list matching the page color */
-        ColorHead = MM::Colors::GetFreePages(ZeroedPageList, PageFrameIndex & MM::Colors::GetPagingColorsMask());
+        /* Record the NUMA node owning the page and select the free list matching its node and color */
+        PageFrame->u3.e1.PageColor = MM::Numa::GetPageNode(PageFrameIndex);
+        ColorHead = MM::Colors::GetFreePages(ZeroedPageList, PageFrame->u3.e1.PageColor,
+                                             PageFrameIndex & MM::Colors::GetPagingColorsMask());
 
         /* Store the color list linkage in the original PTE */
         MM::Paging::SetPte(&PageFrame->OriginalPte, ColorHead->Flink);
@@ -869,7 +2197,7 @@ MM::Pfn::LinkPfn(IN PFN_NUMBER PageFrameIndex,
     if(!MM::Paging::PteValid(Pte))
     {
         /* Check if page table is resident */
-        Status = MM::PageFault::CheckPdeForPagedPool(PointerPte);
+        Status = MM::PageFault::CheckPdeForPagedPool(MM::Paging::GetPteVirtualAddress(PointerPte));
         if(Status != STATUS_SUCCESS)
         {
             /* Could not make the page table resident, crash system */
@@ -1074,6 +2402,86 @@ MM::Pfn::LinkStandbyPage(IN PFN_NUMBER PageFrameIndex)
 
     /* Update the page's location to the standby list */
     CurrentPageFrame->u3.e1.PageLocation = StandbyPageList;
+    MM::Statistics::IncrementCounter(StandbyPageFrees);
+
+    /* Increment number of available pages */
+    IncrementAvailablePages();
+}
+
+/**
+ * Links a physical page, which has just been filled with zeroes, to the zeroed page lists.
+ *
+ * @param PageFrameIndex
+ *        The Page Frame Number (PFN) of the page to link.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the PFN database lock.
+ */
+XTAPI
+VOID
+MM::Pfn::LinkZeroedPage(IN PFN_NUMBER PageFrameIndex)
+{
+    PMMCOLOR_TABLES ColorTable;
+    PMMPFN ColoredPfn, PfnEntry;
+    PFN_NUMBER LastPage;
+
+    /* Get the PFN database entry for the page */
+    PfnEntry = GetPfnEntry(PageFrameIndex);
+
+    /* Get the current last page on the global zeroed list */
+    ZeroedPagesList.Total++;
+    LastPage = ZeroedPagesList.Blink;
+
+    /* Check if the list is not empty */
+    if(LastPage != MAXULONG_PTR)
+    {
+        /* Link with the previous last page */
+        GetPfnEntry(LastPage)->u1.Flink = PageFrameIndex;
+    }
+    else
+    {
+        /* Put the page as the first entry */
+        ZeroedPagesList.Flink = PageFrameIndex;
+    }
+
+    /* Set the page as the new tail of the list */
+    ZeroedPagesList.Blink = PageFrameIndex;
+    PfnEntry->u1.Flink = MAXULONG_PTR;
+    PfnEntry->u2.Blink = LastPage;
+    PfnEntry->u3.e1.CacheAttribute = PfnNotMapped;
+    PfnEntry->u3.e1.PageLocation = ZeroedPageList;
+
+    /* Record the NUMA node owning the page and get the colored zeroed list matching its node and color */
+    PfnEntry->u3.e1.PageColor = MM::Numa::GetPageNode(PageFrameIndex);
+    ColorTable = MM::Colors::GetFreePages(ZeroedPageList, PfnEntry->u3.e1.PageColor,
+                                          PageFrameIndex & MM::Colors::GetPagingColorsMask());
+
+    /* Check if the colored list is empty */
+    if(ColorTable->Flink == MAXULONG_PTR)
+    {
+        /* Put the page as the first entry */
+        ColorTable->Flink = PageFrameIndex;
+        PfnEntry->u4.PteFrame = MM_PFN_PTE_FRAME;
+    }
+    else
+    {
+        /* Link with the previous last page on the colored list */
+        ColoredPfn = (PMMPFN)ColorTable->Blink;
+        MM::Paging::SetPte(&ColoredPfn->OriginalPte, PageFrameIndex);
+        PfnEntry->u4.PteFrame = ColoredPfn - (PMMPFN)MM::Manager::GetMemoryLayout()->PfnDatabase;
+    }
+
+    /* Set the page as the new tail of the colored list */
+    ColorTable->Blink = PfnEntry;
+    ColorTable->Count++;
+    MM::Paging::SetPte(&PfnEntry->OriginalPte, MAXULONG_PTR);
+
+    /* Record the page in the buddy index of free page blocks */
+    MM::Buddy::InsertPage(PageFrameIndex);
+    MM::Statistics::IncrementCounter(ZeroedPageFrees);
 
     /* Increment number of available pages */
     IncrementAvailablePages();
@@ -1102,13 +2510,27 @@ MM::Pfn::ProcessMemoryDescriptor(IN PFN_NUMBER BasePage,
                                  IN LOADER_MEMORY_TYPE MemoryType)
 {
     PVOID VirtualAddress, VirtualRangeStart, VirtualRangeEnd;
-    PFN_NUMBER PageNumber;
+    PFN_NUMBER DeferredBase, PageNumber;
     PMMPDE PointerPde;
     PMMPFN Pfn;
 
     /* Check if the memory descriptor describes a free memory region */
     if(MM::Manager::VerifyMemoryTypeFree(MemoryType))
     {
+        /* Check if initialization of high memory is deferred and the run reaches into it */
+        if(DeferHighMemory && (BasePage + PageCount) > MM_DEFERRED_PFN_BASE_PAGE)
+        {
+            /* Calculate the first page to defer */
+            DeferredBase = (BasePage > MM_DEFERRED_PFN_BASE_PAGE) ? BasePage : MM_DEFERRED_PFN_BASE_PAGE;
+
+            /* Defer the high part of the run, initializing only the pages below it now */
+            if(DeferFreePages(DeferredBase, (BasePage + PageCount) - DeferredBase))
+            {
+                /* Trim the run to the pages below the deferred base */
+                PageCount = DeferredBase - BasePage;
+            }
+        }
+
         /* Iterate over each page in this free memory run */
         for(PageNumber = 0; PageNumber < PageCount; PageNumber++)
         {
@@ -1206,6 +2628,82 @@ MM::Pfn::ProcessMemoryDescriptor(IN PFN_NUMBER BasePage,
     }
 }
 
+/**
+ * Takes a census of the PFN lists, counting the pages linked to each of them.
+ *
+ * @param ListPages
+ *        Supplies a pointer to an array, indexed by the page list, that receives the number of pages on every list
+ *        up to the bad page list.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Pages cached in the per-processor page magazines are not linked to any list, thus are not counted.
+ */
+XTAPI
+VOID
+MM::Pfn::QueryPageLists(OUT PPFN_NUMBER ListPages)
+{
+    ULONG Index;
+
+    /* Acquire the PFN database lock and raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::QueuedSpinLockGuard SpinLock(PfnLock);
+
+    /* Iterate through all page lists */
+    for(Index = ZeroedPageList; Index <= BadPageList; Index++)
+    {
+        /* Store the number of pages on the list */
+        ListPages[Index] = PageLocationList[Index]->Total;
+    }
+}
+
+/**
+ * Refills a page magazine with a batch of consecutively colored pages under a single PFN lock acquisition.
+ *
+ * @param Magazine
+ *        Supplies a pointer to the page magazine to refill.
+ *
+ * @param Color
+ *        Specifies the color of the first page to take.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pfn::RefillPageMagazine(IN PMMPAGE_MAGAZINE Magazine,
+                            IN ULONG Color)
+{
+    PFN_NUMBER PageFrameIndex;
+    ULONG PagingColorsMask;
+
+    /* Retrieve the bitmask used for calculating a page's color */
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+
+    /* Acquire the PFN database lock once for the whole batch */
+    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+    /* Take a batch of pages, walking the colors in the same order as consecutive allocations do */
+    while(Magazine->Count < MM_PAGE_MAGAZINE_BATCH)
+    {
+        /* Allocate a physical page of the next color */
+        PageFrameIndex = AllocatePhysicalPage(Color & PagingColorsMask);
+        if(PageFrameIndex == 0)
+        {
+            /* No more pages available */
+            break;
+        }
+
+        /* Store the page in the magazine and advance to the next color */
+        Magazine->Pages[Magazine->Count] = PageFrameIndex;
+        Magazine->Count++;
+        Color++;
+    }
+}
+
 /**
  * Scans memory descriptors provided by the boot loader.
  *
@@ -1219,6 +2717,7 @@ MM::Pfn::ScanMemoryDescriptors(VOID)
 {
     PLIST_ENTRY LoaderMemoryDescriptors, MemoryMappings;
     PLOADER_MEMORY_DESCRIPTOR MemoryDescriptor;
+    PCWSTR KernelParameter;
     PFN_NUMBER FreePages;
 
     /* Initialize the highest and lowest physical page numbers */
@@ -1228,6 +2727,9 @@ MM::Pfn::ScanMemoryDescriptors(VOID)
     /* Initially, set number of free pages to 0 */
     FreePages = 0;
 
+    /* Check if initialization of high memory should be deferred until application processors are up */
+    DeferHighMemory = (KE::BootInformation::GetKernelParameter(L"DEFERPFN", &KernelParameter) == STATUS_SUCCESS);
+
     /* Get the list head of memory descriptors */
     LoaderMemoryDescriptors = KE::BootInformation::GetMemoryDescriptors();
 
@@ -1349,9 +2851,9 @@ MM::Pfn::UnlinkFreePage(IN PFN_NUMBER PageFrameIndex,
         PfnList->Blink = Pfn->u2.Blink;
     }
 
-    /* Get the first page on the color list */
-    ColorTable = MM::Colors::GetFreePages(PageList, Color);
+    /* Get the first page on the color list of the page's NUMA node */
     NodeColor = Pfn->u3.e1.PageColor;
+    ColorTable = MM::Colors::GetFreePages(PageList, NodeColor, Color);
     PrevPage = Pfn->u4.PteFrame;
     NextPage = MM::Paging::GetPte(&Pfn->OriginalPte);
 
@@ -1383,16 +2885,301 @@ MM::Pfn::UnlinkFreePage(IN PFN_NUMBER PageFrameIndex,
         ColorTable->Blink = (PVOID)PrevPage;
     }
 
-    /* Clear the list pointers and flags, but preserve the color and cache attributes */
+    /* Clear the list pointers and flags, but preserve the NUMA node and cache attributes */
     Pfn->u1.Flink = 0;
     Pfn->u2.Blink = 0;
     Pfn->u3.e1.CacheAttribute = PfnNotMapped;
     Pfn->u3.e1.PageColor = NodeColor;
     Pfn->u3.e2.ShortFlags = 0;
 
+    /* Remove the page from the buddy index of free page blocks */
+    MM::Buddy::RemovePage(PageFrameIndex);
+
+    /* Account the allocation against the list the page was taken from */
+    MM::Statistics::IncrementCounter((MMPERFORMANCE_COUNTER)(ZeroedPageAllocations + PageList));
+
     /* Decrement the global count of available pages */
     DecrementAvailablePages();
 
     /* Return the page that was just unlinked */
     return PageFrameIndex;
 }
+
+/**
+ * Detaches a run of pages from the head of a colored free or zeroed list in a single pass.
+ *
+ * @param PageList
+ *        Specifies the list to take the pages from, either FreePageList or ZeroedPageList.
+ *
+ * @param Node
+ *        Specifies the NUMA node owning the colored list.
+ *
+ * @param Color
+ *        Specifies the color of the list.
+ *
+ * @param Pages
+ *        Specifies the maximum number of pages to take.
+ *
+ * @param Stride
+ *        Specifies the distance between consecutive entries written to the output array.
+ *
+ * @param PageFrames
+ *        Supplies a pointer to an array that will receive the page frame numbers of the detached pages.
+ *
+ * @return This routine returns the number of pages detached from the list.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the PFN database lock.
+ */
+XTAPI
+PFN_COUNT
+MM::Pfn::UnlinkFreePages(IN MMPAGELISTS PageList,
+                         IN ULONG Node,
+                         IN ULONG Color,
+                         IN PFN_COUNT Pages,
+                         IN PFN_COUNT Stride,
+                         OUT PPFN_NUMBER PageFrames)
+{
+    PFN_NUMBER NextPage, PageFrameIndex;
+    PMMCOLOR_TABLES ColorTable;
+    PMMPFNLIST PfnList;
+    PFN_COUNT Count;
+    PMMPFN Pfn;
+
+    /* Get the colored list and walk it from its head */
+    ColorTable = MM::Colors::GetFreePages(PageList, Node, Color);
+    PageFrameIndex = ColorTable->Flink;
+    Count = 0;
+
+    /* Take the pages off the colored list, one after another */
+    while(Count < Pages && PageFrameIndex != MAXULONG_PTR)
+    {
+        /* Get the PFN database entry and the next page on the colored list */
+        Pfn = GetPfnEntry(PageFrameIndex);
+        NextPage = MM::Paging::GetPte(&Pfn->OriginalPte);
+
+        /* Get the global list the page is linked to */
+        PfnList = PageLocationList[Pfn->u3.e1.PageLocation];
+
+        /* Update the forward link of the previous page on the global list */
+        if(Pfn->u2.Blink != MAXULONG_PTR)
+        {
+            /* The page is not the head of the list, update the previous page's Flink */
+            GetPfnEntry(Pfn->u2.Blink)->u1.Flink = Pfn->u1.Flink;
+        }
+        else
+        {
+            /* This is the first page in the list, update the list head's Flink */
+            PfnList->Flink = Pfn->u1.Flink;
+        }
+
+        /* Update the backward link of the next page on the global list */
+        if(Pfn->u1.Flink != MAXULONG_PTR)
+        {
+            /* The page is not the tail of the list, update the next page's Blink */
+            GetPfnEntry(Pfn->u1.Flink)->u2.Blink = Pfn->u2.Blink;
+        }
+        else
+        {
+            /* This is the last page in the list, update the list head's Blink */
+            PfnList->Blink = Pfn->u2.Blink;
+        }
+
+        /* Decrement the total page count of the global list */
+        PfnList->Total--;
+
+        /* Clear the list pointers and flags, but preserve the NUMA node and cache attributes */
+        Pfn->u1.Flink = 0;
+        Pfn->u2.Blink = 0;
+        Pfn->u3.e1.CacheAttribute = PfnNotMapped;
+        Pfn->u3.e1.PageColor = Node;
+        Pfn->u3.e2.ShortFlags = 0;
+
+        /* Remove the page from the buddy index of free page blocks */
+        MM::Buddy::RemovePage(PageFrameIndex);
+
+        /* Store the page and move to the next one */
+        PageFrames[Count * Stride] = PageFrameIndex;
+        PageFrameIndex = NextPage;
+        Count++;
+    }
+
+    /* Check if any page was taken */
+    if(Count == 0)
+    {
+        /* Nothing to update */
+        return 0;
+    }
+
+    /* Detach the whole run from the colored list at once */
+    ColorTable->Flink = PageFrameIndex;
+    ColorTable->Count -= Count;
+    if(PageFrameIndex != MAXULONG_PTR)
+    {
+        /* The next page becomes the first entry of the colored list */
+        GetPfnEntry(PageFrameIndex)->u4.PteFrame = MM_PFN_PTE_FRAME;
+    }
+
+    /* Account the allocations and update the global count of available pages */
+    MM::Statistics::AddCounter((MMPERFORMANCE_COUNTER)(ZeroedPageAllocations + PageList), Count);
+    AvailablePages -= Count;
+
+    /* Return the number of pages taken */
+    return Count;
+}
+
+/**
+ * Moves a batch of free pages to the zeroed page lists, filling them with zeroes. This routine is intended to be
+ * called by idle processors, so that zeroing is kept off the allocation path.
+ *
+ * @param Pages
+ *        Specifies the maximum number of pages to zero, up to MM_ZERO_PAGE_BATCH.
+ *
+ * @return This routine returns the number of pages moved to the zeroed page lists.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PFN_COUNT
+MM::Pfn::ZeroFreePages(IN PFN_COUNT Pages)
+{
+    PFN_NUMBER PageFrames[MM_ZERO_PAGE_BATCH];
+    ULONG Color, Node, NodeCount, PagingColors, PagingColorsMask;
+    PMMCOLOR_TABLES ColorTable;
+    PFN_COUNT Count, Index;
+    PUCHAR NodeOrder;
+
+    /* Limit the number of pages zeroed in a single pass */
+    Pages = MIN(Pages, MM_ZERO_PAGE_BATCH);
+    Count = 0;
+
+    /* Retrieve the number of paging colors and the bitmask used for calculating a page's color */
+    PagingColors = MM::Colors::GetPagingColors();
+    PagingColorsMask = MM::Colors::GetPagingColorsMask();
+
+    /* Raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the number of NUMA nodes and the order in which they are used by the current processor */
+    NodeCount = MM::Numa::GetNodeCount();
+    NodeOrder = MM::Numa::GetNodeOrder(MM::Numa::GetCurrentNode());
+
+    /* Start a guarded code block */
+    {
+        /* Acquire the PFN database lock */
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+
+        /* Prefer pages of the local node, moving to more distant nodes only when no free page was found */
+        for(Node = 0, Index = 0; Node < NodeCount && Count == 0; Node++)
+        {
+            /* Take free pages, walking the colors so that all colored zeroed lists get refilled evenly */
+            for(Index = 0; Index < PagingColors && Count < Pages; Index++)
+            {
+                /* Get the colored free list for the next color */
+                Color = (NextZeroPageColor + Index) & PagingColorsMask;
+                ColorTable = MM::Colors::GetFreePages(FreePageList, NodeOrder[Node], Color);
+
+                /* Check if the colored free list holds any page */
+                if(ColorTable->Flink != MAXULONG_PTR)
+                {
+                    /* Take the first page off the colored free list */
+                    PageFrames[Count] = UnlinkFreePage(ColorTable->Flink, Color);
+                    Count++;
+                }
+            }
+        }
+
+        /* Continue with the next color on the next pass */
+        NextZeroPageColor = (NextZeroPageColor + Index) & PagingColorsMask;
+    }
+
+    /* Check if any free page was taken */
+    if(Count == 0)
+    {
+        /* Nothing to zero */
+        return 0;
+    }
+
+    /* Fill the pages with zeroes */
+    if(ZeroPhysicalPages(PageFrames, Count) != STATUS_SUCCESS)
+    {
+        /* Unable to map the pages, return them to the free lists */
+        KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+        for(Index = 0; Index < Count; Index++)
+        {
+            /* Link the page to the free list */
+            LinkFreePage(PageFrames[Index]);
+        }
+
+        /* Return no pages zeroed */
+        return 0;
+    }
+
+    /* Acquire the PFN database lock and link the zeroed pages */
+    KE::QueuedSpinLockGuard PfnSpinLock(PfnLock);
+    for(Index = 0; Index < Count; Index++)
+    {
+        /* Link the page to the zeroed list */
+        LinkZeroedPage(PageFrames[Index]);
+    }
+
+    /* Return the number of pages zeroed */
+    return Count;
+}
+
+/**
+ * Fills a set of unmapped physical pages with zeroes, using non-temporal stores.
+ *
+ * @param PageFrames
+ *        Supplies a pointer to an array of page frame numbers to zero.
+ *
+ * @param Pages
+ *        Specifies the number of pages in the array.
+ *
+ * @return This routine returns a status code.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+XTSTATUS
+MM::Pfn::ZeroPhysicalPages(IN PPFN_NUMBER PageFrames,
+                           IN PFN_COUNT Pages)
+{
+    PMMPTE StartPte;
+    PVOID BaseAddress;
+    MMPTE ValidPte;
+    PFN_COUNT Index;
+
+    /* Reserve system PTEs to temporarily map the pages */
+    StartPte = MM::Pte::ReserveSystemPtes(Pages, SystemPteSpace);
+    if(!StartPte)
+    {
+        /* Failed to reserve system PTEs, return error */
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    /* Get a template valid PTE */
+    ValidPte = *MM::Pte::GetValidPte();
+
+    /* Map all pages into the reserved PTE range */
+    MM::Paging::MapPtes(StartPte, PageFrames, Pages, &ValidPte);
+
+    /* Zero the whole range, bypassing the CPU caches to avoid evicting useful data */
+    BaseAddress = MM::Paging::GetPteVirtualAddress(StartPte);
+    MM::Paging::ZeroPagesNonTemporal(BaseAddress, Pages << MM_PAGE_SHIFT);
+
+    /* Unmap all pages and invalidate their TLB entries */
+    MM::Paging::UnmapPtes(StartPte, Pages, NULLPTR);
+    for(Index = 0; Index < Pages; Index++)
+    {
+        /* Invalidate the TLB entry */
+        AR::CpuFunctions::InvalidateTlbEntry((PVOID)((ULONG_PTR)BaseAddress + (Index << MM_PAGE_SHIFT)));
+    }
+
+    /* Release the reserved system PTEs */
+    MM::Pte::ReleaseSystemPtes(StartPte, Pages, SystemPteSpace);
+
+    /* Return success */
+    return STATUS_SUCCESS;
+}
@@ -91,6 +91,106 @@ MM::Pool::EncodePoolLink(IN PLIST_ENTRY PoolLink)
     return (PLIST_ENTRY)((ULONG_PTR)PoolLink ^ PoolSecureCookie);
 }
 
+/**
+ * Finds a free run of non-paged pool pages large enough to satisfy the request.
+ *
+ * @param Pages
+ *        Supplies the number of pages requested.
+ *
+ * @return This routine returns a pointer to the free run, or NULLPTR if no suitable run is available.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the non-paged pool lock.
+ */
+XTAPI
+PMMFREE_POOL_ENTRY
+MM::Pool::FindFreePageRun(IN PFN_COUNT Pages)
+{
+    ULONG Bitmap, FirstLevel, SecondLevel;
+    PFN_COUNT Size;
+
+    /* Check if the request falls into a size class spanning multiple sizes */
+    Size = Pages;
+    if(Pages >= MM_FREE_PAGE_RUN_SECOND_LEVELS)
+    {
+        /* Round the size up to the next size class, so that every run found in that class is large enough */
+        Size += (1 << ((31 - RTL::Math::CountLeadingZeroes32(Pages)) - MM_FREE_PAGE_RUN_SECOND_LEVEL_SHIFT)) - 1;
+        if(Size < Pages)
+        {
+            /* Request too large to be ever satisfied */
+            return NULLPTR;
+        }
+    }
+
+    /* Get the size class for the rounded size */
+    GetFreePageRunIndex(Size, &FirstLevel, &SecondLevel);
+
+    /* Look for a non-empty list in the same first level class, at or above the requested second level class */
+    Bitmap = NonPagedPoolFreeListSubBitmap[FirstLevel] & (MAXULONG << SecondLevel);
+    if(!Bitmap)
+    {
+        /* Look for the smallest non-empty first level class above the requested one */
+        Bitmap = (FirstLevel + 1 < MM_FREE_PAGE_RUN_FIRST_LEVELS) ? NonPagedPoolFreeListBitmap & (MAXULONG << (FirstLevel + 1)) : 0;
+        if(!Bitmap)
+        {
+            /* No free run large enough */
+            return NULLPTR;
+        }
+
+        /* Take the first non-empty first level class and its second level bitmap */
+        FirstLevel = RTL::Math::CountTrailingZeroes32(Bitmap);
+        Bitmap = NonPagedPoolFreeListSubBitmap[FirstLevel];
+    }
+
+    /* Take the first non-empty second level class */
+    SecondLevel = RTL::Math::CountTrailingZeroes32(Bitmap);
+
+    /* Return the first free run from the selected list */
+    return CONTAIN_RECORD(NonPagedPoolFreeList[(FirstLevel * MM_FREE_PAGE_RUN_SECOND_LEVELS) + SecondLevel].Flink,
+                          MMFREE_POOL_ENTRY,
+                          List);
+}
+
+/**
+ * Calculates the two-level size class index of a free run of non-paged pool pages.
+ *
+ * @param Pages
+ *        Supplies the number of pages in the free run.
+ *
+ * @param FirstLevel
+ *        Supplies a pointer to a variable that will receive the first level index.
+ *
+ * @param SecondLevel
+ *        Supplies a pointer to a variable that will receive the second level index.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pool::GetFreePageRunIndex(IN PFN_COUNT Pages,
+                              OUT PULONG FirstLevel,
+                              OUT PULONG SecondLevel)
+{
+    ULONG MostSignificantBit;
+
+    /* Check if the run is small enough to have its own size class */
+    if(Pages < MM_FREE_PAGE_RUN_SECOND_LEVELS)
+    {
+        /* Small runs are indexed directly by their size */
+        *FirstLevel = 0;
+        *SecondLevel = Pages;
+        return;
+    }
+
+    /* Split the power of two range the run falls into, into linear subranges */
+    MostSignificantBit = 31 - RTL::Math::CountLeadingZeroes32(Pages);
+    *FirstLevel = MostSignificantBit - MM_FREE_PAGE_RUN_SECOND_LEVEL_SHIFT + 1;
+    *SecondLevel = (Pages >> (MostSignificantBit - MM_FREE_PAGE_RUN_SECOND_LEVEL_SHIFT)) - MM_FREE_PAGE_RUN_SECOND_LEVELS;
+}
+
 /**
  * Calculates the address of a pool block at a specific relative index.
  *
@@ -112,6 +212,58 @@ MM::Pool::GetPoolBlock(IN PPOOL_HEADER Header, IN SSIZE_T Index)
     return (PPOOL_HEADER)((ULONG_PTR)Header + (Index * MM_POOL_BLOCK_SIZE));
 }
 
+/**
+ * Retrieves the pool descriptor used for new small block allocations from the specified pool type.
+ *
+ * @param PoolType
+ *        Specifies the type of pool to allocate from.
+ *
+ * @return This routine returns a pointer to the pool descriptor.
+ *
+ * @since XT 1.0
+ *
+ * @note Non-paged pool blocks are carved out of the pool descriptor of the current processor's NUMA node.
+ */
+XTAPI
+PPOOL_DESCRIPTOR
+MM::Pool::GetPoolDescriptor(IN MMPOOL_TYPE PoolType)
+{
+    /* Check if this is a non-paged pool allocation */
+    if((PoolType & MM_POOL_TYPE_MASK) == NonPagedPool)
+    {
+        /* Return the pool descriptor of the current NUMA node */
+        return &NonPagedPoolDescriptors[MM::Numa::GetCurrentNode()];
+    }
+
+    /* Return the pool descriptor from the pool vector */
+    return PoolVector[PoolType & MM_POOL_TYPE_MASK];
+}
+
+/**
+ * Retrieves the pool descriptor owning an allocated pool block.
+ *
+ * @param Header
+ *        Supplies a pointer to the pool block header.
+ *
+ * @return This routine returns a pointer to the pool descriptor.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PPOOL_DESCRIPTOR
+MM::Pool::GetPoolDescriptor(IN PPOOL_HEADER Header)
+{
+    /* Check if the block belongs to the non-paged pool */
+    if(((Header->PoolType - 1) & MM_POOL_TYPE_MASK) == NonPagedPool)
+    {
+        /* Return the pool descriptor of the NUMA node the block has been carved out for */
+        return &NonPagedPoolDescriptors[Header->PoolIndex];
+    }
+
+    /* Return the pool descriptor from the pool vector */
+    return PoolVector[(Header->PoolType - 1) & MM_POOL_TYPE_MASK];
+}
+
 /**
  * Retrieves the pool header associated with a given pool memory address.
  *
@@ -184,6 +336,25 @@ MM::Pool::GetPoolPreviousBlock(IN PPOOL_HEADER Header)
     return (PPOOL_HEADER)((ULONG_PTR)Header - (Header->PreviousSize * MM_POOL_BLOCK_SIZE));
 }
 
+/**
+ * Checks whether the given virtual address belongs to the guard page pool.
+ *
+ * @param VirtualAddress
+ *        Supplies the virtual address to check.
+ *
+ * @return This routine returns TRUE if the address lies within the guard page pool, or FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::Pool::GuardPoolAddress(IN PVOID VirtualAddress)
+{
+    /* Check if the guard page pool is enabled and the address lies within its virtual range */
+    return (GuardPoolStart && (ULONG_PTR)VirtualAddress >= (ULONG_PTR)GuardPoolStart &&
+            (ULONG_PTR)VirtualAddress < (ULONG_PTR)GuardPoolStart + ((ULONG_PTR)MM_POOL_GUARD_PTES << MM_PAGE_SHIFT));
+}
+
 /**
  * Initializes the non-paged pool for memory allocator.
  *
@@ -206,26 +377,22 @@ MM::Pool::InitializeNonPagedPool(VOID)
     MapNonPagedPool();
 
     /* Iterate over the free page list heads */
-    for(Index = 0; Index < MM_MAX_FREE_PAGE_LIST_HEADS; Index++)
+    for(Index = 0; Index < MM_FREE_PAGE_RUN_LISTS; Index++)
     {
         /* Initialize a free page list head */
         RTL::LinkedList::InitializeListHead(&NonPagedPoolFreeList[Index]);
     }
 
+    /* Mark all free page size classes as empty */
+    NonPagedPoolFreeListBitmap = 0;
+    RTL::Memory::ZeroMemory(NonPagedPoolFreeListSubBitmap, sizeof(NonPagedPoolFreeListSubBitmap));
+
     /* Take the first free page from the pool and set its size */
     FreePage = (PMMFREE_POOL_ENTRY)MemoryLayout->NonPagedPoolStart;
     FreePage->Size = MemoryLayout->NonPagedPoolSize;
 
-    /* Take number of pages in the pool */
-    Index = (ULONG)(MemoryLayout->NonPagedPoolSize - 1);
-    if(Index >= MM_MAX_FREE_PAGE_LIST_HEADS)
-    {
-        /* Number of pages exceeds the number of free page list heads */
-        Index = MM_MAX_FREE_PAGE_LIST_HEADS - 1;
-    }
-
     /* Insert the first free page into the free page list */
-    RTL::LinkedList::InsertHeadList(&NonPagedPoolFreeList[Index], &FreePage->List);
+    InsertFreePageRun(FreePage);
 
     /* Create a free page for each page in the pool */
     SetupPage = FreePage;
@@ -237,31 +404,89 @@ MM::Pool::InitializeNonPagedPool(VOID)
     }
 
     /* Store first and last allocated non-paged pool page */
-    NonPagedPoolFrameStart = MM::Paging::GetPageFrameNumber(MM::Paging::GetPteAddress(MemoryLayout->NonPagedPoolStart));
-    NonPagedPoolFrameEnd = MM::Paging::GetPageFrameNumber(MM::Paging::GetPteAddress(MemoryLayout->NonPagedPoolEnd));
+    NonPagedPoolFrameStart = MM::Pte::GetMappedPageFrame(MemoryLayout->NonPagedPoolStart);
+    NonPagedPoolFrameEnd = MM::Pte::GetMappedPageFrame((PCHAR)MemoryLayout->NonPagedPoolEnd - 1);
+
+    /* Store the NUMA node owning the initial non-paged pool, as it is physically contiguous */
+    NonPagedPoolNode = MM::Numa::GetPageNode(NonPagedPoolFrameStart);
 
     /* Initialize system PTE pool for the non-paged expansion pool */
     Pte::InitializeSystemPtePool(Paging::GetNextPte(Paging::GetPteAddress(MemoryLayout->NonPagedExpansionPoolStart)),
                                                                           MemoryLayout->NonPagedExpansionPoolSize - 2,
                                                                           NonPagedPoolExpansion);
 
-    /* Store non-paged pool descriptor in the pool vector and initialize it */
-    PoolVector[NonPagedPool] = &NonPagedPoolDescriptor;
-    InitializePoolDescriptor(PoolVector[NonPagedPool], NonPagedPool, 0, 0, NULLPTR);
+    /* Initialize a non-paged pool descriptor for each NUMA node, the node number being the descriptor index */
+    for(Index = 0; Index < MM::Numa::GetNodeCount(); Index++)
+    {
+        /* Initialize the node's pool descriptor, guarded by its own lock */
+        KE::SpinLock::InitializeSpinLock(&NonPagedPoolDescriptorLocks[Index]);
+        InitializePoolDescriptor(&NonPagedPoolDescriptors[Index], NonPagedPool, Index, 0,
+                                 &NonPagedPoolDescriptorLocks[Index]);
+    }
+
+    /* Store the first node's descriptor in the pool vector */
+    PoolVector[NonPagedPool] = &NonPagedPoolDescriptors[0];
 }
 
 /**
- * Initializes the non-paged pool for memory allocator.
+ * Initializes the paged pool for memory allocator.
  *
  * @return This routine does not return any value.
  *
  * @since XT 1.0
+ *
+ * @note Only the virtual address space of the paged pool is reserved here. Page tables are created, and physical
+ *       pages are committed on the first touch of every page, by the page fault handler.
  */
 XTAPI
 VOID
 MM::Pool::InitializePagedPool(VOID)
 {
-    UNIMPLEMENTED;
+    PMMMEMORY_LAYOUT MemoryLayout;
+    PFN_NUMBER PoolPages;
+    PULONG_PTR BitMap;
+    SIZE_T BitMapSize;
+    XTSTATUS Status;
+
+    /* Retrieve memory layout */
+    MemoryLayout = MM::Manager::GetMemoryLayout();
+
+    /* Make sure the paged pool does not exceed the virtual address range reserved for it */
+    PoolPages = ((ULONG_PTR)MemoryLayout->PagedPoolEnd - (ULONG_PTR)MemoryLayout->PagedPoolStart + 1) / MM_PAGE_SIZE;
+    MemoryLayout->PagedPoolSize = MIN(MemoryLayout->PagedPoolSize, PoolPages);
+
+    /* Calculate the size of a bitmap tracking every paged pool page */
+    BitMapSize = ((MemoryLayout->PagedPoolSize + (sizeof(ULONG_PTR) * 8) - 1) / (sizeof(ULONG_PTR) * 8)) *
+                 sizeof(ULONG_PTR);
+
+    /* Allocate memory for both, the allocation and the end of allocation bitmaps */
+    Status = MM::Allocator::AllocatePool(NonPagedPool,
+                                         2 * BitMapSize,
+                                         (PVOID *)&BitMap,
+                                         SIGNATURE32('M', 'M', 'g', 'r'));
+    if(Status != STATUS_SUCCESS || !BitMap)
+    {
+        /* Memory allocation failed, kernel panic */
+        DebugPrint(L"Insufficient memory for the paged pool bitmaps!\n");
+        KE::Crash::Panic(0x7D, MemoryLayout->PagedPoolSize, BitMapSize, 0, 0x102);
+    }
+
+    /* Initialize both bitmaps, with no paged pool page reserved yet */
+    RTL::BitMap::InitializeBitMap(&PagedPoolAllocationMap, BitMap, (ULONG)MemoryLayout->PagedPoolSize);
+    RTL::BitMap::InitializeBitMap(&PagedPoolEndOfAllocationMap,
+                                  (PULONG_PTR)((ULONG_PTR)BitMap + BitMapSize),
+                                  (ULONG)MemoryLayout->PagedPoolSize);
+    RTL::BitMap::ClearAllBits(&PagedPoolAllocationMap);
+    RTL::BitMap::ClearAllBits(&PagedPoolEndOfAllocationMap);
+
+    /* Start searching for free virtual space from the beginning of the paged pool */
+    PagedPoolHint = 0;
+    KE::SpinLock::InitializeSpinLock(&PagedPoolLock);
+
+    /* Initialize the paged pool descriptor along with its lock and store it in the pool vector */
+    KE::SpinLock::InitializeSpinLock(&PagedPoolDescriptorLock);
+    InitializePoolDescriptor(&PagedPoolDescriptor, PagedPool, 0, 0, &PagedPoolDescriptorLock);
+    PoolVector[PagedPool] = &PagedPoolDescriptor;
 }
 
 /**
@@ -365,6 +590,116 @@ MM::Pool::InitializePoolSecurity(VOID)
     PoolSecureCookie = 0xDEADC0DE;
 }
 
+/**
+ * Selects the level of the pool integrity checks and sets up the guard page pool. The verification level is read
+ * from the POOLVERIFY kernel parameter (0 - off, 1 - pool headers only, 2 - full pool block and list walks), while
+ * the POOLGUARD kernel parameter names a pool tag, whose allocations are served from the guard page pool.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pool::InitializePoolVerification(VOID)
+{
+    WCHAR ParameterValue[16];
+    PMMPTE PointerPte;
+    ULONG Index, Level;
+    ULONG Tag;
+
+    /* Perform exhaustive checks in debug builds and cheap header checks otherwise */
+#ifdef DBG
+    PoolVerificationLevel = MM_POOL_VERIFY_FULL;
+#else
+    PoolVerificationLevel = MM_POOL_VERIFY_HEADERS;
+#endif
+
+    /* Check if user requested a specific pool verification level */
+    if(KE::BootInformation::GetKernelParameterValue(L"POOLVERIFY", ParameterValue, 16) == STATUS_SUCCESS)
+    {
+        /* Convert string value to number */
+        if(RTL::WideString::WideStringToNumber(ParameterValue, 0, &Level) == STATUS_SUCCESS)
+        {
+            /* Clamp the level to the supported range */
+            PoolVerificationLevel = MIN(Level, MM_POOL_VERIFY_FULL);
+        }
+    }
+
+    /* Check if user requested the guard page pool for a pool tag */
+    if(KE::BootInformation::GetKernelParameterValue(L"POOLGUARD", ParameterValue, 16) != STATUS_SUCCESS)
+    {
+        /* Guard page pool not requested, nothing more to do */
+        return;
+    }
+
+    /* Convert up to four characters of the parameter value into a pool tag */
+    Tag = 0;
+    for(Index = 0; Index < 4 && ParameterValue[Index] != L'\0'; Index++)
+    {
+        /* Append the character to the tag */
+        Tag |= (ULONG)(UCHAR)ParameterValue[Index] << (Index * 8);
+    }
+
+    /* Make sure the tag is valid */
+    if(Tag == 0)
+    {
+        /* Invalid tag, do not enable the guard page pool */
+        return;
+    }
+
+    /* Reserve the virtual space for the guard page pool */
+    PointerPte = MM::Pte::ReserveSystemPtes(MM_POOL_GUARD_PTES, SystemPteSpace);
+    if(!PointerPte)
+    {
+        /* Unable to reserve system PTEs, do not enable the guard page pool */
+        DebugPrint(L"Unable to reserve system PTEs for the guard page pool\n");
+        return;
+    }
+
+    /* Make every PTE of the guard page pool invalid, so that each unused page acts as a guard page */
+    GuardPoolStart = MM::Paging::GetPteVirtualAddress(PointerPte);
+    for(Index = 0; Index < MM_POOL_GUARD_PTES; Index++)
+    {
+        /* Clear the PTE and advance to the next one */
+        MM::Paging::ClearPte(PointerPte);
+        PointerPte = MM::Paging::GetNextPte(PointerPte);
+    }
+
+    /* Initialize the guard page pool lock and enable the guard page pool for the tag */
+    KE::SpinLock::InitializeSpinLock(&GuardPoolLock);
+    GuardPoolTag = Tag;
+    DebugPrint(L"Guard page pool enabled for pool tag 0x%08X\n", Tag);
+}
+
+/**
+ * Inserts a free run of non-paged pool pages into the free list matching its size.
+ *
+ * @param FreePage
+ *        Supplies a pointer to the first page of the free run.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the non-paged pool lock.
+ */
+XTAPI
+VOID
+MM::Pool::InsertFreePageRun(IN PMMFREE_POOL_ENTRY FreePage)
+{
+    ULONG FirstLevel, SecondLevel;
+
+    /* Get the size class of the free run */
+    GetFreePageRunIndex(FreePage->Size, &FirstLevel, &SecondLevel);
+
+    /* Insert the run into the free list and mark the size class as non-empty */
+    RTL::LinkedList::InsertHeadList(&NonPagedPoolFreeList[(FirstLevel * MM_FREE_PAGE_RUN_SECOND_LEVELS) + SecondLevel],
+                                    &FreePage->List);
+    NonPagedPoolFreeListSubBitmap[FirstLevel] |= (1 << SecondLevel);
+    NonPagedPoolFreeListBitmap |= (1 << FirstLevel);
+}
+
 /**
  * Inserts a pool entry at the head of a doubly-linked pool list.
  *
@@ -453,6 +788,45 @@ MM::Pool::PoolListEmpty(IN PLIST_ENTRY ListHead)
     return (DecodePoolLink(ListHead->Flink) == ListHead);
 }
 
+/**
+ * Removes a free run of non-paged pool pages from its free list.
+ *
+ * @param FreePage
+ *        Supplies a pointer to the first page of the free run.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the non-paged pool lock and must not change the run size before removing it.
+ */
+XTAPI
+VOID
+MM::Pool::RemoveFreePageRun(IN PMMFREE_POOL_ENTRY FreePage)
+{
+    ULONG FirstLevel, SecondLevel;
+    PLIST_ENTRY ListHead;
+
+    /* Get the size class of the free run */
+    GetFreePageRunIndex(FreePage->Size, &FirstLevel, &SecondLevel);
+    ListHead = &NonPagedPoolFreeList[(FirstLevel * MM_FREE_PAGE_RUN_SECOND_LEVELS) + SecondLevel];
+
+    /* Remove the run from the free list */
+    RTL::LinkedList::RemoveEntryList(&FreePage->List);
+
+    /* Check if the free list became empty */
+    if(RTL::LinkedList::ListEmpty(ListHead))
+    {
+        /* Mark the second level size class as empty */
+        NonPagedPoolFreeListSubBitmap[FirstLevel] &= ~(1 << SecondLevel);
+        if(!NonPagedPoolFreeListSubBitmap[FirstLevel])
+        {
+            /* Mark the whole first level size class as empty */
+            NonPagedPoolFreeListBitmap &= ~(1 << FirstLevel);
+        }
+    }
+}
+
 /**
  * Removes a specific pool entry from a doubly-linked pool list.
  *
@@ -531,7 +905,8 @@ MM::Pool::RemovePoolTailList(IN PLIST_ENTRY ListHead)
 }
 
 /**
- * Verifies the structural integrity of all pool blocks residing on a specific page.
+ * Verifies the structural integrity of all pool blocks residing on a specific page. Depending on the verification
+ * level, only the header of the given block is checked, or the check is skipped entirely.
  *
  * @param Block
  *        Supplies a pointer to the specific pool block.
@@ -548,6 +923,19 @@ MM::Pool::VerifyPoolBlocks(IN PVOID Block)
     BOOLEAN FoundBlock;
     SIZE_T Size;
 
+    /* Check the pool verification level */
+    if(PoolVerificationLevel == MM_POOL_VERIFY_NONE)
+    {
+        /* Pool verification disabled */
+        return;
+    }
+    else if(PoolVerificationLevel == MM_POOL_VERIFY_HEADERS)
+    {
+        /* Validate only the header of the block against its neighbours */
+        VerifyPoolHeader((PPOOL_HEADER)Block);
+        return;
+    }
+
     /* Initialize tracking variables */
     FoundBlock = FALSE;
     Size = 0;
@@ -654,7 +1042,8 @@ MM::Pool::VerifyPoolHeader(IN PPOOL_HEADER Entry)
 }
 
 /**
- * Validates the structural integrity of a doubly-linked pool list.
+ * Validates the structural integrity of a doubly-linked pool list. The neighbours of the list head are always
+ * checked, unless pool verification is disabled, while full verification walks the entire list.
  *
  * @param ListHead
  *        Supplies a pointer to the pool list head that is to be validated.
@@ -667,6 +1056,15 @@ XTAPI
 VOID
 MM::Pool::VerifyPoolLinks(IN PLIST_ENTRY ListHead)
 {
+    PLIST_ENTRY Entry;
+
+    /* Check if pool verification is disabled */
+    if(PoolVerificationLevel == MM_POOL_VERIFY_NONE)
+    {
+        /* Nothing to verify */
+        return;
+    }
+
     /* Validate the doubly-linked list invariants */
     if((DecodePoolLink(DecodePoolLink(ListHead->Blink)->Flink) != ListHead) ||
        (DecodePoolLink(DecodePoolLink(ListHead->Flink)->Blink) != ListHead))
@@ -678,6 +1076,29 @@ MM::Pool::VerifyPoolLinks(IN PLIST_ENTRY ListHead)
                          (ULONG_PTR)DecodePoolLink(DecodePoolLink(ListHead->Blink)->Flink),
                          (ULONG_PTR)DecodePoolLink(DecodePoolLink(ListHead->Flink)->Blink));
     }
+
+    /* Check if full pool verification is enabled */
+    if(PoolVerificationLevel >= MM_POOL_VERIFY_FULL)
+    {
+        /* Walk the whole list, validating the links of every entry */
+        Entry = DecodePoolLink(ListHead->Flink);
+        while(Entry != ListHead)
+        {
+            /* Make sure the next entry links back to the current one */
+            if(DecodePoolLink(DecodePoolLink(Entry->Flink)->Blink) != Entry)
+            {
+                /* Pool corruption detected, raise kernel panic */
+                KE::Crash::Panic(0x19,
+                                 3,
+                                 (ULONG_PTR)Entry,
+                                 (ULONG_PTR)DecodePoolLink(Entry->Flink),
+                                 (ULONG_PTR)DecodePoolLink(DecodePoolLink(Entry->Flink)->Blink));
+            }
+
+            /* Advance to the next entry */
+            Entry = DecodePoolLink(Entry->Flink);
+        }
+    }
 }
 
 /**
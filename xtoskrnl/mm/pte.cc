@@ -9,6 +9,122 @@
 #include <xtos.hh>
 
 
+/**
+ * Reserves a short run of system PTEs from the current processor's system PTE cache, refilling it in bulk when empty.
+ *
+ * @param NumberOfPtes
+ *        The number of contiguous PTEs to reserve. Must not exceed MM_SYSTEM_PTE_CACHE_SIZES.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool from which to allocate.
+ *
+ * @return This routine returns a pointer to the beginning of the reserved run, or NULLPTR if the cache is empty
+ *         and could not be refilled.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PMMPTE
+MM::Pte::AllocateCachedSystemPtes(IN PFN_COUNT NumberOfPtes,
+                                  IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    PMMSYSTEM_PTE_CACHE Cache;
+    PMMPTE ReservedPte;
+    PFN_COUNT Index;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the system PTE cache of the current processor */
+    Cache = &KE::Processor::GetCurrentProcessorControlBlock()->SystemPteCache[SystemPtePoolType];
+    Cache->TotalReserves++;
+
+    /* Check if there is a cached run of the requested size */
+    if(Cache->Count[NumberOfPtes - 1] == 0)
+    {
+        /* Count a miss and refill the cache with a batch of runs */
+        Cache->ReserveMisses++;
+        RefillSystemPteCache(Cache, NumberOfPtes, SystemPtePoolType);
+        if(Cache->Count[NumberOfPtes - 1] == 0)
+        {
+            /* Cache could not be refilled, return NULLPTR */
+            return NULLPTR;
+        }
+    }
+
+    /* Take the most recently cached run */
+    Cache->Count[NumberOfPtes - 1]--;
+    ReservedPte = Cache->Runs[NumberOfPtes - 1][Cache->Count[NumberOfPtes - 1]];
+    Cache->CachedPtes -= NumberOfPtes;
+
+    /* Invalidate any stale translations of the run on the current processor */
+    for(Index = 0; Index < NumberOfPtes; Index++)
+    {
+        /* Invalidate the TLB entry for the page */
+        AR::CpuFunctions::InvalidateTlbEntry(MM::Paging::GetPteVirtualAddress(MM::Paging::AdvancePte(ReservedPte,
+                                                                                                     Index)));
+    }
+
+    /* Return a pointer to the start of the reserved run */
+    return ReservedPte;
+}
+
+/**
+ * Reserves a contiguous block of system PTEs from the shared free cluster index of a specified pool.
+ *
+ * @param NumberOfPtes
+ *        The number of contiguous PTEs to reserve.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool from which to allocate.
+ *
+ * @return This routine returns a pointer to the beginning of the reserved block,
+ *         or NULLPTR if not enough contiguous PTEs are available.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the system space lock.
+ */
+XTAPI
+PMMPTE
+MM::Pte::AllocateSystemPtes(IN PFN_COUNT NumberOfPtes,
+                            IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    PMMPTE ClusterPte, ReservedPte;
+    ULONG ClusterSize;
+
+    /* Find a free PTE cluster large enough for the request */
+    ClusterPte = FindFreeCluster(NumberOfPtes, SystemPtePoolType);
+    if(!ClusterPte)
+    {
+        /* Out of system PTEs for this pool, return NULLPTR */
+        return NULLPTR;
+    }
+
+    /* Get the cluster size and remove it from the free lists */
+    ClusterSize = GetClusterSize(ClusterPte);
+    RemoveFreeCluster(ClusterPte, SystemPtePoolType);
+
+    /* Check if the cluster is larger than needed */
+    if(ClusterSize > NumberOfPtes)
+    {
+        /* Reserve the end of the cluster and return the leftover fragment to the free lists */
+        ReservedPte = MM::Paging::AdvancePte(ClusterPte, ClusterSize - NumberOfPtes);
+        InsertFreeCluster(ClusterPte, ClusterSize - NumberOfPtes, SystemPtePoolType);
+    }
+    else
+    {
+        /* Exact match, reserve the entire cluster */
+        ReservedPte = ClusterPte;
+    }
+
+    /* Decrement the total number of available PTEs in this pool */
+    TotalSystemFreePtes[SystemPtePoolType] -= NumberOfPtes;
+
+    /* Return a pointer to the start of the reserved PTE block */
+    return ReservedPte;
+}
+
 /**
  * Finds a free cluster of system PTEs that can satisfy a given size.
  *
@@ -18,49 +134,292 @@
  * @param SystemPtePoolType
  *        Specifies the system PTE pool to search within.
  *
- * @param FoundCluster
- *        On success, receives a pointer to the first PTE of the found cluster.
+ * @return This routine returns a pointer to the first PTE of the found cluster, or NULLPTR if no suitable cluster
+ *         is available.
  *
- * @param PreviousClusterNode
- *        On success, receives a pointer to the list node that precedes the found cluster.
+ * @since XT 1.0
  *
- * @return This routine returns TRUE if a suitable cluster was found, FALSE otherwise.
+ * @note The caller must hold the system space lock.
+ */
+XTAPI
+PMMPTE
+MM::Pte::FindFreeCluster(IN PFN_COUNT NumberOfPtes,
+                         IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    ULONG Bitmap, FirstLevel, SecondLevel;
+    PFN_COUNT Size;
+
+    /* Check if the request falls into a size class spanning multiple sizes */
+    Size = NumberOfPtes;
+    if(NumberOfPtes >= MM_SYSTEM_PTE_SECOND_LEVELS)
+    {
+        /* Round the size up to the next size class, so that every cluster found in that class is large enough */
+        Size += (1 << ((31 - RTL::Math::CountLeadingZeroes32(NumberOfPtes)) - MM_SYSTEM_PTE_SECOND_LEVEL_SHIFT)) - 1;
+        if(Size < NumberOfPtes)
+        {
+            /* Request too large to be ever satisfied */
+            return NULLPTR;
+        }
+    }
+
+    /* Get the size class for the rounded size */
+    GetClusterIndex(Size, &FirstLevel, &SecondLevel);
+
+    /* Look for a non-empty list in the same first level class, at or above the requested second level class */
+    Bitmap = SystemPteFreeListSubBitmap[SystemPtePoolType][FirstLevel] & (MAXULONG << SecondLevel);
+    if(!Bitmap)
+    {
+        /* Look for the smallest non-empty first level class above the requested one */
+        Bitmap = (FirstLevel + 1 < MM_SYSTEM_PTE_FIRST_LEVELS) ?
+                 SystemPteFreeListBitmap[SystemPtePoolType] & (MAXULONG << (FirstLevel + 1)) : 0;
+        if(!Bitmap)
+        {
+            /* No free cluster large enough */
+            return NULLPTR;
+        }
+
+        /* Take the first non-empty first level class and its second level bitmap */
+        FirstLevel = RTL::Math::CountTrailingZeroes32(Bitmap);
+        Bitmap = SystemPteFreeListSubBitmap[SystemPtePoolType][FirstLevel];
+    }
+
+    /* Take the first non-empty second level class */
+    SecondLevel = RTL::Math::CountTrailingZeroes32(Bitmap);
+
+    /* Return the first free cluster from the selected list */
+    return MM::Paging::AdvancePte(SystemPteBase,
+                                  MM::Paging::GetNextEntry(&SystemPteFreeList[SystemPtePoolType]
+                                                                             [(FirstLevel * MM_SYSTEM_PTE_SECOND_LEVELS) +
+                                                                              SecondLevel]));
+}
+
+/**
+ * Returns all system PTE runs cached by the current processor back to the shared system PTE pools.
+ *
+ * @return This routine does not return any value.
  *
  * @since XT 1.0
  */
 XTAPI
+VOID
+MM::Pte::FlushSystemPteCache(VOID)
+{
+    PMMSYSTEM_PTE_CACHE Cache;
+    ULONG Index, PoolType;
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Iterate through the caches of all system PTE pools */
+    for(PoolType = 0; PoolType < MaximumPtePoolTypes; PoolType++)
+    {
+        /* Get the system PTE cache of the current processor */
+        Cache = &KE::Processor::GetCurrentProcessorControlBlock()->SystemPteCache[PoolType];
+
+        /* Check if the cache holds any runs */
+        if(Cache->CachedPtes != 0)
+        {
+            /* Acquire the system space lock once for the whole cache */
+            KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+
+            /* Return all cached runs back to the shared pool */
+            for(Index = 0; Index < MM_SYSTEM_PTE_CACHE_SIZES; Index++)
+            {
+                /* Drain all runs of this size */
+                while(Cache->Count[Index] != 0)
+                {
+                    /* Release the run */
+                    Cache->Count[Index]--;
+                    FreeSystemPtes(Cache->Runs[Index][Cache->Count[Index]], Index + 1,
+                                   (MMSYSTEM_PTE_POOL_TYPE)PoolType);
+                }
+            }
+
+            /* The cache is now empty */
+            Cache->CachedPtes = 0;
+        }
+    }
+}
+
+/**
+ * Returns a short run of system PTEs to the current processor's system PTE cache, flushing a batch when it is full.
+ *
+ * @param StartingPte
+ *        A pointer to the first PTE of the run. All PTEs in the run must be zeroed.
+ *
+ * @param NumberOfPtes
+ *        The number of contiguous PTEs in the run. Must not exceed MM_SYSTEM_PTE_CACHE_SIZES.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool the run belongs to.
+ *
+ * @return This routine returns TRUE if the run has been cached, or FALSE if the cache is over its limit and the run
+ *         must be released to the shared pool.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must be running at DISPATCH_LEVEL.
+ */
+XTAPI
 BOOLEAN
-MM::Pte::FindFreeCluster(IN PFN_COUNT NumberOfPtes,
-                         IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType,
-                         OUT PMMPTE *FoundCluster,
-                         OUT PMMPTE *PreviousClusterNode)
+MM::Pte::FreeCachedSystemPtes(IN PMMPTE StartingPte,
+                              IN PFN_COUNT NumberOfPtes,
+                              IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
 {
-    PMMPTE CurrentCluster;
-    PMMPTE PreviousNode = &FirstSystemFreePte[SystemPtePoolType];
-    ULONG ClusterSize;
+    PMMSYSTEM_PTE_CACHE Cache;
 
-    /* Find a free PTE cluster large enough for the request */
-    while(MM::Paging::GetNextEntry(PreviousNode) != MAXULONG)
+    /* Get the system PTE cache of the current processor */
+    Cache = &KE::Processor::GetCurrentProcessorControlBlock()->SystemPteCache[SystemPtePoolType];
+
+    /* Check if caching the run would exceed the per-processor limit */
+    if(Cache->CachedPtes + NumberOfPtes > MM_SYSTEM_PTE_CACHE_MAXIMUM_PTES)
     {
-        /* Retrieve the cluster and its size */
-        CurrentCluster = MM::Paging::AdvancePte(SystemPteBase, MM::Paging::GetNextEntry(PreviousNode));
-        ClusterSize = GetClusterSize(CurrentCluster);
+        /* Do not cache the run */
+        return FALSE;
+    }
+
+    /* Check if the cache for this run size is full */
+    if(Cache->Count[NumberOfPtes - 1] == MM_SYSTEM_PTE_CACHE_DEPTH)
+    {
+        /* Acquire the system space lock once for the whole batch */
+        KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+
+        /* Return a batch of cached runs back to the shared pool */
+        while(Cache->Count[NumberOfPtes - 1] > MM_SYSTEM_PTE_CACHE_DEPTH - MM_SYSTEM_PTE_CACHE_BATCH)
+        {
+            /* Release the run */
+            Cache->Count[NumberOfPtes - 1]--;
+            FreeSystemPtes(Cache->Runs[NumberOfPtes - 1][Cache->Count[NumberOfPtes - 1]],
+                           NumberOfPtes, SystemPtePoolType);
+            Cache->CachedPtes -= NumberOfPtes;
+        }
+    }
 
-        /* Check if this cluster is large enough */
-        if(NumberOfPtes <= ClusterSize)
+    /* Cache the run */
+    Cache->Runs[NumberOfPtes - 1][Cache->Count[NumberOfPtes - 1]] = StartingPte;
+    Cache->Count[NumberOfPtes - 1]++;
+    Cache->CachedPtes += NumberOfPtes;
+
+    /* The run has been cached */
+    return TRUE;
+}
+
+/**
+ * Releases a block of system PTEs into the shared free cluster index, merging it with adjacent free clusters.
+ *
+ * @param StartingPte
+ *        A pointer to the first PTE to release. All PTEs in the block must be zeroed.
+ *
+ * @param NumberOfPtes
+ *        The number of contiguous PTEs to release.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool to release into.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the system space lock.
+ */
+XTAPI
+VOID
+MM::Pte::FreeSystemPtes(IN PMMPTE StartingPte,
+                        IN PFN_COUNT NumberOfPtes,
+                        IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    PMMPTE NextPte, PreviousPte;
+    ULONG ClusterSize;
+
+    /* Increment the total number of available PTEs in this pool */
+    TotalSystemFreePtes[SystemPtePoolType] += NumberOfPtes;
+
+    /* Check if the PTE directly preceding the released block is free */
+    if(StartingPte > SystemPtesStart[SystemPtePoolType] &&
+       RTL::BitMap::TestBit(&SystemPteBitMap[SystemPtePoolType],
+                            MM::Paging::GetPteDistance(StartingPte, SystemPtesStart[SystemPtePoolType]) - 1))
+    {
+        /* Get the size of the preceding cluster from its last PTE */
+        PreviousPte = MM::Paging::AdvancePte(StartingPte, -1);
+        if(!MM::Paging::GetOneEntry(PreviousPte))
+        {
+            /* The last PTE of a cluster spanning at least three PTEs stores its size */
+            ClusterSize = MM::Paging::GetNextEntry(PreviousPte);
+        }
+        else if(PreviousPte > SystemPtesStart[SystemPtePoolType] &&
+                RTL::BitMap::TestBit(&SystemPteBitMap[SystemPtePoolType],
+                                     MM::Paging::GetPteDistance(PreviousPte, SystemPtesStart[SystemPtePoolType]) - 1))
+        {
+            /* Free clusters are never adjacent, so a free PTE in front means a two-PTE cluster */
+            ClusterSize = 2;
+        }
+        else
         {
-            /* Found a suitable cluster */
-            *FoundCluster = CurrentCluster;
-            *PreviousClusterNode = PreviousNode;
-            return TRUE;
+            /* Single-PTE cluster */
+            ClusterSize = 1;
         }
 
-        /* This cluster is too small, check the next one */
-        PreviousNode = CurrentCluster;
+        /* Remove the preceding cluster from the free lists and merge it with the released block */
+        PreviousPte = MM::Paging::AdvancePte(StartingPte, -(LONG)ClusterSize);
+        RemoveFreeCluster(PreviousPte, SystemPtePoolType);
+        StartingPte = PreviousPte;
+        NumberOfPtes += ClusterSize;
     }
 
-    /* No suitable cluster was found */
-    return FALSE;
+    /* Check if the PTE directly following the released block is free */
+    NextPte = MM::Paging::AdvancePte(StartingPte, NumberOfPtes);
+    if(NextPte <= SystemPtesEnd[SystemPtePoolType] &&
+       RTL::BitMap::TestBit(&SystemPteBitMap[SystemPtePoolType],
+                            MM::Paging::GetPteDistance(NextPte, SystemPtesStart[SystemPtePoolType])))
+    {
+        /* Remove the following cluster from the free lists and merge it with the released block */
+        ClusterSize = GetClusterSize(NextPte);
+        RemoveFreeCluster(NextPte, SystemPtePoolType);
+        NumberOfPtes += ClusterSize;
+    }
+
+    /* Insert the merged block into the free lists */
+    InsertFreeCluster(StartingPte, NumberOfPtes, SystemPtePoolType);
+}
+
+/**
+ * Calculates the two-level size class index of a free system PTE cluster.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs in the free cluster.
+ *
+ * @param FirstLevel
+ *        Supplies a pointer to a variable that will receive the first level index.
+ *
+ * @param SecondLevel
+ *        Supplies a pointer to a variable that will receive the second level index.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pte::GetClusterIndex(IN PFN_COUNT NumberOfPtes,
+                         OUT PULONG FirstLevel,
+                         OUT PULONG SecondLevel)
+{
+    ULONG MostSignificantBit;
+
+    /* Check if the cluster is small enough to have its own size class */
+    if(NumberOfPtes < MM_SYSTEM_PTE_SECOND_LEVELS)
+    {
+        /* Small clusters are indexed directly by their size */
+        *FirstLevel = 0;
+        *SecondLevel = NumberOfPtes;
+        return;
+    }
+
+    /* Split the power of two range the cluster falls into, into linear subranges */
+    MostSignificantBit = 31 - RTL::Math::CountLeadingZeroes32(NumberOfPtes);
+    *FirstLevel = MostSignificantBit - MM_SYSTEM_PTE_SECOND_LEVEL_SHIFT + 1;
+    *SecondLevel = (NumberOfPtes >> (MostSignificantBit - MM_SYSTEM_PTE_SECOND_LEVEL_SHIFT)) -
+                   MM_SYSTEM_PTE_SECOND_LEVELS;
 }
 
 /**
@@ -84,11 +443,64 @@ MM::Pte::GetClusterSize(IN PMMPTE Pte)
         return 1;
     }
 
-    /* For larger clusters, the size is encoded in the second PTE of the block */
+    /* The same flag in the second PTE indicates a free cluster of size two */
+    Pte = MM::Paging::GetNextPte(Pte);
+    if(MM::Paging::GetOneEntry(Pte))
+    {
+        /* Flag is set, so the cluster size is 2 by definition */
+        return 2;
+    }
+
+    /* For larger clusters, the size is encoded in the third PTE of the block */
     Pte = MM::Paging::GetNextPte(Pte);
     return MM::Paging::GetNextEntry(Pte);
 }
 
+/**
+ * Retrieves the page frame number backing a mapped virtual address, including addresses mapped by large pages.
+ *
+ * @param VirtualAddress
+ *        Supplies the virtual address to translate.
+ *
+ * @return This routine returns the page frame number, or MAXULONG_PTR if the address is not mapped.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+PFN_NUMBER
+MM::Pte::GetMappedPageFrame(IN PVOID VirtualAddress)
+{
+    PMMPDE PointerPde;
+    PMMPTE PointerPte;
+
+    /* Get the PDE mapping the virtual address and make sure it is valid */
+    PointerPde = MM::Paging::GetPdeAddress(VirtualAddress);
+    if(!MM::Paging::PteValid(PointerPde))
+    {
+        /* Address is not mapped, return MAXULONG_PTR */
+        return MAXULONG_PTR;
+    }
+
+    /* Check if the PDE maps a large page */
+    if(MM::Paging::PteLargePage(PointerPde))
+    {
+        /* Compute the page frame from the large page base and the page offset within it */
+        return MM::Paging::GetPageFrameNumber(PointerPde) +
+               (((ULONG_PTR)VirtualAddress >> MM_PAGE_SHIFT) & (GetPtesPerPage() - 1));
+    }
+
+    /* Get the PTE mapping the virtual address and make sure it is valid */
+    PointerPte = MM::Paging::GetPteAddress(VirtualAddress);
+    if(!MM::Paging::PteValid(PointerPte))
+    {
+        /* Address is not mapped, return MAXULONG_PTR */
+        return MAXULONG_PTR;
+    }
+
+    /* Return the page frame number */
+    return MM::Paging::GetPageFrameNumber(PointerPte);
+}
+
 /**
  * Calculates the number of Page Table Entries (PTEs) that fit within a single page.
  *
@@ -135,7 +547,7 @@ MM::Pte::InitializeSystemPte(VOID)
 }
 
 /**
- * Formats a range of PTEs into a freelist-based pool for system allocations.
+ * Formats a range of PTEs into an indexed pool for system allocations.
  *
  * @param StartingPte
  *        Supplies a pointer to the start of the PTE range to be formatted.
@@ -149,6 +561,9 @@ MM::Pte::InitializeSystemPte(VOID)
  * @return This routine does not return any value.
  *
  * @since XT 1.0
+ *
+ * @note The first pages of the range are used to hold the bitmap tracking free PTEs in the pool, followed by the back
+ *       links of the free clusters.
  */
 XTAPI
 VOID
@@ -156,25 +571,64 @@ MM::Pte::InitializeSystemPtePool(IN PMMPTE StartingPte,
                                  IN PFN_COUNT NumberOfPtes,
                                  IN MMSYSTEM_PTE_POOL_TYPE PoolType)
 {
+    PFN_COUNT BackLinkPages, BitMapPages;
+    PFN_NUMBER BitMapFrame;
+    PVOID BitMapBuffer;
+    MMPTE TempPte;
+    ULONG Index;
+
     /* Set the system PTE base address */
     SystemPteBase = GetSystemPteBaseAddress();
 
+    /* Zero the memory for the new PTE pool before use */
+    RTL::Memory::ZeroMemory(StartingPte, NumberOfPtes * MM::Paging::GetPteSize());
+
+    /* Calculate the number of pages needed for the bitmap tracking free PTEs */
+    BitMapPages = SIZE_TO_PAGES(((NumberOfPtes + (sizeof(ULONG_PTR) * 8) - 1) / (sizeof(ULONG_PTR) * 8)) *
+                                sizeof(ULONG_PTR));
+
+    /* Calculate the number of pages needed for the back links of the free clusters */
+    BackLinkPages = SIZE_TO_PAGES(NumberOfPtes * sizeof(ULONG));
+
+    /* Back the bitmap and the back links with physical pages, mapped by the first PTEs of the range */
+    BitMapBuffer = MM::Paging::GetPteVirtualAddress(StartingPte);
+    SystemPteBackLinks[PoolType] = (PULONG)MM::Paging::GetPteVirtualAddress(MM::Paging::AdvancePte(StartingPte,
+                                                                                                   BitMapPages));
+    BitMapFrame = MM::Pfn::AllocateBootstrapPages(BitMapPages + BackLinkPages);
+    for(Index = 0; Index < BitMapPages + BackLinkPages; Index++)
+    {
+        /* Map the bitmap or back link page */
+        TempPte = ValidPte;
+        MM::Paging::SetPte(&TempPte, BitMapFrame + Index, 0);
+        MM::Paging::WritePte(StartingPte, TempPte);
+        StartingPte = MM::Paging::GetNextPte(StartingPte);
+    }
+
+    /* Exclude the bitmap and back link pages from the pool */
+    NumberOfPtes -= BitMapPages + BackLinkPages;
+
     /* Record the boundaries of this new PTE pool */
     SystemPtesStart[PoolType] = StartingPte;
     SystemPtesEnd[PoolType] = MM::Paging::AdvancePte(StartingPte, NumberOfPtes - 1);
 
-    /* Zero the memory for the new PTE pool before use */
-    RTL::Memory::ZeroMemory(StartingPte, NumberOfPtes * MM::Paging::GetPteSize());
+    /* Initialize the bitmap, with no PTE marked as free yet */
+    RTL::BitMap::InitializeBitMap(&SystemPteBitMap[PoolType], (PULONG_PTR)BitMapBuffer, NumberOfPtes);
+    RTL::BitMap::ClearAllBits(&SystemPteBitMap[PoolType]);
+
+    /* Initialize the free cluster lists */
+    for(Index = 0; Index < MM_SYSTEM_PTE_LISTS; Index++)
+    {
+        /* Mark the list as empty */
+        MM::Paging::ClearPte(&SystemPteFreeList[PoolType][Index]);
+        MM::Paging::SetNextEntry(&SystemPteFreeList[PoolType][Index], MAXULONG);
+    }
 
-    /* Build the free list head to point to the start of the pool */
-    MM::Paging::SetNextEntry(StartingPte, MAXULONG);
-    MM::Paging::ClearPte(&FirstSystemFreePte[PoolType]);
-    MM::Paging::SetNextEntry(&FirstSystemFreePte[PoolType], MM::Paging::GetPteDistance(StartingPte, SystemPteBase));
+    /* Mark all size classes as empty */
+    SystemPteFreeListBitmap[PoolType] = 0;
+    RTL::Memory::ZeroMemory(SystemPteFreeListSubBitmap[PoolType], sizeof(SystemPteFreeListSubBitmap[PoolType]));
 
-    /* Use the second PTE slot to store the total size of this pool */
-    StartingPte = MM::Paging::GetNextPte(StartingPte);
-    MM::Paging::ClearPte(StartingPte);
-    MM::Paging::SetNextEntry(StartingPte, NumberOfPtes);
+    /* Insert the whole range as a single free cluster */
+    InsertFreeCluster(StartingPte, NumberOfPtes, PoolType);
 
     /* Record the total number of free PTEs in this pool */
     TotalSystemFreePtes[PoolType] = NumberOfPtes;
@@ -219,6 +673,169 @@ MM::Pte::InitializeSystemPteSpace(VOID)
     MM::Paging::SetPte(FirstZeroingPte, MM_RESERVED_ZERO_PTES, 0);
 }
 
+/**
+ * Formats a run of PTEs as a free cluster and inserts it into the free list matching its size.
+ *
+ * @param StartingPte
+ *        Supplies a pointer to the first PTE of the free cluster.
+ *
+ * @param NumberOfPtes
+ *        Supplies the number of PTEs in the free cluster.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool the cluster belongs to.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the system space lock. All PTEs of the cluster must be zeroed. The first PTE links to
+ *       the next cluster in the list, while the link back to the previous one, or MAXULONG at the head of the list,
+ *       is kept in the back link array of the pool. The third and the last PTE store the size. Clusters of one and
+ *       two PTEs are marked with a flag in their first and second PTE respectively.
+ */
+XTAPI
+VOID
+MM::Pte::InsertFreeCluster(IN PMMPTE StartingPte,
+                           IN PFN_COUNT NumberOfPtes,
+                           IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    ULONG ClusterIndex, FirstLevel, NextIndex, SecondLevel;
+    PMMPTE ListHead, NextPte;
+    PULONG BackLinks;
+
+    /* Mark all PTEs of the cluster as free */
+    RTL::BitMap::SetBits(&SystemPteBitMap[SystemPtePoolType],
+                         MM::Paging::GetPteDistance(StartingPte, SystemPtesStart[SystemPtePoolType]),
+                         NumberOfPtes);
+
+    /* Check if there is only one PTE in the cluster */
+    if(NumberOfPtes == 1)
+    {
+        /* Mark it as a single-PTE cluster */
+        MM::Paging::SetOneEntry(StartingPte, 1);
+    }
+    else
+    {
+        /* Mark it as a multi-PTE cluster, flagging the second PTE of a two-PTE cluster */
+        MM::Paging::SetOneEntry(StartingPte, 0);
+        MM::Paging::SetOneEntry(MM::Paging::GetNextPte(StartingPte), (NumberOfPtes == 2));
+    }
+
+    /* Check if the cluster spans more than two PTEs */
+    if(NumberOfPtes > 2)
+    {
+        /* Store the size of the cluster in its third and its last PTE, the latter allowing to merge from above */
+        MM::Paging::SetNextEntry(MM::Paging::AdvancePte(StartingPte, 2), NumberOfPtes);
+        MM::Paging::SetNextEntry(MM::Paging::AdvancePte(StartingPte, NumberOfPtes - 1), NumberOfPtes);
+    }
+
+    /* Get the free list for the size class of the cluster */
+    GetClusterIndex(NumberOfPtes, &FirstLevel, &SecondLevel);
+    ListHead = &SystemPteFreeList[SystemPtePoolType][(FirstLevel * MM_SYSTEM_PTE_SECOND_LEVELS) + SecondLevel];
+
+    /* Link the cluster in front of the current head of the free list */
+    BackLinks = SystemPteBackLinks[SystemPtePoolType];
+    ClusterIndex = MM::Paging::GetPteDistance(StartingPte, SystemPteBase);
+    NextIndex = MM::Paging::GetNextEntry(ListHead);
+    MM::Paging::SetNextEntry(StartingPte, NextIndex);
+    BackLinks[MM::Paging::GetPteDistance(StartingPte, SystemPtesStart[SystemPtePoolType])] = MAXULONG;
+    if(NextIndex != MAXULONG)
+    {
+        /* Point the back link of the former head at the cluster */
+        NextPte = MM::Paging::AdvancePte(SystemPteBase, NextIndex);
+        BackLinks[MM::Paging::GetPteDistance(NextPte, SystemPtesStart[SystemPtePoolType])] = ClusterIndex;
+    }
+
+    /* Make the cluster the new head of the free list */
+    MM::Paging::SetNextEntry(ListHead, ClusterIndex);
+
+    /* Mark the size class as non-empty */
+    SystemPteFreeListSubBitmap[SystemPtePoolType][FirstLevel] |= (1 << SecondLevel);
+    SystemPteFreeListBitmap[SystemPtePoolType] |= (1 << FirstLevel);
+}
+
+/**
+ * Maps a range of virtual addresses, using large pages for every PDE fully covered by the range.
+ *
+ * @param StartAddress
+ *        The beginning of the virtual address range to map.
+ *
+ * @param EndAddress
+ *        The end of the virtual address range to map.
+ *
+ * @param TemplatePte
+ *        A template PTE to use for creating new entries.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Parts of the range not covering a whole PDE are mapped with regular pages. Newly mapped memory is zeroed.
+ */
+XTAPI
+VOID
+MM::Pte::MapLargePages(IN PVOID StartAddress,
+                       IN PVOID EndAddress,
+                       IN PMMPTE TemplatePte)
+{
+    ULONG_PTR LargePageSize, RangeEnd, RangeStart;
+    PMMPDE EndSpace, PointerPde;
+    PFN_NUMBER PageFrameNumber;
+    MMPDE TemplatePde;
+
+    /* Calculate the size of the memory mapped by a single PDE */
+    LargePageSize = (ULONG_PTR)GetPtesPerPage() << MM_PAGE_SHIFT;
+
+    /* Get PDE addresses */
+    PointerPde = MM::Paging::GetPdeAddress(StartAddress);
+    EndSpace = MM::Paging::GetPdeAddress(EndAddress);
+    RangeStart = (ULONG_PTR)StartAddress;
+
+    /* Iterate over all PDEs */
+    while(PointerPde <= EndSpace)
+    {
+        /* Calculate the end of the part of the range mapped by this PDE */
+        RangeEnd = RangeStart | (LargePageSize - 1);
+        if(RangeEnd > (ULONG_PTR)EndAddress)
+        {
+            /* Clip the range to the requested end address */
+            RangeEnd = (ULONG_PTR)EndAddress;
+        }
+
+        /* Check if PDE already maps a large page */
+        if(!MM::Paging::PteValid(PointerPde) || !MM::Paging::PteLargePage(PointerPde))
+        {
+            /* Check if the whole PDE can be mapped with a large page */
+            if(LargePageSupport &&
+               (RangeStart & (LargePageSize - 1)) == 0 && (RangeEnd - RangeStart) == (LargePageSize - 1) &&
+               (!MM::Paging::PteValid(PointerPde) || PageTableEmpty(PointerPde)) &&
+               MM::Pfn::AllocateBootstrapAlignedPages(GetPtesPerPage(), GetPtesPerPage(),
+                                                      &PageFrameNumber) == STATUS_SUCCESS)
+            {
+                /* Map PDE as a large page, leaving an existing empty page table unused */
+                TemplatePde = *TemplatePte;
+                MM::Paging::SetPte(&TemplatePde, PageFrameNumber, MM_PTE_LARGE_PAGE);
+                MM::Paging::WritePte(PointerPde, TemplatePde);
+
+                /* Invalidate any stale translation and clear the large page */
+                AR::CpuFunctions::InvalidateTlbEntry((PVOID)RangeStart);
+                RTL::Memory::ZeroMemory((PVOID)RangeStart, LargePageSize);
+            }
+            else
+            {
+                /* Fall back to mapping this part of the range with regular pages */
+                MapPDE((PVOID)RangeStart, (PVOID)RangeEnd, TemplatePte);
+                MapPTE((PVOID)RangeStart, (PVOID)RangeEnd, TemplatePte);
+            }
+        }
+
+        /* Get next table entry */
+        PointerPde = MM::Paging::GetNextPte(PointerPde);
+        RangeStart = RangeEnd + 1;
+    }
+}
+
 /**
  * Maps a range of virtual addresses at the PDE (Page Directory Entry) level.
  *
@@ -297,8 +914,10 @@ MM::Pte::MapPTE(IN PVOID StartAddress,
     /* Iterate over all PTEs */
     while(PointerPte <= EndSpace)
     {
-        /* Check if PTE is already mapped */
-        if(!MM::Paging::PteValid(PointerPte))
+        /* Check if PTE is already mapped, either directly or by a large page */
+        if(!(MM::Paging::PteValid(MM::Paging::GetPteAddress(PointerPte)) &&
+             MM::Paging::PteLargePage(MM::Paging::GetPteAddress(PointerPte))) &&
+           !MM::Paging::PteValid(PointerPte))
         {
             /* Map PTE */
             MM::Paging::SetPte(TemplatePte, MM::Pfn::AllocateBootstrapPages(1), 0);
@@ -313,6 +932,89 @@ MM::Pte::MapPTE(IN PVOID StartAddress,
     }
 }
 
+/**
+ * Checks whether the page table referenced by the given PDE maps no pages.
+ *
+ * @param PointerPde
+ *        Supplies a pointer to the valid PDE referencing the page table to check.
+ *
+ * @return This routine returns TRUE if no PTE in the page table is valid, or FALSE otherwise.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+BOOLEAN
+MM::Pte::PageTableEmpty(IN PMMPDE PointerPde)
+{
+    PMMPTE PointerPte;
+    PFN_COUNT Index;
+
+    /* Get the first PTE of the page table */
+    PointerPte = MM::Paging::GetPteAddress(MM::Paging::GetPdeVirtualAddress(PointerPde));
+
+    /* Iterate over all PTEs in the page table */
+    for(Index = 0; Index < GetPtesPerPage(); Index++)
+    {
+        /* Check if PTE is mapped */
+        if(MM::Paging::PteValid(PointerPte))
+        {
+            /* Page table is in use, return FALSE */
+            return FALSE;
+        }
+
+        /* Get next table entry */
+        PointerPte = MM::Paging::GetNextPte(PointerPte);
+    }
+
+    /* Page table maps no pages, return TRUE */
+    return TRUE;
+}
+
+/**
+ * Refills a system PTE cache with a batch of runs of a given size under a single system space lock acquisition.
+ *
+ * @param Cache
+ *        Supplies a pointer to the system PTE cache to refill.
+ *
+ * @param NumberOfPtes
+ *        The number of contiguous PTEs in each run.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool from which to allocate.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Pte::RefillSystemPteCache(IN PMMSYSTEM_PTE_CACHE Cache,
+                              IN PFN_COUNT NumberOfPtes,
+                              IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    PMMPTE ReservedPte;
+
+    /* Acquire the system space lock once for the whole batch */
+    KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+
+    /* Reserve a batch of runs, as long as the per-processor limit allows */
+    while(Cache->Count[NumberOfPtes - 1] < MM_SYSTEM_PTE_CACHE_BATCH &&
+          Cache->CachedPtes + NumberOfPtes <= MM_SYSTEM_PTE_CACHE_MAXIMUM_PTES)
+    {
+        /* Reserve a run from the shared pool */
+        ReservedPte = AllocateSystemPtes(NumberOfPtes, SystemPtePoolType);
+        if(!ReservedPte)
+        {
+            /* Out of system PTEs for this pool */
+            break;
+        }
+
+        /* Store the run in the cache */
+        Cache->Runs[NumberOfPtes - 1][Cache->Count[NumberOfPtes - 1]] = ReservedPte;
+        Cache->Count[NumberOfPtes - 1]++;
+        Cache->CachedPtes += NumberOfPtes;
+    }
+}
 
 /**
  * Releases a block of system PTEs into a specified pool.
@@ -329,6 +1031,8 @@ MM::Pte::MapPTE(IN PVOID StartAddress,
  * @return This routine does not return any value.
  *
  * @since XT 1.0
+ *
+ * @note Short runs are kept in the current processor's system PTE cache, without acquiring the system space lock.
  */
 XTAPI
 VOID
@@ -336,101 +1040,99 @@ MM::Pte::ReleaseSystemPtes(IN PMMPTE StartingPte,
                            IN PFN_COUNT NumberOfPtes,
                            IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
 {
-    PMMPTE NextPte, PreviousPte, ReleasedPte;
-    ULONG ClusterSize;
-
     /* Clear the PTEs before releasing them */
     RtlZeroMemory(StartingPte, NumberOfPtes * MM::Paging::GetPteSize());
 
-    /* Raise runlevel and acquire lock to protect the PTE pool */
+    /* Raise runlevel to DISPATCH_LEVEL */
     KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-    KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
-
-    /* Increment the total number of available PTEs in this pool */
-    TotalSystemFreePtes[SystemPtePoolType] += NumberOfPtes;
-
-    /* Start at the head of the free list for this pool */
-    PreviousPte = &FirstSystemFreePte[SystemPtePoolType];
-    ReleasedPte = NULLPTR;
 
-    /* Iterate through the free list to find adjacent blocks */
-    while(MM::Paging::GetNextEntry(PreviousPte) != MAXULONG)
+    /* Check if the run is short enough to be kept in the per-processor cache */
+    if(NumberOfPtes <= MM_SYSTEM_PTE_CACHE_SIZES && FreeCachedSystemPtes(StartingPte, NumberOfPtes, SystemPtePoolType))
     {
-        /* Get the next free cluster to check its size */
-        NextPte = MM::Paging::AdvancePte(SystemPteBase, MM::Paging::GetNextEntry(PreviousPte));
-        ClusterSize = GetClusterSize(NextPte);
-
-        /* Check if the released block is adjacent to the current free block */
-        if((MM::Paging::AdvancePte(NextPte, ClusterSize) == StartingPte) ||
-           (MM::Paging::AdvancePte(StartingPte, NumberOfPtes) == NextPte))
-        {
-            /* Merge the blocks by adding their sizes */
-            NumberOfPtes += ClusterSize;
-
-            /* Check if the current free block is before the released block */
-            if(NextPte < StartingPte)
-            {
-                /* The new merged block starts at the current free block's address */
-                StartingPte = NextPte;
-            }
-
-            /* Unlink the current free block as it is being merged */
-            MM::Paging::SetNextEntry(PreviousPte, MM::Paging::GetNextEntry(NextPte));
+        /* Run cached, nothing more to do */
+        return;
+    }
 
-            /* Check if the block represents more than one PTE */
-            if(!MM::Paging::GetOneEntry(NextPte))
-            {
-                /* Clear block header and move to the size PTE */
-                MM::Paging::ClearPte(NextPte);
-                NextPte = MM::Paging::GetNextPte(NextPte);
-            }
+    /* Acquire the system space lock and release the PTEs into the shared pool */
+    KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+    FreeSystemPtes(StartingPte, NumberOfPtes, SystemPtePoolType);
+}
 
-            /* Clear the merged block */
-            MM::Paging::ClearPte(NextPte);
+/**
+ * Removes a free system PTE cluster from its free list and marks its PTEs as in use.
+ *
+ * @param ClusterPte
+ *        Supplies a pointer to the first PTE of the free cluster.
+ *
+ * @param SystemPtePoolType
+ *        Specifies the system PTE pool the cluster belongs to.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The caller must hold the system space lock. The cluster is unlinked in constant time, using the back link
+ *       stored in the back link array of the pool.
+ */
+XTAPI
+VOID
+MM::Pte::RemoveFreeCluster(IN PMMPTE ClusterPte,
+                           IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
+{
+    ULONG ClusterSize, FirstLevel, NextIndex, PreviousIndex, SecondLevel;
+    PMMPTE ListHead, NextPte;
+    PULONG BackLinks;
+
+    /* Get the size of the cluster and mark all its PTEs as in use */
+    ClusterSize = GetClusterSize(ClusterPte);
+    RTL::BitMap::ClearBits(&SystemPteBitMap[SystemPtePoolType],
+                           MM::Paging::GetPteDistance(ClusterPte, SystemPtesStart[SystemPtePoolType]),
+                           ClusterSize);
+
+    /* Get the size class of the cluster and its neighbours in the free list */
+    GetClusterIndex(ClusterSize, &FirstLevel, &SecondLevel);
+    ListHead = &SystemPteFreeList[SystemPtePoolType][(FirstLevel * MM_SYSTEM_PTE_SECOND_LEVELS) + SecondLevel];
+    NextIndex = MM::Paging::GetNextEntry(ClusterPte);
+    BackLinks = SystemPteBackLinks[SystemPtePoolType];
+    PreviousIndex = BackLinks[MM::Paging::GetPteDistance(ClusterPte, SystemPtesStart[SystemPtePoolType])];
+
+    /* Unlink the cluster from its predecessor, being either the list head or another cluster */
+    MM::Paging::SetNextEntry((PreviousIndex == MAXULONG) ? ListHead :
+                             MM::Paging::AdvancePte(SystemPteBase, PreviousIndex), NextIndex);
+    if(NextIndex != MAXULONG)
+    {
+        /* Point the back link of the successor at the predecessor */
+        NextPte = MM::Paging::AdvancePte(SystemPteBase, NextIndex);
+        BackLinks[MM::Paging::GetPteDistance(NextPte, SystemPtesStart[SystemPtePoolType])] = PreviousIndex;
+    }
 
-            /* Reset insertion point since block size/address changed due to merge */
-            ReleasedPte = NULLPTR;
-        }
-        else
+    /* Check if the free list became empty */
+    if(MM::Paging::GetNextEntry(ListHead) == MAXULONG)
+    {
+        /* Mark the second level size class as empty */
+        SystemPteFreeListSubBitmap[SystemPtePoolType][FirstLevel] &= ~(1 << SecondLevel);
+        if(!SystemPteFreeListSubBitmap[SystemPtePoolType][FirstLevel])
         {
-            /* Select the first free block large enough as insertion point */
-            if((ReleasedPte == NULLPTR) && (NumberOfPtes <= ClusterSize))
-            {
-                /* Mark this as the insertion point */
-                ReleasedPte = PreviousPte;
-            }
-
-            /* Advance to the next free block */
-            PreviousPte = NextPte;
+            /* Mark the whole first level size class as empty */
+            SystemPteFreeListBitmap[SystemPtePoolType] &= ~(1 << FirstLevel);
         }
     }
 
-    /* Check if there is only one PTE to release */
-    if(NumberOfPtes == 1)
+    /* Clear the cluster metadata held by the first PTE */
+    MM::Paging::ClearPte(ClusterPte);
+    if(ClusterSize > 1)
     {
-        /* Mark it as a single-PTE block */
-        MM::Paging::SetOneEntry(StartingPte, 1);
+        /* Clear the second PTE, holding the two-PTE cluster flag */
+        MM::Paging::ClearPte(MM::Paging::GetNextPte(ClusterPte));
     }
-    else
-    {
-        /* Otherwise, mark it as a multi-PTE block */
-        MM::Paging::SetOneEntry(StartingPte, 0);
 
-        /* The next PTE stores the size of the block */
-        NextPte = MM::Paging::GetNextPte(StartingPte);
-        MM::Paging::SetNextEntry(NextPte, NumberOfPtes);
-    }
-
-    /* Check if no suitable insertion point was found */
-    if(ReleasedPte == NULLPTR)
+    /* Check if the cluster spans more than two PTEs */
+    if(ClusterSize > 2)
     {
-        /* Insert at the end of the list */
-        ReleasedPte = PreviousPte;
+        /* Clear the PTEs holding the cluster size */
+        MM::Paging::ClearPte(MM::Paging::AdvancePte(ClusterPte, 2));
+        MM::Paging::ClearPte(MM::Paging::AdvancePte(ClusterPte, ClusterSize - 1));
     }
-
-    /* Link the new block into the free list */
-    MM::Paging::SetNextEntry(StartingPte, MM::Paging::GetNextEntry(ReleasedPte));
-    MM::Paging::SetNextEntry(ReleasedPte, MM::Paging::GetPteDistance(StartingPte, SystemPteBase));
 }
 
 /**
@@ -446,98 +1148,60 @@ MM::Pte::ReleaseSystemPtes(IN PMMPTE StartingPte,
  *         or NULLPTR if not enough contiguous PTEs are available.
  *
  * @since XT 1.0
+ *
+ * @note Short runs are taken from the current processor's system PTE cache, without acquiring the system space lock.
  */
 XTAPI
 PMMPTE
 MM::Pte::ReserveSystemPtes(IN PFN_COUNT NumberOfPtes,
                            IN MMSYSTEM_PTE_POOL_TYPE SystemPtePoolType)
 {
-    PMMPTE NextPte, PreviousPte, ReservedPte;
-    ULONG ClusterSize;
-
-    /* Raise runlevel and acquire lock to protect the PTE pool */
-    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
-    KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+    PMMPTE ReservedPte;
 
-    /* Find a free PTE cluster large enough for the request */
-    if(!FindFreeCluster(NumberOfPtes, SystemPtePoolType, &NextPte, &PreviousPte))
+    /* Check if the request is short enough to be served from the per-processor cache */
+    if(NumberOfPtes <= MM_SYSTEM_PTE_CACHE_SIZES)
     {
-        /* Out of system PTEs for this pool, return NULLPTR */
-        return NULLPTR;
+        /* Take a run from the cache */
+        ReservedPte = AllocateCachedSystemPtes(NumberOfPtes, SystemPtePoolType);
+        if(ReservedPte)
+        {
+            /* Return a pointer to the start of the reserved run */
+            return ReservedPte;
+        }
     }
 
-    /* We have the cluster, now get its size for the allocation logic below */
-    ClusterSize = GetClusterSize(NextPte);
-
-    /* Unlink the found cluster from the free list for processing */
-    MM::Paging::SetNextEntry(PreviousPte, MM::Paging::GetNextEntry(NextPte));
+    /* Raise runlevel to DISPATCH_LEVEL */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
 
-    /* Handle the allocation based on whether the cluster size is an exact match */
-    if(ClusterSize == NumberOfPtes)
+    /* Start a guarded code block */
     {
-        /* Exact match, allocate the entire cluster */
-        ReservedPte = NextPte;
-
-        /* Handle metadata cleanup for a single-PTE cluster */
-        if(MM::Paging::GetOneEntry(NextPte))
-        {
-            /* Clear the PTE that held the list metadata */
-            MM::Paging::ClearPte(NextPte);
-            NextPte = MM::Paging::GetNextPte(NextPte);
-        }
-
-        /* Clear the PTE that held the cluster size */
-        MM::Paging::ClearPte(NextPte);
+        /* Acquire the system space lock and reserve the PTEs from the shared pool */
+        KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+        ReservedPte = AllocateSystemPtes(NumberOfPtes, SystemPtePoolType);
     }
-    else
+
+    /* Check if the reservation failed */
+    if(!ReservedPte)
     {
-        /* Cluster is larger than needed, so it will be split */
-        ClusterSize -= NumberOfPtes;
-        ReservedPte = MM::Paging::AdvancePte(NextPte, ClusterSize);
+        /* Return the runs cached by the current processor to the shared pool and try again */
+        FlushSystemPteCache();
 
-        /* Update metadata for the new, smaller leftover cluster */
-        if(ClusterSize == 1)
-        {
-            /* The leftover fragment is a single PTE */
-            MM::Paging::SetOneEntry(NextPte, 1);
-            MM::Paging::ClearPte(ReservedPte);
-        }
-        else
+        /* Start a guarded code block */
         {
-            /* The leftover fragment is larger than one PTE */
-            NextPte = MM::Paging::GetNextPte(NextPte);
-            MM::Paging::SetNextEntry(NextPte, ClusterSize);
+            /* Acquire the system space lock and retry the reservation */
+            KE::QueuedSpinLockGuard SpinLock(SystemSpaceLock);
+            ReservedPte = AllocateSystemPtes(NumberOfPtes, SystemPtePoolType);
         }
 
-        /* Find the correct sorted position to re-insert the leftover fragment */
-        PreviousPte = &FirstSystemFreePte[SystemPtePoolType];
-        while(MM::Paging::GetNextEntry(PreviousPte) != MAXULONG)
+        /* Check if the reservation failed again */
+        if(!ReservedPte)
         {
-            /* Get the next free cluster to check its size */
-            NextPte = MM::Paging::AdvancePte(SystemPteBase, MM::Paging::GetNextEntry(PreviousPte));
-
-            /* Check if the leftover fragment should be inserted here */
-            if(ClusterSize <= GetClusterSize(NextPte))
-            {
-                /* Found the correct sorted position */
-                break;
-            }
-
-            /* Advance to the next entry */
-            PreviousPte = NextPte;
+            /* Out of system PTEs for this pool, account the failure and return NULLPTR */
+            MM::Statistics::IncrementCounter(SystemPteFailures);
+            return NULLPTR;
         }
-
-        /* Get a pointer to the start of the leftover fragment */
-        NextPte = MM::Paging::AdvancePte(ReservedPte, -ClusterSize);
-
-        /* Insert the leftover fragment back into the free list at its sorted position */
-        MM::Paging::SetNextEntry(NextPte, MM::Paging::GetNextEntry(PreviousPte));
-        MM::Paging::SetNextEntry(PreviousPte, MM::Paging::GetPteDistance(NextPte, SystemPteBase));
     }
 
-    /* Decrement the total number of available PTEs in this pool */
-    TotalSystemFreePtes[SystemPtePoolType] -= NumberOfPtes;
-
     /* Flush the TLB to ensure address translation consistency */
     AR::CpuFunctions::FlushTlb();
 
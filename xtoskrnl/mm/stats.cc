@@ -0,0 +1,203 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/stats.cc
+ * DESCRIPTION:     Memory Manager performance counters
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Adds a value to the performance counter of the current processor.
+ *
+ * @param Counter
+ *        Specifies the performance counter to update.
+ *
+ * @param Value
+ *        Supplies the value to add to the counter.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Counters are updated without interlocked operations, as they are only summed on demand. An update racing
+ *       with a processor switch may occasionally be lost, which is acceptable for statistics.
+ */
+XTAPI
+VOID
+MM::Statistics::AddCounter(IN MMPERFORMANCE_COUNTER Counter,
+                           IN ULONG_PTR Value)
+{
+    /* Update the counter in the current processor control block */
+    KE::Processor::GetCurrentProcessorControlBlock()->PerformanceCounters[Counter] += Value;
+}
+
+/**
+ * Prints the memory manager performance counters and the PFN list census to the kernel debugger.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Statistics::DumpPerformanceInformation(VOID)
+{
+    MMPERFORMANCE_INFORMATION Information;
+
+    /* Take a snapshot of the performance information */
+    QueryPerformanceInformation(&Information);
+
+    /* Print the page list census */
+    DebugPrint(L"Memory manager performance information:\n"
+               L"List       Pages      Allocs     Frees\n"
+               L"Zeroed     %-10zu %-10zu %zu\n"
+               L"Free       %-10zu %-10zu %zu\n"
+               L"Standby    %-10zu %-10zu %zu\n"
+               L"Modified   %-10zu %-10zu %zu\n"
+               L"Bad        %zu\n"
+               L"Available  %zu\n",
+               Information.ListPages[ZeroedPageList], Information.Counters[ZeroedPageAllocations],
+               Information.Counters[ZeroedPageFrees],
+               Information.ListPages[FreePageList], Information.Counters[FreePageAllocations],
+               Information.Counters[FreePageFrees],
+               Information.ListPages[StandbyPageList], Information.Counters[StandbyPageAllocations],
+               Information.Counters[StandbyPageFrees],
+               Information.ListPages[ModifiedPageList], Information.Counters[ModifiedPageAllocations],
+               Information.Counters[ModifiedPageFrees],
+               Information.ListPages[BadPageList], Information.AvailablePages);
+
+    /* Print the event counters */
+    DebugPrint(L"Colored list misses: %zu, Pool expansions: %zu, System PTE failures: %zu\n"
+               L"TLB flushes: %zu, Page faults: %zu\n",
+               Information.Counters[ColoredListMisses], Information.Counters[PoolExpansions],
+               Information.Counters[SystemPteFailures], Information.Counters[TlbFlushes],
+               Information.Counters[PageFaults]);
+}
+
+/**
+ * Increments the performance counter of the current processor.
+ *
+ * @param Counter
+ *        Specifies the performance counter to increment.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Statistics::IncrementCounter(IN MMPERFORMANCE_COUNTER Counter)
+{
+    /* Increment the counter in the current processor control block */
+    KE::Processor::GetCurrentProcessorControlBlock()->PerformanceCounters[Counter]++;
+}
+
+/**
+ * Initializes the memory manager performance monitor.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Statistics::InitializeStatistics(VOID)
+{
+    WCHAR ParameterValue[16];
+    ULONG Interval;
+
+    /* Check if user requested periodic performance information dumps */
+    if(KE::BootInformation::GetKernelParameterValue(L"MMSTATS", ParameterValue, 16) == STATUS_SUCCESS)
+    {
+        /* Convert the interval in seconds to 100ns units */
+        if(RTL::WideString::WideStringToNumber(ParameterValue, 0, &Interval) == STATUS_SUCCESS)
+        {
+            /* Enable the performance monitor and schedule the first dump */
+            MonitorInterval = (ULONGLONG)Interval * 10000000;
+            MonitorDeadline = KE::SharedData::GetInterruptTime().QuadPart + MonitorInterval;
+        }
+    }
+}
+
+/**
+ * Periodically prints the memory manager performance information, if enabled with the MMSTATS kernel parameter.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note This routine is called by the idle loop of every processor, on each clock tick the processor is idle.
+ *       Only the bootstrap processor prints the performance information.
+ */
+XTAPI
+VOID
+MM::Statistics::MonitorPerformance(VOID)
+{
+    ULONGLONG CurrentTime;
+
+    /* Check if the performance monitor is enabled and let the bootstrap processor do the work */
+    if(!MonitorInterval || KE::Processor::GetCurrentProcessorNumber() != 0)
+    {
+        /* Nothing to do */
+        return;
+    }
+
+    /* Check if the monitor interval has elapsed */
+    CurrentTime = KE::SharedData::GetInterruptTime().QuadPart;
+    if(CurrentTime < MonitorDeadline)
+    {
+        /* Not yet */
+        return;
+    }
+
+    /* Schedule the next dump and print the performance information */
+    MonitorDeadline = CurrentTime + MonitorInterval;
+    DumpPerformanceInformation();
+}
+
+/**
+ * Takes a snapshot of the memory manager performance counters, summed over all processors, and the PFN list census.
+ *
+ * @param Information
+ *        Supplies a pointer to a buffer that receives the performance information.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Statistics::QueryPerformanceInformation(OUT PMMPERFORMANCE_INFORMATION Information)
+{
+    PKPROCESSOR_BLOCK ProcessorBlock;
+    ULONG Counter, Index;
+
+    /* Clear the performance information */
+    RTL::Memory::ZeroMemory(Information, sizeof(MMPERFORMANCE_INFORMATION));
+
+    /* Iterate through all processors */
+    for(Index = 0; Index < sizeof(KAFFINITY) * 8; Index++)
+    {
+        /* Get the processor block and skip processors, that are not present */
+        ProcessorBlock = KE::Processor::GetProcessorBlock(Index);
+        if(ProcessorBlock == NULLPTR)
+        {
+            /* Processor not present, skip it */
+            continue;
+        }
+
+        /* Sum up the processor counters */
+        for(Counter = 0; Counter < MaximumPerformanceCounters; Counter++)
+        {
+            /* Add the processor counter to the total */
+            Information->Counters[Counter] += ProcessorBlock->Prcb.PerformanceCounters[Counter];
+        }
+    }
+
+    /* Take the PFN list census */
+    MM::Pfn::QueryPageLists(Information->ListPages);
+    Information->AvailablePages = MM::Pfn::GetAvailablePages();
+}
@@ -0,0 +1,411 @@
+/**
+ * PROJECT:         ExectOS
+ * COPYRIGHT:       See COPYING.md in the top level directory
+ * FILE:            xtoskrnl/mm/tlb.cc
+ * DESCRIPTION:     Translation Lookaside Buffer (TLB) shootdown support
+ * DEVELOPERS:      Aiken Harris <harraiken91@gmail.com>
+ */
+
+#include <xtos.hh>
+
+
+/**
+ * Allocates a hardware address space identifier (PCID) for a new address space.
+ *
+ * @return This routine returns the allocated identifier, or 0 if the address space has to be flushed on every switch.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+USHORT
+MM::Tlb::AllocateAddressSpaceId(VOID)
+{
+    ULONG_PTR AddressSpaceId;
+
+    /* Check if address space identifiers are supported */
+    if(!AddressSpaceIdSupport)
+    {
+        /* Fall back to flushing the TLB on address space switch */
+        return 0;
+    }
+
+    /* Raise runlevel and acquire the address space identifiers lock */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::SpinLockGuard AddressSpaceIdSpinLock(&AddressSpaceIdLock);
+
+    /* Find a free identifier */
+    AddressSpaceId = RTL::BitMap::FindClearBits(&AddressSpaceIdMap, 1, 1);
+    if(AddressSpaceId == MAXULONG_PTR)
+    {
+        /* All identifiers are in use, fall back to flushing the TLB on address space switch */
+        return 0;
+    }
+
+    /* Mark the identifier as allocated and return it */
+    RTL::BitMap::SetBits(&AddressSpaceIdMap, AddressSpaceId, 1);
+    return (USHORT)AddressSpaceId;
+}
+
+/**
+ * Invalidates all translations queued in a TLB flush batch on the current processor and on all other processors
+ * that may cache them, using a single IPI round-trip.
+ *
+ * @param Batch
+ *        Supplies a pointer to the TLB flush batch to process. The batch is emptied on return.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note The PTEs of all queued ranges must already be updated before calling this routine.
+ */
+XTAPI
+VOID
+MM::Tlb::FlushBatch(IN OUT PMMTLB_FLUSH_BATCH Batch)
+{
+    PKPROCESSOR_BLOCK ProcessorBlock;
+    KAFFINITY Affinity, Targets;
+    ULONG Index;
+
+    /* Check if there is anything to flush */
+    if(!Batch->FlushEntireTlb && Batch->Count == 0)
+    {
+        /* Nothing to do */
+        return;
+    }
+
+    /* Account the TLB flush */
+    MM::Statistics::IncrementCounter(TlbFlushes);
+
+    /* Check if any processor is able to service TLB shootdowns yet */
+    if(ShootdownProcessors == 0)
+    {
+        /* Early system initialization, only the current processor is running */
+        FlushLocalTlb(Batch);
+        InitializeBatch(Batch);
+        return;
+    }
+
+    /* Raise runlevel to DISPATCH_LEVEL to stay on the current processor */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+
+    /* Get the affinity of the current processor */
+    Affinity = (KAFFINITY)1 << KE::Processor::GetCurrentProcessorControlBlock()->CpuNumber;
+
+    /* Select the other processors that may cache the translations */
+    Targets = ShootdownProcessors & ~Affinity;
+    if(Batch->UserSpace && !Batch->FlushEntireTlb && Batch->AddressSpaceId == 0)
+    {
+        /* Untagged user space translations can only be cached by processors running the current process */
+        Targets &= KE::Processor::GetCurrentThread()->ApcState.Process->ActiveProcessors;
+    }
+
+    /* Check if any other processor needs to be interrupted */
+    if(Targets)
+    {
+        /* Acquire the shootdown lock, servicing requests sent to this processor while waiting */
+        while(RTL::Atomic::CompareExchange32(&ShootdownLock, 1, 0) != 0)
+        {
+            /* Service a pending request, if any, to avoid deadlocking with its initiator */
+            ServiceShootdownRequest();
+            AR::CpuFunctions::YieldProcessor();
+        }
+
+        /* Publish the request and mark all target processors as pending */
+        RTL::Memory::CopyMemory(&ShootdownRequest, Batch, sizeof(MMTLB_FLUSH_BATCH));
+        RTL::Atomic::Exchange64((PLONG_PTR)&ShootdownPending, (LONG_PTR)Targets);
+
+        /* Interrupt all target processors */
+        for(Index = 0; Index < sizeof(KAFFINITY) * 8; Index++)
+        {
+            /* Check if the processor is targeted */
+            if(Targets & ((KAFFINITY)1 << Index))
+            {
+                /* Send the shootdown IPI to the processor */
+                ProcessorBlock = KE::Processor::GetProcessorBlock(Index);
+                if(ProcessorBlock != NULLPTR)
+                {
+                    /* Dispatch the IPI */
+                    HL::Pic::SendIpi(ProcessorBlock->HardwareId, APIC_VECTOR_IPI, APIC_DM_FIXED,
+                                     APIC_DSH_Destination, APIC_TGM_EDGE);
+                }
+            }
+        }
+    }
+
+    /* Flush the translations on the current processor, while the IPIs are being delivered */
+    FlushLocalTlb(Batch);
+
+    /* Check if any other processor has been interrupted */
+    if(Targets)
+    {
+        /* Wait for all target processors to complete the request */
+        while(ShootdownPending != 0)
+        {
+            /* Yield the processor */
+            AR::CpuFunctions::YieldProcessor();
+        }
+
+        /* Release the shootdown lock */
+        RTL::Atomic::Exchange32(&ShootdownLock, 0);
+    }
+
+    /* Empty the batch */
+    InitializeBatch(Batch);
+}
+
+/**
+ * Invalidates the translations of a single virtual address range on all processors that may cache them.
+ *
+ * @param VirtualAddress
+ *        Supplies the first virtual address of the range.
+ *
+ * @param NumberOfPages
+ *        Supplies the number of pages in the range.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::FlushRange(IN PVOID VirtualAddress,
+                    IN PFN_COUNT NumberOfPages)
+{
+    MMTLB_FLUSH_BATCH Batch;
+
+    /* Queue the range in a local batch and flush it */
+    InitializeBatch(&Batch);
+    QueueFlush(&Batch, VirtualAddress, NumberOfPages);
+    FlushBatch(&Batch);
+}
+
+/**
+ * Releases a hardware address space identifier (PCID) of a destroyed address space.
+ *
+ * @param AddressSpaceId
+ *        Supplies the identifier to release.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::FreeAddressSpaceId(IN USHORT AddressSpaceId)
+{
+    /* Check if the address space was tagged */
+    if(AddressSpaceId == 0)
+    {
+        /* Nothing to release */
+        return;
+    }
+
+    /* Drop translations tagged with the identifier on all processors before it gets reused */
+    MM::Paging::FlushEntireTlb();
+
+    /* Raise runlevel and acquire the address space identifiers lock */
+    KE::RaiseRunLevel RunLevel(DISPATCH_LEVEL);
+    KE::SpinLockGuard AddressSpaceIdSpinLock(&AddressSpaceIdLock);
+
+    /* Mark the identifier as free */
+    RTL::BitMap::ClearBits(&AddressSpaceIdMap, AddressSpaceId, 1);
+}
+
+/**
+ * Services the TLB shootdown IPI, invalidating the translations requested by another processor.
+ *
+ * @param TrapFrame
+ *        Supplies a pointer to the hardware trap frame representing the interrupted execution context.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTCDECL
+VOID
+MM::Tlb::HandleShootdownInterrupt(IN PKTRAP_FRAME TrapFrame)
+{
+    KRUNLEVEL RunLevel;
+
+    /* Start the interrupt */
+    HL::Irq::BeginSystemInterrupt(IPI_LEVEL, &RunLevel);
+
+    /* Service the pending shootdown request */
+    ServiceShootdownRequest();
+
+    /* End the interrupt */
+    HL::Irq::EndInterrupt(TrapFrame, RunLevel);
+}
+
+/**
+ * Initializes an empty TLB flush batch.
+ *
+ * @param Batch
+ *        Supplies a pointer to the TLB flush batch to initialize.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::InitializeBatch(OUT PMMTLB_FLUSH_BATCH Batch)
+{
+    /* Reset the batch */
+    Batch->FlushEntireTlb = FALSE;
+    Batch->UserSpace = FALSE;
+    Batch->AddressSpaceId = 0;
+    Batch->Count = 0;
+    Batch->NumberOfPages = 0;
+}
+
+/**
+ * Queues a virtual address range for invalidation, so that several unmaps can share a single IPI round-trip.
+ *
+ * @param Batch
+ *        Supplies a pointer to the TLB flush batch to queue the range in.
+ *
+ * @param VirtualAddress
+ *        Supplies the first virtual address of the range.
+ *
+ * @param NumberOfPages
+ *        Supplies the number of pages in the range.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ *
+ * @note Once the batch covers more than MM_TLB_FLUSH_THRESHOLD pages, it is turned into an entire TLB flush.
+ */
+XTAPI
+VOID
+MM::Tlb::QueueFlush(IN OUT PMMTLB_FLUSH_BATCH Batch,
+                    IN PVOID VirtualAddress,
+                    IN PFN_COUNT NumberOfPages)
+{
+    PMMTLB_FLUSH_RANGE LastRange;
+
+    /* Align virtual address down to page boundary */
+    VirtualAddress = (PVOID)((ULONG_PTR)VirtualAddress & ~(MM_PAGE_SIZE - 1));
+
+    /* Check if the range belongs to the user space */
+    if(VirtualAddress <= MM::Manager::GetMemoryLayout()->UserSpaceEnd)
+    {
+        /* Mark the batch as containing user space translations of the current process */
+        Batch->UserSpace = TRUE;
+        Batch->AddressSpaceId = KE::Processor::GetCurrentThread()->ApcState.Process->AddressSpaceId;
+    }
+
+    /* Check if the entire TLB is going to be flushed anyway */
+    if(Batch->FlushEntireTlb)
+    {
+        /* Nothing more to queue */
+        return;
+    }
+
+    /* Check if invalidating pages one by one would cost more than flushing the entire TLB */
+    Batch->NumberOfPages += NumberOfPages;
+    if(Batch->NumberOfPages > MM_TLB_FLUSH_THRESHOLD)
+    {
+        /* Switch to an entire TLB flush */
+        Batch->FlushEntireTlb = TRUE;
+        Batch->Count = 0;
+        return;
+    }
+
+    /* Check if the range directly follows the last queued one */
+    LastRange = Batch->Count ? &Batch->Ranges[Batch->Count - 1] : NULLPTR;
+    if(LastRange && (ULONG_PTR)LastRange->VirtualAddress + ((ULONG_PTR)LastRange->NumberOfPages << MM_PAGE_SHIFT) ==
+                    (ULONG_PTR)VirtualAddress)
+    {
+        /* Extend the last queued range */
+        LastRange->NumberOfPages += NumberOfPages;
+        return;
+    }
+
+    /* Check if there is room for another range */
+    if(Batch->Count == MM_TLB_FLUSH_RANGES)
+    {
+        /* Out of ranges, switch to an entire TLB flush */
+        Batch->FlushEntireTlb = TRUE;
+        Batch->Count = 0;
+        return;
+    }
+
+    /* Queue the range */
+    Batch->Ranges[Batch->Count].VirtualAddress = VirtualAddress;
+    Batch->Ranges[Batch->Count].NumberOfPages = NumberOfPages;
+    Batch->Count++;
+}
+
+/**
+ * Registers the TLB shootdown interrupt handler for the current processor and adds it to the shootdown targets.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::RegisterProcessor(VOID)
+{
+    /* Register the TLB shootdown interrupt handler */
+    HL::Irq::RegisterSystemInterruptHandler(APIC_VECTOR_IPI, HandleShootdownInterrupt);
+
+    /* Enable address space identifiers, if supported */
+    EnableAddressSpaceIds();
+
+    /* Add the current processor to the shootdown targets */
+    RTL::Atomic::Or64((PLONG_PTR)&ShootdownProcessors,
+                      (LONG_PTR)1 << KE::Processor::GetCurrentProcessorControlBlock()->CpuNumber);
+}
+
+/**
+ * Invalidates the translations requested by another processor, if the current processor is targeted.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::ServiceShootdownRequest(VOID)
+{
+    KAFFINITY Affinity;
+
+    /* Get the affinity of the current processor */
+    Affinity = (KAFFINITY)1 << KE::Processor::GetCurrentProcessorControlBlock()->CpuNumber;
+
+    /* Check if the current processor is targeted by a pending request */
+    if(ShootdownPending & Affinity)
+    {
+        /* Make sure the request is read only after it has been published */
+        AR::CpuFunctions::ReadWriteBarrier();
+
+        /* Flush the requested translations and signal completion */
+        FlushLocalTlb(&ShootdownRequest);
+        RTL::Atomic::And64((PLONG_PTR)&ShootdownPending, ~(LONG_PTR)Affinity);
+    }
+}
+
+/**
+ * Removes the current processor from the shootdown targets, before it stops executing with interrupts disabled.
+ *
+ * @return This routine does not return any value.
+ *
+ * @since XT 1.0
+ */
+XTAPI
+VOID
+MM::Tlb::UnregisterProcessor(VOID)
+{
+    KAFFINITY Affinity;
+
+    /* Get the affinity of the current processor */
+    Affinity = (KAFFINITY)1 << KE::Processor::GetCurrentProcessorControlBlock()->CpuNumber;
+
+    /* Stop targeting the current processor and complete any request pending for it */
+    RTL::Atomic::And64((PLONG_PTR)&ShootdownProcessors, ~(LONG_PTR)Affinity);
+    RTL::Atomic::And64((PLONG_PTR)&ShootdownPending, ~(LONG_PTR)Affinity);
+}
@@ -47,12 +47,31 @@ PO::Idle::InitializeProcessorIdleState(IN OUT PKPROCESSOR_CONTROL_BLOCK Prcb)
  * @return This routine does not return any value.
  *
  * @since XT 1.0
+ *
+ * @note This routine is called repeatedly by the idle loop of every processor, once per interrupt.
  */
 XTFASTCALL
 VOID
 PO::Idle::Idle0Function(IN PPROCESSOR_POWER_STATE PowerState)
 {
-    UNIMPLEMENTED;
+    /* Use idle time to move a batch of free pages to the zeroed page lists */
+    MM::Pfn::ZeroFreePages(MM_ZERO_PAGE_BATCH);
+
+    /* Return the cached pool blocks, if flushing the lookaside lists has been requested */
+    MM::Allocator::TrimLookasideLists();
+
+    /* Prepare a zeroed kernel stack for the kernel stack cache */
+    MM::KernelPool::RefillKernelStackCache();
+
+    /* Print the pool tag statistics if the pool monitor is due */
+    MM::Allocator::MonitorPoolTags();
+
+    /* Print the memory manager performance information if the performance monitor is due */
+    MM::Statistics::MonitorPerformance();
+
+    /* Enable interrupts and halt the processor until the next interrupt arrives */
+    AR::CpuFunctions::SetInterruptFlag();
+    AR::CpuFunctions::Halt();
 }
 
 /**